@@ -0,0 +1,601 @@
+/**
+ * @file Translator.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Aot - Ahead of time translator of 6502 programs
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "Translator.hpp"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace m6502
+{
+
+namespace
+{
+
+/**
+ * @brief 6502 operations the translator writes in C++
+ * 
+ */
+enum class EOp : Byte
+{
+    None,
+    LDA, LDX, LDY, STA, STX, STY,
+    AND, ORA, EOR, BIT, ADC, SBC, CMP, CPX, CPY,
+    INC, DEC, ASL, LSR, ROL, ROR,
+    TAX, TAY, TXA, TYA, TSX, TXS,
+    INX, INY, DEX, DEY,
+    CLC, SEC, CLV, CLI, SEI, CLD, NOP,
+    PHA, PLA, PHP, JMP, JMPI, JSR, RTS,
+    BEQ, BNE, BCS, BCC, BMI, BPL, BVC, BVS
+};
+
+/**
+ * @brief Operation of an opcode, None when left to the interpreter
+ *        (BRK, RTI, PLP, SED and illegal opcodes)
+ * 
+ * @param pIns 
+ * @return EOp 
+ */
+EOp operationOf(Ins pIns)
+{
+    switch (pIns)
+    {
+        case Ins::LDA_IM: case Ins::LDA_ZP: case Ins::LDA_ZPX: case Ins::LDA_ABS:
+        case Ins::LDA_ABSX: case Ins::LDA_ABSY: case Ins::LDA_INDX: case Ins::LDA_INDY:
+            return EOp::LDA;
+        case Ins::LDX_IM: case Ins::LDX_ZP: case Ins::LDX_ZPY:
+        case Ins::LDX_ABS: case Ins::LDX_ABSY:
+            return EOp::LDX;
+        case Ins::LDY_IM: case Ins::LDY_ZP: case Ins::LDY_ZPX:
+        case Ins::LDY_ABS: case Ins::LDY_ABSX:
+            return EOp::LDY;
+        case Ins::STA_ZP: case Ins::STA_ZPX: case Ins::STA_ABS: case Ins::STA_ABSX:
+        case Ins::STA_ABSY: case Ins::STA_INDX: case Ins::STA_INDY:
+            return EOp::STA;
+        case Ins::STX_ZP: case Ins::STX_ZPY: case Ins::STX_ABS:
+            return EOp::STX;
+        case Ins::STY_ZP: case Ins::STY_ZPX: case Ins::STY_ABS:
+            return EOp::STY;
+        case Ins::AND_IM: case Ins::AND_ZP: case Ins::AND_ZPX: case Ins::AND_ABS:
+        case Ins::AND_ABSX: case Ins::AND_ABSY: case Ins::AND_INDX: case Ins::AND_INDY:
+            return EOp::AND;
+        case Ins::ORA_IM: case Ins::ORA_ZP: case Ins::ORA_ZPX: case Ins::ORA_ABS:
+        case Ins::ORA_ABSX: case Ins::ORA_ABSY: case Ins::ORA_INDX: case Ins::ORA_INDY:
+            return EOp::ORA;
+        case Ins::EOR_IM: case Ins::EOR_ZP: case Ins::EOR_ZPX: case Ins::EOR_ABS:
+        case Ins::EOR_ABSX: case Ins::EOR_ABSY: case Ins::EOR_INDX: case Ins::EOR_INDY:
+            return EOp::EOR;
+        case Ins::BIT_ZP: case Ins::BIT_ABS:
+            return EOp::BIT;
+        case Ins::ADC: case Ins::ADC_ZP: case Ins::ADC_ZPX: case Ins::ADC_ABS:
+        case Ins::ADC_ABSX: case Ins::ADC_ABSY: case Ins::ADC_INDX: case Ins::ADC_INDY:
+            return EOp::ADC;
+        case Ins::SBC: case Ins::SBC_ZP: case Ins::SBC_ZPX: case Ins::SBC_ABS:
+        case Ins::SBC_ABSX: case Ins::SBC_ABSY: case Ins::SBC_INDX: case Ins::SBC_INDY:
+            return EOp::SBC;
+        case Ins::CMP: case Ins::CMP_ZP: case Ins::CMP_ZPX: case Ins::CMP_ABS:
+        case Ins::CMP_ABSX: case Ins::CMP_ABSY: case Ins::CMP_INDX: case Ins::CMP_INDY:
+            return EOp::CMP;
+        case Ins::CPX: case Ins::CPX_ZP: case Ins::CPX_ABS:
+            return EOp::CPX;
+        case Ins::CPY: case Ins::CPY_ZP: case Ins::CPY_ABS:
+            return EOp::CPY;
+        case Ins::INC_ZP: case Ins::INC_ZPX: case Ins::INC_ABS: case Ins::INC_ABSX:
+            return EOp::INC;
+        case Ins::DEC_ZP: case Ins::DEC_ZPX: case Ins::DEC_ABS: case Ins::DEC_ABSX:
+            return EOp::DEC;
+        case Ins::ASL: case Ins::ASL_ZP: case Ins::ASL_ZPX:
+        case Ins::ASL_ABS: case Ins::ASL_ABSX:
+            return EOp::ASL;
+        case Ins::LSR: case Ins::LSR_ZP: case Ins::LSR_ZPX:
+        case Ins::LSR_ABS: case Ins::LSR_ABSX:
+            return EOp::LSR;
+        case Ins::ROL: case Ins::ROL_ZP: case Ins::ROL_ZPX:
+        case Ins::ROL_ABS: case Ins::ROL_ABSX:
+            return EOp::ROL;
+        case Ins::ROR: case Ins::ROR_ZP: case Ins::ROR_ZPX:
+        case Ins::ROR_ABS: case Ins::ROR_ABSX:
+            return EOp::ROR;
+        case Ins::TAX: return EOp::TAX;
+        case Ins::TAY: return EOp::TAY;
+        case Ins::TXA: return EOp::TXA;
+        case Ins::TYA: return EOp::TYA;
+        case Ins::TSX: return EOp::TSX;
+        case Ins::TXS: return EOp::TXS;
+        case Ins::INX: return EOp::INX;
+        case Ins::INY: return EOp::INY;
+        case Ins::DEX: return EOp::DEX;
+        case Ins::DEY: return EOp::DEY;
+        case Ins::CLC: return EOp::CLC;
+        case Ins::SEC: return EOp::SEC;
+        case Ins::CLV: return EOp::CLV;
+        case Ins::CLI: return EOp::CLI;
+        case Ins::SEI: return EOp::SEI;
+        case Ins::CLD: return EOp::CLD;
+        case Ins::NOP: return EOp::NOP;
+        case Ins::PHA: return EOp::PHA;
+        case Ins::PLA: return EOp::PLA;
+        case Ins::PHP: return EOp::PHP;
+        case Ins::JMP_ABS: return EOp::JMP;
+        case Ins::JMP_IND: return EOp::JMPI;
+        case Ins::JSR: return EOp::JSR;
+        case Ins::RTS: return EOp::RTS;
+        case Ins::BEQ: return EOp::BEQ;
+        case Ins::BNE: return EOp::BNE;
+        case Ins::BSC: return EOp::BCS;
+        case Ins::BCC: return EOp::BCC;
+        case Ins::BMI: return EOp::BMI;
+        case Ins::BPL: return EOp::BPL;
+        case Ins::BVC: return EOp::BVC;
+        case Ins::BVS: return EOp::BVS;
+        default:
+            return EOp::None;
+    }
+}
+
+/**
+ * @brief Target of a branch
+ * 
+ * @param pInstruction 
+ * @return Word 
+ */
+Word branchTarget(const SBlockInstruction& pInstruction)
+{
+    const Word Next = pInstruction.address + pInstruction.size;
+    return static_cast<Word>(Next + static_cast<SByte>(pInstruction.operand & 0xFF));
+}
+
+/**
+ * @brief C++ literal of a byte
+ * 
+ * @param pValue 
+ * @return std::string 
+ */
+std::string hex2(Word pValue)
+{
+    std::ostringstream Out;
+    Out << "0x" << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << (pValue & 0xFF);
+    return Out.str();
+}
+
+/**
+ * @brief C++ literal of a word
+ * 
+ * @param pValue 
+ * @return std::string 
+ */
+std::string hex4(Word pValue)
+{
+    std::ostringstream Out;
+    Out << "0x" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << pValue;
+    return Out.str();
+}
+
+/**
+ * @brief C++ expression of the effective address of an instruction
+ * 
+ * @param pInstruction 
+ * @return std::string 
+ */
+std::string addressOf(const SBlockInstruction& pInstruction)
+{
+    const Word Operand = pInstruction.operand;
+    const bool PageCross = CCPU::OpTable[pInstruction.opcode].penalty == EPagePenalty::PageCross;
+    switch (pInstruction.mode)
+    {
+        case EAddrMode::ZeroPage:
+        case EAddrMode::Absolute:
+        case EAddrMode::Indirect:
+            return hex4(Operand);
+        case EAddrMode::ZeroPageX:
+            return "static_cast<Byte>(" + hex2(Operand) + " + S.X)";
+        case EAddrMode::ZeroPageY:
+            return "static_cast<Byte>(" + hex2(Operand) + " + S.Y)";
+        case EAddrMode::AbsoluteX:
+            return PageCross ? "aot::indexed(" + hex4(Operand) + ", S.X, Extra)" :
+                               "static_cast<Word>(" + hex4(Operand) + " + S.X)";
+        case EAddrMode::AbsoluteY:
+            return PageCross ? "aot::indexed(" + hex4(Operand) + ", S.Y, Extra)" :
+                               "static_cast<Word>(" + hex4(Operand) + " + S.Y)";
+        case EAddrMode::IndirectX:
+            // STA (zp,x) indexes the pointer read, as CCPU does
+            if (static_cast<Ins>(pInstruction.opcode) == Ins::STA_INDX)
+            {
+                return "static_cast<Word>(aot::readWord(pBus, " + hex4(Operand) + ") + S.X)";
+            }
+            return "aot::readWord(pBus, static_cast<Word>(" + hex2(Operand) + " + S.X))";
+        case EAddrMode::IndirectY:
+            return PageCross ? "aot::indexed(aot::readWord(pBus, " + hex4(Operand) + "), S.Y, Extra)" :
+                               "static_cast<Word>(aot::readWord(pBus, " + hex4(Operand) + ") + S.Y)";
+        default:
+            return "";
+    }
+}
+
+/**
+ * @brief C++ expression of the operand value of an instruction
+ * 
+ * @param pInstruction 
+ * @return std::string 
+ */
+std::string valueOf(const SBlockInstruction& pInstruction)
+{
+    if (pInstruction.mode == EAddrMode::Immediate)
+    {
+        return hex2(pInstruction.operand);
+    }
+    return "aot::read(pBus, " + addressOf(pInstruction) + ")";
+}
+
+/**
+ * @brief Write the statements leaving a block
+ * 
+ * @param pOut 
+ * @param pIndent 
+ * @param pPC C++ expression of the next PC
+ * @param pCycles cycles of the block up to the exit, penalties excluded
+ */
+void emitExit(std::ostream& pOut, const std::string& pIndent, const std::string& pPC, u32 pCycles)
+{
+    pOut << pIndent << "aot::store(S, pCPU);\n";
+    pOut << pIndent << "pCPU.PC = " << pPC << ";\n";
+    pOut << pIndent << "return " << pCycles << " + Extra;\n";
+}
+
+/**
+ * @brief Condition of a branch on the state
+ * 
+ * @param pOp 
+ * @return const char* 
+ */
+const char* conditionOf(EOp pOp)
+{
+    switch (pOp)
+    {
+        case EOp::BEQ: return "S.Z";
+        case EOp::BNE: return "!S.Z";
+        case EOp::BCS: return "S.C";
+        case EOp::BCC: return "!S.C";
+        case EOp::BMI: return "S.N";
+        case EOp::BPL: return "!S.N";
+        case EOp::BVS: return "S.V";
+        default: return "!S.V";
+    }
+}
+
+}
+
+/*****************************************************************************/
+
+CAotTranslator::CAotTranslator( const std::vector<Byte>& pPrg ) :
+    _mem(_bus, 0x0000, 0x0000), _cpu(_bus), _loadAddress(0), _size(0)
+{
+    if (pPrg.size() > 2)
+    {
+        _loadAddress = _cpu.loadPrg(pPrg.data(), static_cast<u32>(pPrg.size()));
+        // Bytes past $FFFF are never loaded
+        _size = std::min<u32>(static_cast<u32>(pPrg.size() - 2), 0x10000 - _loadAddress);
+        _data.assign(pPrg.begin() + 2, pPrg.begin() + 2 + _size);
+    }
+}
+
+/*****************************************************************************/
+
+void CAotTranslator::addEntry( const Word& pAddress )
+{
+    _pending.push_back(pAddress);
+}
+
+/*****************************************************************************/
+
+bool CAotTranslator::_inProgram( const Word& pAddress, const Byte& pSize ) const
+{
+    return pAddress >= _loadAddress && u32(pAddress) + pSize <= u32(_loadAddress) + _size;
+}
+
+/*****************************************************************************/
+
+void CAotTranslator::recover()
+{
+    _pending.push_back(_loadAddress);
+    // Vectors are entries only when the program defines them
+    for (Word Vector : { Word(0xFFFC), Word(0xFFFE) })
+    {
+        if (_inProgram(Vector, 2))
+        {
+            _pending.push_back(_bus.readBusData(Vector) | (_bus.readBusData(Vector + 1) << 8));
+        }
+    }
+    while (!_pending.empty())
+    {
+        const Word Entry = _pending.back();
+        _pending.pop_back();
+        if (!_inProgram(Entry, 1) || !_visited.insert(Entry).second) continue;
+
+        const SBlock Decoded = CBlockCache::decode(_bus, Entry);
+        SAotSourceBlock Block;
+        Block.start = Entry;
+        Block.end = Decoded.end;
+        bool Translated = !Decoded.instructions.empty();
+        for (const SBlockInstruction& Instruction : Decoded.instructions)
+        {
+            const EOp Op = operationOf(static_cast<Ins>(Instruction.opcode));
+            if (!_inProgram(Instruction.address, Instruction.size) || Op == EOp::None)
+            {
+                // Interpreted, code after a PLP or SED may still be translated
+                Block.end = Instruction.address;
+                const Ins Instr = static_cast<Ins>(Instruction.opcode);
+                if (Instr == Ins::PLP || Instr == Ins::SED)
+                {
+                    _pending.push_back(Instruction.address + Instruction.size);
+                }
+                Translated = false;
+                break;
+            }
+            Block.instructions.push_back(Instruction);
+        }
+        if (Translated)
+        {
+            const SBlockInstruction& Last = Decoded.instructions.back();
+            const Word Next = Last.address + Last.size;
+            switch (operationOf(static_cast<Ins>(Last.opcode)))
+            {
+                case EOp::JMP:
+                    _pending.push_back(Last.operand);
+                    break;
+                case EOp::JSR:
+                    _pending.push_back(Last.operand);
+                    _pending.push_back(Next);
+                    break;
+                case EOp::BEQ: case EOp::BNE: case EOp::BCS: case EOp::BCC:
+                case EOp::BMI: case EOp::BPL: case EOp::BVC: case EOp::BVS:
+                    _pending.push_back(branchTarget(Last));
+                    _pending.push_back(Next);
+                    break;
+                case EOp::JMPI:
+                case EOp::RTS:
+                    break;
+                default:
+                    // Block cut at max length
+                    _pending.push_back(Next);
+                    break;
+            }
+        }
+        if (!Block.instructions.empty())
+        {
+            _blocks[Entry] = Block;
+        }
+    }
+}
+
+/*****************************************************************************/
+
+u32 CAotTranslator::_emitBlock( std::ostream& pOut, const SAotSourceBlock& pBlock ) const
+{
+    std::ostringstream Body;
+    u32 Cycles = 0;
+    u32 MaxCycles = 0;
+    bool Exited = false;
+    for (const SBlockInstruction& Instruction : pBlock.instructions)
+    {
+        const CCPU::SOpCode& OpCode = CCPU::OpTable[Instruction.opcode];
+        const EOp Op = operationOf(static_cast<Ins>(Instruction.opcode));
+        const Word Next = Instruction.address + Instruction.size;
+        Cycles += Instruction.cycles;
+        MaxCycles += Instruction.cycles + (OpCode.penalty == EPagePenalty::PageCross ? 1 : 0);
+
+        Body << "    // " << hex4(Instruction.address) << ":";
+        for (Byte Index = 0; Index < Instruction.size; Index++)
+        {
+            Body << " " << hex2(Index ? Instruction.operand >> (8 * (Index - 1)) : Instruction.opcode).substr(2);
+        }
+        Body << "\n";
+
+        const bool Accumulator = Instruction.mode == EAddrMode::Accumulator;
+        switch (Op)
+        {
+            case EOp::LDA: case EOp::LDX: case EOp::LDY:
+            {
+                const char* Register = Op == EOp::LDA ? "S.A" : (Op == EOp::LDX ? "S.X" : "S.Y");
+                Body << "    " << Register << " = " << valueOf(Instruction) << ";\n";
+                Body << "    aot::setZN(S, " << Register << ");\n";
+                break;
+            }
+            case EOp::STA: case EOp::STX: case EOp::STY:
+            {
+                const char* Register = Op == EOp::STA ? "S.A" : (Op == EOp::STX ? "S.X" : "S.Y");
+                Body << "    aot::write(pBus, " << addressOf(Instruction) << ", " << Register << ");\n";
+                break;
+            }
+            case EOp::AND: case EOp::ORA: case EOp::EOR:
+            {
+                const char* Operator = Op == EOp::AND ? "&=" : (Op == EOp::ORA ? "|=" : "^=");
+                Body << "    S.A " << Operator << " " << valueOf(Instruction) << ";\n";
+                Body << "    aot::setZN(S, S.A);\n";
+                break;
+            }
+            case EOp::BIT:
+                Body << "    aot::bit(S, " << valueOf(Instruction) << ");\n";
+                break;
+            case EOp::ADC:
+                Body << "    aot::adc(S, " << valueOf(Instruction) << ");\n";
+                break;
+            case EOp::SBC:
+                Body << "    aot::sbc(S, " << valueOf(Instruction) << ");\n";
+                break;
+            case EOp::CMP: case EOp::CPX: case EOp::CPY:
+            {
+                const char* Register = Op == EOp::CMP ? "S.A" : (Op == EOp::CPX ? "S.X" : "S.Y");
+                Body << "    aot::compare(S, " << Register << ", " << valueOf(Instruction) << ");\n";
+                break;
+            }
+            case EOp::INC: case EOp::DEC:
+                Body << "    {\n";
+                Body << "        const Word Address = " << addressOf(Instruction) << ";\n";
+                Body << "        const Byte Value = static_cast<Byte>(aot::read(pBus, Address) " << (Op == EOp::INC ? "+" : "-") << " 1);\n";
+                Body << "        aot::write(pBus, Address, Value);\n";
+                Body << "        aot::setZN(S, Value);\n";
+                Body << "    }\n";
+                break;
+            case EOp::ASL: case EOp::LSR: case EOp::ROL: case EOp::ROR:
+            {
+                const char* Helper = Op == EOp::ASL ? "aot::asl" : Op == EOp::LSR ? "aot::lsr" :
+                                     Op == EOp::ROL ? "aot::rol" : "aot::ror";
+                if (Accumulator)
+                {
+                    Body << "    S.A = " << Helper << "(S, S.A);\n";
+                }
+                else
+                {
+                    Body << "    {\n";
+                    Body << "        const Word Address = " << addressOf(Instruction) << ";\n";
+                    Body << "        aot::write(pBus, Address, " << Helper << "(S, aot::read(pBus, Address)));\n";
+                    Body << "    }\n";
+                }
+                break;
+            }
+            case EOp::TAX: Body << "    S.X = S.A;\n    aot::setZN(S, S.X);\n"; break;
+            case EOp::TAY: Body << "    S.Y = S.A;\n    aot::setZN(S, S.Y);\n"; break;
+            case EOp::TXA: Body << "    S.A = S.X;\n    aot::setZN(S, S.A);\n"; break;
+            case EOp::TYA: Body << "    S.A = S.Y;\n    aot::setZN(S, S.A);\n"; break;
+            case EOp::TSX: Body << "    S.X = S.SP;\n    aot::setZN(S, S.X);\n"; break;
+            case EOp::TXS: Body << "    S.SP = S.X;\n"; break;
+            case EOp::INX: Body << "    S.X++;\n    aot::setZN(S, S.X);\n"; break;
+            case EOp::INY: Body << "    S.Y++;\n    aot::setZN(S, S.Y);\n"; break;
+            case EOp::DEX: Body << "    S.X--;\n    aot::setZN(S, S.X);\n"; break;
+            case EOp::DEY: Body << "    S.Y--;\n    aot::setZN(S, S.Y);\n"; break;
+            case EOp::CLC: Body << "    S.C = false;\n"; break;
+            case EOp::SEC: Body << "    S.C = true;\n"; break;
+            case EOp::CLV: Body << "    S.V = false;\n"; break;
+            case EOp::CLI: Body << "    pCPU.Flags.I = false;\n"; break;
+            case EOp::SEI: Body << "    pCPU.Flags.I = true;\n"; break;
+            case EOp::CLD: Body << "    pCPU.Flags.D = false;\n"; break;
+            case EOp::NOP: break;
+            case EOp::PHA: Body << "    aot::push(pBus, S, S.A);\n"; break;
+            case EOp::PLA: Body << "    S.A = aot::pull(pBus, S);\n    aot::setZN(S, S.A);\n"; break;
+            case EOp::PHP: Body << "    aot::pushStatus(pBus, S, pCPU);\n"; break;
+            case EOp::JMP:
+                emitExit(Body, "    ", hex4(Instruction.operand), Cycles);
+                Exited = true;
+                break;
+            case EOp::JMPI:
+                emitExit(Body, "    ", "aot::readWord(pBus, " + hex4(Instruction.operand) + ")", Cycles);
+                Exited = true;
+                break;
+            case EOp::JSR:
+                Body << "    aot::pushWord(pBus, S, " << hex4(Next - 1) << ");\n";
+                emitExit(Body, "    ", hex4(Instruction.operand), Cycles);
+                Exited = true;
+                break;
+            case EOp::RTS:
+                Body << "    const Word Return = static_cast<Word>(aot::pullWord(pBus, S) + 1);\n";
+                emitExit(Body, "    ", "Return", Cycles);
+                Exited = true;
+                break;
+            default:
+            {
+                // Branches, taken costs one cycle, one more to another page
+                const Word Target = branchTarget(Instruction);
+                const u32 Taken = Cycles + ((Target >> 8) != (Next >> 8) ? 2 : 1);
+                MaxCycles += Taken - Cycles;
+                Body << "    if (" << conditionOf(Op) << ")\n";
+                Body << "    {\n";
+                emitExit(Body, "        ", hex4(Target), Taken);
+                Body << "    }\n";
+                emitExit(Body, "    ", hex4(Next), Cycles);
+                Exited = true;
+                break;
+            }
+        }
+    }
+    if (!Exited)
+    {
+        emitExit(Body, "    ", hex4(pBlock.end), Cycles);
+    }
+
+    const std::string Code = Body.str();
+    pOut << "/* " << hex4(pBlock.start) << ", " << pBlock.instructions.size() << " instructions, "
+         << MaxCycles << " cycles at most */\n";
+    pOut << "u32 block_" << hex4(pBlock.start).substr(2) << "( CCPU& pCPU, CBus&"
+         << (Code.find("pBus") != std::string::npos ? " pBus" : "") << " )\n";
+    pOut << "{\n";
+    pOut << "    aot::SState S;\n";
+    pOut << "    aot::load(S, pCPU);\n";
+    pOut << "    u32 Extra = 0;\n";
+    pOut << Code;
+    pOut << "}\n\n";
+    return MaxCycles;
+}
+
+/*****************************************************************************/
+
+std::string CAotTranslator::emit( const std::string& pSymbol, const std::string& pSource ) const
+{
+    std::ostringstream Out;
+    Out << "/*\n";
+    Out << " * Translated by M6502Aot from " << pSource << ", do not edit\n";
+    Out << " * " << _blocks.size() << " blocks, program at " << hex4(_loadAddress)
+        << ", " << _size << " bytes\n";
+    Out << " */\n\n";
+    Out << "#include <m6502/System/Aot.hpp>\n\n";
+    Out << "using namespace m6502;\n\n";
+    Out << "namespace\n{\n\n";
+
+    std::vector<u32> MaxCycles;
+    for (const auto& Block : _blocks)
+    {
+        MaxCycles.push_back(_emitBlock(Out, Block.second));
+    }
+
+    Out << "const Byte Program[] = {";
+    for (u32 Index = 0; Index < _size; Index++)
+    {
+        Out << (Index % 12 ? " " : "\n    ") << hex2(_data[Index]) << (Index + 1 < _size ? "," : "");
+    }
+    Out << " };\n\n";
+
+    if (_blocks.empty())
+    {
+        Out << "const SAotBlock* const Blocks = nullptr;\n\n";
+    }
+    else
+    {
+        Out << "const SAotBlock Blocks[] = {\n";
+        size_t Index = 0;
+        for (const auto& Block : _blocks)
+        {
+            const std::string Name = hex4(Block.first);
+            Out << "    { " << Name << ", " << MaxCycles[Index++] << ", &block_" << Name.substr(2) << " },\n";
+        }
+        Out << "};\n\n";
+    }
+    Out << "}\n\n";
+
+    Out << "extern const SAotImage " << pSymbol << ";\n";
+    Out << "const SAotImage " << pSymbol << " = { " << hex4(_loadAddress) << ", " << _size
+        << ", Program, Blocks, " << _blocks.size() << " };\n";
+    return Out.str();
+}
+
+}
@@ -0,0 +1,211 @@
+/**
+ * @file Translator.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Aot - Ahead of time translator of 6502 programs
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef TRANSLATOR_HPP
+#define TRANSLATOR_HPP
+
+#include <m6502/System.hpp>
+#include <m6502/System/BlockCache.hpp>
+#include <string>
+#include <ostream>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace m6502
+{
+
+/**
+ * @brief Basic block recovered from the program
+ * 
+ */
+struct SAotSourceBlock
+{
+    /**
+     * @brief Address of the first opcode
+     * 
+     */
+    Word start;
+
+    /**
+     * @brief PC once the last instruction ran, when it does not
+     *        change the flow itself (block cut, untranslated next)
+     * 
+     */
+    Word end;
+
+    /**
+     * @brief Translated instructions in execution order
+     * 
+     */
+    std::vector<SBlockInstruction> instructions;
+};
+
+/**
+ * @brief Recover the control flow of a program loaded by CCPU::loadPrg
+ *        and write it as a C++ translation unit, one function per block
+ * 
+ *        Blocks are found from entry points (load address, reset and
+ *        IRQ vectors, extra entries) following branches, JMP and JSR.
+ *        RTS and JMP (ind) leave the block with a PC computed at run
+ *        time, a PC without a block is left to the interpreter
+ */
+class CAotTranslator
+{
+public:
+    /**
+     * @brief Construct a new translator for a program
+     * 
+     * @param pPrg program as given to CCPU::loadPrg, load address first
+     */
+    explicit CAotTranslator(const std::vector<Byte>& pPrg);
+
+    /**
+     * @brief Construct a new translator object
+     * 
+     * @param pCopy 
+     */
+    CAotTranslator(const CAotTranslator& pCopy) = delete;
+
+    /**
+     * @brief Check the program holds at least one byte of code
+     * 
+     * @return true 
+     */
+    bool isValid() const { return _size > 0; }
+
+    /**
+     * @brief Get the address the program is loaded at
+     * 
+     * @return Word 
+     */
+    Word getLoadAddress() const { return _loadAddress; }
+
+    /**
+     * @brief Add an entry point, an address reached by an indirect
+     *        jump the static recovery cannot follow
+     * 
+     * @param pAddress 
+     */
+    void addEntry(const Word& pAddress);
+
+    /**
+     * @brief Recover the blocks reachable from the entry points
+     * 
+     */
+    void recover();
+
+    /**
+     * @brief Get the recovered blocks
+     * 
+     * @return const std::map<Word, SAotSourceBlock>& blocks by address
+     */
+    const std::map<Word, SAotSourceBlock>& getBlocks() const { return _blocks; }
+
+    /**
+     * @brief Write the translation unit defining the SAotImage
+     * 
+     * @param pSymbol name of the SAotImage, in the global namespace
+     * @param pSource name of the program, written in the header comment
+     * @return std::string C++ source
+     */
+    std::string emit(const std::string& pSymbol, const std::string& pSource) const;
+
+private:
+    /**
+     * @brief Bus the program is loaded on
+     * 
+     */
+    CBus _bus;
+
+    /**
+     * @brief 64KB of RAM holding the program
+     * 
+     */
+    CMem _mem;
+
+    /**
+     * @brief CPU used to load the program
+     * 
+     */
+    CCPU _cpu;
+
+    /**
+     * @brief Bytes of the program, load address excluded
+     * 
+     */
+    std::vector<Byte> _data;
+
+    /**
+     * @brief Address the program is loaded at
+     * 
+     */
+    Word _loadAddress;
+
+    /**
+     * @brief Number of bytes of the program
+     * 
+     */
+    u32 _size;
+
+    /**
+     * @brief Entry points left to decode
+     * 
+     */
+    std::vector<Word> _pending;
+
+    /**
+     * @brief Addresses already decoded, with or without a block
+     * 
+     */
+    std::set<Word> _visited;
+
+    /**
+     * @brief Recovered blocks by address
+     * 
+     */
+    std::map<Word, SAotSourceBlock> _blocks;
+
+    /**
+     * @brief Check bytes are part of the program
+     * 
+     * @param pAddress 
+     * @param pSize 
+     * @return true 
+     */
+    bool _inProgram(const Word& pAddress, const Byte& pSize) const;
+
+    /**
+     * @brief Write the function of a block
+     * 
+     * @param pOut 
+     * @param pBlock 
+     * @return u32 max cycles of the block
+     */
+    u32 _emitBlock(std::ostream& pOut, const SAotSourceBlock& pBlock) const;
+};
+
+}
+
+#endif
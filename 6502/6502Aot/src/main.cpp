@@ -0,0 +1,103 @@
+/**
+ * @file main.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Aot - Ahead of time translator of 6502 programs
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "Translator.hpp"
+
+/**
+ * @brief Print the command line help
+ * 
+ */
+static void usage()
+{
+    std::cerr << "Usage: M6502Aot <program.prg> <output.cpp> [--symbol NAME] [--entry ADDRESS]...\n"
+              << "  program.prg     program as loaded by CCPU::loadPrg, load address first\n"
+              << "  output.cpp      C++ translation unit to write\n"
+              << "  --symbol NAME   name of the m6502::SAotImage defined (default AotProgram)\n"
+              << "  --entry ADDRESS extra entry point in hexadecimal, as targets of JMP (ind)\n";
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace m6502;
+    std::vector<std::string> Args(argv + 1, argv + argc);
+    std::string Symbol = "AotProgram";
+    std::vector<Word> Entries;
+    std::vector<std::string> Files;
+    for (size_t Index = 0; Index < Args.size(); Index++)
+    {
+        const bool HasValue = Index + 1 < Args.size();
+        if (Args[Index] == "--symbol" && HasValue)
+        {
+            Symbol = Args[++Index];
+        }
+        else if (Args[Index] == "--entry" && HasValue)
+        {
+            Entries.push_back(static_cast<Word>(std::stoul(Args[++Index], nullptr, 16)));
+        }
+        else
+        {
+            Files.push_back(Args[Index]);
+        }
+    }
+    if (Files.size() != 2)
+    {
+        usage();
+        return 1;
+    }
+
+    std::ifstream Input(Files[0], std::ios::binary);
+    if (!Input)
+    {
+        std::cerr << "Can't read " << Files[0] << "\n";
+        return 1;
+    }
+    const std::vector<Byte> Prg((std::istreambuf_iterator<char>(Input)), std::istreambuf_iterator<char>());
+
+    CAotTranslator Translator(Prg);
+    if (!Translator.isValid())
+    {
+        std::cerr << Files[0] << " holds no program\n";
+        return 1;
+    }
+    for (Word Entry : Entries)
+    {
+        Translator.addEntry(Entry);
+    }
+    Translator.recover();
+
+    std::ofstream Output(Files[1], std::ios::binary);
+    Output << Translator.emit(Symbol, Files[0]);
+    if (!Output)
+    {
+        std::cerr << "Can't write " << Files[1] << "\n";
+        return 1;
+    }
+    std::cout << Files[0] << ": " << Translator.getBlocks().size() << " blocks translated to " << Files[1] << "\n";
+    return 0;
+}
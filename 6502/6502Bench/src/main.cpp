@@ -0,0 +1,350 @@
+/**
+ * @file main.cpp
+ * @author Gianni Peschiutta
+ * @brief 6502Bench - Motorola 6502 CPU Emulator benchmark
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <m6502/System.hpp>
+#ifdef M6502_BENCH_JIT
+#include <m6502/Jit/Jit.hpp>
+#endif
+
+typedef std::chrono::steady_clock bench_clock;
+
+/* Benchmark program, a mix of table fill, indirect copy,
+ * shifts, calls and short loops
+
+    * = $0200
+
+    lda #$00
+    sta $20
+    sta $22
+    lda #$04
+    sta $21
+    lda #$06
+    sta $23
+start
+    ldx #$00
+fill
+    txa
+    clc
+    adc #$03
+    sta $0400,x
+    eor $10
+    and #$7F
+    ora $11
+    sta $0500,x
+    inx
+    bne fill
+    ldy #$3F
+copy
+    lda ($20),y
+    asl a
+    rol $30
+    cmp #$40
+    bcc skip
+    sbc #$40
+skip
+    sta ($22),y
+    dey
+    bpl copy
+    ldx #$10
+calls
+    jsr sub
+    dex
+    bne calls
+    inc $12
+    jmp start
+sub
+    pha
+    txa
+    pha
+    lsr $31
+    lda $0500,x
+    ldy #$04
+inner
+    dey
+    bne inner
+    pla
+    tax
+    pla
+    rts
+*/
+static const m6502::Byte BenchPrg[] = {
+    0x00, 0x02,
+    0xA9, 0x00, 0x85, 0x20, 0x85, 0x22, 0xA9, 0x04, 0x85, 0x21, 0xA9, 0x06,
+    0x85, 0x23, 0xA2, 0x00, 0x8A, 0x18, 0x69, 0x03, 0x9D, 0x00, 0x04, 0x45,
+    0x10, 0x29, 0x7F, 0x05, 0x11, 0x9D, 0x00, 0x05, 0xE8, 0xD0, 0xED, 0xA0,
+    0x3F, 0xB1, 0x20, 0x0A, 0x26, 0x30, 0xC9, 0x40, 0x90, 0x02, 0xE9, 0x40,
+    0x91, 0x22, 0x88, 0x10, 0xF0, 0xA2, 0x10, 0x20, 0x42, 0x02, 0xCA, 0xD0,
+    0xFA, 0xE6, 0x12, 0x4C, 0x0E, 0x02, 0x48, 0x8A, 0x48, 0x46, 0x31, 0xBD,
+    0x00, 0x05, 0xA0, 0x04, 0x88, 0xD0, 0xFD, 0x68, 0xAA, 0x68, 0x60 };
+
+/**
+ * @brief Cycles given to each execute call, as the emulator
+ *        loop does for one period
+ * 
+ */
+static constexpr m6502::s64 SLICE_CYCLES = 100000;
+
+/**
+ * @brief Result of one engine run
+ * 
+ */
+struct SBenchResult
+{
+    std::string name;
+    m6502::s64 cycles;
+    double seconds;
+};
+
+/**
+ * @brief Run the benchmark program for the given cycles
+ * 
+ * @param pEngine 
+ * @param pCycles 
+ * @return SBenchResult 
+ */
+static SBenchResult runEngine(m6502::EEngine pEngine, const std::string& pName, m6502::s64 pCycles)
+{
+    using namespace m6502;
+    CBus Bus;
+    CMem Mem(Bus, 0x0000, 0x0000);
+    CCPU CPU(Bus);
+    CPU.setEngine(pEngine);
+    CPU.loadPrg(BenchPrg, sizeof(BenchPrg));
+    // Warm up caches and branch predictors
+    CPU.execute(SLICE_CYCLES);
+    CPU.loadPrg(BenchPrg, sizeof(BenchPrg));
+
+    s64 Cycles = 0;
+    bench_clock::time_point Start = bench_clock::now();
+    while (Cycles < pCycles)
+    {
+        Cycles += CPU.execute(SLICE_CYCLES);
+    }
+    bench_clock::time_point End = bench_clock::now();
+    return { pName, Cycles, std::chrono::duration<double>(End - Start).count() };
+}
+
+/**
+ * @brief Run the benchmark program for the given cycles with
+ *        a CPU on a static bus of 64KB of RAM
+ * 
+ * @param pCycles 
+ * @return SBenchResult 
+ */
+static SBenchResult runStatic(m6502::s64 pCycles)
+{
+    using namespace m6502;
+    typedef CStaticBus<SStaticChip<CStaticMem<>, 0x0000, 0x0000>> CRamBus;
+    CRamBus Bus;
+    CStaticCPU<CRamBus> CPU(Bus);
+    CPU.loadPrg(BenchPrg, sizeof(BenchPrg));
+    // Warm up caches and branch predictors
+    CPU.execute(SLICE_CYCLES);
+    CPU.loadPrg(BenchPrg, sizeof(BenchPrg));
+
+    s64 Cycles = 0;
+    bench_clock::time_point Start = bench_clock::now();
+    while (Cycles < pCycles)
+    {
+        Cycles += CPU.execute(SLICE_CYCLES);
+    }
+    bench_clock::time_point End = bench_clock::now();
+    return { "Static", Cycles, std::chrono::duration<double>(End - Start).count() };
+}
+
+/**
+ * @brief Run the benchmark program as a batch of independent systems
+ *        over every hardware thread, sharing the given cycles
+ * 
+ * @param pCycles 
+ * @return SBenchResult 
+ */
+static SBenchResult runBatch(m6502::s64 pCycles)
+{
+    using namespace m6502;
+    CBatchRunner Runner;
+    const u32 Count = Runner.getThreads() * 8;
+    SBatchSystem System;
+    System.program.assign(BenchPrg, BenchPrg + sizeof(BenchPrg));
+    System.resetVector = 0x0200;
+    System.cycles = pCycles / Count;
+    System.stop = EBatchStop::Budget;
+    System.stopAddress = 0;
+    System.resultAddress = 0;
+    System.resultSize = 0;
+    const std::vector<SBatchSystem> Systems(Count, System);
+
+    bench_clock::time_point Start = bench_clock::now();
+    const std::vector<SBatchResult> Results = Runner.run(Systems);
+    bench_clock::time_point End = bench_clock::now();
+    s64 Cycles = 0;
+    for (const SBatchResult& Result : Results)
+    {
+        Cycles += Result.cycles;
+    }
+    return { "Batch x" + std::to_string(Runner.getThreads()), Cycles,
+             std::chrono::duration<double>(End - Start).count() };
+}
+
+/**
+ * @brief Run the benchmark program in every lane of a lockstep CPU,
+ *        lanes sharing the given cycles
+ * 
+ * @param pCycles 
+ * @return SBenchResult 
+ */
+static SBenchResult runLockstep(m6502::s64 pCycles)
+{
+    using namespace m6502;
+    constexpr u32 Lanes = 16;
+    // Heap, lanes memory is 1MB
+    std::unique_ptr<CLockstepCPU<Lanes>> CPU = std::make_unique<CLockstepCPU<Lanes>>();
+    CPU->loadPrg(BenchPrg, sizeof(BenchPrg));
+    // Warm up caches and branch predictors
+    CPU->execute(SLICE_CYCLES / Lanes);
+    CPU->loadPrg(BenchPrg, sizeof(BenchPrg));
+
+    s64 Cycles = 0;
+    bench_clock::time_point Start = bench_clock::now();
+    while (Cycles < pCycles)
+    {
+        CPU->execute(SLICE_CYCLES / Lanes);
+        for (u32 Lane = 0; Lane < Lanes; Lane++)
+        {
+            Cycles += CPU->getCycles(Lane);
+        }
+    }
+    bench_clock::time_point End = bench_clock::now();
+    return { "Lockstep x" + std::to_string(Lanes), Cycles, std::chrono::duration<double>(End - Start).count() };
+}
+
+#ifdef M6502_BENCH_JIT
+/**
+ * @brief Run the benchmark program for the given cycles with the JIT
+ * 
+ * @param pCycles 
+ * @return SBenchResult 
+ */
+static SBenchResult runJit(m6502::s64 pCycles)
+{
+    using namespace m6502;
+    CBus Bus;
+    CMem Mem(Bus, 0x0000, 0x0000);
+    CCPU CPU(Bus);
+    CJit Jit(CPU, Bus);
+    CPU.loadPrg(BenchPrg, sizeof(BenchPrg));
+    // Warm up, hot blocks get compiled
+    Jit.execute(SLICE_CYCLES);
+    CPU.loadPrg(BenchPrg, sizeof(BenchPrg));
+
+    s64 Cycles = 0;
+    bench_clock::time_point Start = bench_clock::now();
+    while (Cycles < pCycles)
+    {
+        Cycles += Jit.execute(SLICE_CYCLES);
+    }
+    bench_clock::time_point End = bench_clock::now();
+    return { "Jit", Cycles, std::chrono::duration<double>(End - Start).count() };
+}
+#endif
+
+/**
+ * @brief Count the instructions retired by the benchmark
+ *        program within the given cycles
+ * 
+ * @param pCycles 
+ * @return m6502::u64 
+ */
+static m6502::u64 countInstructions(m6502::s64 pCycles)
+{
+    using namespace m6502;
+    CBus Bus;
+    CMem Mem(Bus, 0x0000, 0x0000);
+    CCPU CPU(Bus);
+    CPU.loadPrg(BenchPrg, sizeof(BenchPrg));
+    u64 Instructions = 0;
+    s64 Cycles = 0;
+    while (Cycles < pCycles)
+    {
+        Cycles += CPU.step();
+        Instructions++;
+    }
+    return Instructions;
+}
+
+/**
+ * @brief Benchmark every dispatch engine on the same program
+ * 
+ * @return int 
+ */
+int main(int argc, char* argv[])
+{
+    using namespace m6502;
+    s64 Cycles = 200000000;
+    if (argc > 1)
+    {
+        Cycles = std::stoll(argv[1]);
+    }
+
+    std::vector<SBenchResult> Results;
+    Results.push_back(runEngine(EEngine::Switch, "Switch", Cycles));
+    Results.push_back(runEngine(EEngine::Table, "Table", Cycles));
+#if M6502_HAS_THREADED
+    Results.push_back(runEngine(EEngine::Threaded, "Threaded", Cycles));
+#endif
+    Results.push_back(runEngine(EEngine::Block, "Block", Cycles));
+    Results.push_back(runStatic(Cycles));
+    Results.push_back(runBatch(Cycles));
+    Results.push_back(runLockstep(Cycles));
+#ifdef M6502_BENCH_JIT
+    Results.push_back(runJit(Cycles));
+#endif
+
+    const u64 Instructions = countInstructions(Results.front().cycles);
+    const double Reference = Instructions / Results.front().seconds;
+
+    std::cout << "M6502Bench : " << Results.front().cycles << " cycles, "
+              << Instructions << " instructions per engine" << std::endl;
+    std::cout << std::left << std::setw(14) << "Engine"
+              << std::right << std::setw(12) << "Time (ms)"
+              << std::setw(12) << "MHz"
+              << std::setw(14) << "Minstr/sec"
+              << std::setw(10) << "Gain" << std::endl;
+    for (const SBenchResult& Result : Results)
+    {
+        const double InstrPerSec = Instructions / Result.seconds;
+        std::cout << std::left << std::setw(14) << Result.name << std::right << std::fixed
+                  << std::setw(12) << std::setprecision(1) << Result.seconds * 1000.0
+                  << std::setw(12) << std::setprecision(1) << Result.cycles / Result.seconds / 1e6
+                  << std::setw(14) << std::setprecision(1) << InstrPerSec / 1e6
+                  << std::setw(9) << std::setprecision(2) << InstrPerSec / Reference << "x"
+                  << std::endl;
+    }
+    return 0;
+}
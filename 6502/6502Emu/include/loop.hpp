@@ -29,9 +29,15 @@
 #include <atomic>
 #include <vector>
 #include <mutex>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
 
 typedef std::chrono::high_resolution_clock hrc;
+typedef std::chrono::steady_clock steady;
 typedef std::chrono::microseconds period;
+typedef std::chrono::nanoseconds lateness;
 
 class CLoop;
 
@@ -44,7 +50,8 @@ class CProcessEvent
 friend class CLoop;
 public:
     /**
-     * @brief Construct a new CProcessEvent object
+     * @brief Construct a new CProcessEvent object, called by the
+     *        loop once startProcess is called
      * 
      * @param pParent 
      */
@@ -54,9 +61,23 @@ public:
      * @brief Destroy the CProcessEvent object
      * 
      */
-    ~CProcessEvent();
+    virtual ~CProcessEvent();
 
 protected:
+    /**
+     * @brief Get called by the loop from its next period on.
+     *        To call once the derived object is built, the loop may
+     *        already be running
+     * 
+     */
+    void startProcess();
+
+    /**
+     * @brief Stop being called by the loop, waits for the call in
+     *        progress. To call first in the derived destructor
+     * 
+     */
+    void stopProcess();
 
     /**
      * @brief Process Event Callback
@@ -66,7 +87,7 @@ protected:
 virtual void onProcess(const period& pInterval)=0;
 
     /**
-     * @brief 
+     * @brief Time left on last period of the worker calling us
      * 
      */
     period getLastSleep();
@@ -77,6 +98,18 @@ virtual void onProcess(const period& pInterval)=0;
      * 
      */
     CLoop&  _parent;
+
+    /**
+     * @brief Worker calling us, changed with the loop _mutex held
+     * 
+     */
+    std::atomic<std::size_t> _shard;
+
+    /**
+     * @brief Moving average of onProcess time in nsec
+     * 
+     */
+    std::atomic<std::int64_t> _processTime;
 };
 
 /**
@@ -85,9 +118,40 @@ virtual void onProcess(const period& pInterval)=0;
  */
 typedef std::vector<CProcessEvent*> v_subscribers;
 
+/**
+ * @brief Wake up lateness of the loop against its deadlines
+ * 
+ */
+struct SJitterStats
+{
+    /**
+     * @brief Periods run since start or last reset
+     * 
+     */
+    std::uint64_t periods;
+
+    /**
+     * @brief Periods given up because processing was late
+     *        by more than a whole period
+     * 
+     */
+    std::uint64_t overruns;
+
+    /**
+     * @brief Lateness of the wake ups, p99 with a microsecond resolution
+     * 
+     */
+    lateness min;
+    lateness max;
+    lateness p99;
+};
+
 /**
  * @brief Loop Class Ensure Main loop management 
  * 
+ * Subscribers are spread over a pool of workers, each one running its
+ * own periods. Subscribers are moved from the busiest worker to the
+ * least busy one from time to time, after their measured onProcess time
  * 
  */
 class CLoop
@@ -110,8 +174,9 @@ public:
      * @brief Start the loop processing with given period
      * 
      * @param pPeriod : Period in msec
+     * @param pWorkers : Threads calling the subscribers
      */
-    void start(int pPeriod=10);
+    void start(int pPeriod=10, std::size_t pWorkers=1);
 
     /**
      * @brief Stop the loop processing
@@ -119,7 +184,86 @@ public:
      */
     void stop();
 
-    period getLastSleep ();
+    /**
+     * @brief Time left on last period of a worker
+     * 
+     * @param pWorker 
+     * @return period 
+     */
+    period getLastSleep (std::size_t pWorker=0);
+
+    /**
+     * @brief Busy wait the last part of each period instead of
+     *        sleeping, trading CPU time for a lower jitter
+     * 
+     * @param pSpin : Spin time in µsec, 0 to always sleep
+     */
+    void setSpin(period pSpin);
+
+    /**
+     * @brief Get the spin time
+     * 
+     * @return period 
+     */
+    period getSpin();
+
+    /**
+     * @brief Pin worker N to core N (modulo the cores) from next start
+     * 
+     * @param pPinned 
+     */
+    void setPinning(bool pPinned);
+
+    /**
+     * @brief Tell if workers are pinned to cores
+     * 
+     * @return true 
+     */
+    bool getPinning();
+
+    /**
+     * @brief Get the number of workers
+     * 
+     * @return std::size_t 
+     */
+    std::size_t getWorkers();
+
+    /**
+     * @brief Get the number of subscribers called by a worker
+     * 
+     * @param pWorker 
+     * @return std::size_t 
+     */
+    std::size_t getSubscribers(std::size_t pWorker);
+
+    /**
+     * @brief Get the measured onProcess time of a worker per period
+     * 
+     * @param pWorker 
+     * @return lateness 
+     */
+    lateness getLoad(std::size_t pWorker);
+
+    /**
+     * @brief Get the lateness of the wake ups of every worker
+     * 
+     * @return SJitterStats 
+     */
+    SJitterStats getJitterStats();
+
+    /**
+     * @brief Get the lateness of the wake ups and the overruns of a worker
+     * 
+     * @param pWorker 
+     * @return SJitterStats 
+     */
+    SJitterStats getJitterStats(std::size_t pWorker);
+
+    /**
+     * @brief Clear the lateness of the wake ups
+     * 
+     */
+    void resetJitterStats();
 
 protected:
     /**
@@ -130,7 +274,9 @@ protected:
     void subscribe (CProcessEvent* pSubscriber);
 
     /**
-     * @brief Unsuscribe to event loop
+     * @brief Unsuscribe to event loop, the subscriber is never called
+     *        again once returned. Only waits for a call of the
+     *        subscriber in progress on another worker
      * 
      * @param pSubscriber 
      */
@@ -138,34 +284,178 @@ protected:
 
 private:
     /**
-     * @brief Thread for loop
+     * @brief Shard of subscribers not called by any worker
      * 
      */
-    std::thread*    _thread;
+    static constexpr std::size_t NoShard = static_cast<std::size_t>(-1);
 
     /**
-     * @brief Start Loop Time
+     * @brief Shard of a subscriber moving to another worker
      * 
      */
-    hrc::time_point _start;
+    static constexpr std::size_t Moving = static_cast<std::size_t>(-2);
 
     /**
-     * @brief End Loop time
+     * @brief Size of the lateness histograms, by µsec, last bucket for more
      * 
      */
-    hrc::time_point _end;
+    static constexpr std::size_t JitterBuckets = 4096;
 
     /**
-     * @brief Loop Period Execution
+     * @brief Subscriber in the containers of a worker, marked when it
+     *        leaves so a walk still holding it skips it
      * 
      */
-    period          _period;
+    struct SEntry
+    {
+        CProcessEvent*      subscriber;
+        std::atomic<bool>   removed;
+    };
+
+    /**
+     * @brief Container of the entries of a worker
+     * 
+     */
+    typedef std::vector<SEntry*> v_entries;
+
+    /**
+     * @brief Replaced container, with the walks count and state of its
+     *        worker when replaced, freed once the worker is done with it
+     *        along with the entry the change removed, if any
+     * 
+     */
+    struct SRetired
+    {
+        v_entries*      entries;
+        SEntry*         removed;
+        std::uint64_t   walks;
+        bool            walking;
+    };
+
+    /**
+     * @brief Thread calling a shard of the subscribers
+     * 
+     */
+    struct SWorker
+    {
+        /**
+         * @brief Thread of the worker, null when stopped
+         * 
+         */
+        std::thread*    thread = nullptr;
+
+        /**
+         * @brief Id of the thread while running
+         * 
+         */
+        std::atomic<std::thread::id> id{std::thread::id()};
+
+        /**
+         * @brief Absolute time the next period starts, periods are
+         *        counted from it so wake up delays do not add up
+         * 
+         */
+        steady::time_point deadline;
+
+        /**
+         * @brief Time left on last period (Free Time) in µsec
+         * 
+         */
+        std::atomic<period::rep> lastSleep{0};
+
+        /**
+         * @brief Suscribers of the shard, replaced as a whole on
+         *        changes and read by the worker without lock
+         * 
+         */
+        std::atomic<v_entries*> subscribers{nullptr};
+
+        /**
+         * @brief Replaced containers not freed yet, guarded by _mutex
+         * 
+         */
+        std::vector<SRetired> retired;
+
+        /**
+         * @brief Worker is calling the subscribers
+         * 
+         */
+        std::atomic<bool> walking{false};
+
+        /**
+         * @brief Walks over the subscribers done by the worker
+         * 
+         */
+        std::atomic<std::uint64_t> walks{0};
+
+        /**
+         * @brief Entry being called, read by the threads removing it
+         * 
+         */
+        std::atomic<SEntry*> current{nullptr};
+
+        /**
+         * @brief Calls done by the worker
+         * 
+         */
+        std::atomic<std::uint64_t> calls{0};
+
+        /**
+         * @brief Lateness of the wake ups, histogram by µsec
+         * 
+         */
+        SJitterStats    jitter;
+        std::array<std::uint64_t, JitterBuckets> histogram;
+
+        /**
+         * @brief Guard jitter statistics read from other threads
+         * 
+         */
+        std::mutex      jitterMutex;
+    };
+
+    /**
+     * @brief Subscriber leaving a worker, added to the other one once
+     *        the first is done with it so it is never called twice
+     * 
+     */
+    struct SMove
+    {
+        CProcessEvent*  subscriber;
+        std::size_t     from;
+        std::size_t     to;
+        SRetired        released;
+    };
+
+    /**
+     * @brief Workers of the loop, changed only when stopped
+     * 
+     */
+    std::vector<std::unique_ptr<SWorker>> _workers;
 
     /**
-     * @brief Time sleeping on last loop (Free Time)
+     * @brief Subscribers moving between workers, guarded by _mutex
      * 
      */
-    period          _lastSleep;
+    std::vector<SMove> _moves;
+
+    /**
+     * @brief Time busy waited before the deadline
+     * 
+     */
+    std::atomic<period::rep> _spin;
+
+    /**
+     * @brief Pin workers to cores
+     * 
+     */
+    std::atomic<bool> _pinning;
+
+    /**
+     * @brief Loop Period Execution
+     * 
+     */
+    period          _period;
 
     /**
      * @brief State of current loop Execution
@@ -174,18 +464,116 @@ private:
     std::atomic<bool> _running;
 
     /**
-     * @brief Suscribers container for loop event
+     * @brief Serialise subscribers and workers changes, never
+     *        waited for by the workers
      * 
      */
-    v_subscribers   _subscribers;
+    std::mutex      _mutex;
 
     /**
-     * @brief 
+     * @brief Subscribers moving, tells workers to finish the moves
      * 
      */
-    std::mutex      _mutex;
+    std::atomic<std::size_t> _pendingMoves;
+
+    /**
+     * @brief Periods of a worker
+     * 
+     * @param pIndex : index of the worker
+     */
+    void            _mainLoop(std::size_t pIndex);
+
+    /**
+     * @brief Wait for an absolute time, sleeping then spinning
+     * 
+     * @param pDeadline 
+     */
+    void            _waitUntil(const steady::time_point& pDeadline);
+
+    /**
+     * @brief Account the lateness of a wake up
+     * 
+     * @param pWorker 
+     * @param pLateness 
+     * @param pOverrun : period given up
+     */
+    void            _recordLateness(SWorker& pWorker, lateness pLateness, bool pOverrun);
+
+    /**
+     * @brief Pin the calling worker to a core
+     * 
+     * @param pIndex : index of the worker
+     */
+    void            _pin(std::size_t pIndex);
 
-    void            _mainLoop();
+    /**
+     * @brief Replace the subscribers container of a worker, _mutex held
+     * 
+     * @param pWorker 
+     * @param pEntries 
+     * @return SRetired : the container replaced
+     */
+    SRetired        _publish(SWorker& pWorker, v_entries* pEntries);
+
+    /**
+     * @brief Add or remove a subscriber of a worker, the entry removed
+     *        is marked before the container is replaced, _mutex held
+     * 
+     * @param pShard 
+     * @param pSubscriber 
+     * @param pAdd 
+     * @return SRetired : the container replaced
+     */
+    SRetired        _change(std::size_t pShard, CProcessEvent* pSubscriber, bool pAdd);
+
+    /**
+     * @brief Tell if a worker no longer walks a container replaced
+     * 
+     * @param pWorker 
+     * @param pRetired 
+     * @return true 
+     */
+    bool            _released(const SWorker& pWorker, const SRetired& pRetired);
+
+    /**
+     * @brief Wait for the end of a call of a removed entry in progress
+     *        on another worker, but when the calling thread is itself
+     *        in a call being waited for
+     * 
+     * @param pWorker : worker of the entry
+     * @param pEntry 
+     */
+    void            _waitCall(const SWorker& pWorker, const SEntry* pEntry);
+
+    /**
+     * @brief Free the replaced containers the workers are done with
+     *        and finish the moves, _mutex held
+     * 
+     */
+    void            _reclaim();
+
+    /**
+     * @brief Measured onProcess time of a worker per period, _mutex held
+     * 
+     * @param pWorker 
+     * @return std::int64_t : nsec
+     */
+    std::int64_t    _load(const SWorker& pWorker);
+
+    /**
+     * @brief Start moving one subscriber from the busiest worker to
+     *        the least busy one when it evens them out, _mutex held
+     * 
+     */
+    void            _rebalance();
+
+    /**
+     * @brief Spread every subscriber over a new number of workers,
+     *        stopped, _mutex held
+     * 
+     * @param pWorkers 
+     */
+    void            _reshard(std::size_t pWorkers);
 };
 
 #endif
\ No newline at end of file
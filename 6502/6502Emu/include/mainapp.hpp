@@ -39,8 +39,9 @@ public:
      * @brief Construct a new CMainApp object
      * 
      * @param pParent 
+     * @param pStrict run idle loops instruction by instruction
      */
-    CMainApp (CLoop& pParent);
+    CMainApp (CLoop& pParent, bool pStrict = false);
 
     /**
      * @brief Destroy the CMainApp object
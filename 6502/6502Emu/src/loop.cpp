@@ -23,15 +23,61 @@
 
 #include "loop.hpp"
 #include <algorithm>
+#if defined(__linux__)
+#include <time.h>
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#elif defined(WIN32)
+#include <Windows.h>
+#endif
 
-CProcessEvent::CProcessEvent(CLoop& pParent) : _parent(pParent)
+/**
+ * @brief Lateness under which 99% of the wake ups are
+ * 
+ * @param pHistogram : wake ups by µsec of lateness
+ * @param pStats 
+ * @return lateness 
+ */
+template<std::size_t Buckets>
+static lateness percentile99(const std::array<std::uint64_t, Buckets>& pHistogram, const SJitterStats& pStats)
+{
+    const std::uint64_t Rank = (pStats.periods * 99 + 99) / 100;
+    std::uint64_t Count = 0;
+    for (std::size_t Bucket = 0; Bucket < Buckets && pStats.periods; Bucket++)
+    {
+        Count += pHistogram[Bucket];
+        if (Count >= Rank)
+        {
+            return std::min<lateness>(period(Bucket + 1), pStats.max);
+        }
+    }
+    return lateness(0);
+}
+
+/*****************************************************************************/
+
+CProcessEvent::CProcessEvent(CLoop& pParent) : _parent(pParent), _shard(CLoop::NoShard), _processTime(0)
 {
-    _parent.subscribe(this);
 }
 
 /*****************************************************************************/
 
 CProcessEvent::~CProcessEvent()
+{
+    stopProcess();
+}
+
+/*****************************************************************************/
+
+void CProcessEvent::startProcess()
+{
+    _parent.subscribe(this);
+}
+
+/*****************************************************************************/
+
+void CProcessEvent::stopProcess()
 {
     _parent.unSubscribe(this);
 }
@@ -40,7 +86,8 @@ CProcessEvent::~CProcessEvent()
 
 period CProcessEvent::getLastSleep()
 {
-    return _parent.getLastSleep();
+    const std::size_t Shard = _shard;
+    return _parent.getLastSleep(Shard < _parent._workers.size() ? Shard : 0);
 }
 
 /*****************************************************************************/
@@ -48,8 +95,12 @@ period CProcessEvent::getLastSleep()
 CLoop::CLoop ()
 {
     _running=false;
-    _thread = nullptr;
-    _lastSleep = std::chrono::milliseconds(0);
+    _spin = 0;
+    _pinning = false;
+    _pendingMoves = 0;
+    _period = std::chrono::milliseconds(10);
+    std::lock_guard<std::mutex> Lock(_mutex);
+    _reshard(1);
 }
 
 /*****************************************************************************/
@@ -57,17 +108,37 @@ CLoop::CLoop ()
 CLoop::~CLoop ()
 {
     if (_running) stop();
+    for (const std::unique_ptr<SWorker>& Worker : _workers)
+    {
+        for (const SRetired& Retired : Worker->retired)
+        {
+            delete Retired.entries;
+            delete Retired.removed;
+        }
+        for (const SEntry* Entry : *Worker->subscribers.load())
+        {
+            delete Entry;
+        }
+        delete Worker->subscribers.load();
+    }
 }
 
 /*****************************************************************************/
 
-void CLoop::start(int pPeriod)
+void CLoop::start(int pPeriod, std::size_t pWorkers)
 {
-    _period = std::chrono::microseconds(pPeriod*1000);
-    if ((!_running) && (_thread==nullptr))
+    if (!_running)
     {
+        std::lock_guard<std::mutex> Lock(_mutex);
+        _period = std::chrono::microseconds(pPeriod*1000);
+        _reshard(std::max<std::size_t>(pWorkers, 1));
         _running = true;
-        _thread= new std::thread(&CLoop::_mainLoop, this);
+        const steady::time_point Now = steady::now();
+        for (std::size_t Index = 0; Index < _workers.size(); Index++)
+        {
+            _workers[Index]->deadline = Now;
+            _workers[Index]->thread = new std::thread(&CLoop::_mainLoop, this, Index);
+        }
     }
 }
 
@@ -75,67 +146,560 @@ void CLoop::start(int pPeriod)
 
 void CLoop::stop()
 {
-    if (_running && _thread != nullptr)
+    if (_running)
     {
         _running = false;
-        _thread->join();
-        delete _thread;
-        _thread = nullptr;
+        for (const std::unique_ptr<SWorker>& Worker : _workers)
+        {
+            Worker->thread->join();
+            delete Worker->thread;
+            Worker->thread = nullptr;
+        }
+        std::lock_guard<std::mutex> Lock(_mutex);
+        _reclaim();
     }
 }
 
 /*****************************************************************************/
 
-void CLoop::_mainLoop()
+void CLoop::_mainLoop(std::size_t pIndex)
 {
+    SWorker& Worker = *_workers[pIndex];
+    Worker.id = std::this_thread::get_id();
+    if (_pinning)
+    {
+        _pin(pIndex);
+    }
+    const std::uint64_t RebalancePeriods = std::max<std::uint64_t>(1, std::chrono::seconds(1) / _period);
     // Main Loop
     while (_running)
     {
-        _start = std::chrono::high_resolution_clock::now();
         // Doing some things ...
-        _mutex.lock();
-        for (auto Subcriber : _subscribers)
+        // Subscribers changes are seen from the next walk on
+        Worker.walking = true;
+        const v_entries* Entries = Worker.subscribers.load();
+        for (SEntry* Entry : *Entries)
         {
-            if (Subcriber != nullptr)
+            // Set before the mark is read, a thread removing the entry
+            // either has it skipped or sees the call and waits for it
+            Worker.current = Entry;
+            if (Entry->removed) continue;
+            CProcessEvent* Subcriber = Entry->subscriber;
+            const steady::time_point Start = steady::now();
+            Subcriber->onProcess(_period);
+            // May be gone if it left during its onProcess
+            if (!Entry->removed)
             {
-                Subcriber->onProcess(_period);
+                const std::int64_t Spent = std::chrono::duration_cast<lateness>(steady::now()-Start).count();
+                Subcriber->_processTime.store((Subcriber->_processTime.load(std::memory_order_relaxed) * 7 + Spent) / 8,
+                    std::memory_order_relaxed);
             }
+            Worker.calls++;
+        }
+        Worker.current = nullptr;
+        Worker.walks++;
+        Worker.walking = false;
+        // Moves wait for the end of a walk, and first worker evens
+        // the shards out, unless subscribers are being changed
+        const bool Rebalance = pIndex == 0 && Worker.walks % RebalancePeriods == 0;
+        if ((_pendingMoves || Rebalance) && _mutex.try_lock())
+        {
+            _reclaim();
+            if (Rebalance) _rebalance();
+            _mutex.unlock();
+        }
+        const steady::time_point End = steady::now();
+        // Next period starts from the deadline, not from now, so
+        // being woken up late is made up on the following period
+        Worker.deadline += _period;
+        Worker.lastSleep = std::chrono::duration_cast<period>(Worker.deadline-End).count();
+        bool Overrun = false;
+        if (End - Worker.deadline > _period)
+        {
+            // Too late to catch up, give the missed periods up
+            Overrun = true;
+            Worker.deadline = End;
         }
-        _mutex.unlock();
-        _end = hrc::now();
-        // Calculate spent time
-        period TimeSpent = std::chrono::duration_cast<std::chrono::microseconds>(_end-_start);
-        _lastSleep = _period-TimeSpent;
         //Sleep the rest of time period
-        if (_lastSleep.count() > 0)
-            std::this_thread::sleep_for(_lastSleep);
+        _waitUntil(Worker.deadline);
+        _recordLateness(Worker, steady::now() - Worker.deadline, Overrun);
+    }
+    Worker.id = std::thread::id();
+}
+
+/*****************************************************************************/
+
+void CLoop::_waitUntil(const steady::time_point& pDeadline)
+{
+    const steady::time_point Wake = pDeadline - period(_spin.load(std::memory_order_relaxed));
+    if (Wake > steady::now())
+    {
+#if defined(__linux__)
+        // steady_clock is CLOCK_MONOTONIC with glibc, sleep to the
+        // absolute time so an interrupted sleep does not drift
+        const std::chrono::nanoseconds Since = Wake.time_since_epoch();
+        timespec Time;
+        Time.tv_sec = static_cast<time_t>(std::chrono::duration_cast<std::chrono::seconds>(Since).count());
+        Time.tv_nsec = static_cast<long>((Since - std::chrono::seconds(Time.tv_sec)).count());
+        int Result;
+        do
+        {
+            Result = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Time, nullptr);
+        } while (Result == EINTR);
+        if (Result != 0)
+        {
+            // Clock refused, the portable sleep still gets there
+            std::this_thread::sleep_until(Wake);
+        }
+#else
+        std::this_thread::sleep_until(Wake);
+#endif
+    }
+    while (steady::now() < pDeadline)
+    {
+    }
+}
+
+/*****************************************************************************/
+
+void CLoop::_recordLateness(SWorker& pWorker, lateness pLateness, bool pOverrun)
+{
+    pLateness = std::max(pLateness, lateness(0));
+    const std::size_t Bucket = std::min<std::size_t>(
+        static_cast<std::size_t>(std::chrono::duration_cast<period>(pLateness).count()), JitterBuckets - 1);
+    std::lock_guard<std::mutex> Lock(pWorker.jitterMutex);
+    pWorker.histogram[Bucket]++;
+    pWorker.jitter.min = pWorker.jitter.periods ? std::min(pWorker.jitter.min, pLateness) : pLateness;
+    pWorker.jitter.max = std::max(pWorker.jitter.max, pLateness);
+    pWorker.jitter.periods++;
+    if (pOverrun) pWorker.jitter.overruns++;
+}
+
+/*****************************************************************************/
+
+void CLoop::_pin(std::size_t pIndex)
+{
+#if defined(__linux__)
+    // Cores the process may run on, in order
+    cpu_set_t Allowed;
+    if (sched_getaffinity(0, sizeof(Allowed), &Allowed) != 0 || CPU_COUNT(&Allowed) == 0) return;
+    std::size_t Nth = pIndex % static_cast<std::size_t>(CPU_COUNT(&Allowed));
+    for (int Core = 0; Core < CPU_SETSIZE; Core++)
+    {
+        if (CPU_ISSET(Core, &Allowed) && Nth-- == 0)
+        {
+            cpu_set_t Set;
+            CPU_ZERO(&Set);
+            CPU_SET(Core, &Set);
+            pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set);
+            return;
+        }
     }
+#elif defined(WIN32)
+    const std::size_t Cores = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (pIndex % Cores));
+#else
+    (void)pIndex;
+#endif
 }
 
 /*****************************************************************************/
 
 void CLoop::subscribe(CProcessEvent* pSubscriber)
 {
-    if (std::find(_subscribers.begin(), _subscribers.end(),pSubscriber) == _subscribers.end())
+    std::lock_guard<std::mutex> Lock(_mutex);
+    if (pSubscriber->_shard == NoShard)
     {
-        _mutex.lock();
-        _subscribers.push_back(pSubscriber);
-        _mutex.unlock();
+        // Unknown time, taken as the average one
+        std::int64_t Total = 0;
+        std::size_t Count = 0;
+        std::size_t Shard = 0;
+        std::int64_t ShardLoad = 0;
+        for (std::size_t Index = 0; Index < _workers.size(); Index++)
+        {
+            const std::int64_t Load = _load(*_workers[Index]);
+            Total += Load;
+            Count += _workers[Index]->subscribers.load()->size();
+            if (Index == 0 || Load < ShardLoad)
+            {
+                Shard = Index;
+                ShardLoad = Load;
+            }
+        }
+        pSubscriber->_processTime = Count ? Total / static_cast<std::int64_t>(Count) : 0;
+        if (Total == 0)
+        {
+            // Nothing measured yet, spread by count
+            for (std::size_t Index = 0; Index < _workers.size(); Index++)
+            {
+                if (_workers[Index]->subscribers.load()->size() < _workers[Shard]->subscribers.load()->size())
+                {
+                    Shard = Index;
+                }
+            }
+        }
+        pSubscriber->_shard = Shard;
+        _change(Shard, pSubscriber, true);
     }
+    _reclaim();
 }
 
 /*****************************************************************************/
 
 void CLoop::unSubscribe(CProcessEvent* pSubscriber)
 {
-    _mutex.lock();
-    _subscribers.erase(std::remove(_subscribers.begin(), _subscribers.end(), pSubscriber), _subscribers.end());
-    _mutex.unlock();
+    std::size_t Shard = NoShard;
+    const SEntry* Entry = nullptr;
+    {
+        std::lock_guard<std::mutex> Lock(_mutex);
+        if (pSubscriber->_shard == Moving)
+        {
+            // Only the worker it leaves may still be calling it, its
+            // entry there is marked and lives until that worker is done
+            auto Move = std::find_if(_moves.begin(), _moves.end(),
+                [pSubscriber](const SMove& pMove) { return pMove.subscriber == pSubscriber; });
+            Shard = Move->from;
+            Entry = Move->released.removed;
+            _moves.erase(Move);
+            _pendingMoves--;
+        }
+        else if (pSubscriber->_shard != NoShard)
+        {
+            Shard = pSubscriber->_shard;
+            Entry = _change(Shard, pSubscriber, false).removed;
+        }
+        pSubscriber->_shard = NoShard;
+        _reclaim();
+    }
+    // Walks skip the marked entry, the replaced containers and the
+    // entry are freed by _reclaim once no walk holds them. Only a call
+    // in progress is waited for, the entry is compared but not read
+    if (Shard != NoShard)
+    {
+        _waitCall(*_workers[Shard], Entry);
+    }
+}
+
+/*****************************************************************************/
+
+CLoop::SRetired CLoop::_publish(SWorker& pWorker, v_entries* pEntries)
+{
+    SRetired Retired;
+    Retired.entries = pWorker.subscribers.exchange(pEntries);
+    Retired.removed = nullptr;
+    // Read after the exchange, a walk starting later sees the new container
+    Retired.walks = pWorker.walks.load();
+    Retired.walking = pWorker.walking.load();
+    pWorker.retired.push_back(Retired);
+    return Retired;
+}
+
+/*****************************************************************************/
+
+CLoop::SRetired CLoop::_change(std::size_t pShard, CProcessEvent* pSubscriber, bool pAdd)
+{
+    SWorker& Worker = *_workers[pShard];
+    v_entries* Changed = new v_entries(*Worker.subscribers.load());
+    SEntry* Removed = nullptr;
+    if (pAdd)
+    {
+        Changed->push_back(new SEntry{pSubscriber, {false}});
+    }
+    else
+    {
+        auto Found = std::find_if(Changed->begin(), Changed->end(),
+            [pSubscriber](const SEntry* pEntry) { return pEntry->subscriber == pSubscriber; });
+        Removed = *Found;
+        Changed->erase(Found);
+        Removed->removed = true;
+    }
+    // The container it was removed from frees the entry
+    SRetired Retired = _publish(Worker, Changed);
+    Worker.retired.back().removed = Removed;
+    Retired.removed = Removed;
+    return Retired;
+}
+
+/*****************************************************************************/
+
+bool CLoop::_released(const SWorker& pWorker, const SRetired& pRetired)
+{
+    return !pRetired.walking || pWorker.walks.load() != pRetired.walks;
+}
+
+/*****************************************************************************/
+
+void CLoop::_waitCall(const SWorker& pWorker, const SEntry* pEntry)
+{
+    const std::thread::id Self = std::this_thread::get_id();
+    // Leaving from a call on the same worker, nothing else runs there
+    if (pWorker.id.load() == Self) return;
+    const SWorker* Caller = nullptr;
+    for (const std::unique_ptr<SWorker>& Worker : _workers)
+    {
+        if (Worker->id.load() == Self) Caller = Worker.get();
+    }
+    const std::uint64_t Calls = pWorker.calls.load();
+    while (pWorker.current.load() == pEntry && pWorker.calls.load() == Calls)
+    {
+        // Two subscribers removing each other from their calls would
+        // wait for one another, the one removed already gives up
+        const SEntry* Current = Caller ? Caller->current.load() : nullptr;
+        if (Current && Current->removed) return;
+        std::this_thread::yield();
+    }
 }
 
 /*****************************************************************************/
 
-period CLoop::getLastSleep()
+void CLoop::_reclaim()
 {
-    return _lastSleep;
-}
\ No newline at end of file
+    for (const std::unique_ptr<SWorker>& Worker : _workers)
+    {
+        auto Released = std::remove_if(Worker->retired.begin(), Worker->retired.end(),
+            [this, &Worker](const SRetired& pRetired)
+            {
+                if (!_released(*Worker, pRetired)) return false;
+                delete pRetired.entries;
+                delete pRetired.removed;
+                return true;
+            });
+        Worker->retired.erase(Released, Worker->retired.end());
+    }
+    // Subscribers left behind by their worker join the other one
+    for (auto Move = _moves.begin(); Move != _moves.end();)
+    {
+        if (_released(*_workers[Move->from], Move->released))
+        {
+            Move->subscriber->_shard = Move->to;
+            _change(Move->to, Move->subscriber, true);
+            Move = _moves.erase(Move);
+            _pendingMoves--;
+        }
+        else
+        {
+            ++Move;
+        }
+    }
+}
+
+/*****************************************************************************/
+
+std::int64_t CLoop::_load(const SWorker& pWorker)
+{
+    std::int64_t Load = 0;
+    for (const SEntry* Entry : *pWorker.subscribers.load())
+    {
+        Load += Entry->subscriber->_processTime.load(std::memory_order_relaxed);
+    }
+    return Load;
+}
+
+/*****************************************************************************/
+
+void CLoop::_rebalance()
+{
+    if (_workers.size() < 2 || !_moves.empty()) return;
+    std::size_t Busiest = 0;
+    std::size_t Idlest = 0;
+    std::vector<std::int64_t> Loads;
+    for (std::size_t Index = 0; Index < _workers.size(); Index++)
+    {
+        Loads.push_back(_load(*_workers[Index]));
+        if (Loads[Index] > Loads[Busiest]) Busiest = Index;
+        if (Loads[Index] < Loads[Idlest]) Idlest = Index;
+    }
+    // The moved subscriber misses a period, not worth it for less
+    // than 5% of the period
+    const std::int64_t Gap = Loads[Busiest] - Loads[Idlest];
+    if (Gap < std::chrono::duration_cast<lateness>(_period).count() / 20) return;
+    // Moving T makes the gap |Gap - 2T|, the closest to Gap / 2 is best
+    CProcessEvent* Best = nullptr;
+    std::int64_t BestGap = Gap;
+    for (const SEntry* Entry : *_workers[Busiest]->subscribers.load())
+    {
+        CProcessEvent* Subscriber = Entry->subscriber;
+        const std::int64_t Time = Subscriber->_processTime.load(std::memory_order_relaxed);
+        const std::int64_t NewGap = Gap > 2 * Time ? Gap - 2 * Time : 2 * Time - Gap;
+        if (Time > 0 && NewGap < BestGap)
+        {
+            Best = Subscriber;
+            BestGap = NewGap;
+        }
+    }
+    if (Best == nullptr) return;
+    SMove Move;
+    Move.subscriber = Best;
+    Move.from = Busiest;
+    Move.to = Idlest;
+    Move.released = _change(Busiest, Best, false);
+    Best->_shard = Moving;
+    _moves.push_back(Move);
+    _pendingMoves++;
+}
+
+/*****************************************************************************/
+
+void CLoop::_reshard(std::size_t pWorkers)
+{
+    if (_workers.size() == pWorkers) return;
+    // Everyone, moving ones included
+    v_subscribers All;
+    for (const std::unique_ptr<SWorker>& Worker : _workers)
+    {
+        const v_entries* Entries = Worker->subscribers.load();
+        for (const SEntry* Entry : *Entries)
+        {
+            All.push_back(Entry->subscriber);
+            delete Entry;
+        }
+        for (const SRetired& Retired : Worker->retired)
+        {
+            delete Retired.entries;
+            delete Retired.removed;
+        }
+        delete Entries;
+    }
+    for (const SMove& Move : _moves)
+    {
+        All.push_back(Move.subscriber);
+    }
+    _moves.clear();
+    _pendingMoves = 0;
+    _workers.clear();
+    std::vector<std::int64_t> Loads(pWorkers, 0);
+    for (std::size_t Index = 0; Index < pWorkers; Index++)
+    {
+        _workers.emplace_back(new SWorker());
+        _workers.back()->subscribers = new v_entries();
+        _workers.back()->histogram.fill(0);
+        _workers.back()->jitter = SJitterStats{0, 0, lateness(0), lateness(0), lateness(0)};
+    }
+    // Longest first, each one on the least busy worker
+    std::stable_sort(All.begin(), All.end(), [](const CProcessEvent* pLeft, const CProcessEvent* pRight)
+        {
+            return pLeft->_processTime.load() > pRight->_processTime.load();
+        });
+    for (std::size_t Index = 0; Index < All.size(); Index++)
+    {
+        std::size_t Shard = 0;
+        for (std::size_t Worker = 1; Worker < pWorkers; Worker++)
+        {
+            const bool Less = Loads[Worker] < Loads[Shard] ||
+                (Loads[Worker] == Loads[Shard] && _workers[Worker]->subscribers.load()->size() < _workers[Shard]->subscribers.load()->size());
+            if (Less) Shard = Worker;
+        }
+        Loads[Shard] += All[Index]->_processTime.load();
+        All[Index]->_shard = Shard;
+        _workers[Shard]->subscribers.load()->push_back(new SEntry{All[Index], {false}});
+    }
+}
+
+/*****************************************************************************/
+
+period CLoop::getLastSleep(std::size_t pWorker)
+{
+    return period(_workers[pWorker]->lastSleep.load());
+}
+
+/*****************************************************************************/
+
+void CLoop::setSpin(period pSpin)
+{
+    _spin = pSpin.count();
+}
+
+/*****************************************************************************/
+
+period CLoop::getSpin()
+{
+    return period(_spin.load());
+}
+
+/*****************************************************************************/
+
+void CLoop::setPinning(bool pPinned)
+{
+    _pinning = pPinned;
+}
+
+/*****************************************************************************/
+
+bool CLoop::getPinning()
+{
+    return _pinning;
+}
+
+/*****************************************************************************/
+
+std::size_t CLoop::getWorkers()
+{
+    std::lock_guard<std::mutex> Lock(_mutex);
+    return _workers.size();
+}
+
+/*****************************************************************************/
+
+std::size_t CLoop::getSubscribers(std::size_t pWorker)
+{
+    std::lock_guard<std::mutex> Lock(_mutex);
+    return _workers[pWorker]->subscribers.load()->size();
+}
+
+/*****************************************************************************/
+
+lateness CLoop::getLoad(std::size_t pWorker)
+{
+    std::lock_guard<std::mutex> Lock(_mutex);
+    return lateness(_load(*_workers[pWorker]));
+}
+
+/*****************************************************************************/
+
+SJitterStats CLoop::getJitterStats()
+{
+    std::lock_guard<std::mutex> Lock(_mutex);
+    std::array<std::uint64_t, JitterBuckets> Histogram;
+    Histogram.fill(0);
+    SJitterStats Stats{0, 0, lateness(0), lateness(0), lateness(0)};
+    for (const std::unique_ptr<SWorker>& Worker : _workers)
+    {
+        std::lock_guard<std::mutex> JitterLock(Worker->jitterMutex);
+        if (Worker->jitter.periods == 0) continue;
+        Stats.min = Stats.periods ? std::min(Stats.min, Worker->jitter.min) : Worker->jitter.min;
+        Stats.max = std::max(Stats.max, Worker->jitter.max);
+        Stats.periods += Worker->jitter.periods;
+        Stats.overruns += Worker->jitter.overruns;
+        for (std::size_t Bucket = 0; Bucket < JitterBuckets; Bucket++)
+        {
+            Histogram[Bucket] += Worker->histogram[Bucket];
+        }
+    }
+    Stats.p99 = percentile99(Histogram, Stats);
+    return Stats;
+}
+
+/*****************************************************************************/
+
+SJitterStats CLoop::getJitterStats(std::size_t pWorker)
+{
+    std::lock_guard<std::mutex> Lock(_mutex);
+    SWorker& Worker = *_workers[pWorker];
+    std::lock_guard<std::mutex> JitterLock(Worker.jitterMutex);
+    SJitterStats Stats = Worker.jitter;
+    Stats.p99 = percentile99(Worker.histogram, Stats);
+    return Stats;
+}
+
+/*****************************************************************************/
+
+void CLoop::resetJitterStats()
+{
+    std::lock_guard<std::mutex> Lock(_mutex);
+    for (const std::unique_ptr<SWorker>& Worker : _workers)
+    {
+        std::lock_guard<std::mutex> JitterLock(Worker->jitterMutex);
+        Worker->histogram.fill(0);
+        Worker->jitter = SJitterStats{0, 0, lateness(0), lateness(0), lateness(0)};
+    }
+}
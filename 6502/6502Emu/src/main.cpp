@@ -21,21 +21,107 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>
  */
 
+#include <cerrno>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
 #include "loop.hpp"
 #include "mainapp.hpp"
 
+/**
+ * @brief Read a count argument
+ * 
+ * @param pArg : Decimal digits only
+ * @param pCount : Count read
+ * @return true when the whole argument is a count
+ */
+static bool ParseCount(const char* pArg, std::size_t& pCount)
+{
+    // strtoul takes spaces and signs too
+    if (*pArg < '0' || *pArg > '9') return false;
+    char* End = nullptr;
+    errno = 0;
+    const unsigned long Count = std::strtoul(pArg, &End, 10);
+    if (*End != '\0' || errno == ERANGE) return false;
+    pCount = Count;
+    return true;
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Print the options
+ * 
+ * @param pName : Program name
+ * @return int exit status
+ */
+static int Usage(const char* pName)
+{
+    std::cerr << "Usage: " << pName
+              << " [--strict] [--pin] [--machines <count>] [--workers <count>]" << std::endl;
+    return 1;
+}
+
+/*****************************************************************************/
+
 /**
  * @brief 
  * 
  * @return * int 
  */
-int main() {
+int main(int argc, char* argv[]) {
+    // Strict mode runs every instruction, idle loops included
+    bool Strict = false;
+    // Machines emulated, spread over the loop workers
+    std::size_t Machines = 1;
+    std::size_t Workers = 1;
+    bool Pinning = false;
+    for (int Index = 1; Index < argc; Index++)
+    {
+        const std::string Arg(argv[Index]);
+        if (Arg == "--strict")
+        {
+            Strict = true;
+        }
+        else if (Arg == "--pin")
+        {
+            Pinning = true;
+        }
+        else if (Arg == "--machines" && Index + 1 < argc)
+        {
+            if (!ParseCount(argv[++Index], Machines)) return Usage(argv[0]);
+        }
+        else if (Arg == "--workers" && Index + 1 < argc)
+        {
+            if (!ParseCount(argv[++Index], Workers)) return Usage(argv[0]);
+        }
+    }
     CLoop Loop;
-    CMainApp MainApp(Loop);
-    Loop.start(2);
+    std::vector<std::unique_ptr<CMainApp>> MainApps;
+    for (std::size_t Index = 0; Index < Machines; Index++)
+    {
+        MainApps.emplace_back(new CMainApp(Loop, Strict));
+    }
+    // Sleeping is only precise to some tens of µsec, spin the rest
+    Loop.setSpin(std::chrono::microseconds(50));
+    Loop.setPinning(Pinning);
+    Loop.start(2, Workers);
     std::cout << "Wait touch press..." << std::endl;
     std::getchar();
     Loop.stop();
+    for (std::size_t Worker = 0; Worker < Loop.getWorkers(); Worker++)
+    {
+        const SJitterStats Jitter = Loop.getJitterStats(Worker);
+        std::cout << "Worker " << Worker
+                  << " : Machines = " << Loop.getSubscribers(Worker)
+                  << " , Load = " << Loop.getLoad(Worker).count() << " nsec"
+                  << " , Periods = " << Jitter.periods
+                  << " , Overruns = " << Jitter.overruns
+                  << " , Lateness min / max / p99 = " << Jitter.min.count()
+                  << " / " << Jitter.max.count()
+                  << " / " << Jitter.p99.count() << " nsec" << std::endl;
+    }
     return 0;
 }
\ No newline at end of file
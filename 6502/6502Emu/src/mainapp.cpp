@@ -31,7 +31,7 @@
 
 /*****************************************************************************/
 
-CMainApp::CMainApp(CLoop& pParent) : CProcessEvent(pParent), _mem(_bus, 0x0000, 0x0000), _cpu(_bus)
+CMainApp::CMainApp(CLoop& pParent, bool pStrict) : CProcessEvent(pParent), _mem(_bus, 0x0000, 0x0000), _cpu(_bus)
 {
 #ifdef WIN32
     // Set console code page to UTF-8 so console known how to interpret string data
@@ -57,14 +57,20 @@ CMainApp::CMainApp(CLoop& pParent) : CProcessEvent(pParent), _mem(_bus, 0x0000,
 		{ 0x00,0x40,0xA2,0x00,0xE8,0x4C,0x02,0x40 };
 
 	_cpu.loadPrg( TestPrg, sizeof(TestPrg) );
+    // The demo only counts in X, skip its loop unless strict
+    _cpu.setIdleSkip( !pStrict );
 
     _clock = 3; // Set Clock speed in MHz
+    // Ready, the loop may call us
+    startProcess();
 }
 
 /*****************************************************************************/
 
 CMainApp::~CMainApp()
 {
+    // Members are going away, the loop must not call us anymore
+    stopProcess();
 
 }
 
@@ -91,6 +97,7 @@ void CMainApp::onProcess(const period& pInterval)
                   << " µsec , Execution Time = " << ExecTime
                   << " µsec , Cycles Executed = " << ActualCycles
                   << " CPU X = " << std::hex << static_cast<int>(_cpu.X) << std::dec
+                  << " Idle Cycles Skipped = " << _cpu.getIdleSkippedCycles()
                   << " CPU Idle Clice Time = " << IDLE_Time.count() << " nsec"
                   << " SleepTime = " << getLastSleep().count() << " µsec"
                   << std::endl;
@@ -0,0 +1,229 @@
+/**
+ * @file main.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <m6502/System.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#if M6502_COVERAGE && defined(__linux__)
+#include <sys/shm.h>
+#endif
+
+/**
+ * @brief Print the command line help
+ * 
+ */
+static void usage()
+{
+    std::cerr << "Usage: M6502Fuzz <program.prg> [options] [input...]\n"
+              << "  program.prg     program as loaded by CCPU::loadPrg, load address first\n"
+              << "  input           files run one after the other, stdin when none\n"
+              << "  --reset ADDRESS PC after loading (default load address)\n"
+              << "  --boot CYCLES   cycles run once before the snapshot (default 0)\n"
+              << "  --input ADDRESS RAM given the input (default 0200)\n"
+              << "  --max SIZE      bytes of RAM given the input (default 256)\n"
+              << "  --size-at ADDRESS  write the input size there, little endian word\n"
+              << "  --target ADDRESS stop when PC reaches the address\n"
+              << "  --trap ADDRESS  unused byte the BRK vector is pointed at (default FFF0)\n"
+              << "  --cycles CYCLES cycle cap of each input (default 1000000)\n"
+              << "  --abort         abort on crash, as AFL expects\n"
+              << "Addresses are hexadecimal\n";
+}
+
+/**
+ * @brief Name of an exit
+ * 
+ * @param pExit 
+ * @return const char* 
+ */
+static const char* exitName(m6502::EFuzzExit pExit)
+{
+    using namespace m6502;
+    switch (pExit)
+    {
+        case EFuzzExit::Break: return "break";
+        case EFuzzExit::Target: return "target";
+        case EFuzzExit::Cycles: return "cycles";
+        case EFuzzExit::Illegal: return "crash illegal opcode";
+        case EFuzzExit::Decimal: return "crash decimal mode";
+        case EFuzzExit::StackOverflow: return "crash stack overflow";
+        default: return "crash stack underflow";
+    }
+}
+
+/**
+ * @brief Read a whole file, or stdin for "-"
+ * 
+ * @param pName 
+ * @param pData 
+ * @return true when read
+ */
+static bool readFile(const std::string& pName, std::vector<m6502::Byte>& pData)
+{
+    if (pName == "-")
+    {
+        pData.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+        return true;
+    }
+    std::ifstream Input(pName, std::ios::binary);
+    if (!Input) return false;
+    pData.assign(std::istreambuf_iterator<char>(Input), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace m6502;
+    std::vector<std::string> Args(argv + 1, argv + argc);
+    SFuzzConfig Config;
+    bool HasReset = false;
+    Config.resetVector = 0;
+    Config.bootCycles = 0;
+    Config.inputAddress = 0x0200;
+    Config.inputSize = 256;
+    Config.writeSize = false;
+    Config.sizeAddress = 0;
+    Config.stopOnTarget = false;
+    Config.targetPC = 0;
+    Config.trapAddress = 0xFFF0;
+    Config.cycles = 1000000;
+    bool Abort = false;
+    std::vector<std::string> Files;
+    for (size_t Index = 0; Index < Args.size(); Index++)
+    {
+        const bool HasValue = Index + 1 < Args.size();
+        const auto Hex = [&]() { return static_cast<Word>(std::stoul(Args[++Index], nullptr, 16)); };
+        if (Args[Index] == "--reset" && HasValue)
+        {
+            Config.resetVector = Hex();
+            HasReset = true;
+        }
+        else if (Args[Index] == "--boot" && HasValue)
+        {
+            Config.bootCycles = std::stoll(Args[++Index]);
+        }
+        else if (Args[Index] == "--input" && HasValue)
+        {
+            Config.inputAddress = Hex();
+        }
+        else if (Args[Index] == "--max" && HasValue)
+        {
+            Config.inputSize = static_cast<u32>(std::stoul(Args[++Index]));
+        }
+        else if (Args[Index] == "--size-at" && HasValue)
+        {
+            Config.sizeAddress = Hex();
+            Config.writeSize = true;
+        }
+        else if (Args[Index] == "--target" && HasValue)
+        {
+            Config.targetPC = Hex();
+            Config.stopOnTarget = true;
+        }
+        else if (Args[Index] == "--trap" && HasValue)
+        {
+            Config.trapAddress = Hex();
+        }
+        else if (Args[Index] == "--cycles" && HasValue)
+        {
+            Config.cycles = std::stoll(Args[++Index]);
+        }
+        else if (Args[Index] == "--abort")
+        {
+            Abort = true;
+        }
+        else
+        {
+            Files.push_back(Args[Index]);
+        }
+    }
+    if (Files.empty())
+    {
+        usage();
+        return 1;
+    }
+    if (!readFile(Files[0], Config.program) || Config.program.size() < 3)
+    {
+        std::cerr << "Can't read a program from " << Files[0] << "\n";
+        return 1;
+    }
+    if (!HasReset)
+    {
+        Config.resetVector = static_cast<Word>(Config.program[0] | (Config.program[1] << 8));
+    }
+    Files.erase(Files.begin());
+    if (Files.empty())
+    {
+        Files.push_back("-");
+    }
+
+    CFuzzHarness Harness(Config);
+#if M6502_COVERAGE && defined(__linux__)
+    // Run by afl-fuzz, edges go to its shared map
+    if (const char* ShmId = std::getenv("__AFL_SHM_ID"))
+    {
+        void* Map = shmat(std::atoi(ShmId), nullptr, 0);
+        if (Map != reinterpret_cast<void*>(-1))
+        {
+            Harness.getCPU().setCoverageMap(static_cast<Byte*>(Map));
+        }
+    }
+#endif
+
+    std::vector<Byte> Input;
+    u32 Crashes = 0;
+    const auto Start = std::chrono::steady_clock::now();
+    for (const std::string& File : Files)
+    {
+        if (!readFile(File, Input))
+        {
+            std::cerr << "Can't read " << File << "\n";
+            return 1;
+        }
+        const SFuzzResult Result = Harness.run(Input.data(), Input.size());
+        std::cout << File << ": " << exitName(Result.exit) << " after " << Result.cycles
+                  << " cycles, PC $" << std::hex << std::uppercase << std::setw(4) << std::setfill('0')
+                  << Result.PC << std::dec << std::setfill(' ') << "\n";
+        if (Result.crashed())
+        {
+            if (Abort)
+            {
+                std::abort();
+            }
+            Crashes++;
+        }
+    }
+    const double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    if (Files.size() > 1 && Seconds > 0)
+    {
+        std::cout << Harness.getRuns() << " inputs, " << Crashes << " crashes, "
+                  << static_cast<u64>(Harness.getRuns() / Seconds) << " inputs/sec\n";
+    }
+    return Crashes ? 2 : 0;
+}
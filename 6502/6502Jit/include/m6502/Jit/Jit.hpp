@@ -0,0 +1,297 @@
+/**
+ * @file Jit.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef JIT_HPP
+#define JIT_HPP
+
+#include <m6502/Config.hpp>
+#include <m6502/System/Bus.hpp>
+#include <m6502/System/Cpu.hpp>
+#include <vector>
+#include <array>
+#include <memory>
+
+namespace m6502
+{
+
+/**
+ * @brief Counters of the JIT
+ * 
+ */
+struct SJitStats
+{
+    /**
+     * @brief Blocks translated to native code
+     * 
+     */
+    u64 compiledBlocks;
+
+    /**
+     * @brief Native blocks run
+     * 
+     */
+    u64 nativeRuns;
+
+    /**
+     * @brief Instructions run by the interpreter
+     * 
+     */
+    u64 interpretedInstructions;
+
+    /**
+     * @brief Native blocks dropped because their code was written
+     * 
+     */
+    u64 invalidations;
+
+    /**
+     * @brief Whole translation cache drops (arena full, bus remapped)
+     * 
+     */
+    u64 flushes;
+};
+
+/**
+ * @brief Dynamic recompiler of hot 6502 code to x86-64 for Linux
+ *        Runs a CPU like CCPU::execute, with the same cycle counts:
+ *        blocks entered often enough are translated into an
+ *        executable arena, anything else is run by CCPU::step
+ *
+ *        Native code reads and writes RAM pages directly, an
+ *        instruction touching a page without host memory (I/O)
+ *        ends the block and is left to the interpreter
+ */
+class CJit : public CBusChip
+{
+public:
+    /**
+     * @brief Construct a new JIT for a CPU and its bus
+     * 
+     * @param pCPU 
+     * @param pBus bus the CPU is connected to
+     */
+    CJit(CCPU& pCPU, CBus& pBus);
+
+    /**
+     * @brief Construct a new JIT object
+     * 
+     * @param pCopy 
+     */
+    CJit(const CJit& pCopy) = delete;
+
+    /**
+     * @brief Destroy the JIT object
+     * 
+     */
+    ~CJit();
+
+    /**
+     * @brief Execute specified number of cycles
+     * 
+     * @param pCycles 
+     * @return The real numbers cycles excecuted
+     */
+    s64 execute( s64 pCycles );
+
+    /**
+     * @brief Drop every native block
+     * 
+     */
+    void flush();
+
+    /**
+     * @brief Set the number of entries of a PC before it is compiled
+     * 
+     * @param pThreshold 
+     */
+    void setHotThreshold( u32 pThreshold );
+
+    /**
+     * @brief Get the counters
+     * 
+     * @return const SJitStats& 
+     */
+    const SJitStats& getStats() const { return _stats; }
+
+    /**
+     * @brief false when no executable memory could be mapped,
+     *        everything is then interpreted
+     * 
+     * @return bool 
+     */
+    bool isAvailable() const { return _arena != nullptr; }
+
+    /**
+     * @brief Size of the code arena
+     * 
+     */
+    static constexpr size_t ArenaSize = 4 * 1024 * 1024;
+
+    /**
+     * @brief Max 6502 instructions in a native block
+     * 
+     */
+    static constexpr size_t MaxInstructions = 64;
+
+    /**
+     * @brief Registers of the CPU seen by native code
+     *        NZ holds a result : Z when 0, N its bit 7
+     */
+    struct SState
+    {
+        Byte A;
+        Byte X;
+        Byte Y;
+        Byte SP;
+        Byte NZ;
+        Byte C;
+        Byte V;
+        Byte Unused;
+        Word PC;
+    };
+
+protected:
+    /**
+     * @brief Write Event on a page holding native blocks
+     * 
+     * @param pAddress 
+     */
+    void onWatchedWrite( const Word& pAddress ) override;
+
+private:
+    /**
+     * @brief Native block entry, returns the cycles used
+     * 
+     */
+    typedef u32 (*native_block)(SState*);
+
+    /**
+     * @brief Native block of a 6502 entry PC
+     * 
+     */
+    struct SNativeBlock
+    {
+        native_block code;
+        s64 maxCycles;
+        std::vector<Byte> storePages;
+    };
+
+    /**
+     * @brief Translate the block starting at PC
+     * 
+     * @param pPC 
+     * @return SNativeBlock* nullptr when the first instruction
+     *         can not be translated
+     */
+    SNativeBlock* _compile( const Word& pPC );
+
+    /**
+     * @brief Set arena pages writable or executable, never both
+     * 
+     * @param pFrom first byte of the range
+     * @param pTo byte after the range
+     * @param pExecutable 
+     * @return true if the pages were changed
+     */
+    bool _protect( size_t pFrom, size_t pTo, bool pExecutable );
+
+    /**
+     * @brief Drop the native blocks in a page
+     * 
+     * @param pPage 
+     */
+    void _invalidatePage( const Byte& pPage );
+
+    /**
+     * @brief Drop the native blocks storing directly into a page
+     * 
+     * @param pPage 
+     */
+    void _invalidateStorers( const Byte& pPage );
+
+    /**
+     * @brief CPU run
+     * 
+     */
+    CCPU& _cpu;
+
+    /**
+     * @brief Code memory, writable while a block is emitted and
+     *        executable otherwise
+     * 
+     */
+    Byte* _arena;
+
+    /**
+     * @brief Bytes of arena used
+     * 
+     */
+    size_t _arenaUsed;
+
+    /**
+     * @brief Native block of each PC
+     * 
+     */
+    std::vector<std::unique_ptr<SNativeBlock>> _blocks;
+
+    /**
+     * @brief Entries of each PC, compiled when reaching threshold
+     * 
+     */
+    std::vector<Word> _entries;
+
+    /**
+     * @brief Entry PC of the blocks in each page
+     * 
+     */
+    std::array<std::vector<Word>,256> _pageBlocks;
+
+    /**
+     * @brief Entry PC of the blocks storing directly into each page
+     * 
+     */
+    std::array<std::vector<Word>,256> _pageStorers;
+
+    /**
+     * @brief Bus page map generation the native code was made for
+     * 
+     */
+    u64 _mapGeneration;
+
+    /**
+     * @brief Entries before compiling
+     * 
+     */
+    u32 _hotThreshold;
+
+    /**
+     * @brief Counters
+     * 
+     */
+    SJitStats _stats;
+};
+
+}
+
+#endif
@@ -0,0 +1,963 @@
+/**
+ * @file Jit.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <m6502/Jit/Jit.hpp>
+#include "X64Emitter.hpp"
+#include <sys/mman.h>
+#include <stddef.h>
+#include <unistd.h>
+
+namespace m6502
+{
+
+namespace
+{
+
+/**
+ * @brief 6502 operations the JIT translates
+ * 
+ */
+enum class EOp : Byte
+{
+    None,
+    LDA, LDX, LDY, STA, STX, STY,
+    AND, ORA, EOR, ADC, SBC, CMP, CPX, CPY,
+    INC, DEC, ASL, LSR, ROL, ROR,
+    TAX, TAY, TXA, TYA, TSX, TXS,
+    INX, INY, DEX, DEY,
+    CLC, SEC, CLV, NOP,
+    PHA, PLA, JMP, JSR, RTS,
+    BEQ, BNE, BCS, BCC, BMI, BPL, BVC, BVS
+};
+
+/**
+ * @brief Operation of an opcode, None when not translated
+ *        (indirect modes, BIT, PHP/PLP, BRK/RTI, I and D flags)
+ * 
+ * @param pIns 
+ * @return EOp 
+ */
+EOp operationOf(Ins pIns)
+{
+    switch (pIns)
+    {
+        case Ins::LDA_IM: case Ins::LDA_ZP: case Ins::LDA_ZPX:
+        case Ins::LDA_ABS: case Ins::LDA_ABSX: case Ins::LDA_ABSY:
+            return EOp::LDA;
+        case Ins::LDX_IM: case Ins::LDX_ZP: case Ins::LDX_ZPY:
+        case Ins::LDX_ABS: case Ins::LDX_ABSY:
+            return EOp::LDX;
+        case Ins::LDY_IM: case Ins::LDY_ZP: case Ins::LDY_ZPX:
+        case Ins::LDY_ABS: case Ins::LDY_ABSX:
+            return EOp::LDY;
+        case Ins::STA_ZP: case Ins::STA_ZPX: case Ins::STA_ABS:
+        case Ins::STA_ABSX: case Ins::STA_ABSY:
+            return EOp::STA;
+        case Ins::STX_ZP: case Ins::STX_ZPY: case Ins::STX_ABS:
+            return EOp::STX;
+        case Ins::STY_ZP: case Ins::STY_ZPX: case Ins::STY_ABS:
+            return EOp::STY;
+        case Ins::AND_IM: case Ins::AND_ZP: case Ins::AND_ZPX:
+        case Ins::AND_ABS: case Ins::AND_ABSX: case Ins::AND_ABSY:
+            return EOp::AND;
+        case Ins::ORA_IM: case Ins::ORA_ZP: case Ins::ORA_ZPX:
+        case Ins::ORA_ABS: case Ins::ORA_ABSX: case Ins::ORA_ABSY:
+            return EOp::ORA;
+        case Ins::EOR_IM: case Ins::EOR_ZP: case Ins::EOR_ZPX:
+        case Ins::EOR_ABS: case Ins::EOR_ABSX: case Ins::EOR_ABSY:
+            return EOp::EOR;
+        case Ins::ADC: case Ins::ADC_ZP: case Ins::ADC_ZPX:
+        case Ins::ADC_ABS: case Ins::ADC_ABSX: case Ins::ADC_ABSY:
+            return EOp::ADC;
+        case Ins::SBC: case Ins::SBC_ZP: case Ins::SBC_ZPX:
+        case Ins::SBC_ABS: case Ins::SBC_ABSX: case Ins::SBC_ABSY:
+            return EOp::SBC;
+        case Ins::CMP: case Ins::CMP_ZP: case Ins::CMP_ZPX:
+        case Ins::CMP_ABS: case Ins::CMP_ABSX: case Ins::CMP_ABSY:
+            return EOp::CMP;
+        case Ins::CPX: case Ins::CPX_ZP: case Ins::CPX_ABS:
+            return EOp::CPX;
+        case Ins::CPY: case Ins::CPY_ZP: case Ins::CPY_ABS:
+            return EOp::CPY;
+        case Ins::INC_ZP: case Ins::INC_ZPX: case Ins::INC_ABS: case Ins::INC_ABSX:
+            return EOp::INC;
+        case Ins::DEC_ZP: case Ins::DEC_ZPX: case Ins::DEC_ABS: case Ins::DEC_ABSX:
+            return EOp::DEC;
+        case Ins::ASL: case Ins::ASL_ZP: case Ins::ASL_ZPX:
+        case Ins::ASL_ABS: case Ins::ASL_ABSX:
+            return EOp::ASL;
+        case Ins::LSR: case Ins::LSR_ZP: case Ins::LSR_ZPX:
+        case Ins::LSR_ABS: case Ins::LSR_ABSX:
+            return EOp::LSR;
+        case Ins::ROL: case Ins::ROL_ZP: case Ins::ROL_ZPX:
+        case Ins::ROL_ABS: case Ins::ROL_ABSX:
+            return EOp::ROL;
+        case Ins::ROR: case Ins::ROR_ZP: case Ins::ROR_ZPX:
+        case Ins::ROR_ABS: case Ins::ROR_ABSX:
+            return EOp::ROR;
+        case Ins::TAX: return EOp::TAX;
+        case Ins::TAY: return EOp::TAY;
+        case Ins::TXA: return EOp::TXA;
+        case Ins::TYA: return EOp::TYA;
+        case Ins::TSX: return EOp::TSX;
+        case Ins::TXS: return EOp::TXS;
+        case Ins::INX: return EOp::INX;
+        case Ins::INY: return EOp::INY;
+        case Ins::DEX: return EOp::DEX;
+        case Ins::DEY: return EOp::DEY;
+        case Ins::CLC: return EOp::CLC;
+        case Ins::SEC: return EOp::SEC;
+        case Ins::CLV: return EOp::CLV;
+        case Ins::NOP: return EOp::NOP;
+        case Ins::PHA: return EOp::PHA;
+        case Ins::PLA: return EOp::PLA;
+        case Ins::JMP_ABS: return EOp::JMP;
+        case Ins::JSR: return EOp::JSR;
+        case Ins::RTS: return EOp::RTS;
+        case Ins::BEQ: return EOp::BEQ;
+        case Ins::BNE: return EOp::BNE;
+        case Ins::BSC: return EOp::BCS;
+        case Ins::BCC: return EOp::BCC;
+        case Ins::BMI: return EOp::BMI;
+        case Ins::BPL: return EOp::BPL;
+        case Ins::BVC: return EOp::BVC;
+        case Ins::BVS: return EOp::BVS;
+        default: return EOp::None;
+    }
+}
+
+// Host registers of the 6502 state while in native code
+constexpr EX64Reg RegA = EX64Reg::R8;
+constexpr EX64Reg RegX = EX64Reg::R9;
+constexpr EX64Reg RegY = EX64Reg::R10;
+constexpr EX64Reg RegV = EX64Reg::R11;
+constexpr EX64Reg RegSP = EX64Reg::R12;
+constexpr EX64Reg RegNZ = EX64Reg::RCX;
+constexpr EX64Reg RegC = EX64Reg::RDX;
+// Extra cycles of page crossings, only known at run time
+constexpr EX64Reg RegExtra = EX64Reg::RBX;
+// Host address of the operand, then its value
+constexpr EX64Reg RegOp = EX64Reg::RSI;
+constexpr EX64Reg RegTmp = EX64Reg::RAX;
+
+constexpr Word Cold = 0xFFFF;
+
+}
+
+/*****************************************************************************/
+
+/**
+ * @brief Translate one block of 6502 code with a CX64Emitter
+ * 
+ */
+class CX64Translator
+{
+public:
+    CX64Translator(CBus& pBus, CX64Emitter& pEmit, const Word& pStart) :
+        bus(pBus), emit(pEmit), start(pStart), cycles(0), maxCycles(0)
+    {
+    }
+
+    /**
+     * @brief Load the state into host registers
+     * 
+     */
+    void prologue()
+    {
+        emit.push(RegExtra);
+        emit.push(RegSP);
+        emit.alu(EX64Alu::XOR, RegExtra, RegExtra);
+        emit.loadStateByte(RegA, offsetof(CJit::SState, A));
+        emit.loadStateByte(RegX, offsetof(CJit::SState, X));
+        emit.loadStateByte(RegY, offsetof(CJit::SState, Y));
+        emit.loadStateByte(RegSP, offsetof(CJit::SState, SP));
+        emit.loadStateByte(RegNZ, offsetof(CJit::SState, NZ));
+        emit.loadStateByte(RegC, offsetof(CJit::SState, C));
+        emit.loadStateByte(RegV, offsetof(CJit::SState, V));
+    }
+
+    /**
+     * @brief Leave the block at a known PC
+     * 
+     * @param pPC 
+     * @param pCycles 
+     */
+    void exit(const Word& pPC, s64 pCycles)
+    {
+        emit.storeStateWordImm(offsetof(CJit::SState, PC), pPC);
+        _epilogue(pCycles);
+    }
+
+    /**
+     * @brief Leave the block at the PC held by RegTmp
+     * 
+     * @param pCycles 
+     */
+    void exitDynamic(s64 pCycles)
+    {
+        emit.storeStateWord(offsetof(CJit::SState, PC), RegTmp);
+        _epilogue(pCycles);
+    }
+
+    /**
+     * @brief Translate one instruction
+     * 
+     * @param pAddress address of the opcode
+     * @param pOpCode 
+     * @param pOperand 
+     * @param pTerminal set when the instruction left the block
+     * @return bool false when the instruction can not be translated,
+     *         nothing has been emitted then
+     */
+    bool translate(const Word& pAddress, const Byte& pOpCode, const Word& pOperand, bool& pTerminal);
+
+    CBus& bus;
+    CX64Emitter& emit;
+    Word start;
+    s64 cycles;
+    s64 maxCycles;
+    std::vector<Byte> storePages;
+
+private:
+    void _epilogue(s64 pCycles)
+    {
+        emit.storeStateByte(offsetof(CJit::SState, A), RegA);
+        emit.storeStateByte(offsetof(CJit::SState, X), RegX);
+        emit.storeStateByte(offsetof(CJit::SState, Y), RegY);
+        emit.storeStateByte(offsetof(CJit::SState, SP), RegSP);
+        emit.storeStateByte(offsetof(CJit::SState, NZ), RegNZ);
+        emit.storeStateByte(offsetof(CJit::SState, C), RegC);
+        emit.storeStateByte(offsetof(CJit::SState, V), RegV);
+        emit.movImm(RegTmp, static_cast<u32>(pCycles));
+        emit.alu(EX64Alu::ADD, RegTmp, RegExtra);
+        emit.pop(RegSP);
+        emit.pop(RegExtra);
+        emit.ret();
+    }
+
+    // Host memory of an address, nullptr for I/O
+    Byte* _hostRead(const Word& pAddress) const
+    {
+        const Byte* Page = bus.getReadPage(pAddress);
+        return Page ? const_cast<Byte*>(Page) + (pAddress & 0xFF) : nullptr;
+    }
+
+    Byte* _hostWrite(const Word& pAddress) const
+    {
+        Byte* Page = bus.getWritePage(pAddress);
+        return Page ? Page + (pAddress & 0xFF) : nullptr;
+    }
+
+    /**
+     * @brief Check a 6502 address range can be accessed as one
+     *        host memory range, for reads and/or writes
+     */
+    Byte* _hostRange(const Word& pFirst, const Word& pLast, bool pRead, bool pWrite) const;
+
+    /**
+     * @brief Put the host address of the operand in RegOp
+     * 
+     * @return bool false when the operand is not plain memory
+     */
+    bool _address(EAddrMode pMode, const Word& pOperand, bool pRead, bool pWrite, bool pPenalty);
+
+    void _setNZ(EX64Reg pReg) { emit.mov(RegNZ, pReg); }
+    void _push(EX64Reg pReg, Byte* pStack);
+    void _compare(EX64Reg pReg);
+    void _adc();
+    void _shift(EOp pOp);
+    void _branch(EOp pOp, const Word& pNext, const Word& pTarget, s64 pCycles);
+};
+
+/*****************************************************************************/
+
+Byte* CX64Translator::_hostRange(const Word& pFirst, const Word& pLast, bool pRead, bool pWrite) const
+{
+    // Wrapping around the address space never maps to host memory
+    if (pLast < pFirst) return nullptr;
+    Byte* Host = pRead ? _hostRead(pFirst) : _hostWrite(pFirst);
+    if (!Host) return nullptr;
+    // Each page of the range must follow the previous one in host memory
+    Byte* Base = Host - (pFirst & 0xFF);
+    for (u32 Page = pFirst >> 8; Page <= static_cast<u32>(pLast >> 8); Page++)
+    {
+        const Word Address = static_cast<Word>(Page << 8);
+        Byte* Expected = Base + ((Page - (pFirst >> 8)) << 8);
+        if (pRead && bus.getReadPage(Address) != Expected) return nullptr;
+        if (pWrite)
+        {
+            // Code pages are watched, a store there goes to the interpreter
+            if (Page == static_cast<u32>(start >> 8)) return nullptr;
+            if (bus.getWritePage(Address) != Expected) return nullptr;
+        }
+    }
+    return Host;
+}
+
+/*****************************************************************************/
+
+bool CX64Translator::_address(EAddrMode pMode, const Word& pOperand, bool pRead, bool pWrite, bool pPenalty)
+{
+    Word First = pOperand;
+    Word Last = pOperand;
+    EX64Reg Index = RegX;
+    switch (pMode)
+    {
+        case EAddrMode::ZeroPage:
+        case EAddrMode::Absolute:
+            break;
+        case EAddrMode::ZeroPageY:
+            Index = RegY;
+            // fall through
+        case EAddrMode::ZeroPageX:
+            First = 0x00;
+            Last = 0xFF;
+            break;
+        case EAddrMode::AbsoluteY:
+            Index = RegY;
+            // fall through
+        case EAddrMode::AbsoluteX:
+            Last = pOperand + 0xFF;
+            break;
+        default:
+            return false;
+    }
+    Byte* Host = _hostRange(First, Last, pRead, pWrite);
+    if (!Host) return false;
+    if (pWrite)
+    {
+        for (u32 Page = First >> 8; Page <= static_cast<u32>(Last >> 8); Page++)
+        {
+            storePages.push_back(static_cast<Byte>(Page));
+        }
+    }
+    emit.movImm64(RegOp, reinterpret_cast<u64>(Host));
+    if (pMode == EAddrMode::ZeroPageX || pMode == EAddrMode::ZeroPageY)
+    {
+        // Index wraps in zero page
+        emit.mov(RegTmp, Index);
+        emit.aluImm(EX64Alu::ADD, RegTmp, pOperand);
+        emit.aluImm(EX64Alu::AND, RegTmp, 0xFF);
+        emit.add64(RegOp, RegTmp);
+    }
+    else if (pMode == EAddrMode::AbsoluteX || pMode == EAddrMode::AbsoluteY)
+    {
+        emit.add64(RegOp, Index);
+        if (pPenalty)
+        {
+            // One more cycle when base + index crosses a page
+            emit.mov(RegTmp, Index);
+            emit.aluImm(EX64Alu::ADD, RegTmp, pOperand & 0xFF);
+            emit.shrImm(RegTmp, 8);
+            emit.alu(EX64Alu::ADD, RegExtra, RegTmp);
+            maxCycles++;
+        }
+    }
+    return true;
+}
+
+/*****************************************************************************/
+
+void CX64Translator::_push(EX64Reg pReg, Byte* pStack)
+{
+    emit.movImm64(RegOp, reinterpret_cast<u64>(pStack));
+    emit.add64(RegOp, RegSP);
+    emit.storeByte(pReg);
+    emit.aluImm(EX64Alu::SUB, RegSP, 1);
+    emit.aluImm(EX64Alu::AND, RegSP, 0xFF);
+}
+
+/*****************************************************************************/
+
+void CX64Translator::_compare(EX64Reg pReg)
+{
+    // C when register >= operand, N and Z from the difference
+    emit.mov(RegTmp, pReg);
+    emit.alu(EX64Alu::SUB, RegTmp, RegOp);
+    emit.setcc(EX64Cond::AE, RegC);
+    emit.movzx8(RegC, RegC);
+    emit.aluImm(EX64Alu::AND, RegTmp, 0xFF);
+    _setNZ(RegTmp);
+}
+
+/*****************************************************************************/
+
+void CX64Translator::_adc()
+{
+    // Binary mode only, blocks are not entered with D set
+    emit.mov(RegTmp, RegA);
+    emit.alu(EX64Alu::ADD, RegTmp, RegOp);
+    emit.alu(EX64Alu::ADD, RegTmp, RegC);
+    emit.mov(RegC, RegTmp);
+    emit.shrImm(RegC, 8);
+    // V when operands have the same sign and the result another one
+    emit.mov(RegV, RegA);
+    emit.alu(EX64Alu::XOR, RegV, RegTmp);
+    emit.alu(EX64Alu::XOR, RegOp, RegA);
+    emit.notReg(RegOp);
+    emit.alu(EX64Alu::AND, RegV, RegOp);
+    emit.shrImm(RegV, 7);
+    emit.aluImm(EX64Alu::AND, RegV, 1);
+    emit.aluImm(EX64Alu::AND, RegTmp, 0xFF);
+    emit.mov(RegA, RegTmp);
+    _setNZ(RegA);
+}
+
+/*****************************************************************************/
+
+void CX64Translator::_shift(EOp pOp)
+{
+    // Value in RegTmp
+    switch (pOp)
+    {
+        case EOp::ASL:
+            emit.mov(RegC, RegTmp);
+            emit.shrImm(RegC, 7);
+            emit.shlImm(RegTmp, 1);
+            emit.aluImm(EX64Alu::AND, RegTmp, 0xFF);
+            break;
+        case EOp::LSR:
+            emit.mov(RegC, RegTmp);
+            emit.aluImm(EX64Alu::AND, RegC, 1);
+            emit.shrImm(RegTmp, 1);
+            break;
+        case EOp::ROL:
+            emit.shlImm(RegTmp, 1);
+            emit.alu(EX64Alu::OR, RegTmp, RegC);
+            emit.mov(RegC, RegTmp);
+            emit.shrImm(RegC, 8);
+            emit.aluImm(EX64Alu::AND, RegTmp, 0xFF);
+            break;
+        default:
+            // ROR, old carry goes to bit 8 to be shifted in bit 7
+            emit.shlImm(RegC, 8);
+            emit.alu(EX64Alu::OR, RegTmp, RegC);
+            emit.mov(RegC, RegTmp);
+            emit.aluImm(EX64Alu::AND, RegC, 1);
+            emit.shrImm(RegTmp, 1);
+            break;
+    }
+    _setNZ(RegTmp);
+}
+
+/*****************************************************************************/
+
+void CX64Translator::_branch(EOp pOp, const Word& pNext, const Word& pTarget, s64 pCycles)
+{
+    EX64Cond Taken = EX64Cond::NE;
+    switch (pOp)
+    {
+        case EOp::BEQ: emit.test(RegNZ, RegNZ); Taken = EX64Cond::E; break;
+        case EOp::BNE: emit.test(RegNZ, RegNZ); Taken = EX64Cond::NE; break;
+        case EOp::BMI: emit.testImm(RegNZ, 0x80); Taken = EX64Cond::NE; break;
+        case EOp::BPL: emit.testImm(RegNZ, 0x80); Taken = EX64Cond::E; break;
+        case EOp::BCS: emit.test(RegC, RegC); Taken = EX64Cond::NE; break;
+        case EOp::BCC: emit.test(RegC, RegC); Taken = EX64Cond::E; break;
+        case EOp::BVS: emit.test(RegV, RegV); Taken = EX64Cond::NE; break;
+        default: emit.test(RegV, RegV); Taken = EX64Cond::E; break;
+    }
+    const size_t Jump = emit.jcc(Taken);
+    exit(pNext, pCycles);
+    emit.patch(Jump);
+    // Taken branch costs one cycle, one more when crossing a page
+    const bool PageChanged = (pNext ^ pTarget) & 0xFF00;
+    exit(pTarget, pCycles + 1 + (PageChanged ? 1 : 0));
+}
+
+/*****************************************************************************/
+
+bool CX64Translator::translate(const Word& pAddress, const Byte& pOpCode, const Word& pOperand, bool& pTerminal)
+{
+    const CCPU::SOpCode& Info = CCPU::OpTable[pOpCode];
+    const EOp Op = operationOf(static_cast<Ins>(pOpCode));
+    const EAddrMode Mode = Info.mode;
+    const bool Penalty = Info.penalty == EPagePenalty::PageCross;
+    const Word Next = pAddress + instructionSize(Mode);
+    const s64 After = cycles + Info.cycles;
+    pTerminal = false;
+
+    // Operand value in RegOp for read operations
+    auto Operand = [&]() -> bool
+    {
+        if (Mode == EAddrMode::Immediate)
+        {
+            emit.movImm(RegOp, pOperand & 0xFF);
+            return true;
+        }
+        if (!_address(Mode, pOperand, true, false, Penalty)) return false;
+        emit.loadByte(RegOp);
+        return true;
+    };
+    auto Load = [&](EX64Reg pReg) -> bool
+    {
+        if (!Operand()) return false;
+        emit.mov(pReg, RegOp);
+        _setNZ(pReg);
+        return true;
+    };
+    auto Store = [&](EX64Reg pReg) -> bool
+    {
+        if (!_address(Mode, pOperand, false, true, false)) return false;
+        emit.storeByte(pReg);
+        return true;
+    };
+    auto Logic = [&](EX64Alu pAlu) -> bool
+    {
+        if (!Operand()) return false;
+        emit.alu(pAlu, RegA, RegOp);
+        _setNZ(RegA);
+        return true;
+    };
+    auto Step = [&](EX64Reg pReg, EX64Alu pAlu)
+    {
+        emit.aluImm(pAlu, pReg, 1);
+        emit.aluImm(EX64Alu::AND, pReg, 0xFF);
+        _setNZ(pReg);
+    };
+    auto Transfer = [&](EX64Reg pDst, EX64Reg pSrc)
+    {
+        emit.mov(pDst, pSrc);
+        _setNZ(pDst);
+    };
+    Byte* Stack = nullptr;
+    const bool UsesStack = Op == EOp::PHA || Op == EOp::PLA ||
+        Op == EOp::JSR || Op == EOp::RTS;
+    if (UsesStack)
+    {
+        // RTS reads its word at SP + 1 with 16 bits arithmetics
+        const Word Last = Op == EOp::RTS ? 0x0201 : 0x01FF;
+        const bool Writes = Op == EOp::PHA || Op == EOp::JSR;
+        Stack = _hostRange(0x0100, Last, true, Writes);
+        if (!Stack) return false;
+        if (Writes) storePages.push_back(0x01);
+    }
+
+    switch (Op)
+    {
+        case EOp::LDA: if (!Load(RegA)) return false; break;
+        case EOp::LDX: if (!Load(RegX)) return false; break;
+        case EOp::LDY: if (!Load(RegY)) return false; break;
+        case EOp::STA: if (!Store(RegA)) return false; break;
+        case EOp::STX: if (!Store(RegX)) return false; break;
+        case EOp::STY: if (!Store(RegY)) return false; break;
+        case EOp::AND: if (!Logic(EX64Alu::AND)) return false; break;
+        case EOp::ORA: if (!Logic(EX64Alu::OR)) return false; break;
+        case EOp::EOR: if (!Logic(EX64Alu::XOR)) return false; break;
+        case EOp::ADC:
+            if (!Operand()) return false;
+            _adc();
+            break;
+        case EOp::SBC:
+            if (!Operand()) return false;
+            emit.aluImm(EX64Alu::XOR, RegOp, 0xFF);
+            _adc();
+            break;
+        case EOp::CMP: if (!Operand()) return false; _compare(RegA); break;
+        case EOp::CPX: if (!Operand()) return false; _compare(RegX); break;
+        case EOp::CPY: if (!Operand()) return false; _compare(RegY); break;
+        case EOp::INC:
+        case EOp::DEC:
+            if (!_address(Mode, pOperand, true, true, false)) return false;
+            emit.loadByte(RegTmp);
+            Step(RegTmp, Op == EOp::INC ? EX64Alu::ADD : EX64Alu::SUB);
+            emit.storeByte(RegTmp);
+            break;
+        case EOp::ASL:
+        case EOp::LSR:
+        case EOp::ROL:
+        case EOp::ROR:
+            if (Mode == EAddrMode::Accumulator)
+            {
+                emit.mov(RegTmp, RegA);
+                _shift(Op);
+                emit.mov(RegA, RegTmp);
+            }
+            else
+            {
+                if (!_address(Mode, pOperand, true, true, false)) return false;
+                emit.loadByte(RegTmp);
+                _shift(Op);
+                emit.storeByte(RegTmp);
+            }
+            break;
+        case EOp::TAX: Transfer(RegX, RegA); break;
+        case EOp::TAY: Transfer(RegY, RegA); break;
+        case EOp::TXA: Transfer(RegA, RegX); break;
+        case EOp::TYA: Transfer(RegA, RegY); break;
+        case EOp::TSX: Transfer(RegX, RegSP); break;
+        case EOp::TXS: emit.mov(RegSP, RegX); break;
+        case EOp::INX: Step(RegX, EX64Alu::ADD); break;
+        case EOp::INY: Step(RegY, EX64Alu::ADD); break;
+        case EOp::DEX: Step(RegX, EX64Alu::SUB); break;
+        case EOp::DEY: Step(RegY, EX64Alu::SUB); break;
+        case EOp::CLC: emit.movImm(RegC, 0); break;
+        case EOp::SEC: emit.movImm(RegC, 1); break;
+        case EOp::CLV: emit.movImm(RegV, 0); break;
+        case EOp::NOP: break;
+        case EOp::PHA: _push(RegA, Stack); break;
+        case EOp::PLA:
+            emit.aluImm(EX64Alu::ADD, RegSP, 1);
+            emit.aluImm(EX64Alu::AND, RegSP, 0xFF);
+            emit.movImm64(RegOp, reinterpret_cast<u64>(Stack));
+            emit.add64(RegOp, RegSP);
+            emit.loadByte(RegA);
+            _setNZ(RegA);
+            break;
+        case EOp::JMP:
+            exit(pOperand, After);
+            pTerminal = true;
+            break;
+        case EOp::JSR:
+        {
+            // Return address is the last byte of JSR
+            const Word Return = pAddress + 2;
+            emit.movImm(RegTmp, Return >> 8);
+            _push(RegTmp, Stack);
+            emit.movImm(RegTmp, Return & 0xFF);
+            _push(RegTmp, Stack);
+            exit(pOperand, After);
+            pTerminal = true;
+        } break;
+        case EOp::RTS:
+            emit.movImm64(RegOp, reinterpret_cast<u64>(Stack + 1));
+            emit.add64(RegOp, RegSP);
+            emit.loadByte(RegTmp);
+            emit.movImm64(RegOp, reinterpret_cast<u64>(Stack + 2));
+            emit.add64(RegOp, RegSP);
+            emit.loadByte(RegOp);
+            emit.shlImm(RegOp, 8);
+            emit.alu(EX64Alu::OR, RegTmp, RegOp);
+            emit.aluImm(EX64Alu::ADD, RegTmp, 1);
+            emit.aluImm(EX64Alu::AND, RegTmp, 0xFFFF);
+            emit.aluImm(EX64Alu::ADD, RegSP, 2);
+            emit.aluImm(EX64Alu::AND, RegSP, 0xFF);
+            exitDynamic(After);
+            pTerminal = true;
+            break;
+        case EOp::BEQ: case EOp::BNE: case EOp::BCS: case EOp::BCC:
+        case EOp::BMI: case EOp::BPL: case EOp::BVC: case EOp::BVS:
+        {
+            const Word Target = Next + static_cast<SByte>(pOperand & 0xFF);
+            _branch(Op, Next, Target, After);
+            maxCycles += 2;
+            pTerminal = true;
+        } break;
+        default:
+            return false;
+    }
+    cycles = After;
+    maxCycles += Info.cycles;
+    return true;
+}
+
+/*****************************************************************************/
+
+CJit::CJit(CCPU& pCPU, CBus& pBus) :
+    CBusChip(pBus, 0xFFFF, 0),
+    _cpu(pCPU),
+    _arena(nullptr),
+    _arenaUsed(0),
+    _blocks(0x10000),
+    _entries(0x10000, 0),
+    _mapGeneration(0),
+    _hotThreshold(16),
+    _stats{0, 0, 0, 0, 0}
+{
+    void* Arena = mmap(nullptr, ArenaSize, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (Arena != MAP_FAILED)
+    {
+        _arena = static_cast<Byte*>(Arena);
+    }
+    _mapGeneration = bus.getMapGeneration();
+}
+
+/*****************************************************************************/
+
+CJit::~CJit()
+{
+    for (u32 Page = 0; Page < _pageBlocks.size(); Page++)
+    {
+        if (!_pageBlocks[Page].empty())
+        {
+            bus.unwatchPage(this, static_cast<Byte>(Page));
+        }
+    }
+    if (_arena)
+    {
+        munmap(_arena, ArenaSize);
+    }
+}
+
+/*****************************************************************************/
+
+void CJit::setHotThreshold( u32 pThreshold )
+{
+    _hotThreshold = pThreshold < Cold ? pThreshold : Cold - 1;
+}
+
+/*****************************************************************************/
+
+s64 CJit::execute( s64 pCycles )
+{
+    if (_mapGeneration != bus.getMapGeneration())
+    {
+        flush();
+    }
+    CScheduler& Scheduler = bus.getScheduler();
+    s64 Remaining = pCycles;
+    SState State;
+    while (Remaining > 0)
+    {
+        // Native blocks run only when they end before the next event
+        const u64 Deadline = Scheduler.getNextDeadline();
+        const u64 ToDeadline = Deadline > Scheduler.getNow() ? Deadline - Scheduler.getNow() : 0;
+        const s64 Limit = ToDeadline < static_cast<u64>(Remaining) ? static_cast<s64>(ToDeadline) : Remaining;
+        const Word PC = _cpu.PC;
+        SNativeBlock* Block = _blocks[PC].get();
+        if (!Block && _arena && _entries[PC] != Cold && ++_entries[PC] >= _hotThreshold)
+        {
+            Block = _compile(PC);
+        }
+        // Interrupts are taken by step, before the instruction at PC
+        const u32 Interrupts = bus.getInterrupts();
+        const bool Pending = (Interrupts & (CBus::NMIEdge | CBus::ResetEdge | CBus::ResetLines)) ||
+            ((Interrupts & CBus::IRQLines) && !_cpu.Flags.I);
+        // Native code knows binary mode only, and N and Z from a single result
+        if (Block && !Pending && Block->maxCycles < Limit && !_cpu.Flags.D &&
+            !(_cpu.Flags.Z && _cpu.Flags.N))
+        {
+            State.A = _cpu.A;
+            State.X = _cpu.X;
+            State.Y = _cpu.Y;
+            State.SP = _cpu.SP;
+            State.NZ = _cpu.Flags.Z ? 0x00 : (_cpu.Flags.N ? 0x80 : 0x01);
+            State.C = _cpu.Flags.C;
+            State.V = _cpu.Flags.V;
+            const s64 Used = Block->code(&State);
+            Remaining -= Used;
+            _cpu.A = State.A;
+            _cpu.X = State.X;
+            _cpu.Y = State.Y;
+            _cpu.SP = State.SP;
+            _cpu.PC = State.PC;
+            _cpu.Flags.Z = State.NZ == 0;
+            _cpu.Flags.N = (State.NZ & 0x80) != 0;
+            _cpu.Flags.C = State.C;
+            _cpu.Flags.V = State.V;
+            _stats.nativeRuns++;
+            Scheduler.advance(static_cast<u64>(Used));
+        }
+        else
+        {
+            Remaining -= _cpu.step();
+            _stats.interpretedInstructions++;
+            // Faults, BRK and halt stop the CPU
+            if (_cpu.getStop() != EStop::Budget)
+            {
+                break;
+            }
+            if (_mapGeneration != bus.getMapGeneration())
+            {
+                flush();
+            }
+        }
+    }
+    return pCycles - Remaining;
+}
+
+/*****************************************************************************/
+
+CJit::SNativeBlock* CJit::_compile( const Word& pPC )
+{
+    const Byte* Code = bus.getReadPage(pPC);
+    if (!Code)
+    {
+        // Code from I/O is always interpreted
+        _entries[pPC] = Cold;
+        return nullptr;
+    }
+    const size_t Start = _arenaUsed;
+    if (!_protect(Start, ArenaSize, false))
+    {
+        _entries[pPC] = Cold;
+        return nullptr;
+    }
+    CX64Emitter Emit(_arena + _arenaUsed, ArenaSize - _arenaUsed);
+    CX64Translator Translator(bus, Emit, pPC);
+    Translator.prologue();
+    Word Address = pPC;
+    size_t Count = 0;
+    bool Terminal = false;
+    while (Count < MaxInstructions && !Terminal)
+    {
+        const Byte OpCode = Code[Address & 0xFF];
+        const CCPU::SOpCode& Info = CCPU::OpTable[OpCode];
+        if (!Info.legal) break;
+        const Byte Size = instructionSize(Info.mode);
+        // Blocks stay in their page, the only one watched for writes
+        if (((Address + Size - 1) >> 8) != (pPC >> 8)) break;
+        Word Operand = 0;
+        if (Size > 1) Operand = Code[(Address + 1) & 0xFF];
+        if (Size > 2) Operand |= Code[(Address + 2) & 0xFF] << 8;
+        if (!Translator.translate(Address, OpCode, Operand, Terminal)) break;
+        Address += Size;
+        Count++;
+    }
+    if (Count == 0)
+    {
+        // Older blocks sharing the first page run again
+        _protect(Start, Start, true);
+        _entries[pPC] = Cold;
+        return nullptr;
+    }
+    if (!Terminal)
+    {
+        Translator.exit(Address, Translator.cycles);
+    }
+    if (!Emit.good())
+    {
+        // Arena full, start again from an empty one
+        flush();
+        return nullptr;
+    }
+    if (!_protect(Start, Start + Emit.size(), true))
+    {
+        _entries[pPC] = Cold;
+        return nullptr;
+    }
+    _arenaUsed += Emit.size();
+    // Keep native blocks 16 bytes aligned
+    _arenaUsed = (_arenaUsed + 15) & ~static_cast<size_t>(15);
+
+    std::unique_ptr<SNativeBlock>& Block = _blocks[pPC];
+    Block = std::make_unique<SNativeBlock>();
+    Block->code = reinterpret_cast<native_block>(Emit.code());
+    Block->maxCycles = Translator.maxCycles;
+    Block->storePages = Translator.storePages;
+    for (const Byte Page : Block->storePages)
+    {
+        _pageStorers[Page].push_back(pPC);
+    }
+    const Byte CodePage = pPC >> 8;
+    if (_pageBlocks[CodePage].empty())
+    {
+        const bool MapCurrent = _mapGeneration == bus.getMapGeneration();
+        bus.watchPage(this, CodePage);
+        if (MapCurrent)
+        {
+            _mapGeneration = bus.getMapGeneration();
+        }
+        // Older blocks may store into the new code page directly
+        _invalidateStorers(CodePage);
+    }
+    _pageBlocks[CodePage].push_back(pPC);
+    _stats.compiledBlocks++;
+    return Block.get();
+}
+
+/*****************************************************************************/
+
+bool CJit::_protect( size_t pFrom, size_t pTo, bool pExecutable )
+{
+    // Whole pages, the first one may hold the end of older blocks
+    const size_t PageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t From = pFrom & ~(PageSize - 1);
+    const size_t To = (pTo + PageSize - 1) & ~(PageSize - 1);
+    if (From >= To) return true;
+    const int Protection = pExecutable ? PROT_READ | PROT_EXEC : PROT_READ | PROT_WRITE;
+    return mprotect(_arena + From, To - From, Protection) == 0;
+}
+
+/*****************************************************************************/
+
+void CJit::onWatchedWrite( const Word& pAddress )
+{
+    const bool MapCurrent = _mapGeneration == bus.getMapGeneration();
+    _invalidatePage(pAddress >> 8);
+    if (MapCurrent)
+    {
+        _mapGeneration = bus.getMapGeneration();
+    }
+}
+
+/*****************************************************************************/
+
+void CJit::_invalidatePage( const Byte& pPage )
+{
+    std::vector<Word>& Entries = _pageBlocks[pPage];
+    if (Entries.empty()) return;
+    for (const Word Entry : Entries)
+    {
+        if (_blocks[Entry])
+        {
+            _blocks[Entry].reset();
+            _stats.invalidations++;
+        }
+    }
+    Entries.clear();
+    // New code may be translated
+    std::fill(_entries.begin() + (pPage << 8), _entries.begin() + (pPage << 8) + 0x100, 0);
+    bus.unwatchPage(this, pPage);
+}
+
+/*****************************************************************************/
+
+void CJit::_invalidateStorers( const Byte& pPage )
+{
+    for (const Word Entry : _pageStorers[pPage])
+    {
+        if (_blocks[Entry])
+        {
+            _blocks[Entry].reset();
+            _stats.invalidations++;
+        }
+    }
+    _pageStorers[pPage].clear();
+}
+
+/*****************************************************************************/
+
+void CJit::flush()
+{
+    for (u32 Page = 0; Page < _pageBlocks.size(); Page++)
+    {
+        if (!_pageBlocks[Page].empty())
+        {
+            _pageBlocks[Page].clear();
+            bus.unwatchPage(this, static_cast<Byte>(Page));
+        }
+        _pageStorers[Page].clear();
+    }
+    for (auto& Block : _blocks)
+    {
+        Block.reset();
+    }
+    std::fill(_entries.begin(), _entries.end(), 0);
+    _arenaUsed = 0;
+    _mapGeneration = bus.getMapGeneration();
+    _stats.flushes++;
+}
+
+}
@@ -0,0 +1,339 @@
+/**
+ * @file X64Emitter.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include "X64Emitter.hpp"
+
+namespace m6502
+{
+
+static inline Byte regLow(EX64Reg pReg)
+{
+    return static_cast<Byte>(pReg) & 7;
+}
+
+/*****************************************************************************/
+
+static inline bool regHigh(EX64Reg pReg)
+{
+    return static_cast<Byte>(pReg) >= 8;
+}
+
+/*****************************************************************************/
+
+CX64Emitter::CX64Emitter(Byte* pBuffer, size_t pSize) :
+    _buffer(pBuffer),
+    _size(pSize),
+    _used(0),
+    _good(true)
+{
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::_byte(Byte pValue)
+{
+    if (_used < _size)
+    {
+        _buffer[_used++] = pValue;
+    }
+    else
+    {
+        _good = false;
+    }
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::_dword(u32 pValue)
+{
+    for (int Shift = 0; Shift < 32; Shift += 8)
+    {
+        _byte(static_cast<Byte>(pValue >> Shift));
+    }
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::_rex(bool pWide, EX64Reg pReg, EX64Reg pRm, bool pByteRegs)
+{
+    const Byte Rex = 0x40 | (pWide ? 0x08 : 0) |
+        (regHigh(pReg) ? 0x04 : 0) | (regHigh(pRm) ? 0x01 : 0);
+    // SPL, BPL, SIL and DIL need an empty REX to be addressed
+    const bool ByteNeedsRex = pByteRegs &&
+        ((pReg >= EX64Reg::RSP && pReg <= EX64Reg::RDI) ||
+         (pRm >= EX64Reg::RSP && pRm <= EX64Reg::RDI));
+    if (Rex != 0x40 || ByteNeedsRex)
+    {
+        _byte(Rex);
+    }
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::_modrm(Byte pMod, Byte pReg, EX64Reg pRm)
+{
+    _byte(static_cast<Byte>((pMod << 6) | ((pReg & 7) << 3) | regLow(pRm)));
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::_stateOperand(EX64Reg pReg, u32 pOffset)
+{
+    // [RDI + disp32]
+    _modrm(2, static_cast<Byte>(pReg), EX64Reg::RDI);
+    _dword(pOffset);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::movImm(EX64Reg pDst, u32 pImm)
+{
+    _rex(false, EX64Reg::RAX, pDst);
+    _byte(0xB8 + regLow(pDst));
+    _dword(pImm);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::movImm64(EX64Reg pDst, u64 pImm)
+{
+    _rex(true, EX64Reg::RAX, pDst);
+    _byte(0xB8 + regLow(pDst));
+    _dword(static_cast<u32>(pImm));
+    _dword(static_cast<u32>(pImm >> 32));
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::mov(EX64Reg pDst, EX64Reg pSrc)
+{
+    _rex(false, pSrc, pDst);
+    _byte(0x89);
+    _modrm(3, static_cast<Byte>(pSrc), pDst);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::alu(EX64Alu pOp, EX64Reg pDst, EX64Reg pSrc)
+{
+    _rex(false, pSrc, pDst);
+    _byte(static_cast<Byte>((static_cast<Byte>(pOp) << 3) | 0x01));
+    _modrm(3, static_cast<Byte>(pSrc), pDst);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::aluImm(EX64Alu pOp, EX64Reg pDst, u32 pImm)
+{
+    _rex(false, EX64Reg::RAX, pDst);
+    _byte(0x81);
+    _modrm(3, static_cast<Byte>(pOp), pDst);
+    _dword(pImm);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::add64(EX64Reg pDst, EX64Reg pSrc)
+{
+    _rex(true, pSrc, pDst);
+    _byte(0x01);
+    _modrm(3, static_cast<Byte>(pSrc), pDst);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::test(EX64Reg pDst, EX64Reg pSrc)
+{
+    _rex(false, pSrc, pDst);
+    _byte(0x85);
+    _modrm(3, static_cast<Byte>(pSrc), pDst);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::testImm(EX64Reg pDst, u32 pImm)
+{
+    _rex(false, EX64Reg::RAX, pDst);
+    _byte(0xF7);
+    _modrm(3, 0, pDst);
+    _dword(pImm);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::notReg(EX64Reg pDst)
+{
+    _rex(false, EX64Reg::RAX, pDst);
+    _byte(0xF7);
+    _modrm(3, 2, pDst);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::shlImm(EX64Reg pDst, Byte pCount)
+{
+    _rex(false, EX64Reg::RAX, pDst);
+    _byte(0xC1);
+    _modrm(3, 4, pDst);
+    _byte(pCount);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::shrImm(EX64Reg pDst, Byte pCount)
+{
+    _rex(false, EX64Reg::RAX, pDst);
+    _byte(0xC1);
+    _modrm(3, 5, pDst);
+    _byte(pCount);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::setcc(EX64Cond pCond, EX64Reg pDst)
+{
+    _rex(false, EX64Reg::RAX, pDst, true);
+    _byte(0x0F);
+    _byte(0x90 + static_cast<Byte>(pCond));
+    _modrm(3, 0, pDst);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::movzx8(EX64Reg pDst, EX64Reg pSrc)
+{
+    _rex(false, pDst, pSrc, true);
+    _byte(0x0F);
+    _byte(0xB6);
+    _modrm(3, static_cast<Byte>(pDst), pSrc);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::loadByte(EX64Reg pDst)
+{
+    // movzx dst, byte [RSI]
+    _rex(false, pDst, EX64Reg::RSI);
+    _byte(0x0F);
+    _byte(0xB6);
+    _modrm(0, static_cast<Byte>(pDst), EX64Reg::RSI);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::storeByte(EX64Reg pSrc)
+{
+    // mov byte [RSI], src
+    _rex(false, pSrc, EX64Reg::RSI, true);
+    _byte(0x88);
+    _modrm(0, static_cast<Byte>(pSrc), EX64Reg::RSI);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::loadStateByte(EX64Reg pDst, u32 pOffset)
+{
+    _rex(false, pDst, EX64Reg::RDI);
+    _byte(0x0F);
+    _byte(0xB6);
+    _stateOperand(pDst, pOffset);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::storeStateByte(u32 pOffset, EX64Reg pSrc)
+{
+    _rex(false, pSrc, EX64Reg::RDI, true);
+    _byte(0x88);
+    _stateOperand(pSrc, pOffset);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::storeStateWord(u32 pOffset, EX64Reg pSrc)
+{
+    _byte(0x66);
+    _rex(false, pSrc, EX64Reg::RDI);
+    _byte(0x89);
+    _stateOperand(pSrc, pOffset);
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::storeStateWordImm(u32 pOffset, Word pImm)
+{
+    _byte(0x66);
+    _byte(0xC7);
+    _stateOperand(EX64Reg::RAX, pOffset);
+    _byte(static_cast<Byte>(pImm));
+    _byte(static_cast<Byte>(pImm >> 8));
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::push(EX64Reg pReg)
+{
+    _rex(false, EX64Reg::RAX, pReg);
+    _byte(0x50 + regLow(pReg));
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::pop(EX64Reg pReg)
+{
+    _rex(false, EX64Reg::RAX, pReg);
+    _byte(0x58 + regLow(pReg));
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::ret()
+{
+    _byte(0xC3);
+}
+
+/*****************************************************************************/
+
+size_t CX64Emitter::jcc(EX64Cond pCond)
+{
+    _byte(0x0F);
+    _byte(0x80 + static_cast<Byte>(pCond));
+    const size_t Displacement = _used;
+    _dword(0);
+    return Displacement;
+}
+
+/*****************************************************************************/
+
+void CX64Emitter::patch(size_t pDisplacement)
+{
+    if (!_good) return;
+    const u32 Relative = static_cast<u32>(_used - (pDisplacement + 4));
+    for (int Index = 0; Index < 4; Index++)
+    {
+        _buffer[pDisplacement + Index] = static_cast<Byte>(Relative >> (Index * 8));
+    }
+}
+
+}
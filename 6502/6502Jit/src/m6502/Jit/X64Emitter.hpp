@@ -0,0 +1,170 @@
+/**
+ * @file X64Emitter.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef X64EMITTER_HPP
+#define X64EMITTER_HPP
+
+#include <m6502/Config.hpp>
+#include <stddef.h>
+
+namespace m6502
+{
+
+/**
+ * @brief x86-64 general purpose registers
+ * 
+ */
+enum class EX64Reg : Byte
+{
+    RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+/**
+ * @brief x86-64 condition codes used by jcc and setcc
+ * 
+ */
+enum class EX64Cond : Byte
+{
+    B = 0x2,    // Below, carry set
+    AE = 0x3,   // Above or equal, carry clear
+    E = 0x4,    // Equal, zero set
+    NE = 0x5    // Not equal, zero clear
+};
+
+/**
+ * @brief x86-64 integer operations with a register destination
+ *        Value is the /digit of the 0x81 immediate form
+ */
+enum class EX64Alu : Byte
+{
+    ADD = 0,
+    OR = 1,
+    AND = 4,
+    SUB = 5,
+    XOR = 6,
+    CMP = 7
+};
+
+/**
+ * @brief Minimal x86-64 machine code writer for the JIT
+ *        Only the encodings the JIT needs, 32 bits operations
+ *        unless named otherwise, memory operands are [RSI]
+ *        or [RDI + displacement]
+ */
+class CX64Emitter
+{
+public:
+    /**
+     * @brief Construct a new emitter writing into a buffer
+     * 
+     * @param pBuffer 
+     * @param pSize 
+     */
+    CX64Emitter(Byte* pBuffer, size_t pSize);
+
+    /**
+     * @brief Bytes written so far
+     * 
+     * @return size_t 
+     */
+    size_t size() const { return _used; }
+
+    /**
+     * @brief false once the buffer was too small for the code
+     * 
+     * @return bool 
+     */
+    bool good() const { return _good; }
+
+    /**
+     * @brief Start of the buffer
+     * 
+     * @return Byte* 
+     */
+    Byte* code() const { return _buffer; }
+
+    // Register moves
+    void movImm(EX64Reg pDst, u32 pImm);
+    void movImm64(EX64Reg pDst, u64 pImm);
+    void mov(EX64Reg pDst, EX64Reg pSrc);
+
+    // Integer operations
+    void alu(EX64Alu pOp, EX64Reg pDst, EX64Reg pSrc);
+    void aluImm(EX64Alu pOp, EX64Reg pDst, u32 pImm);
+    void add64(EX64Reg pDst, EX64Reg pSrc);
+    void test(EX64Reg pDst, EX64Reg pSrc);
+    void testImm(EX64Reg pDst, u32 pImm);
+    void notReg(EX64Reg pDst);
+    void shlImm(EX64Reg pDst, Byte pCount);
+    void shrImm(EX64Reg pDst, Byte pCount);
+    void setcc(EX64Cond pCond, EX64Reg pDst);
+    void movzx8(EX64Reg pDst, EX64Reg pSrc);
+
+    // Byte memory at [RSI]
+    void loadByte(EX64Reg pDst);
+    void storeByte(EX64Reg pSrc);
+
+    // Fields of the state structure at [RDI + displacement]
+    void loadStateByte(EX64Reg pDst, u32 pOffset);
+    void storeStateByte(u32 pOffset, EX64Reg pSrc);
+    void storeStateWord(u32 pOffset, EX64Reg pSrc);
+    void storeStateWordImm(u32 pOffset, Word pImm);
+
+    // Control flow
+    void push(EX64Reg pReg);
+    void pop(EX64Reg pReg);
+    void ret();
+
+    /**
+     * @brief Conditional jump with a 32 bits displacement to patch
+     * 
+     * @param pCond 
+     * @return size_t offset of the displacement for patch
+     */
+    size_t jcc(EX64Cond pCond);
+
+    /**
+     * @brief Make a jump land at the current position
+     * 
+     * @param pDisplacement offset returned by jcc
+     */
+    void patch(size_t pDisplacement);
+
+private:
+    void _byte(Byte pValue);
+    void _dword(u32 pValue);
+    void _rex(bool pWide, EX64Reg pReg, EX64Reg pRm, bool pByteRegs = false);
+    void _modrm(Byte pMod, Byte pReg, EX64Reg pRm);
+    void _stateOperand(EX64Reg pReg, u32 pOffset);
+
+    Byte* _buffer;
+    size_t _size;
+    size_t _used;
+    bool _good;
+};
+
+}
+
+#endif
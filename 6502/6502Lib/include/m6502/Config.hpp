@@ -43,4 +43,31 @@ using s64 = std::int64_t;
 static constexpr u32 MAX_MEM = 1024*64;
 }
 
+/**
+ * @brief Threaded engine needs computed goto (labels as values),
+ *        a GCC/Clang extension not available with MSVC
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define M6502_HAS_THREADED 1
+#else
+#define M6502_HAS_THREADED 0
+#endif
+
+/**
+ * @brief Keep C, Z, N and V out of PS while running, set by the
+ *        M6502_LAZY_FLAGS option for the library and its users
+ */
+#ifndef M6502_LAZY_FLAGS
+#define M6502_LAZY_FLAGS 1
+#endif
+
+/**
+ * @brief Count control flow edges in an AFL coverage map, set by the
+ *        M6502_COVERAGE option for the library and its users
+ *        Off, the CPU has no coverage code at all
+ */
+#ifndef M6502_COVERAGE
+#define M6502_COVERAGE 0
+#endif
+
 #endif
\ No newline at end of file
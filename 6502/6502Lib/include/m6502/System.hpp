@@ -28,5 +28,14 @@
 #include <m6502/Config.hpp>
 #include <m6502/System/Cpu.hpp>
 #include <m6502/System/Mem.hpp>
+#include <m6502/System/CowMem.hpp>
+#include <m6502/System/Scheduler.hpp>
+#include <m6502/System/Rom.hpp>
 #include <m6502/System/Bus.hpp>
+#include <m6502/System/StaticBus.hpp>
+#include <m6502/System/StaticMem.hpp>
+#include <m6502/System/StaticCPU.hpp>
+#include <m6502/System/Batch.hpp>
+#include <m6502/System/Lockstep.hpp>
+#include <m6502/System/Fuzz.hpp>
 #endif
\ No newline at end of file
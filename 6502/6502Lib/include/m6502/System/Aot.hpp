@@ -0,0 +1,528 @@
+/**
+ * @file Aot.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef AOT_HPP
+#define AOT_HPP
+
+#include <m6502/Config.hpp>
+#include <m6502/System/Bus.hpp>
+#include <m6502/System/Cpu.hpp>
+#include <vector>
+
+namespace m6502
+{
+
+/**
+ * @brief Helpers called by the C++ translation units written by
+ *        the M6502Aot tool, they do what the CPU instructions of
+ *        the same name do, on registers held in locals
+ * 
+ */
+namespace aot
+{
+
+/**
+ * @brief Registers and condition flags while a translated block runs
+ * 
+ */
+struct SState
+{
+    Byte A;
+    Byte X;
+    Byte Y;
+    Byte SP;
+    bool C;
+    bool Z;
+    bool N;
+    bool V;
+};
+
+/**
+ * @brief Copy the CPU registers into the state
+ * 
+ * @param pState 
+ * @param pCPU 
+ */
+inline void load( SState& pState, const CCPU& pCPU )
+{
+    pState.A = pCPU.A;
+    pState.X = pCPU.X;
+    pState.Y = pCPU.Y;
+    pState.SP = pCPU.SP;
+    pState.C = pCPU.Flags.C;
+    pState.Z = pCPU.Flags.Z;
+    pState.N = pCPU.Flags.N;
+    pState.V = pCPU.Flags.V;
+}
+
+/**
+ * @brief Copy the state back into the CPU registers
+ * 
+ * @param pState 
+ * @param pCPU 
+ */
+inline void store( const SState& pState, CCPU& pCPU )
+{
+    pCPU.A = pState.A;
+    pCPU.X = pState.X;
+    pCPU.Y = pState.Y;
+    pCPU.SP = pState.SP;
+    pCPU.Flags.C = pState.C;
+    pCPU.Flags.Z = pState.Z;
+    pCPU.Flags.N = pState.N;
+    pCPU.Flags.V = pState.V;
+}
+
+/**
+ * @brief Read the bus, directly from host memory when the page is RAM
+ * 
+ * @param pBus 
+ * @param pAddress 
+ * @return Byte 
+ */
+inline Byte read( CBus& pBus, const Word pAddress )
+{
+    const Byte* Page = pBus.getReadPage(pAddress);
+    return Page ? Page[pAddress & 0xFF] : pBus.readBusData(pAddress);
+}
+
+/**
+ * @brief Write the bus, directly to host memory when the page is RAM
+ * 
+ * @param pBus 
+ * @param pAddress 
+ * @param pData 
+ */
+inline void write( CBus& pBus, const Word pAddress, const Byte pData )
+{
+    Byte* Page = pBus.getWritePage(pAddress);
+    if (Page)
+    {
+        Page[pAddress & 0xFF] = pData;
+    }
+    else
+    {
+        pBus.writeBusData(pAddress, pData);
+    }
+}
+
+/**
+ * @brief Read a little endian word, without zero page wrap as the CPU
+ * 
+ * @param pBus 
+ * @param pAddress 
+ * @return Word 
+ */
+inline Word readWord( CBus& pBus, const Word pAddress )
+{
+    const Byte Lo = read(pBus, pAddress);
+    return static_cast<Word>(Lo | (read(pBus, pAddress + 1) << 8));
+}
+
+/**
+ * @brief Index an address, counting the extra cycle of a page crossing
+ * 
+ * @param pBase 
+ * @param pIndex 
+ * @param pExtra incremented when the page changes
+ * @return Word 
+ */
+inline Word indexed( const Word pBase, const Byte pIndex, u32& pExtra )
+{
+    const Word Address = static_cast<Word>(pBase + pIndex);
+    pExtra += ((pBase ^ Address) >> 8) ? 1 : 0;
+    return Address;
+}
+
+/**
+ * @brief Set Z and N from a result
+ * 
+ * @param pState 
+ * @param pValue 
+ */
+inline void setZN( SState& pState, const Byte pValue )
+{
+    pState.Z = pValue == 0;
+    pState.N = (pValue & CRegisters::NegativeFlagBit) != 0;
+}
+
+/**
+ * @brief Add with carry, binary mode only
+ * 
+ * @param pState 
+ * @param pOperand 
+ */
+inline void adc( SState& pState, const Byte pOperand )
+{
+    const bool AreSignBitsTheSame = !((pState.A ^ pOperand) & CRegisters::NegativeFlagBit);
+    const Word Sum = static_cast<Word>(pState.A + pOperand + (pState.C ? 1 : 0));
+    pState.A = static_cast<Byte>(Sum);
+    setZN(pState, pState.A);
+    pState.C = Sum > 0xFF;
+    pState.V = AreSignBitsTheSame && ((pState.A ^ pOperand) & CRegisters::NegativeFlagBit);
+}
+
+/**
+ * @brief Subtract with carry, binary mode only
+ * 
+ * @param pState 
+ * @param pOperand 
+ */
+inline void sbc( SState& pState, const Byte pOperand )
+{
+    adc(pState, static_cast<Byte>(~pOperand));
+}
+
+/**
+ * @brief Compare a register with an operand
+ * 
+ * @param pState 
+ * @param pRegister 
+ * @param pOperand 
+ */
+inline void compare( SState& pState, const Byte pRegister, const Byte pOperand )
+{
+    setZN(pState, static_cast<Byte>(pRegister - pOperand));
+    pState.C = pRegister >= pOperand;
+}
+
+/**
+ * @brief Test bits of A
+ * 
+ * @param pState 
+ * @param pOperand 
+ */
+inline void bit( SState& pState, const Byte pOperand )
+{
+    pState.Z = (pState.A & pOperand) == 0;
+    pState.N = (pOperand & CRegisters::NegativeFlagBit) != 0;
+    pState.V = (pOperand & CRegisters::OverflowFlagBit) != 0;
+}
+
+/**
+ * @brief Arithmetic shift left
+ * 
+ * @param pState 
+ * @param pOperand 
+ * @return Byte 
+ */
+inline Byte asl( SState& pState, const Byte pOperand )
+{
+    const Byte Result = static_cast<Byte>(pOperand << 1);
+    pState.C = (pOperand & CRegisters::NegativeFlagBit) != 0;
+    setZN(pState, Result);
+    return Result;
+}
+
+/**
+ * @brief Logical shift right
+ * 
+ * @param pState 
+ * @param pOperand 
+ * @return Byte 
+ */
+inline Byte lsr( SState& pState, const Byte pOperand )
+{
+    const Byte Result = pOperand >> 1;
+    pState.C = (pOperand & CRegisters::ZeroBit) != 0;
+    setZN(pState, Result);
+    return Result;
+}
+
+/**
+ * @brief Rotate left through carry
+ * 
+ * @param pState 
+ * @param pOperand 
+ * @return Byte 
+ */
+inline Byte rol( SState& pState, const Byte pOperand )
+{
+    const Byte Result = static_cast<Byte>((pOperand << 1) | (pState.C ? CRegisters::ZeroBit : 0));
+    pState.C = (pOperand & CRegisters::NegativeFlagBit) != 0;
+    setZN(pState, Result);
+    return Result;
+}
+
+/**
+ * @brief Rotate right through carry
+ * 
+ * @param pState 
+ * @param pOperand 
+ * @return Byte 
+ */
+inline Byte ror( SState& pState, const Byte pOperand )
+{
+    const Byte Result = static_cast<Byte>((pOperand >> 1) | (pState.C ? CRegisters::NegativeFlagBit : 0));
+    pState.C = (pOperand & CRegisters::ZeroBit) != 0;
+    setZN(pState, Result);
+    return Result;
+}
+
+/**
+ * @brief Push a byte onto the stack
+ * 
+ * @param pBus 
+ * @param pState 
+ * @param pValue 
+ */
+inline void push( CBus& pBus, SState& pState, const Byte pValue )
+{
+    write(pBus, 0x100 | pState.SP, pValue);
+    pState.SP--;
+}
+
+/**
+ * @brief Pull a byte from the stack
+ * 
+ * @param pBus 
+ * @param pState 
+ * @return Byte 
+ */
+inline Byte pull( CBus& pBus, SState& pState )
+{
+    pState.SP++;
+    return read(pBus, 0x100 | pState.SP);
+}
+
+/**
+ * @brief Push a word onto the stack, high byte first
+ * 
+ * @param pBus 
+ * @param pState 
+ * @param pValue 
+ */
+inline void pushWord( CBus& pBus, SState& pState, const Word pValue )
+{
+    push(pBus, pState, pValue >> 8);
+    push(pBus, pState, pValue & 0xFF);
+}
+
+/**
+ * @brief Pull a word from the stack, read as CCPU does without
+ *        wrapping in the stack page
+ * 
+ * @param pBus 
+ * @param pState 
+ * @return Word 
+ */
+inline Word pullWord( CBus& pBus, SState& pState )
+{
+    const Word Value = readWord(pBus, (0x100 | pState.SP) + 1);
+    pState.SP += 2;
+    return Value;
+}
+
+/**
+ * @brief Push the status register as PHP does
+ * 
+ * @param pBus 
+ * @param pState 
+ * @param pCPU I and D flags are not held by the state
+ */
+inline void pushStatus( CBus& pBus, SState& pState, const CCPU& pCPU )
+{
+    // I and D
+    Byte Status = pCPU.PS & 0b00001100;
+    Status |= pState.C ? 0b00000001 : 0;
+    Status |= pState.Z ? 0b00000010 : 0;
+    Status |= pState.V ? CRegisters::OverflowFlagBit : 0;
+    Status |= pState.N ? CRegisters::NegativeFlagBit : 0;
+    push(pBus, pState, Status | CRegisters::BreakFlagBit | CRegisters::UnusedFlagBit);
+}
+
+}
+
+/**
+ * @brief Translated basic block
+ * 
+ */
+struct SAotBlock
+{
+    /**
+     * @brief Address of the first opcode
+     * 
+     */
+    Word address;
+
+    /**
+     * @brief Cycles of the block with every possible penalty taken
+     * 
+     */
+    u32 maxCycles;
+
+    /**
+     * @brief Run the block, set PC to the next instruction
+     * 
+     * @return cycles used
+     */
+    u32 (*run)(CCPU&, CBus&);
+};
+
+/**
+ * @brief Program translated ahead of time by M6502Aot
+ * 
+ */
+struct SAotImage
+{
+    /**
+     * @brief Address the program is loaded at
+     * 
+     */
+    Word loadAddress;
+
+    /**
+     * @brief Number of bytes of the program
+     * 
+     */
+    u32 size;
+
+    /**
+     * @brief Bytes of the program the blocks were translated from
+     * 
+     */
+    const Byte* data;
+
+    /**
+     * @brief Translated blocks, sorted by address
+     * 
+     */
+    const SAotBlock* blocks;
+
+    /**
+     * @brief Number of translated blocks
+     * 
+     */
+    u32 blockCount;
+};
+
+/**
+ * @brief Counters of an ahead of time translated program
+ * 
+ */
+struct SAotStats
+{
+    /**
+     * @brief Translated blocks run
+     * 
+     */
+    u64 translatedRuns;
+
+    /**
+     * @brief Instructions run by the interpreter
+     * 
+     */
+    u64 interpretedInstructions;
+};
+
+/**
+ * @brief Runs a CPU like CCPU::execute, with the same cycle counts,
+ *        through the blocks of a translated program
+ *        PC without a translated block (indirect jump targets,
+ *        code out of the program...) is run by CCPU::step, and so
+ *        is PC while an interrupt is pending
+ *        Blocks move the clock of the bus scheduler, a block runs
+ *        only when it ends before the next deadline
+ *        Stops of step (faults with setFaultStop, halt, BRK with
+ *        setBreakStop) end the run, see CCPU::getStop. Breakpoints
+ *        and runUntil conditions are not checked
+ *
+ *        The program must not modify its own code, matchesMemory
+ *        tells if the memory still holds the translated bytes
+ */
+class CAotProgram
+{
+public:
+    /**
+     * @brief Construct a new AOT program for a CPU and its bus
+     * 
+     * @param pCPU 
+     * @param pBus bus the CPU is connected to
+     * @param pImage translated program
+     */
+    CAotProgram(CCPU& pCPU, CBus& pBus, const SAotImage& pImage);
+
+    /**
+     * @brief Execute specified number of cycles
+     * 
+     * @param pCycles 
+     * @return The real numbers cycles excecuted
+     */
+    s64 execute( s64 pCycles );
+
+    /**
+     * @brief Check the bus still holds the bytes of the program
+     * 
+     * @return true when translated blocks match the memory
+     */
+    bool matchesMemory() const;
+
+    /**
+     * @brief Get the counters
+     * 
+     * @return const SAotStats& 
+     */
+    const SAotStats& getStats() const { return _stats; }
+
+    /**
+     * @brief Reset the counters
+     * 
+     */
+    void resetStats();
+
+private:
+    /**
+     * @brief CPU run by the program
+     * 
+     */
+    CCPU& _cpu;
+
+    /**
+     * @brief Bus the CPU is connected to
+     * 
+     */
+    CBus& _bus;
+
+    /**
+     * @brief Translated program
+     * 
+     */
+    const SAotImage& _image;
+
+    /**
+     * @brief Translated block of each PC, nullptr to interpret
+     * 
+     */
+    std::vector<const SAotBlock*> _entries;
+
+    /**
+     * @brief Counters
+     * 
+     */
+    SAotStats _stats;
+};
+
+}
+
+#endif
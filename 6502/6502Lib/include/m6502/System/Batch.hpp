@@ -0,0 +1,233 @@
+/**
+ * @file Batch.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <m6502/Config.hpp>
+#include <vector>
+
+namespace m6502
+{
+
+/**
+ * @brief Condition ending the run of a batch system before its budget
+ * 
+ */
+enum class EBatchStop : Byte
+{
+    // Run the whole cycle budget
+    Budget,
+    // Stop when PC reaches stopAddress, before running the instruction
+    Address,
+    // Stop on a jump or branch to itself, as test programs end
+    Trap
+};
+
+/**
+ * @brief How the run of a batch system ended
+ * 
+ */
+enum class EBatchStatus : Byte
+{
+    // Cycle budget used
+    Budget,
+    // PC reached stopAddress
+    Address,
+    // Jump or branch to itself
+    Trap,
+    // Opcode not handled by the CPU or decimal mode, registers are
+    // the ones left by the CPU when it gave up
+    Illegal
+};
+
+/**
+ * @brief Independent system of a batch : 64KB of RAM and a CPU
+ * 
+ */
+struct SBatchSystem
+{
+    /**
+     * @brief Program as given to CCPU::loadPrg, load address first
+     * 
+     */
+    std::vector<Byte> program;
+
+    /**
+     * @brief PC after the program is loaded
+     * 
+     */
+    Word resetVector;
+
+    /**
+     * @brief Cycles given to the system
+     * 
+     */
+    s64 cycles;
+
+    /**
+     * @brief Condition ending the run before the budget
+     * 
+     */
+    EBatchStop stop;
+
+    /**
+     * @brief Address for EBatchStop::Address
+     * 
+     */
+    Word stopAddress;
+
+    /**
+     * @brief First address of the memory given back in the result
+     * 
+     */
+    Word resultAddress;
+
+    /**
+     * @brief Bytes of memory given back in the result
+     * 
+     */
+    u32 resultSize;
+};
+
+/**
+ * @brief Final state of a batch system
+ * 
+ */
+struct SBatchResult
+{
+    /**
+     * @brief How the run ended
+     * 
+     */
+    EBatchStatus status;
+
+    /**
+     * @brief Cycles used, may exceed the budget by the last instruction
+     *        Cycles of an Illegal run are only counted with a stop condition
+     * 
+     */
+    s64 cycles;
+
+    /**
+     * @brief Registers
+     * 
+     */
+    Word PC;
+    Byte SP;
+    Byte A;
+    Byte X;
+    Byte Y;
+    Byte PS;
+
+    /**
+     * @brief Memory from resultAddress, resultSize bytes
+     * 
+     */
+    std::vector<Byte> memory;
+};
+
+/**
+ * @brief Counters of the last batch run
+ * 
+ */
+struct SBatchStats
+{
+    /**
+     * @brief Threads run
+     * 
+     */
+    u32 threads;
+
+    /**
+     * @brief Systems a thread took from the queue of another one
+     * 
+     */
+    u64 steals;
+};
+
+/**
+ * @brief Run many independent systems over a pool of threads
+ *        Each thread owns a queue of systems, runs it from the front
+ *        and, once empty, steals from the back of the other queues.
+ *        Results are the ones of runSystem, whatever the threads
+ * 
+ */
+class CBatchRunner
+{
+public:
+    /**
+     * @brief Construct a new Batch Runner object
+     * 
+     * @param pThreads threads to run, 0 for one per hardware thread
+     */
+    explicit CBatchRunner( u32 pThreads = 0 );
+
+    /**
+     * @brief Run every system until its stop condition or budget
+     * 
+     * @param pSystems 
+     * @return std::vector<SBatchResult> one result per system, same order
+     */
+    std::vector<SBatchResult> run( const std::vector<SBatchSystem>& pSystems );
+
+    /**
+     * @brief Run one system on the calling thread
+     * 
+     * @param pSystem 
+     * @return SBatchResult 
+     */
+    static SBatchResult runSystem( const SBatchSystem& pSystem );
+
+    /**
+     * @brief Get the threads used by run
+     * 
+     * @return u32 
+     */
+    u32 getThreads() const;
+
+    /**
+     * @brief Get the counters of the last run
+     * 
+     * @return const SBatchStats& 
+     */
+    const SBatchStats& getStats() const;
+
+private:
+    /**
+     * @brief Threads used by run
+     * 
+     */
+    u32 _threads;
+
+    /**
+     * @brief Counters of the last run
+     * 
+     */
+    SBatchStats _stats;
+};
+
+}
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * @file BlockCache.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef BLOCKCACHE_HPP
+#define BLOCKCACHE_HPP
+
+#include <m6502/Config.hpp>
+#include <m6502/System/Bus.hpp>
+#include <m6502/System/OpCodes.hpp>
+#include <vector>
+#include <array>
+#include <memory>
+
+namespace m6502
+{
+
+class CCPU;
+
+/**
+ * @brief Instruction decoded once in a basic block
+ * 
+ */
+struct SBlockInstruction
+{
+    /**
+     * @brief Handler running the instruction on its decoded operand,
+     *        to call once PC is past the opcode
+     * 
+     */
+    void (*handler)(CCPU&, const SBlockInstruction&);
+
+    /**
+     * @brief Address of the opcode
+     * 
+     */
+    Word address;
+
+    /**
+     * @brief Operand bytes following the opcode, little endian
+     * 
+     */
+    Word operand;
+
+    /**
+     * @brief Kind of effective address the operand gives
+     * 
+     */
+    EAddrMode mode;
+
+    /**
+     * @brief Opcode byte
+     * 
+     */
+    Byte opcode;
+
+    /**
+     * @brief Number of bytes, opcode included
+     * 
+     */
+    Byte size;
+
+    /**
+     * @brief Base cycle count, opcode fetch included
+     * 
+     */
+    Byte cycles;
+};
+
+/**
+ * @brief Straight run of instructions from an entry PC up to the
+ *        first branch, JMP, JSR, RTS, RTI, BRK or illegal opcode,
+ *        or up to the end of the host memory holding the code
+ * 
+ */
+struct SBlock
+{
+    /**
+     * @brief Address of the first opcode
+     * 
+     */
+    Word start;
+
+    /**
+     * @brief Address following the last instruction
+     * 
+     */
+    Word end;
+
+    /**
+     * @brief Sum of base cycles of the instructions
+     * 
+     */
+    s64 cycles;
+
+    /**
+     * @brief Sum of cycles with every possible penalty taken
+     * 
+     */
+    s64 maxCycles;
+
+    /**
+     * @brief Decoded instructions in execution order
+     * 
+     */
+    std::vector<SBlockInstruction> instructions;
+};
+
+/**
+ * @brief Counters of the block cache
+ * 
+ */
+struct SBlockCacheStats
+{
+    /**
+     * @brief Lookups answered by a decoded block
+     * 
+     */
+    u64 hits;
+
+    /**
+     * @brief Lookups which needed to decode a block
+     * 
+     */
+    u64 misses;
+
+    /**
+     * @brief Blocks dropped because their code was written
+     * 
+     */
+    u64 invalidations;
+
+    /**
+     * @brief Ratio of hits over lookups
+     * 
+     * @return double 
+     */
+    double hitRate() const
+    {
+        const u64 Lookups = hits + misses;
+        return Lookups ? static_cast<double>(hits) / Lookups : 0.0;
+    }
+};
+
+/**
+ * @brief Cache of decoded basic blocks keyed by entry PC
+ *        Pages holding a block are watched on the bus, a write on
+ *        one of them drops the blocks covering it
+ */
+class CBlockCache
+{
+public:
+    /**
+     * @brief Construct a new Block Cache object
+     * 
+     * @param pBus 
+     * @param pWatcher chip notified by the bus of writes on code pages
+     */
+    CBlockCache(CBus& pBus, CBusChip* pWatcher);
+
+    /**
+     * @brief Destroy the Block Cache object
+     * 
+     */
+    ~CBlockCache();
+
+    /**
+     * @brief Get the block starting at PC, decode it on first use
+     *        Empty when PC is not in host memory, the instruction
+     *        must then be run from the bus
+     *        Blocks are dropped when the bus pages are mapped again
+     * 
+     * @param pPC 
+     * @return const SBlock& 
+     */
+    const SBlock& lookup(const Word& pPC);
+
+    /**
+     * @brief Drop the blocks covering a page
+     * 
+     * @param pPage high byte of the page address
+     */
+    void invalidatePage(const Byte& pPage);
+
+    /**
+     * @brief Drop every block
+     * 
+     */
+    void clear();
+
+    /**
+     * @brief Get the counters
+     * 
+     * @return const SBlockCacheStats& 
+     */
+    const SBlockCacheStats& getStats() const { return _stats; }
+
+    /**
+     * @brief Reset the counters
+     * 
+     */
+    void resetStats();
+
+    /**
+     * @brief Changes each time blocks are dropped, a running block
+     *        must be left when it differs from the value at its entry
+     * 
+     * @return u64 
+     */
+    u64 getGeneration() const { return _generation; }
+
+    /**
+     * @brief Decode the block starting at PC without caching it,
+     *        from the host memory of the bus pages only as chips
+     *        reads may have side effects. Empty when the first
+     *        instruction is not in host memory
+     * 
+     * @param pBus 
+     * @param pPC 
+     * @return SBlock 
+     */
+    static SBlock decode(CBus& pBus, const Word& pPC);
+
+    /**
+     * @brief Max instructions in a block
+     * 
+     */
+    static constexpr size_t MaxInstructions = 64;
+
+private:
+    /**
+     * @brief Bus read to decode and watched for writes
+     * 
+     */
+    CBus& _bus;
+
+    /**
+     * @brief Chip registered as page watcher
+     * 
+     */
+    CBusChip* _watcher;
+
+    /**
+     * @brief Decoded block of each entry PC, allocated on first lookup
+     * 
+     */
+    std::vector<std::unique_ptr<SBlock>> _blocks;
+
+    /**
+     * @brief Entry PC of the blocks covering each page
+     * 
+     */
+    std::array<std::vector<Word>,256> _pageBlocks;
+
+    /**
+     * @brief Dropped blocks, kept alive until next lookup
+     *        as the CPU may still be running one of them
+     */
+    std::vector<std::unique_ptr<SBlock>> _retired;
+
+    /**
+     * @brief Counters
+     * 
+     */
+    SBlockCacheStats _stats;
+
+    /**
+     * @brief Blocks drop counter
+     * 
+     */
+    u64 _generation;
+
+    /**
+     * @brief Block given for code outside host memory
+     * 
+     */
+    static const SBlock Uncached;
+};
+
+}
+
+#endif
@@ -26,8 +26,11 @@
 #define BUS_HPP
 
 #include <m6502/Config.hpp>
+#include <m6502/System/Scheduler.hpp>
 #include <vector>
+#include <array>
 #include <algorithm>
+#include <atomic>
 
 namespace m6502
 {
@@ -82,6 +85,147 @@ class CBusChip
          */
         virtual Byte onReadBusData(const Word&){return 0;};
 
+        /**
+         * @brief Host memory the bus can read directly for a page
+         *        instead of calling onReadBusData
+         * 
+         * @return const Byte* 256 bytes of the page at given offset
+         *         (relative to bank), nullptr to be called on each read
+         */
+        virtual const Byte* onMapReadPage(const Word&){return nullptr;};
+
+        /**
+         * @brief Host memory the bus can write directly for a page
+         *        instead of calling onWriteBusData
+         * 
+         * @return Byte* 256 bytes of the page at given offset
+         *         (relative to bank), nullptr to be called on each write
+         */
+        virtual Byte* onMapWritePage(const Word&){return nullptr;};
+
+        /**
+         * @brief Write Event from Bus on a page watched by the chip
+         *        Called after the data has been written
+         * 
+         */
+        virtual void onWatchedWrite(const Word&){};
+
+        /**
+         * @brief Write Event from Bus in the range trapped by the chip
+         *        Called after the data has been written
+         * 
+         */
+        virtual void onTrappedWrite(const Word&){};
+
+        /**
+         * @brief Tell if reading an address has no side effect and gives
+         *        the same value until the chip is written or the CPU
+         *        leaves execute, so a CPU polling it may skip ahead
+         * 
+         * @return true when reads are stable
+         */
+        virtual bool onStableRead(const Word&){return false;};
+
+        /**
+         * @brief Bytes of state the chip saves in a snapshot of the bus,
+         *        always the same for a chip
+         * 
+         * @return u32 
+         */
+        virtual u32 onStateSize() const {return 0;};
+
+        /**
+         * @brief Save the state of the chip, onStateSize bytes
+         * 
+         */
+        virtual void onSaveState(Byte*) const {};
+
+        /**
+         * @brief Load the state saved by onSaveState, in place
+         * 
+         */
+        virtual void onLoadState(const Byte*) {};
+
+        /**
+         * @brief Save a value of the state, least significant byte first
+         * 
+         * @param pState 
+         * @param pValue 
+         * @return Byte* past the value
+         */
+        template<class T> static Byte* _saveState(Byte* pState, const T& pValue)
+        {
+            for (u32 Index = 0; Index < sizeof(T); Index++)
+            {
+                *pState++ = static_cast<Byte>(static_cast<u64>(pValue) >> (Index * 8));
+            }
+            return pState;
+        }
+
+        /**
+         * @brief Load a value saved by _saveState
+         * 
+         * @param pState 
+         * @param pValue 
+         * @return const Byte* past the value
+         */
+        template<class T> static const Byte* _loadState(const Byte* pState, T& pValue)
+        {
+            u64 Value = 0;
+            for (u32 Index = 0; Index < sizeof(T); Index++)
+            {
+                Value |= static_cast<u64>(*pState++) << (Index * 8);
+            }
+            pValue = static_cast<T>(Value);
+            return pState;
+        }
+
+        /**
+         * @brief Ask the bus to decode again the pages of the chip
+         *        Needed when mapped host memory changes
+         * 
+         */
+        void _remap();
+
+        /**
+         * @brief Ask the bus to map again one page of the chip
+         *        Needed when mapped host memory of the page changes
+         * 
+         * @param pOffset address of the page, relative to bank
+         */
+        void _remapPage(const Word& pOffset);
+
+        /**
+         * @brief Hold or release the IRQ line of the bus
+         * 
+         * @param pAsserted 
+         */
+        void _setIRQ(bool pAsserted);
+
+        /**
+         * @brief Hold or release the NMI line of the bus, the CPU
+         *        is interrupted when the line gets held
+         * 
+         * @param pAsserted 
+         */
+        void _setNMI(bool pAsserted);
+
+        /**
+         * @brief Hold or release the RESET line of the bus, the CPU
+         *        waits while the line is held and resets once released
+         * 
+         * @param pAsserted 
+         */
+        void _setReset(bool pAsserted);
+
+        /**
+         * @brief Interrupt lines held by the chip
+         * 
+         */
+        bool _irq = false;
+        bool _nmi = false;
+        bool _reset = false;
+
         /**
          * @brief Bus Parent
          * 
@@ -106,6 +250,51 @@ class CBusChip
 
 typedef std::vector<CBusChip*> v_buschips;
 
+/**
+ * @brief Decoded owner of a 256 bytes page of the address space
+ * 
+ */
+struct SBusPage
+{
+    /**
+     * @brief Host memory for reads, nullptr to call readChip
+     * 
+     */
+    const Byte* read;
+
+    /**
+     * @brief Host memory for writes, nullptr to call writeChip
+     * 
+     */
+    Byte* write;
+
+    /**
+     * @brief Chip answering reads on the whole page
+     * 
+     */
+    CBusChip* readChip;
+
+    /**
+     * @brief Only chip receiving writes on the whole page
+     * 
+     */
+    CBusChip* writeChip;
+
+    /**
+     * @brief Page needs the linear scan of chips when no chip is set:
+     *        chips decoding less than a page or several writers
+     * 
+     */
+    bool scan;
+
+    /**
+     * @brief Some chips watch writes on the page or a write trap
+     *        covers it, writes never use host memory directly
+     * 
+     */
+    bool watched;
+};
+
 
 /**
  * @brief Link chips on a data bus
@@ -122,7 +311,7 @@ class CBus
          * @brief Construct a new CBus object
          * 
          */
-        CBus(){};
+        CBus();
 
         /**
          * @brief Destroy the CBus object
@@ -159,6 +348,197 @@ class CBus
          */
         Byte readBusData(const Word& pAddress);
 
+        /**
+         * @brief Get host memory to read the page of address directly
+         * 
+         * @param pAddress 
+         * @return const Byte* 256 bytes of the page, nullptr when
+         *         the page must be read with readBusData
+         */
+        const Byte* getReadPage(const Word& pAddress) const { return _pages[pAddress >> 8].read; }
+
+        /**
+         * @brief Get host memory to write the page of address directly
+         * 
+         * @param pAddress 
+         * @return Byte* 256 bytes of the page, nullptr when
+         *         the page must be written with writeBusData
+         */
+        Byte* getWritePage(const Word& pAddress) const { return _pages[pAddress >> 8].write; }
+
+        /**
+         * @brief Notify a chip of each write on a page
+         *        The page is written through writeBusData until unwatched
+         * 
+         * @param pWatcher 
+         * @param pPage high byte of the page address
+         */
+        void watchPage(CBusChip* pWatcher, const Byte& pPage);
+
+        /**
+         * @brief Stop notifying a chip of the writes on a page
+         * 
+         * @param pWatcher 
+         * @param pPage high byte of the page address
+         */
+        void unwatchPage(CBusChip* pWatcher, const Byte& pPage);
+
+        /**
+         * @brief Notify a chip of each write in an address range, the
+         *        pages of the range being written through writeBusData
+         *        One trap per bus, replacing the previous one
+         * 
+         * @param pChip 
+         * @param pFirst first address of the range
+         * @param pLast last address of the range
+         */
+        void trapWrites(CBusChip* pChip, const Word& pFirst, const Word& pLast);
+
+        /**
+         * @brief Remove the write trap, its pages go back to direct writes
+         * 
+         */
+        void untrapWrites();
+
+        /**
+         * @brief Changes each time the host memory given by getReadPage
+         *        or getWritePage may have changed
+         * 
+         * @return u64 
+         */
+        u64 getMapGeneration() const { return _mapGeneration; }
+
+        /**
+         * @brief Interrupt lines state : chips holding each line,
+         *        and the NMI and RESET edges waiting for the CPU
+         * 
+         */
+        static constexpr u32 IRQLines = 0x000000FF;
+        static constexpr u32 NMILines = 0x0000FF00;
+        static constexpr u32 ResetLines = 0x00FF0000;
+        static constexpr u32 NMIEdge = 0x01000000;
+        static constexpr u32 ResetEdge = 0x02000000;
+
+        /**
+         * @brief Hold the IRQ line, it stays held until each
+         *        holder released it
+         * 
+         */
+        void assertIRQ() { _changeLine(IRQLines, 0x000001, true); }
+
+        /**
+         * @brief Release the IRQ line
+         * 
+         */
+        void releaseIRQ() { _changeLine(IRQLines, 0x000001, false); }
+
+        /**
+         * @brief Hold the NMI line, the CPU is interrupted
+         *        when no one held it before
+         * 
+         */
+        void assertNMI();
+
+        /**
+         * @brief Release the NMI line
+         * 
+         */
+        void releaseNMI() { _changeLine(NMILines, 0x000100, false); }
+
+        /**
+         * @brief Hold the RESET line, the CPU waits until released
+         * 
+         */
+        void assertReset() { _changeLine(ResetLines, 0x010000, true); }
+
+        /**
+         * @brief Release the RESET line, the CPU resets when
+         *        the last holder released it
+         * 
+         */
+        void releaseReset();
+
+        /**
+         * @brief Get the interrupt lines state, zero when the CPU
+         *        has nothing to do. Lines may be held from any thread
+         * 
+         * @return u32 
+         */
+        u32 getInterrupts() const { return _interrupts.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Clear NMIEdge or ResetEdge once the CPU handled it
+         * 
+         * @param pEdge 
+         */
+        void acknowledgeInterrupt(u32 pEdge) { _interrupts.fetch_and(~pEdge, std::memory_order_acq_rel); }
+
+        /**
+         * @brief Get the device events of the system, fired by the CPU
+         *        while it runs
+         * 
+         * @return CScheduler& 
+         */
+        CScheduler& getScheduler() { return _scheduler; }
+
+        /**
+         * @brief Tell if reading an address gives the same value, without
+         *        side effect, as long as nothing writes the bus
+         *        Host memory pages always do, chips decide otherwise
+         * 
+         * @param pAddress 
+         * @return true when reads are stable
+         */
+        bool isStableRead(const Word& pAddress);
+
+        /**
+         * @brief First bytes of a snapshot, "M65S" read as little endian
+         * 
+         */
+        static constexpr u32 SnapshotMagic = 0x5335364D;
+
+        /**
+         * @brief Format of the snapshots written, changed with their layout
+         * 
+         */
+        static constexpr Word SnapshotVersion = 1;
+
+        /**
+         * @brief Save the state of every chip, CPU included, in a blob:
+         *        magic, version, chip count, then the size and state of
+         *        each chip in connection order
+         *        The blob is reused, no allocation once big enough
+         * 
+         * @param pBlob 
+         */
+        void snapshot(std::vector<Byte>& pBlob) const;
+
+        /**
+         * @brief Save the state of every chip in a new blob
+         * 
+         * @return std::vector<Byte> 
+         */
+        std::vector<Byte> snapshot() const;
+
+        /**
+         * @brief Load in place a blob saved by snapshot, from this bus or
+         *        another one with the same chips connected in the same order
+         *        Nothing is loaded unless the whole blob matches the chips
+         * 
+         * @param pBlob 
+         * @param pSize 
+         * @return true when restored
+         */
+        bool restore(const Byte* pBlob, size_t pSize);
+
+        /**
+         * @brief Load in place a blob saved by snapshot
+         * 
+         * @param pBlob 
+         * @return true when restored
+         */
+        bool restore(const std::vector<Byte>& pBlob);
+
     private:
         /**
          * @brief Vector contain list of chips connected on bus
@@ -166,6 +546,103 @@ class CBus
          */
         v_buschips _chips;
 
+        /**
+         * @brief Page map rebuilt each time a chip connects or disconnects
+         * 
+         */
+        std::array<SBusPage,256> _pages;
+
+        /**
+         * @brief Chips watching writes, for each page
+         * 
+         */
+        std::array<v_buschips,256> _watchers;
+
+        /**
+         * @brief Pages of the write trap, one bit each
+         * 
+         */
+        std::array<u64,4> _trapPages;
+
+        /**
+         * @brief Chip notified of the trapped writes, nullptr without trap
+         * 
+         */
+        CBusChip* _trapChip;
+
+        /**
+         * @brief Address range of the write trap
+         * 
+         */
+        Word _trapFirst;
+        Word _trapLast;
+
+        /**
+         * @brief Page map changes counter
+         * 
+         */
+        u64 _mapGeneration;
+
+        /**
+         * @brief Device events of the system
+         * 
+         */
+        CScheduler _scheduler;
+
+        /**
+         * @brief Interrupt lines state, see getInterrupts
+         * 
+         */
+        std::atomic<u32> _interrupts;
+
+        /**
+         * @brief Count one more or one less holder of a line, the
+         *        counter stays in 0..255 and never spills on its
+         *        neighbours when holds and releases do not match
+         * 
+         * @param pLines counter mask of the line
+         * @param pOne one holder in the counter
+         * @param pHold 
+         * @return u32 lines state before the change
+         */
+        u32 _changeLine(u32 pLines, u32 pOne, bool pHold);
+
+        /**
+         * @brief Update the watched state of a page and its direct writes
+         * 
+         * @param pPage 
+         */
+        void _updateWatch(const Byte& pPage);
+
+        /**
+         * @brief Decode again the page map from connected chips
+         * 
+         */
+        void _rebuildPages();
+
+        /**
+         * @brief Map again the host memory of a page from its chips
+         * 
+         * @param pPage 
+         */
+        void _remapPage(const Byte& pPage);
+
+        /**
+         * @brief Write data to every chip in range of address
+         * 
+         * @param pAddress 
+         * @param pData 
+         */
+        void _scanWrite(const Word& pAddress, const Byte& pData);
+
+        /**
+         * @brief Read data from the first chip in range of address
+         * 
+         * @param pAddress 
+         * @return Byte 
+         */
+        Byte _scanRead(const Word& pAddress);
+
         /**
          * @brief Called by Chips to connect on bus events
          * 
@@ -0,0 +1,2017 @@
+/**
+ * @file CPUCore.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef CPUCORE_HPP
+#define CPUCORE_HPP
+
+#include <m6502/Config.hpp>
+#include <m6502/System/Bus.hpp>
+#include <m6502/System/Registers.hpp>
+#include <m6502/System/OpCodes.hpp>
+#include <stdio.h>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace m6502
+{
+
+/**
+ * @brief Tag type selecting the body of an instruction
+ * 
+ */
+template<Ins I> using SIns = std::integral_constant<Ins, I>;
+
+/**
+ * @brief Operand source of an instruction : the bytes following
+ *        the opcode, fetched from the bus
+ * 
+ */
+struct SFetched {};
+
+/**
+ * @brief Operand source of an instruction : operand decoded beforehand,
+ *        by the block cache, PC and cycles are charged as if fetched
+ * 
+ */
+struct SDecoded
+{
+    Word operand;
+};
+
+/**
+ * @brief Fault stopping a CPU whose faults do not throw, see setFaultStop
+ * 
+ */
+enum class EFault : Byte
+{
+    // No fault
+    None,
+    // Opcode not handled by the CPU, PC is its address
+    Illegal,
+    // ADC or SBC with the decimal flag set, not handled
+    Decimal,
+    // Push with the stack full, SP wrapped from 0x00 to 0xFF
+    StackOverflow,
+    // Pull with the stack empty, SP wrapped from 0xFF to 0x00
+    StackUnderflow
+};
+
+/**
+ * @brief Why a run of the CPU stopped
+ * 
+ */
+enum class EStop : Byte
+{
+    // Cycles used
+    Budget,
+    // Fault, see EFault
+    Fault,
+    // BRK reached with setBreakStop, not run
+    Break,
+    // Breakpoint reached, its instruction not run
+    Breakpoint,
+    // halt called while running
+    Halt,
+    // Condition of a runUntil met
+    Condition
+};
+
+/**
+ * @brief Result of CCPUCore::run
+ * 
+ */
+struct SExecResult
+{
+    /**
+     * @brief Cycles used
+     * 
+     */
+    s64 cycles;
+
+    /**
+     * @brief Instructions run to their end
+     * 
+     */
+    u64 instructions;
+
+    /**
+     * @brief Why the run stopped
+     * 
+     */
+    EStop stop;
+
+    /**
+     * @brief Fault when stop is Fault, None otherwise
+     * 
+     */
+    EFault fault;
+
+    /**
+     * @brief PC when the run stopped : address of the opcode not run
+     *        for Break, Breakpoint, Illegal faults and the PC, return
+     *        and predicate conditions, PC inside the instruction
+     *        raising the stop for the others
+     * 
+     */
+    Word PC;
+};
+
+/**
+ * @brief Registers, addressing modes and instructions of the 6502,
+ *        shared by the CPUs whatever the bus type
+ *        TBus gives readBusData and writeBusData, called directly
+ *        so a bus known at compile time is inlined in the instructions
+ *        TCPU is the CPU deriving from the core, it gets _onJump and
+ *        _onBranchNotTaken calls
+ * 
+ * @tparam TCPU 
+ * @tparam TBus 
+ */
+template<class TCPU, class TBus>
+class CCPUCore : public CRegisters
+{
+public:
+    /**
+     * @brief Load program in memory
+     * 
+     * @param Program 
+     * @param NumBytes 
+     * @return the address that the rogram was loading into, or 0 if no program 
+     * 
+     * This method handle a Byte array containing programm.
+     * The 2 first Bytes contain the memory address where
+     * Load the program
+     */
+    Word loadPrg( const Byte* pProgram, u32 pNumBytes);
+
+    /**
+     * @brief Get the stack pointer
+     * 
+     * @return the stack pointer as a full 16-bit address (in the 1st page) 
+     */
+    Word SPToAddress() const;
+
+    /**
+     * @brief Stop execute on a fault instead of throwing, the fault
+     *        being given by getFault. Stack wraps are faults too
+     *        Off by default
+     * 
+     * @param pEnabled 
+     */
+    void setFaultStop( bool pEnabled ) { _faultStop = pEnabled; }
+
+    /**
+     * @brief Tell if faults stop execute instead of throwing
+     * 
+     * @return true 
+     */
+    bool getFaultStop() const { return _faultStop; }
+
+    /**
+     * @brief Get the fault which stopped the last execute or step
+     * 
+     * @return EFault 
+     */
+    EFault getFault() const { return _fault; }
+
+    /**
+     * @brief Get why the last execute or step stopped
+     * 
+     * @return EStop
+     */
+    EStop getStop() const { return _stop; }
+
+    /**
+     * @brief Execute specified number of cycles without ever throwing,
+     *        illegal opcodes and decimal mode stop the run as faults
+     *        Stack wraps are faults only with setFaultStop
+     * 
+     * @param pCycles
+     * @return SExecResult
+     */
+    SExecResult run( s64 pCycles );
+
+    /**
+     * @brief Stop on BRK instead of running it, PC being left on it
+     *        Off by default
+     * 
+     * @param pEnabled
+     */
+    void setBreakStop( bool pEnabled ) { _breakStop = pEnabled; }
+
+    /**
+     * @brief Tell if BRK stops the CPU
+     * 
+     * @return true
+     */
+    bool getBreakStop() const { return _breakStop; }
+
+    /**
+     * @brief Stop execute before the instruction at an address,
+     *        unless it is the first one of the run so a stopped CPU
+     *        can go on. step does not stop
+     * 
+     * @param pAddress
+     */
+    void setBreakpoint( Word pAddress );
+
+    /**
+     * @brief Remove the breakpoint at an address
+     * 
+     * @param pAddress
+     */
+    void clearBreakpoint( Word pAddress );
+
+    /**
+     * @brief Remove all the breakpoints, the engines go back to
+     *        running without checking PC
+     * 
+     */
+    void clearBreakpoints();
+
+    /**
+     * @brief Tell if there is a breakpoint at an address
+     * 
+     * @param pAddress
+     * @return true
+     */
+    bool isBreakpoint( Word pAddress ) const;
+
+    /**
+     * @brief Stop execute after the current instruction, to be called
+     *        while running (e.g. by a chip on a bus access), from the
+     *        thread running the CPU
+     * 
+     */
+    void halt() { _raiseStop( EStop::Halt ); }
+
+    /**
+     * @brief Get the instructions run since the CPU was built,
+     *        the ones run natively by the JIT are not counted
+     * 
+     * @return u64
+     */
+    u64 getInstructions() const { return _instructions; }
+
+    /**
+     * @brief Run until PC reaches an address, before its instruction
+     *        The instruction at PC when called is always run
+     * 
+     * @param pAddress 
+     * @param pCycles most cycles to run
+     * @return SExecResult stop is Condition when reached
+     */
+    SExecResult runUntilPC( Word pAddress, s64 pCycles );
+
+    /**
+     * @brief Run until SP is back up to a stack depth, as after the
+     *        RTS of a subroutine: from a JSR, runUntilReturn( SP )
+     *        runs the whole call. The first instruction is always run
+     * 
+     * @param pSP 
+     * @param pCycles most cycles to run
+     * @return SExecResult stop is Condition when returned
+     */
+    SExecResult runUntilReturn( Byte pSP, s64 pCycles );
+
+    /**
+     * @brief Run until a predicate on the CPU is true, checked before
+     *        each instruction by every engine. The first instruction
+     *        is always run
+     * 
+     * @param pPredicate 
+     * @param pCycles most cycles to run
+     * @return SExecResult stop is Condition when true
+     */
+    SExecResult runUntil( const std::function<bool(const TCPU&)>& pPredicate, s64 pCycles );
+
+#if M6502_COVERAGE
+    /**
+     * @brief Bytes of the edge coverage map, the one of AFL
+     * 
+     */
+    static constexpr u32 CoverageMapSize = 0x10000;
+
+    /**
+     * @brief Count the edges taken by branches, jumps, JSR, RTS, BRK and
+     *        RTI in a hit count map, as AFL instrumentation does:
+     *        map[location(target) ^ previous]++, previous being
+     *        location(target) >> 1, location the hash of AFL QEMU mode
+     *        The map may be the shared memory of a fuzzer
+     * 
+     * @param pMap CoverageMapSize bytes, nullptr to stop counting
+     */
+    void setCoverageMap( Byte* pMap ) { _coverage = pMap; _coveragePrevious = 0; }
+
+    /**
+     * @brief Forget the previous location, as at the start of each
+     *        run of a fuzzer input
+     * 
+     */
+    void resetCoveragePrevious() { _coveragePrevious = 0; }
+#endif
+
+protected:
+    /**
+     * @brief Construct a new CPU core on a bus
+     * 
+     * @param pBus 
+     */
+    explicit CCPUCore( TBus& pBus );
+
+    /**
+     * @brief Construct a new CPU core, copy of another one
+     * 
+     * @param pCopy 
+     */
+    CCPUCore( const CCPUCore& pCopy ) = default;
+
+    /**
+     * @brief Bus the CPU reads and writes
+     * 
+     */
+    TBus& _bus;
+
+    /**
+     * @brief Put the registers in their power on state
+     * 
+     * @param pResetVector start PC
+     */
+    void _resetRegisters( const Word& pResetVector );
+
+    /**
+     * @brief The CPU deriving from the core
+     * 
+     * @return TCPU& 
+     */
+    TCPU& _self() { return static_cast<TCPU&>( *this ); }
+
+    /**
+     * @brief Execute one instruction, its opcode being already fetched
+     *        One overload for each Ins value, in Instructions.inl
+     *        Operand comes from pOperand, SFetched or SDecoded
+     * 
+     */
+#define M6502_OP( Name, Mode, Cycles, Penalty ) \
+    template<class TOperand> void _ins( SIns<Ins::Name>, TOperand pOperand );
+#include <m6502/System/OpTable.inl>
+
+    /**
+     * @brief Run the cycles with the switch engine
+     * 
+     * @tparam Watch check the breakpoints before each instruction
+     */
+    template<bool Watch> void _executeSwitch();
+
+    /**
+     * @brief Run the cycles with the threaded engine
+     * 
+     * @tparam Watch check the breakpoints before each instruction
+     */
+    template<bool Watch> void _executeThreaded();
+
+    /**
+     * @brief Report an opcode not handled by the CPU
+     * 
+     * @param pOpCode 
+     */
+    void _illegal( Byte pOpCode );
+
+    /**
+     * @brief Cycles counter down for Execution
+     *        process
+     * 
+     */
+    s64 _cycles;
+
+    /**
+     * @brief Faults stop execute instead of throwing
+     * 
+     */
+    bool _faultStop;
+
+    /**
+     * @brief Illegal opcodes and decimal mode stop instead of
+     *        throwing, set during run
+     * 
+     */
+    bool _noThrow;
+
+    /**
+     * @brief BRK stops the CPU
+     * 
+     */
+    bool _breakStop;
+
+    /**
+     * @brief Why the last run stopped
+     * 
+     */
+    EStop _stop;
+
+    /**
+     * @brief Fault which stopped the last run
+     * 
+     */
+    EFault _fault;
+
+    /**
+     * @brief PC when the stop was raised
+     * 
+     */
+    Word _stopPC;
+
+    /**
+     * @brief Cycles left when the stop was raised, the cycles
+     *        counter being zeroed to stop the engine
+     * 
+     */
+    s64 _stopCycles;
+
+    /**
+     * @brief Instructions run since the CPU was built
+     * 
+     */
+    u64 _instructions;
+
+    /**
+     * @brief Instructions counter at the start of the last run
+     * 
+     */
+    u64 _runInstructions;
+
+    /**
+     * @brief One bit per address holding a breakpoint or the address
+     *        of runUntilPC, empty until one is set
+     * 
+     */
+    std::vector<u64> _breakpoints;
+
+    /**
+     * @brief Breakpoints set, the engines check PC when not zero
+     * 
+     */
+    u32 _breakpointCount;
+
+    /**
+     * @brief runUntilPC is running, to _untilPC
+     * 
+     */
+    bool _untilPCArmed;
+    Word _untilPC;
+
+    /**
+     * @brief runUntilReturn is running, to _untilSP
+     * 
+     */
+    bool _untilSPArmed;
+    Byte _untilSP;
+
+    /**
+     * @brief Predicate of runUntil while running, empty otherwise
+     * 
+     */
+    std::function<bool(const TCPU&)> _untilPredicate;
+
+    /**
+     * @brief Tell if the engines have something to check before
+     *        the instructions
+     * 
+     * @return true 
+     */
+    bool _watching() const
+    {
+        return _breakpointCount || _untilSPArmed || _untilPredicate;
+    }
+
+    /**
+     * @brief Stop the engine after the current instruction
+     * 
+     * @param pStop 
+     */
+    void _raiseStop( EStop pStop )
+    {
+        if ( _stop == EStop::Budget )
+        {
+            _stop = pStop;
+            _stopPC = PC;
+            _stopCycles = _cycles;
+            _cycles = 0;
+        }
+    }
+
+    /**
+     * @brief Stop the engine after the current instruction on a fault
+     * 
+     * @param pFault 
+     */
+    void _raiseFault( EFault pFault )
+    {
+        if ( _stop == EStop::Budget )
+        {
+            _fault = pFault;
+            _raiseStop( EStop::Fault );
+        }
+    }
+
+    /**
+     * @brief Give back the fetch of an opcode which is not run
+     * 
+     */
+    void _unfetch()
+    {
+        PC--;
+        _instructions--;
+    }
+
+    /**
+     * @brief Enter an IRQ or NMI handler, 7 cycles like BRK but
+     *        PC is pushed as is and B is clear on the stack
+     * 
+     * @param pVector 
+     */
+    void _interrupt( Word pVector );
+
+    /**
+     * @brief Stop on a breakpoint or a runUntil condition before the
+     *        instruction at PC, but for the first one of the run
+     * 
+     * @return true when stopped
+     */
+    bool _watchStop()
+    {
+        if ( _instructions == _runInstructions ) return false;
+        if ( !_breakpoints.empty() && ((_breakpoints[PC >> 6] >> (PC & 63)) & 1) )
+        {
+            _raiseStop( _untilPCArmed && PC == _untilPC ? EStop::Condition : EStop::Breakpoint );
+            return true;
+        }
+        if ( _untilSPArmed && SP >= _untilSP )
+        {
+            _raiseStop( EStop::Condition );
+            return true;
+        }
+        if ( _untilPredicate )
+        {
+            // The predicate sees the lazy flags too
+            _storeFlags();
+            if ( _untilPredicate( _self() ) )
+            {
+                _raiseStop( EStop::Condition );
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Start a run of execute or step
+     * 
+     * @param pCycles 
+     */
+    void _startRun( s64 pCycles )
+    {
+        _cycles = pCycles;
+        _stop = EStop::Budget;
+        _fault = EFault::None;
+        _runInstructions = _instructions;
+        // Flags may have been changed from outside since last run
+        _loadFlags();
+    }
+
+    /**
+     * @brief End a run, giving back the cycles left by a stop
+     * 
+     */
+    void _endRun()
+    {
+        if ( _stop != EStop::Budget )
+        {
+            _cycles += _stopCycles;
+        }
+        _storeFlags();
+    }
+
+    /**
+     * @brief Count the edge to PC in the coverage map, PC being the
+     *        target of a control flow instruction
+     *        Compiled out without M6502_COVERAGE
+     * 
+     */
+    void _coverEdge()
+    {
+#if M6502_COVERAGE
+        if ( _coverage )
+        {
+            const Word Location = static_cast<Word>( (PC >> 4) ^ (PC << 8) );
+            _coverage[Location ^ _coveragePrevious]++;
+            _coveragePrevious = Location >> 1;
+        }
+#endif
+    }
+
+#if M6502_COVERAGE
+    /**
+     * @brief Edge coverage map, nullptr when not counting
+     * 
+     */
+    Byte* _coverage = nullptr;
+
+    /**
+     * @brief Location of the last edge, shifted
+     * 
+     */
+    Word _coveragePrevious = 0;
+#endif
+
+    /**
+     * @brief Lazy flags : Z is set when this result is zero
+     *
+     */
+    Byte _zeroResult;
+
+    /**
+     * @brief Lazy flags : N is bit 7 of this result
+     *
+     */
+    Byte _negativeResult;
+
+    /**
+     * @brief Lazy flags : carry out of the last operation
+     *
+     */
+    Byte _carry;
+
+    /**
+     * @brief Lazy flags : overflow of the last operation
+     *
+     */
+    Byte _overflow;
+
+    /**
+     * @brief Read the bus, directly from host memory when
+     *        a CBus page is plain RAM
+     * 
+     * @param pAddress 
+     * @return Byte 
+     */
+    Byte _busRead( const Word& pAddress );
+
+    /**
+     * @brief Write the bus, directly to host memory when
+     *        a CBus page is plain RAM
+     * 
+     * @param pAddress 
+     * @param pData 
+     */
+    void _busWrite( const Word& pAddress, const Byte& pData );
+
+    /**
+     * @brief 
+     * 
+     * @return Byte 
+     */
+    Byte _fetchByte();
+
+    /**
+     * @brief 
+     * 
+     * @return Word 
+     */
+    Word _fetchWord();
+
+    /**
+     * @brief 
+     * 
+     * @return SByte 
+     */
+    SByte _fetchSByte();
+
+    /**
+     * @brief Operand byte of the instruction, fetched from the bus
+     * 
+     * @return Byte 
+     */
+    Byte _operandByte( SFetched ) { return _fetchByte(); }
+
+    /**
+     * @brief Operand byte of the instruction, already decoded
+     * 
+     * @param pOperand 
+     * @return Byte 
+     */
+    Byte _operandByte( SDecoded pOperand )
+    {
+        PC++;
+        _cycles--;
+        return static_cast<Byte>( pOperand.operand );
+    }
+
+    /**
+     * @brief Operand word of the instruction, fetched from the bus
+     * 
+     * @return Word 
+     */
+    Word _operandWord( SFetched ) { return _fetchWord(); }
+
+    /**
+     * @brief Operand word of the instruction, already decoded
+     * 
+     * @param pOperand 
+     * @return Word 
+     */
+    Word _operandWord( SDecoded pOperand )
+    {
+        PC += 2;
+        _cycles -= 2;
+        return pOperand.operand;
+    }
+
+    /**
+     * @brief 
+     * 
+     * @param Address 
+     * @return Byte 
+     */
+    Byte _readByte( const Word& Address );
+
+    /**
+     * @brief Read Word from memory at address
+     * 
+     * @param Address 
+     * @return Word 
+     */
+    Word _readWord( const Word& Address );
+
+    /**
+     * @brief Write 1 Byte to memory
+     * 
+     * @param Value 
+     * @param Address 
+     */
+    void _writeByte( const Byte& Value, const Word& Address );
+
+    /**
+     * @brief Write 1 Word to memory
+     * 
+     * @param Value 
+     * @param Address 
+     */
+    void _writeWord(	const Word& Value, const Word& Address );
+
+    /**
+     * @brief Write 1 Word on to Stack
+     * 
+     * @param Value 
+     */
+    void _pushWordToStack( const Word& Value );
+
+    /**
+     * @brief Push the PC-1 onto the stack
+     * 
+     */
+    void _pushPCMinusOneToStack();
+
+    /**
+     * @brief Push the PC+1 onto the stack
+     * 
+     */
+    void _pushPCPlusOneToStack();
+
+    /**
+     * @brief Push the PC onto the stack
+     * 
+     */
+    void _pushPCToStack();
+
+    /**
+     * @brief Push a byte on to Stack
+     * 
+     * @param Value 
+     */
+    void _pushByteOntoStack( const Byte& Value );
+
+    /**
+     * @brief Pop a byte value from the stack
+     * 
+     * @return Byte 
+     */
+    Byte _popByteFromStack();
+
+    /**
+     * @brief Pop a 16-bit value from the stack
+     * 
+     * @return Word 
+     */
+    Word _popWordFromStack();
+
+    /**
+     * @brief Sets the correct Process status after a load register instruction
+     * 
+     * @param Register 
+     * 
+     * Sets the correct Process status after a load register instruction
+     * - LDA, LDX, LDY
+     * @Register The A,X or Y Register
+     * 
+     */
+    void _setZeroAndNegativeFlags( const Byte& Register );
+
+    /**
+     * @brief Sets Z from a zero test and N from bit 7 of another value,
+     *        as BIT instruction does
+     * 
+     * @param pZeroTest 
+     * @param pNegativeTest 
+     */
+    void _setZeroAndNegativeFlags( const Byte& pZeroTest, const Byte& pNegativeTest );
+
+    /**
+     * @brief Set the carry flag
+     * 
+     * @param pFlag 
+     */
+    void _setFlagC( bool pFlag );
+
+    /**
+     * @brief Set the overflow flag
+     * 
+     * @param pFlag 
+     */
+    void _setFlagV( bool pFlag );
+
+    /**
+     * @brief Get the carry flag
+     * 
+     * @return bool 
+     */
+    bool _flagC() const;
+
+    /**
+     * @brief Get the zero flag
+     * 
+     * @return bool 
+     */
+    bool _flagZ() const;
+
+    /**
+     * @brief Get the negative flag
+     * 
+     * @return bool 
+     */
+    bool _flagN() const;
+
+    /**
+     * @brief Get the overflow flag
+     * 
+     * @return bool 
+     */
+    bool _flagV() const;
+
+    /**
+     * @brief Write lazy C, Z, N and V back into PS
+     * 
+     */
+    void _storeFlags();
+
+    /**
+     * @brief Reload lazy C, Z, N and V from PS
+     * 
+     */
+    void _loadFlags();
+
+    /**
+     * @brief Addressing mode - Zero page
+     * 
+     * @return Word 
+     */
+    template<class TOperand> Word _addrZeroPage( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Zero page with X offset
+     * 
+     * @return Word 
+     */
+    template<class TOperand> Word _addrZeroPageX( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Zero page with Y offset
+     * 
+     * @return Word 
+     */
+    template<class TOperand> Word _addrZeroPageY( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Absolute
+     * 
+     * @return Word 
+     */
+    template<class TOperand> Word _addrAbsolute( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Absolute with X offset
+     * 
+     * @return Word
+     * 
+     * Addressing mode - Absolute with X offset
+     * 
+     */
+    template<class TOperand> Word _addrAbsoluteX( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Absolute with X offset
+     * 
+     * @return Word
+     * 
+     *  Addressing mode - Absolute with X offset
+     *  - Always takes a cycle for the X page boundary)
+     *  - See "STA Absolute,X"
+     * 
+     */
+    template<class TOperand> Word _addrAbsoluteX_5( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Absolute with Y offset
+     * 
+     * @return Word 
+     */
+    template<class TOperand> Word _addrAbsoluteY( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Absolute with Y offset
+     * 
+     * @return Word 
+     * 
+     *  - Always takes a cycle for the Y page boundary)
+     *	- See "STA Absolute,Y"
+        *
+        */
+    template<class TOperand> Word _addrAbsoluteY_5( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Indirect X | Indexed Indirect
+     * 
+     * @return Word 
+     */
+    template<class TOperand> Word _addrIndirectX( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Indirect Y | Indirect Indexed
+     * 
+     * @return Word 
+     */
+    template<class TOperand> Word _addrIndirectY( TOperand pOperand );
+
+    /** Addressing mode - Indirect X | Indirect Indexed
+    *	- Always takes a cycle for the Y page boundary)
+    *	- See "STA (Indirect,Y) */
+
+    template<class TOperand> Word _addrIndirectX_6( TOperand pOperand );
+
+    /**
+     * @brief Addressing mode - Indirect Y | Indirect Indexed
+     * 
+     * @return Word 
+     * 
+     * - Always takes a cycle for the Y page boundary)
+     * - See "STA (Indirect,Y)
+     */
+    template<class TOperand> Word _addrIndirectY_6( TOperand pOperand );
+
+    /**
+     * @brief Load the specied Register with data in memory
+     * 
+     * @param pAddress 
+     * @param pRegister 
+     */
+    void _loadRegister(Word pAddress, Byte& pRegister);
+
+    /**
+     * @brief And the A Register with the value from the memory address
+     * 
+     * @param pAddress 
+     */
+    void _and( Word pAddress );
+
+    /**
+     * @brief Or the A Register with the value from the memory address
+     * 
+     * @param pAddress 
+     */
+    void _ora( Word pAddress );
+
+    /**
+     * @brief Eor the A Register with the value from the memory address
+     * 
+     * @param pAddress 
+     */
+    void _eor( Word pAddress );
+
+    /**
+     * @brief Conditional branch
+     * 
+     * @param pTest 
+     * @param pExpected 
+     */
+    template<class TOperand> void _branchIf( bool pTest, bool pExpected, TOperand pOperand );
+
+    /**
+     * @brief Do add with carry given the the operand
+     * 
+     * @param pOperand 
+     */
+    void _ADC( Byte pOperand );
+    
+    /**
+     * @brief Do subtract with carry given the the operand
+     * 
+     * @param pOperand 
+     */
+    void _SBC( Byte pOperand );
+
+    /**
+     * @brief Sets the processor status for a CMP/CPX/CPY instruction
+     * 
+     * @param pOperand 
+     * @param pRegisterValue 
+     */
+    void _registerCompare( Byte pOperand, Byte pRegisterValue );
+
+    /**
+     * @brief Arithmetic shift left
+     * 
+     * @param Operand 
+     * @return Byte 
+     */
+    Byte _ASL( Byte Operand );
+
+    /**
+     * @brief Logical shift right
+     * 
+     * @param Operand 
+     * @return Byte 
+     */
+    Byte _LSR( Byte Operand );
+
+    /**
+     * @brief Rotate left
+     * 
+     * @param Operand 
+     * @return Byte 
+     */
+    Byte _ROL( Byte Operand );
+
+    /**
+     * @brief Rotate right
+     * 
+     * @param Operand 
+     * @return Byte 
+     */
+    Byte _ROR( Byte Operand );
+
+    /**
+     * @brief Push Processor status onto the stack
+     *        Setting bits 4 & 5 on the stack
+     * 
+     */
+    void _pushPSToStack();
+
+    /**
+     * @brief Pop Processor status from the stack
+     *        Clearing bits 4 & 5 (Break & Unused)
+     * 
+     */
+    void _popPSFromStack();
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+CCPUCore<TCPU,TBus>::CCPUCore( TBus& pBus ) : _bus(pBus), _cycles(0),
+    _faultStop(false), _noThrow(false), _breakStop(false), _stop(EStop::Budget),
+    _fault(EFault::None), _stopPC(0), _stopCycles(0), _instructions(0),
+    _runInstructions(0), _breakpointCount(0), _untilPCArmed(false), _untilPC(0),
+    _untilSPArmed(false), _untilSP(0),
+    _zeroResult(1), _negativeResult(0), _carry(0), _overflow(0)
+{
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_resetRegisters( const Word& pResetVector )
+{
+    PC = pResetVector;
+    SP = 0xFF;
+    Flags.C = Flags.Z = Flags.I = Flags.D = Flags.B = Flags.Unused = Flags.V = Flags.N = 0;
+    A = X = Y = 0;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline Byte CCPUCore<TCPU,TBus>::_busRead( const Word& pAddress )
+{
+    if constexpr ( std::is_same_v<TBus, CBus> )
+    {
+        const Byte* Page = _bus.getReadPage( pAddress );
+        if ( Page )
+        {
+            return Page[pAddress & 0xFF];
+        }
+    }
+    return _bus.readBusData( pAddress );
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline void CCPUCore<TCPU,TBus>::_busWrite( const Word& pAddress, const Byte& pData )
+{
+    if constexpr ( std::is_same_v<TBus, CBus> )
+    {
+        Byte* Page = _bus.getWritePage( pAddress );
+        if ( Page )
+        {
+            Page[pAddress & 0xFF] = pData;
+            return;
+        }
+    }
+    _bus.writeBusData( pAddress, pData );
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Byte CCPUCore<TCPU,TBus>::_fetchByte()
+{
+    _cycles--;
+    return _busRead(PC++);
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+SByte CCPUCore<TCPU,TBus>::_fetchSByte()
+{
+    return static_cast<SByte>(_fetchByte());
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Word CCPUCore<TCPU,TBus>::_fetchWord()
+{
+    // 6502 is little endian
+    Word Data = _busRead(PC++);
+    Data |= (_busRead(PC++) << 8 );
+    _cycles-=2;
+    return Data;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Byte CCPUCore<TCPU,TBus>::_readByte( const Word& pAddress )
+{
+    _cycles--;
+    return _busRead(pAddress);
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Word CCPUCore<TCPU,TBus>::_readWord( const Word& pAddress )
+{
+    return _readByte( pAddress ) | (  _readByte( pAddress + 1 ) << 8 );
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_writeByte( const Byte& pValue, const Word& pAddress )
+{
+    _busWrite( pAddress , pValue );
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_writeWord( const Word& pValue, const Word& pAddress )
+{
+    _busWrite( pAddress , pValue & 0xFF);
+    _busWrite( pAddress + 1 , pValue >> 8);
+    _cycles -= 2;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Word CCPUCore<TCPU,TBus>::SPToAddress() const
+{
+    return 0x100 | SP;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+SExecResult CCPUCore<TCPU,TBus>::run( s64 pCycles )
+{
+    _noThrow = true;
+    SExecResult Result;
+    Result.cycles = _self().execute( pCycles );
+    _noThrow = false;
+    Result.instructions = _instructions - _runInstructions;
+    Result.stop = _stop;
+    Result.fault = _fault;
+    Result.PC = _stop == EStop::Budget ? PC : _stopPC;
+    return Result;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+SExecResult CCPUCore<TCPU,TBus>::runUntilPC( Word pAddress, s64 pCycles )
+{
+    const bool WasBreakpoint = isBreakpoint( pAddress );
+    setBreakpoint( pAddress );
+    _untilPCArmed = true;
+    _untilPC = pAddress;
+    const SExecResult Result = run( pCycles );
+    _untilPCArmed = false;
+    if ( !WasBreakpoint )
+    {
+        clearBreakpoint( pAddress );
+    }
+    return Result;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+SExecResult CCPUCore<TCPU,TBus>::runUntilReturn( Byte pSP, s64 pCycles )
+{
+    _untilSPArmed = true;
+    _untilSP = pSP;
+    const SExecResult Result = run( pCycles );
+    _untilSPArmed = false;
+    return Result;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+SExecResult CCPUCore<TCPU,TBus>::runUntil( const std::function<bool(const TCPU&)>& pPredicate, s64 pCycles )
+{
+    _untilPredicate = pPredicate;
+    const SExecResult Result = run( pCycles );
+    _untilPredicate = nullptr;
+    return Result;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::setBreakpoint( Word pAddress )
+{
+    if ( _breakpoints.empty() )
+    {
+        _breakpoints.resize( 0x10000 / 64, 0 );
+    }
+    if ( !isBreakpoint( pAddress ) )
+    {
+        _breakpoints[pAddress >> 6] |= u64(1) << (pAddress & 63);
+        _breakpointCount++;
+    }
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::clearBreakpoint( Word pAddress )
+{
+    if ( isBreakpoint( pAddress ) )
+    {
+        _breakpoints[pAddress >> 6] &= ~(u64(1) << (pAddress & 63));
+        _breakpointCount--;
+    }
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::clearBreakpoints()
+{
+    std::fill( _breakpoints.begin(), _breakpoints.end(), 0 );
+    _breakpointCount = 0;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+bool CCPUCore<TCPU,TBus>::isBreakpoint( Word pAddress ) const
+{
+    return !_breakpoints.empty() && ((_breakpoints[pAddress >> 6] >> (pAddress & 63)) & 1);
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_pushWordToStack( const Word& pValue )
+{
+    if ( SP < 0x02 && _faultStop )
+    {
+        _raiseFault( EFault::StackOverflow );
+    }
+    _writeByte( pValue >> 8, SPToAddress());
+    SP--;
+    _writeByte( pValue & 0xFF, SPToAddress());
+    SP--;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_pushPCMinusOneToStack()
+{
+    _pushWordToStack( PC - 1 );
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_pushPCPlusOneToStack()
+{
+    _pushWordToStack( PC + 1 );
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_pushPCToStack()
+{
+    _pushWordToStack( PC );
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_pushByteOntoStack( const Byte& pValue )
+{
+    if ( SP == 0x00 && _faultStop )
+    {
+        _raiseFault( EFault::StackOverflow );
+    }
+    _busWrite( SPToAddress() , pValue );
+    _cycles-=2;
+    SP--;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Byte CCPUCore<TCPU,TBus>::_popByteFromStack()
+{
+    if ( SP == 0xFF && _faultStop )
+    {
+        _raiseFault( EFault::StackUnderflow );
+    }
+    SP++;
+    _cycles-=2;
+    return _busRead( SPToAddress());
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Word CCPUCore<TCPU,TBus>::_popWordFromStack()
+{
+    if ( SP > 0xFD && _faultStop )
+    {
+        _raiseFault( EFault::StackUnderflow );
+    }
+    Word ValueFromStack = _readWord( SPToAddress()+1 );
+    SP += 2;
+    _cycles--;
+    return ValueFromStack;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline void CCPUCore<TCPU,TBus>::_setZeroAndNegativeFlags( const Byte& pRegister )
+{
+#if M6502_LAZY_FLAGS
+    _zeroResult = _negativeResult = pRegister;
+#else
+    Flags.Z = (pRegister == 0);
+    Flags.N = (pRegister & NegativeFlagBit) > 0;
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline void CCPUCore<TCPU,TBus>::_setZeroAndNegativeFlags( const Byte& pZeroTest, const Byte& pNegativeTest )
+{
+#if M6502_LAZY_FLAGS
+    _zeroResult = pZeroTest;
+    _negativeResult = pNegativeTest;
+#else
+    Flags.Z = (pZeroTest == 0);
+    Flags.N = (pNegativeTest & NegativeFlagBit) > 0;
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline void CCPUCore<TCPU,TBus>::_setFlagC( bool pFlag )
+{
+#if M6502_LAZY_FLAGS
+    _carry = pFlag;
+#else
+    Flags.C = pFlag;
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline void CCPUCore<TCPU,TBus>::_setFlagV( bool pFlag )
+{
+#if M6502_LAZY_FLAGS
+    _overflow = pFlag;
+#else
+    Flags.V = pFlag;
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline bool CCPUCore<TCPU,TBus>::_flagC() const
+{
+#if M6502_LAZY_FLAGS
+    return _carry;
+#else
+    return Flags.C;
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline bool CCPUCore<TCPU,TBus>::_flagZ() const
+{
+#if M6502_LAZY_FLAGS
+    return _zeroResult == 0;
+#else
+    return Flags.Z;
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline bool CCPUCore<TCPU,TBus>::_flagN() const
+{
+#if M6502_LAZY_FLAGS
+    return (_negativeResult & NegativeFlagBit) != 0;
+#else
+    return Flags.N;
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline bool CCPUCore<TCPU,TBus>::_flagV() const
+{
+#if M6502_LAZY_FLAGS
+    return _overflow;
+#else
+    return Flags.V;
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline void CCPUCore<TCPU,TBus>::_storeFlags()
+{
+#if M6502_LAZY_FLAGS
+    Flags.C = _flagC();
+    Flags.Z = _flagZ();
+    Flags.N = _flagN();
+    Flags.V = _flagV();
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+inline void CCPUCore<TCPU,TBus>::_loadFlags()
+{
+#if M6502_LAZY_FLAGS
+    _carry = Flags.C;
+    _overflow = Flags.V;
+    // Any byte giving back the same Z and N will do
+    _zeroResult = Flags.Z ? 0 : 1;
+    _negativeResult = Flags.N ? NegativeFlagBit : 0;
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<bool Watch>
+void CCPUCore<TCPU,TBus>::_executeSwitch()
+{
+    while ( _cycles > 0)
+    {
+        if ( _self()._interruptPending() && _self()._serviceInterrupts() ) continue;
+        if constexpr ( Watch )
+        {
+            if ( _watchStop() ) return;
+        }
+        Byte Instr = _fetchByte();
+        _instructions++;
+        switch (ins(Instr))
+        {
+#define M6502_OP( Name, Mode, Cycles, Penalty ) \
+            case Ins::Name: _ins( SIns<Ins::Name>(), SFetched() ); break;
+#include <m6502/System/OpTable.inl>
+            default:
+            {
+                _illegal( Instr );
+            } break;
+        }
+    }
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<bool Watch>
+void CCPUCore<TCPU,TBus>::_executeThreaded()
+{
+#if M6502_HAS_THREADED
+    // Label of each opcode handler, unknown byte values go to Illegal
+    void* Labels[256];
+    for ( void*& Label : Labels )
+    {
+        Label = &&Illegal;
+    }
+#define M6502_OP( Name, Mode, Cycles, Penalty ) \
+    Labels[opcode(Ins::Name)] = &&Name;
+#include <m6502/System/OpTable.inl>
+
+    // Opcode of the running instruction, for the illegal ones
+    Byte OpCode = 0;
+
+    // Every handler ends with its own copy of the dispatch
+    // so each one gets its own indirect branch prediction
+#define M6502_NEXT() \
+    if ( _cycles <= 0 ) return; \
+    if ( _self()._interruptPending() && _self()._serviceInterrupts() ) goto Dispatch; \
+    if constexpr ( Watch ) \
+    { \
+        if ( _watchStop() ) return; \
+    } \
+    _instructions++; \
+    OpCode = _fetchByte(); \
+    goto *Labels[OpCode]
+
+Dispatch:
+    M6502_NEXT();
+#define M6502_OP( Name, Mode, Cycles, Penalty ) \
+Name: \
+    _ins( SIns<Ins::Name>(), SFetched() ); \
+    M6502_NEXT();
+#include <m6502/System/OpTable.inl>
+Illegal:
+    _illegal( OpCode );
+    M6502_NEXT();
+#undef M6502_NEXT
+#else
+    _executeSwitch<Watch>();
+#endif
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_illegal( Byte pOpCode )
+{
+    if ( _faultStop || _noThrow )
+    {
+        // Stopped on the opcode
+        _unfetch();
+        _raiseFault( EFault::Illegal );
+        return;
+    }
+    _storeFlags();
+    printf("Instruction %02X not handled\n", pOpCode);
+    throw - 1;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrZeroPage( TOperand pOperand )
+{
+    return static_cast<Word>(_operandByte( pOperand ));
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrZeroPageX( TOperand pOperand )
+{
+    Byte ZeroPageAddr = _operandByte( pOperand );
+    ZeroPageAddr += X;
+    _cycles--;
+    return ZeroPageAddr;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrZeroPageY( TOperand pOperand )
+{
+    Byte ZeroPageAddr = _operandByte( pOperand );
+    ZeroPageAddr += Y;
+    _cycles--;
+    return ZeroPageAddr;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrAbsolute( TOperand pOperand )
+{
+    return _operandWord( pOperand );
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrAbsoluteX( TOperand pOperand )
+{
+    Word AbsAddress = _operandWord( pOperand );
+    Word AbsAddressX = AbsAddress + X;
+    const bool CrossedPageBoundary = (AbsAddress ^ AbsAddressX) >> 8;
+    if ( CrossedPageBoundary )
+    {
+        _cycles--;
+    }
+
+    return AbsAddressX;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrAbsoluteX_5( TOperand pOperand )
+{
+    Word AbsAddress = _operandWord( pOperand );
+    _cycles--;
+    return AbsAddress + X;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrAbsoluteY( TOperand pOperand )
+{
+    Word AbsAddress = _operandWord( pOperand );
+    Word AbsAddressY = AbsAddress + Y;
+    const bool CrossedPageBoundary = (AbsAddress ^ AbsAddressY) >> 8;
+    if ( CrossedPageBoundary )
+    {
+        _cycles--;
+    }
+
+    return AbsAddressY;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrIndirectX( TOperand pOperand )
+{
+    _cycles--;
+    return _readWord(_operandByte( pOperand ) + X);
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrIndirectY( TOperand pOperand )
+{
+    Byte ZPAddress = _operandByte( pOperand );
+    Word EffectiveAddr = _readWord( ZPAddress );
+    Word EffectiveAddrY = EffectiveAddr + Y;
+    const bool CrossedPageBoundary = (EffectiveAddr ^ EffectiveAddrY) >> 8;
+    if ( CrossedPageBoundary )
+    {
+        _cycles--;
+    }
+    return EffectiveAddrY;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrAbsoluteY_5( TOperand pOperand )
+{
+    _cycles--;
+    return _operandWord( pOperand ) + Y;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrIndirectX_6( TOperand pOperand )
+{
+    _cycles--;
+    return _readWord( _operandByte( pOperand ) ) + X;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+Word CCPUCore<TCPU,TBus>::_addrIndirectY_6( TOperand pOperand )
+{
+    _cycles--;
+    return _readWord( _operandByte( pOperand ) ) + Y;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Word CCPUCore<TCPU,TBus>::loadPrg( const Byte* pProgram, u32 NumBytes )
+{
+    Word LoadAddress = 0;
+    if ( pProgram && NumBytes > 2 )
+    {
+        Word At = 0;
+        const Word Lo = pProgram[At++];
+        const Word Hi = pProgram[At++] << 8;
+        LoadAddress = Lo | Hi;
+        for ( Word Addr = LoadAddress; Addr < LoadAddress+NumBytes-2; Addr++ )
+        {
+            //TODO: mem copy?
+            _bus.writeBusData(Addr, pProgram[At++]);
+        }
+        PC = LoadAddress;
+    }
+    return LoadAddress;
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_loadRegister(Word pAddress, Byte& pRegister)
+{
+    pRegister = _readByte ( pAddress );
+    _setZeroAndNegativeFlags( pRegister );
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_and( Word pAddress )
+{
+    A &= _readByte( pAddress );
+    _setZeroAndNegativeFlags( A );
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_ora( Word pAddress )
+{
+    A |= _readByte( pAddress );
+    _setZeroAndNegativeFlags( A );
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_eor( Word pAddress )
+{
+    A ^= _readByte( pAddress );
+    _setZeroAndNegativeFlags( A );
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+template<class TOperand>
+void CCPUCore<TCPU,TBus>::_branchIf( bool pTest, bool pExpected, TOperand pOperand )
+{
+    SByte Offset = static_cast<SByte>( _operandByte( pOperand ) );
+    if ( pTest == pExpected )
+    {
+        const Word PCOld = PC;
+        PC += Offset;
+        _cycles--;
+
+        const bool PageChanged = (PC >> 8) != (PCOld >> 8);
+        if ( PageChanged )
+        {
+            _cycles--;
+        }
+        _coverEdge();
+        _self()._onJump( PCOld - 2 );
+    }
+    else
+    {
+        _self()._onBranchNotTaken();
+    }
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_ADC( Byte pOperand )
+{
+    if ( Flags.D )
+    {
+        // Decimal mode not handled
+        if ( _faultStop || _noThrow )
+        {
+            _raiseFault( EFault::Decimal );
+            return;
+        }
+        _storeFlags();
+        throw -1;
+    }
+    const bool AreSignBitsTheSame =
+        !((A ^ pOperand) & NegativeFlagBit);
+    Word Sum = static_cast<Word>(A);
+    Sum += pOperand;
+    Sum += _flagC();
+    A = (Sum & 0xFF);
+    _setZeroAndNegativeFlags( A );
+    _setFlagC( Sum > 0xFF );
+    _setFlagV( AreSignBitsTheSame &&
+        ((A ^ pOperand) & NegativeFlagBit) );
+};
+    
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_SBC( Byte pOperand )
+{
+    _ADC( ~pOperand );
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_registerCompare( Byte pOperand, Byte pRegisterValue )
+{
+    // Temp is zero only when both values are equal
+    Byte Temp = pRegisterValue - pOperand;
+    _setZeroAndNegativeFlags( Temp );
+    _setFlagC( pRegisterValue >= pOperand );
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Byte CCPUCore<TCPU,TBus>::_ASL( Byte pOperand )
+{
+    _setFlagC( (pOperand & NegativeFlagBit) > 0 );
+    Byte Result = pOperand << 1;
+    _setZeroAndNegativeFlags( Result );
+    _cycles--;
+    return Result;
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Byte CCPUCore<TCPU,TBus>::_LSR( Byte pOperand )
+{
+    _setFlagC( (pOperand & ZeroBit) > 0 );
+    Byte Result = pOperand >> 1;
+    _setZeroAndNegativeFlags( Result );
+    _cycles--;
+    return Result;
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Byte CCPUCore<TCPU,TBus>::_ROL( Byte pOperand )
+{
+    Byte NewBit0 = _flagC() ? ZeroBit : 0;
+    _setFlagC( (pOperand & NegativeFlagBit) > 0 );
+    pOperand = pOperand << 1;
+    pOperand |= NewBit0;
+    _setZeroAndNegativeFlags( pOperand );
+    _cycles--;
+    return pOperand;
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+Byte CCPUCore<TCPU,TBus>::_ROR( Byte pOperand )
+{
+    bool OldBit0 = (pOperand & ZeroBit) > 0;
+    pOperand = pOperand >> 1;
+    if ( _flagC() )
+    {
+        pOperand |= NegativeFlagBit;
+    }
+    _cycles--;
+    _setFlagC( OldBit0 );
+    _setZeroAndNegativeFlags( pOperand );
+    return pOperand;
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_pushPSToStack()
+{
+    _storeFlags();
+    Byte PSStack = PS | BreakFlagBit | UnusedFlagBit;		
+    _pushByteOntoStack( PSStack );
+};
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_interrupt( Word pVector )
+{
+    // Opcode fetch thrown away
+    _cycles--;
+    _pushPCToStack();
+    _storeFlags();
+    _pushByteOntoStack( static_cast<Byte>( (PS & ~BreakFlagBit) | UnusedFlagBit ) );
+    Flags.I = true;
+    PC = _readWord( pVector );
+    _coverEdge();
+}
+
+/*****************************************************************************/
+
+template<class TCPU, class TBus>
+void CCPUCore<TCPU,TBus>::_popPSFromStack()
+{
+    PS = _popByteFromStack();
+    Flags.B = false;
+    Flags.Unused = false;
+    _loadFlags();
+};
+
+/*****************************************************************************/
+
+#include <m6502/System/Instructions.inl>
+
+}
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @file CowMem.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef COWMEM_HPP
+#define COWMEM_HPP
+
+#include <m6502/Config.hpp>
+#include <m6502/System/Bus.hpp>
+#include <array>
+#include <atomic>
+
+namespace m6502
+{
+
+/**
+ * @brief 256 bytes page of a copy on write memory, shared by the
+ *        memories holding a reference on it
+ * 
+ */
+struct SCowPage
+{
+    /**
+     * @brief Memories holding the page, written in place when alone
+     * 
+     */
+    std::atomic<u32> refs;
+
+    /**
+     * @brief Bytes of the page
+     * 
+     */
+    std::array<Byte,256> data;
+};
+
+/**
+ * @brief 64KB of RAM made of 256 pages shared until first write
+ *        A fork holds the pages of its parent, the first write on a
+ *        shared page copies it. Shared pages are read directly by the
+ *        bus, written pages once copied are written directly too.
+ *        Forks may run on other threads than their parent
+ * 
+ */
+class CCowMem : CBusChip
+{
+public:
+    /**
+     * @brief Construct a new zeroed memory, its pages share one zero page
+     * 
+     * @param pBus 
+     * @param pMask 
+     * @param pBank 
+     */
+    explicit CCowMem(CBus& pBus, const Word& pMask, const Word& pBank);
+
+    /**
+     * @brief Fork a memory onto another bus, sharing all its pages
+     *        The parent must not run meanwhile, its written pages
+     *        become shared again
+     * 
+     * @param pBus 
+     * @param pParent 
+     */
+    CCowMem(CBus& pBus, CCowMem& pParent);
+
+    /**
+     * @brief Copy a memory, on the same bus like CMem
+     * 
+     * @param pCopy 
+     */
+    explicit CCowMem(CCowMem& pCopy);
+
+    /**
+     * @brief Destroy the memory, releasing its pages
+     * 
+     */
+    ~CCowMem();
+
+    /**
+     * @brief Zero the memory, sharing one zero page again
+     * 
+     */
+    void initialise();
+
+    /**
+     * @brief Read 1 Byte
+     * 
+     * @param pAddress 
+     * @return Byte 
+     */
+    Byte operator[]( const Word& pAddress ) const;
+
+    /**
+     * @brief Write 1 Byte, the page is copied when shared
+     * 
+     * @param pAddress 
+     * @return Byte& 
+     */
+    Byte& operator[]( const Word& pAddress );
+
+    /**
+     * @brief Get the pages held by no other memory, the
+     *        pages written since the fork
+     * 
+     * @return u32 
+     */
+    u32 getPrivatePages() const;
+
+    /**
+     * @brief Get the host memory used by the memory alone:
+     *        its page table and private pages
+     * 
+     * @return u64 
+     */
+    u64 getPrivateBytes() const;
+
+protected:
+    void onWriteBusData( const Word& pAddress, const Byte& pData ) override;
+    Byte onReadBusData( const Word& pAddress ) override;
+
+    /**
+     * @brief Pages are read directly, shared or not
+     * 
+     * @param pOffset 
+     * @return const Byte* 
+     */
+    const Byte* onMapReadPage( const Word& pOffset ) override;
+
+    /**
+     * @brief Private pages are written directly, writes on shared pages
+     *        go through onWriteBusData to copy the page
+     * 
+     * @param pOffset 
+     * @return Byte* 
+     */
+    Byte* onMapWritePage( const Word& pOffset ) override;
+
+    /**
+     * @brief The whole memory is saved in snapshots, pages loaded
+     *        with other bytes become private
+     * 
+     * @return u32 
+     */
+    u32 onStateSize() const override;
+    void onSaveState( Byte* pState ) const override;
+    void onLoadState( const Byte* pState ) override;
+
+private:
+    /**
+     * @brief Pages of the memory
+     * 
+     */
+    std::array<SCowPage*,256> _pages;
+
+    /**
+     * @brief Share the pages of another memory
+     * 
+     * @param pParent 
+     */
+    void _share( CCowMem& pParent );
+
+    /**
+     * @brief Drop the reference on every page
+     * 
+     */
+    void _release();
+
+    /**
+     * @brief Get a page for writing, copied first when shared
+     *        The bus maps the copy once done
+     * 
+     * @param pPage 
+     * @return SCowPage& 
+     */
+    SCowPage& _own( const Byte& pPage );
+};
+
+}
+
+#endif
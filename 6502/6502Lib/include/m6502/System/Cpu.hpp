@@ -27,23 +27,103 @@
 
 #include <m6502/Config.hpp>
 #include <m6502/System/Bus.hpp>
-#include <m6502/System/Registers.hpp>
+#include <m6502/System/CPUCore.hpp>
 #include <m6502/System/OpCodes.hpp>
+#include <m6502/System/BlockCache.hpp>
+#include <m6502/System/IdleLoop.hpp>
 #include <stdio.h>
 #include <stdlib.h>
 #include <iostream>
 #include <array>
+#include <vector>
+#include <unordered_map>
+#include <utility>
 
 namespace m6502
 {
 
 /**
- * @brief Registers for 6502 CPU
+ * @brief Instruction dispatch engines of the CPU
  * 
  */
-class CCPU : public CRegisters, CBusChip
+enum class EEngine : Byte
 {
+    // One switch over the fetched opcode
+    Switch,
+    // 256 entries handler table indexed by the fetched opcode
+    Table,
+    // Each handler jumps to the next one through a label table
+    // Runs the Switch engine when M6502_HAS_THREADED is 0
+    Threaded,
+    // Basic blocks decoded once and kept in a cache keyed by PC
+    // Memory changed without the bus needs flushBlockCache
+    Block
+};
+
+/**
+ * @brief 6502 CPU on a CBus, the bus of systems put together at run time
+ *        See CStaticCPU for systems known at compile time
+ * 
+ */
+class CCPU : public CCPUCore<CCPU, CBus>, CBusChip
+{
+    /**
+     * @brief Core calls the jump hooks
+     * 
+     */
+    friend class CCPUCore<CCPU, CBus>;
+
 public:
+    /**
+     * @brief Entry of the opcode dispatch table
+     * 
+     */
+    struct SOpCode
+    {
+        /**
+         * @brief Execute the instruction once its opcode is fetched
+         * 
+         */
+        void (*handler)(CCPU&);
+
+        /**
+         * @brief Addressing mode of the instruction
+         * 
+         */
+        EAddrMode mode;
+
+        /**
+         * @brief Base cycle count, opcode fetch included
+         * 
+         */
+        Byte cycles;
+
+        /**
+         * @brief Extra cycles rule on top of base cycle count
+         * 
+         */
+        EPagePenalty penalty;
+
+        /**
+         * @brief false for the byte values not handled by the CPU
+         * 
+         */
+        bool legal;
+
+        /**
+         * @brief Execute the instruction on its operand decoded by
+         *        the block cache, once PC is past the opcode
+         * 
+         */
+        void (*decoded)(CCPU&, const SBlockInstruction&);
+    };
+
+    /**
+     * @brief Dispatch table, one entry per opcode byte value
+     * 
+     */
+    static const std::array<SOpCode,256> OpTable;
+
     /**
      * @brief Construct a new CPU object
      * 
@@ -84,26 +164,6 @@ public:
      */
     void reset( const Word& pResetVector );
 
-    /**
-     * @brief Load program in memory
-     * 
-     * @param Program 
-     * @param NumBytes 
-     * @return the address that the rogram was loading into, or 0 if no program 
-     * 
-     * This method handle a Byte array containing programm.
-     * The 2 first Bytes contain the memory address where
-     * Load the program
-     */
-    Word loadPrg( const Byte* pProgram, u32 pNumBytes);
-
-    /**
-     * @brief Get the stack pointer
-     * 
-     * @return the stack pointer as a full 16-bit address (in the 1st page) 
-     */
-    Word SPToAddress() const;
-
     /**
      * @brief Execute specified number of cycles
      * 
@@ -112,328 +172,315 @@ public:
      */
     s64 execute( s64 pCycles);
 
-private:
-
     /**
-     * @brief Cycles counter down for Execution
-     *        process
+     * @brief Execute exactly one instruction
      * 
+     * @return The cycles used by the instruction
      */
-    s64 _cycles;
+    s64 step();
 
     /**
-     * @brief 
+     * @brief Select the dispatch engine used by execute
      * 
-     * @return Byte 
+     * @param pEngine 
      */
-    Byte _fetchByte();
+    void setEngine( EEngine pEngine );
 
     /**
-     * @brief 
+     * @brief Get the dispatch engine used by execute
      * 
-     * @return Word 
+     * @return EEngine 
      */
-    Word _fetchWord();
+    EEngine getEngine() const;
 
     /**
-     * @brief 
+     * @brief Get the counters of the block cache used by the Block engine
      * 
-     * @return SByte 
+     * @return const SBlockCacheStats& 
      */
-    SByte _fetchSByte();
+    const SBlockCacheStats& getBlockCacheStats() const;
 
     /**
-     * @brief 
+     * @brief Reset the counters of the block cache
      * 
-     * @param Address 
-     * @return Byte 
      */
-    Byte _readByte( const Word& Address );
+    void resetBlockCacheStats();
 
     /**
-     * @brief Read Word from memory at address
+     * @brief Drop the decoded blocks, needed when code has been changed
+     *        without the bus (e.g. CMem operator[])
      * 
-     * @param Address 
-     * @return Word 
      */
-    Word _readWord( const Word& Address );
+    void flushBlockCache();
 
     /**
-     * @brief Write 1 Byte to memory
+     * @brief Skip ahead idle loops (polling, delay loops) in execute,
+     *        with the cycles and registers they would have given
+     *        Off by default, step never skips
      * 
-     * @param Value 
-     * @param Address 
+     * @param pEnabled 
      */
-    void _writeByte( const Byte& Value, const Word& Address );
+    void setIdleSkip( bool pEnabled );
 
     /**
-     * @brief Write 1 Word to memory
+     * @brief Tell if idle loops are skipped ahead
      * 
-     * @param Value 
-     * @param Address 
+     * @return true 
      */
-    void _writeWord(	const Word& Value, const Word& Address );
+    bool getIdleSkip() const;
 
     /**
-     * @brief Write 1 Word on to Stack
+     * @brief Get the cycles skipped ahead in idle loops since reset
      * 
-     * @param Value 
+     * @return u64 
      */
-    void _pushWordToStack( const Word& Value );
+    u64 getIdleSkippedCycles() const;
 
     /**
-     * @brief Push the PC-1 onto the stack
+     * @brief Run until an address of a range is written through the bus,
+     *        stopping after the writing instruction
+     *        Pages of the range are trapped on the bus for the run only
      * 
+     * @param pFirst first address of the range
+     * @param pLast last address of the range
+     * @param pCycles most cycles to run
+     * @return SExecResult stop is Condition when written
      */
-    void _pushPCMinusOneToStack();
+    SExecResult runUntilWrite( Word pFirst, Word pLast, s64 pCycles );
 
     /**
-     * @brief Push the PC+1 onto the stack
+     * @brief Run until an address is written through the bus
      * 
+     * @param pAddress 
+     * @param pCycles most cycles to run
+     * @return SExecResult stop is Condition when written
      */
-    void _pushPCPlusOneToStack();
+    SExecResult runUntilWrite( Word pAddress, s64 pCycles ) { return runUntilWrite( pAddress, pAddress, pCycles ); }
 
+protected:
     /**
-     * @brief Push the PC onto the stack
+     * @brief Write Event on a page holding decoded blocks
      * 
+     * @param pAddress 
      */
-    void _pushPCToStack();
+    void onWatchedWrite( const Word& pAddress ) override;
 
     /**
-     * @brief Push a byte on to Stack
+     * @brief Write Event in the range of runUntilWrite
      * 
-     * @param Value 
      */
-    void _pushByteOntoStack( const Byte& Value );
+    void onTrappedWrite( const Word& pAddress ) override;
 
     /**
-     * @brief Pop a byte value from the stack
+     * @brief Registers and cycle counters are saved in snapshots,
+     *        decoded blocks and idle loops are dropped on load
      * 
-     * @return Byte 
+     * @return u32 
      */
-    Byte _popByteFromStack();
+    u32 onStateSize() const override;
+    void onSaveState( Byte* pState ) const override;
+    void onLoadState( const Byte* pState ) override;
 
-    /**
-     * @brief Pop a 16-bit value from the stack
-     * 
-     * @return Word 
-     */
-    Word _popWordFromStack();
+private:
 
     /**
-     * @brief Sets the correct Process status after a load register instruction
-     * 
-     * @param Register 
-     * 
-     * Sets the correct Process status after a load register instruction
-     * - LDA, LDX, LDY
-     * @Register The A,X or Y Register
+     * @brief Dispatch engine used by execute
      * 
      */
-    void _setZeroAndNegativeFlags( const Byte& Register );
+    EEngine _engine;
 
     /**
-     * @brief Addressing mode - Zero page
+     * @brief Dispatch table handler of an instruction
      * 
-     * @return Word 
+     * @param pCPU 
      */
-    Word _addrZeroPage();
+    template<Ins I> static void _dispatch( CCPU& pCPU );
 
     /**
-     * @brief Addressing mode - Zero page with X offset
+     * @brief Dispatch table handler of the byte values
+     *        which are not an instruction
      * 
-     * @return Word 
+     * @tparam OpCode the byte value, not read back from the bus
+     * @param pCPU 
      */
-    Word _addrZeroPageX();
+    template<Byte OpCode> static void _dispatchIllegal( CCPU& pCPU );
 
     /**
-     * @brief Addressing mode - Zero page with Y offset
+     * @brief Block engine handler of an instruction
      * 
-     * @return Word 
+     * @param pCPU 
+     * @param pInstruction decoded instruction
      */
-    Word _addrZeroPageY();
+    template<Ins I> static void _dispatchDecoded( CCPU& pCPU, const SBlockInstruction& pInstruction );
 
     /**
-     * @brief Addressing mode - Absolute
+     * @brief Block engine handler of the byte values
+     *        which are not an instruction
      * 
-     * @return Word 
+     * @param pCPU 
+     * @param pInstruction decoded instruction
      */
-    Word _addrAbsolute();
+    static void _dispatchDecodedIllegal( CCPU& pCPU, const SBlockInstruction& pInstruction );
 
     /**
-     * @brief Addressing mode - Absolute with X offset
-     * 
-     * @return Word
-     * 
-     * Addressing mode - Absolute with X offset
+     * @brief Illegal handler of each byte value
      * 
+     * @return std::array<void(*)(CCPU&),256> 
      */
-    Word _addrAbsoluteX();
+    template<std::size_t... OpCode>
+    static constexpr std::array<void(*)(CCPU&),256> _illegalHandlers( std::index_sequence<OpCode...> );
 
     /**
-     * @brief Addressing mode - Absolute with X offset
-     * 
-     * @return Word
-     * 
-     *  Addressing mode - Absolute with X offset
-     *  - Always takes a cycle for the X page boundary)
-     *  - See "STA Absolute,X"
+     * @brief Build the dispatch table from the Ins enum
      * 
+     * @return std::array<SOpCode,256> 
      */
-    Word _addrAbsoluteX_5();
+    static constexpr std::array<SOpCode,256> _buildOpTable();
 
     /**
-     * @brief Addressing mode - Absolute with Y offset
+     * @brief Advance the bus scheduler, its events see the flags
+     *        and may change them
      * 
-     * @return Word 
+     * @param pCycles 
      */
-    Word _addrAbsoluteY();
+    void _advanceScheduler( u64 pCycles );
 
     /**
-     * @brief Addressing mode - Absolute with Y offset
+     * @brief Run the cycles with the selected engine, in slices
+     *        ending at the deadlines of the bus scheduler whose
+     *        events are fired after each slice
      * 
-     * @return Word 
-     * 
-     *  - Always takes a cycle for the Y page boundary)
-     *	- See "STA Absolute,Y"
-        *
-        */
-    Word _addrAbsoluteY_5();
+     * @tparam Watch check the breakpoints before each instruction
+     */
+    template<bool Watch> void _executeEvents();
 
     /**
-     * @brief Addressing mode - Indirect X | Indexed Indirect
+     * @brief Run the cycles with the selected engine
      * 
-     * @return Word 
+     * @tparam Watch check the breakpoints before each instruction
      */
-    Word _addrIndirectX();
+    template<bool Watch> void _executeEngine();
 
     /**
-     * @brief Addressing mode - Indirect Y | Indirect Indexed
+     * @brief Run the cycles with the dispatch table engine
      * 
-     * @return Word 
+     * @tparam Watch check the breakpoints before each instruction
      */
-    Word _addrIndirectY();
-
-    /** Addressing mode - Indirect X | Indirect Indexed
-    *	- Always takes a cycle for the Y page boundary)
-    *	- See "STA (Indirect,Y) */
-
-    Word _addrIndirectX_6();
+    template<bool Watch> void _executeTable();
 
     /**
-     * @brief Addressing mode - Indirect Y | Indirect Indexed
-     * 
-     * @return Word 
+     * @brief Run the cycles with the basic block engine
      * 
-     * - Always takes a cycle for the Y page boundary)
-     * - See "STA (Indirect,Y)
+     * @tparam Watch check the breakpoints before each instruction
      */
-    Word _addrIndirectY_6();
+    template<bool Watch> void _executeBlock();
 
     /**
-     * @brief Load the specied Register with data in memory
+     * @brief Decoded basic blocks of the Block engine
      * 
-     * @param pAddress 
-     * @param pRegister 
      */
-    void _loadRegister(Word pAddress, Byte& pRegister);
+    CBlockCache _blocks;
 
     /**
-     * @brief And the A Register with the value from the memory address
+     * @brief Idle loops are skipped ahead
      * 
-     * @param pAddress 
      */
-    void _and( Word pAddress );
+    bool _idleSkip;
 
     /**
-     * @brief Or the A Register with the value from the memory address
+     * @brief The jump back of _idleBranch has been taken once, the
+     *        next time a whole iteration of its loop has run
      * 
-     * @param pAddress 
      */
-    void _ora( Word pAddress );
+    bool _idleArmed;
 
     /**
-     * @brief Eor the A Register with the value from the memory address
+     * @brief Address of the last jump back to an idle loop
      * 
-     * @param pAddress 
      */
-    void _eor( Word pAddress );
+    Word _idleBranch;
 
     /**
-     * @brief Conditional branch
+     * @brief Cycles skipped ahead in idle loops
      * 
-     * @param pTest 
-     * @param pExpected 
      */
-    void _branchIf( bool pTest, bool pExpected );
+    u64 _idleSkippedCycles;
 
     /**
-     * @brief Do add with carry given the the operand
+     * @brief Analysis result of the loop closed at each address
      * 
-     * @param pOperand 
      */
-    void _ADC( Byte pOperand );
-    
+    std::vector<Byte> _idleVerdicts;
+
     /**
-     * @brief Do subtract with carry given the the operand
+     * @brief Idle loops found, by address of their jump back
      * 
-     * @param pOperand 
      */
-    void _SBC( Byte pOperand );
+    std::unordered_map<Word, SIdleLoop> _idleLoops;
 
     /**
-     * @brief Sets the processor status for a CMP/CPX/CPY instruction
+     * @brief Tell the engines to look at the bus interrupt lines
      * 
-     * @param pOperand 
-     * @param pRegisterValue 
+     * @return true 
      */
-    void _registerCompare( Byte pOperand, Byte pRegisterValue );
+    bool _interruptPending() const { return bus.getInterrupts() != 0; }
 
     /**
-     * @brief Arithmetic shift left
+     * @brief Take the RESET, NMI or IRQ pending, before the
+     *        instruction at PC
      * 
-     * @param Operand 
-     * @return Byte 
+     * @return true when PC or the cycles changed
      */
-    Byte _ASL( Byte Operand );
+    bool _serviceInterrupts();
 
     /**
-     * @brief Logical shift right
+     * @brief Called by the core when a branch or JMP is taken,
+     *        PC being its target. Idle loops are run instruction by
+     *        instruction while breakpoints or runUntil are watched
      * 
-     * @param Operand 
-     * @return Byte 
+     * @param pFrom address of the branch or JMP
      */
-    Byte _LSR( Byte Operand );
+    void _onJump( const Word& pFrom )
+    {
+        if ( _idleSkip && !_watching() )
+        {
+            _idleJump( pFrom );
+        }
+    }
 
     /**
-     * @brief Rotate left
+     * @brief Called by the core when a branch is not taken
      * 
-     * @param Operand 
-     * @return Byte 
      */
-    Byte _ROL( Byte Operand );
+    void _onBranchNotTaken()
+    {
+        if ( _idleSkip )
+        {
+            _idleArmed = false;
+        }
+    }
 
     /**
-     * @brief Rotate right
+     * @brief Called when a branch or JMP is taken with idle skip on,
+     *        PC being its target
      * 
-     * @param Operand 
-     * @return Byte 
+     * @param pBranch address of the branch or JMP
      */
-    Byte _ROR( Byte Operand );
+    void _idleJump( const Word& pBranch );
 
     /**
-     * @brief Push Processor status onto the stack
-     *        Setting bits 4 & 5 on the stack
+     * @brief Run the iterations of an idle loop left in the cycles
+     *        at once, PC being its head
      * 
+     * @param pLoop 
      */
-    void _pushPSToStack();
+    void _skipIdleLoop( const SIdleLoop& pLoop );
 
     /**
-     * @brief Pop Processor status from the stack
-     *        Clearing bits 4 & 5 (Break & Unused)
+     * @brief Forget the analysed loops, code may have changed
      * 
      */
-    void _popPSFromStack();
+    void _clearIdleLoops();
 };
 
 }
@@ -0,0 +1,251 @@
+/**
+ * @file Fuzz.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef FUZZ_HPP
+#define FUZZ_HPP
+
+#include <m6502/Config.hpp>
+#include <m6502/System/Bus.hpp>
+#include <m6502/System/Cpu.hpp>
+#include <m6502/System/Mem.hpp>
+#include <vector>
+
+namespace m6502
+{
+
+/**
+ * @brief How the run of a fuzzer input ended
+ * 
+ */
+enum class EFuzzExit : Byte
+{
+    // BRK executed
+    Break,
+    // PC reached targetPC
+    Target,
+    // Cycle cap used
+    Cycles,
+    // Crash: opcode not handled by the CPU
+    Illegal,
+    // Crash: ADC or SBC in decimal mode
+    Decimal,
+    // Crash: push with the stack full
+    StackOverflow,
+    // Crash: pull with the stack empty
+    StackUnderflow
+};
+
+/**
+ * @brief System run by the harness and where inputs go
+ * 
+ */
+struct SFuzzConfig
+{
+    /**
+     * @brief Program as given to CCPU::loadPrg, load address first
+     * 
+     */
+    std::vector<Byte> program;
+
+    /**
+     * @brief PC after the program is loaded
+     * 
+     */
+    Word resetVector;
+
+    /**
+     * @brief Cycles run once to boot, before the snapshot
+     * 
+     */
+    s64 bootCycles;
+
+    /**
+     * @brief First address of the RAM given the input
+     * 
+     */
+    Word inputAddress;
+
+    /**
+     * @brief Bytes of the RAM given the input, longer inputs are cut
+     * 
+     */
+    u32 inputSize;
+
+    /**
+     * @brief Write the input size, as a little endian word, at sizeAddress
+     * 
+     */
+    bool writeSize;
+    Word sizeAddress;
+
+    /**
+     * @brief Stop when PC reaches targetPC
+     * 
+     */
+    bool stopOnTarget;
+    Word targetPC;
+
+    /**
+     * @brief Unused byte of memory the BRK vector is pointed at,
+     *        to stop on BRK without checking each instruction
+     * 
+     */
+    Word trapAddress;
+
+    /**
+     * @brief Cycle cap of each input
+     * 
+     */
+    s64 cycles;
+};
+
+/**
+ * @brief Verdict of a fuzzer input
+ * 
+ */
+struct SFuzzResult
+{
+    /**
+     * @brief How the run ended
+     * 
+     */
+    EFuzzExit exit;
+
+    /**
+     * @brief Cycles used
+     * 
+     */
+    s64 cycles;
+
+    /**
+     * @brief PC when the run ended, the address of the faulting
+     *        instruction for Illegal
+     * 
+     */
+    Word PC;
+
+    /**
+     * @brief Tell if the input crashed the system
+     * 
+     * @return true 
+     */
+    bool crashed() const { return exit >= EFuzzExit::Illegal; }
+};
+
+/**
+ * @brief In process fuzzing target: the system boots once, then each
+ *        input is run from the booted state, restored in place
+ *        The CPU stops on faults instead of throwing, BRK and targetPC
+ *        are turned into traps, so no instruction is checked. Only the
+ *        pages written by an input are restored
+ * 
+ */
+class CFuzzHarness
+{
+public:
+    /**
+     * @brief Construct a new harness and boot its system
+     * 
+     * @param pConfig 
+     */
+    explicit CFuzzHarness( const SFuzzConfig& pConfig );
+
+    /**
+     * @brief Run an input from the booted state
+     * 
+     * @param pInput 
+     * @param pSize 
+     * @return SFuzzResult 
+     */
+    SFuzzResult run( const Byte* pInput, size_t pSize );
+
+    /**
+     * @brief Get the CPU, e.g. to give it a coverage map
+     * 
+     * @return CCPU& 
+     */
+    CCPU& getCPU();
+
+    /**
+     * @brief Get the memory as left by the last run
+     * 
+     * @return const CMem& 
+     */
+    const CMem& getMem() const;
+
+    /**
+     * @brief Get the inputs run
+     * 
+     * @return u64 
+     */
+    u64 getRuns() const;
+
+private:
+    /**
+     * @brief Configuration given at construction
+     * 
+     */
+    SFuzzConfig _config;
+
+    /**
+     * @brief System run
+     * 
+     */
+    CBus _bus;
+    CCPU _cpu;
+    CMem _mem;
+
+    /**
+     * @brief Memory once booted
+     * 
+     */
+    std::vector<Byte> _boot;
+
+    /**
+     * @brief Registers once booted
+     * 
+     */
+    Word _bootPC;
+    Byte _bootSP;
+    Byte _bootA;
+    Byte _bootX;
+    Byte _bootY;
+    Byte _bootPS;
+
+    /**
+     * @brief Inputs run
+     * 
+     */
+    u64 _runs;
+
+    /**
+     * @brief Put back the pages written by the last run
+     * 
+     */
+    void _restore();
+};
+
+}
+
+#endif
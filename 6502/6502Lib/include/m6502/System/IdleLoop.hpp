@@ -0,0 +1,146 @@
+/**
+ * @file IdleLoop.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef IDLELOOP_HPP
+#define IDLELOOP_HPP
+
+#include <m6502/Config.hpp>
+#include <m6502/System/Bus.hpp>
+#include <m6502/System/BlockCache.hpp>
+#include <vector>
+
+namespace m6502
+{
+
+/**
+ * @brief What a loop does to the CPU on each iteration
+ * 
+ */
+enum class EIdleKind : Byte
+{
+    // Changes something else than registers, or can't be proven idle
+    None,
+    // Leaves every register as it is, loops until something else happens
+    Spin,
+    // Only steps X or Y, other registers keep the value of the first iteration
+    Count
+};
+
+/**
+ * @brief Register stepped by a counting loop
+ * 
+ */
+enum class EIdleCounter : Byte
+{
+    None,
+    X,
+    Y
+};
+
+/**
+ * @brief Loop made of a straight run of instructions, jumping back
+ *        to its first instruction, which writes nothing and reads
+ *        memory it does not modify (polling and delay loops)
+ * 
+ *        Once a whole iteration has run, each register written by
+ *        the loop, the counter excepted, keeps its value, so the
+ *        iterations left can be done at once
+ */
+struct SIdleLoop
+{
+    /**
+     * @brief Kind of loop
+     * 
+     */
+    EIdleKind kind;
+
+    /**
+     * @brief Address of the first instruction
+     * 
+     */
+    Word head;
+
+    /**
+     * @brief Address of the branch or JMP back to head
+     * 
+     */
+    Word branch;
+
+    /**
+     * @brief Register stepped by a counting loop
+     * 
+     */
+    EIdleCounter counter;
+
+    /**
+     * @brief +1 for INX / INY, -1 for DEX / DEY
+     * 
+     */
+    SByte step;
+
+    /**
+     * @brief The loop leaves once the counter reaches zero (BNE)
+     * 
+     */
+    bool exits;
+
+    /**
+     * @brief Z and N are last set by the counter step
+     * 
+     */
+    bool countSetsFlags;
+
+    /**
+     * @brief Cycles of an iteration, page crossings of indexed reads excluded
+     * 
+     */
+    s64 cycles;
+
+    /**
+     * @brief Instructions reading memory, the addresses read must give
+     *        the same value while the loop runs
+     * 
+     */
+    std::vector<SBlockInstruction> reads;
+
+    /**
+     * @brief Bytes of the loop when it was analysed
+     * 
+     */
+    std::vector<Byte> code;
+};
+
+/**
+ * @brief Analyse the loop closed by a branch or JMP back to head
+ * 
+ * @param pBus 
+ * @param pHead target of the branch
+ * @param pBranch address of the branch or JMP
+ * @return SIdleLoop kind None when not an idle loop
+ */
+SIdleLoop analyseIdleLoop(CBus& pBus, const Word& pHead, const Word& pBranch);
+
+}
+
+#endif
@@ -0,0 +1,1252 @@
+/**
+ * @file Instructions.inl
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+/*
+ * Instruction bodies shared by every dispatch engine and every bus.
+ * Each M6502_INSTRUCTION( Name ) defines the overload
+ * CCPUCore::_ins( SIns<Ins::Name>, TOperand ) executing the instruction
+ * whose opcode has just been fetched, its operand read through pOperand
+ * (SFetched or SDecoded). Included by CPUCore.hpp only.
+ */
+
+#define M6502_INSTRUCTION( Name ) \
+    template<class TCPU, class TBus> template<class TOperand> \
+    inline void CCPUCore<TCPU,TBus>::_ins( SIns<Ins::Name>, [[maybe_unused]] TOperand pOperand )
+
+M6502_INSTRUCTION( AND_IM )
+{
+    A &= _operandByte( pOperand );
+    _setZeroAndNegativeFlags(A);
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ORA_IM )
+{
+    A |= _operandByte( pOperand );
+    _setZeroAndNegativeFlags(A);
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( EOR_IM )
+{
+    A ^= _operandByte( pOperand );
+    _setZeroAndNegativeFlags(A);
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( AND_ZP )
+{
+    _and( _addrZeroPage( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ORA_ZP )
+{
+    _ora( _addrZeroPage( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( EOR_ZP )
+{
+    _eor( _addrZeroPage( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( AND_ZPX )
+{
+    _and( _addrZeroPageX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ORA_ZPX )
+{
+    _ora( _addrZeroPageX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( EOR_ZPX )
+{
+    _eor( _addrZeroPageX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( AND_ABS )
+{
+    _and( _addrAbsolute( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ORA_ABS )
+{
+    _ora( _addrAbsolute( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( EOR_ABS )
+{
+    _eor( _addrAbsolute( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( AND_ABSX )
+{
+    _and( _addrAbsoluteX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ORA_ABSX )
+{
+    _ora( _addrAbsoluteX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( EOR_ABSX )
+{
+    _eor( _addrAbsoluteX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( AND_ABSY )
+{
+    _and( _addrAbsoluteY( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ORA_ABSY )
+{
+    _ora( _addrAbsoluteY( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( EOR_ABSY )
+{
+    _eor( _addrAbsoluteY( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( AND_INDX )
+{
+    _and( _addrIndirectX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ORA_INDX )
+{
+    _ora( _addrIndirectX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( EOR_INDX )
+{
+    _eor( _addrIndirectX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( AND_INDY )
+{
+    _and( _addrIndirectY( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ORA_INDY )
+{
+    _ora( _addrIndirectY( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( EOR_INDY )
+{
+    _eor( _addrIndirectY( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BIT_ZP )
+{
+    Byte Value = _readByte( _addrZeroPage( pOperand ) );
+    _setZeroAndNegativeFlags( A & Value, Value );
+    _setFlagV( (Value & OverflowFlagBit) != 0 );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BIT_ABS )
+{
+    Byte Value = _readByte( _addrAbsolute( pOperand ) );
+    _setZeroAndNegativeFlags( A & Value, Value );
+    _setFlagV( (Value & OverflowFlagBit) != 0 );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDA_IM )
+{
+    A = _operandByte( pOperand );
+    _setZeroAndNegativeFlags(A);
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDX_IM )
+{
+    X = _operandByte( pOperand );
+    _setZeroAndNegativeFlags(X);
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDY_IM )
+{
+    Y = _operandByte( pOperand );
+    _setZeroAndNegativeFlags(Y);
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDA_ZP )
+{
+    _loadRegister ( _addrZeroPage( pOperand ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDX_ZP )
+{
+    _loadRegister ( _addrZeroPage( pOperand ), X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDY_ZP )
+{
+    _loadRegister ( _addrZeroPage( pOperand ), Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDA_ZPX )
+{
+    _loadRegister ( _addrZeroPageX( pOperand ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDX_ZPY )
+{
+    _loadRegister ( _addrZeroPageY( pOperand ), X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDY_ZPX )
+{
+    _loadRegister ( _addrZeroPageX( pOperand ), Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDA_ABS )
+{
+    _loadRegister ( _addrAbsolute( pOperand ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDX_ABS )
+{
+    _loadRegister ( _addrAbsolute( pOperand ), X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDY_ABS )
+{
+    _loadRegister ( _addrAbsolute( pOperand ), Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDA_ABSX )
+{
+    _loadRegister ( _addrAbsoluteX( pOperand ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDA_ABSY )
+{
+    _loadRegister ( _addrAbsoluteY( pOperand ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDX_ABSY )
+{
+    _loadRegister ( _addrAbsoluteY( pOperand ), X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDY_ABSX )
+{
+    _loadRegister ( _addrAbsoluteX( pOperand ), Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDA_INDX )
+{
+    _loadRegister ( _addrIndirectX( pOperand ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LDA_INDY )
+{
+    _loadRegister ( _addrIndirectY( pOperand ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STA_ZP )
+{
+    _writeByte ( A , _addrZeroPage( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STX_ZP )
+{
+    _writeByte ( X , _addrZeroPage( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STY_ZP )
+{
+    _writeByte ( Y , _addrZeroPage( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STA_ABS )
+{
+    _writeByte ( A , _addrAbsolute( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STX_ABS )
+{
+    _writeByte ( X , _addrAbsolute( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STY_ABS )
+{
+    _writeByte ( Y , _addrAbsolute( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STA_ZPX )
+{
+    _writeByte ( A , _addrZeroPageX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STY_ZPX )
+{
+    _writeByte ( Y , _addrZeroPageX( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STA_ABSX )
+{
+    _writeByte ( A , _addrAbsoluteX_5( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STA_ABSY )
+{
+    _writeByte ( A , _addrAbsoluteY_5( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STX_ZPY )
+{
+    _writeByte ( X , _addrZeroPageY( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STA_INDX )
+{
+    _writeByte ( A , _addrIndirectX_6( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( STA_INDY )
+{
+    _writeByte ( A , _addrIndirectY_6( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( JSR )
+{
+    Word SubAddr = _operandWord( pOperand );
+    _pushPCMinusOneToStack();
+    PC = SubAddr;
+    _cycles--;
+    _coverEdge();
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( RTS )
+{
+    PC = _popWordFromStack() + 1;
+    _cycles -= 2;
+    _coverEdge();
+}
+
+/*****************************************************************************/
+
+//TODO:
+//An original 6502 has does not correctly fetch the target
+//address if the indirect vector falls on a page boundary
+//( e.g.$xxFF where xx is any value from $00 to $FF ).
+//In this case fetches the LSB from $xxFF as expected but
+//takes the MSB from $xx00.This is fixed in some later chips
+//like the 65SC02 so for compatibility always ensure the
+//indirect vector is not at the end of the page.
+M6502_INSTRUCTION( JMP_ABS )
+{
+    const Word Jump = PC - 1;
+    PC = _addrAbsolute( pOperand );
+    _coverEdge();
+    _self()._onJump( Jump );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( JMP_IND )
+{
+    PC = _readWord( _addrAbsolute( pOperand ) );
+    _coverEdge();
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( TSX )
+{
+    X = SP;
+    _cycles--;
+    _setZeroAndNegativeFlags( X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( TXS )
+{
+    SP = X;
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( PHA )
+{
+    _pushByteOntoStack( A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( PLA )
+{
+    A = _popByteFromStack();
+    _setZeroAndNegativeFlags( A );
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( PHP )
+{
+    _pushPSToStack();
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( PLP )
+{
+    _popPSFromStack();
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( TAX )
+{
+    X = A;
+    _cycles--;
+    _setZeroAndNegativeFlags( X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( TAY )
+{
+    Y = A;
+    _cycles--;
+    _setZeroAndNegativeFlags( Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( TXA )
+{
+    A = X;
+    _cycles--;
+    _setZeroAndNegativeFlags( A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( TYA )
+{
+    A = Y;
+    _cycles--;
+    _setZeroAndNegativeFlags( A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( INX )
+{
+    X++;
+    _cycles--;
+    _setZeroAndNegativeFlags( X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( INY )
+{
+    Y++;
+    _cycles--;
+    _setZeroAndNegativeFlags( Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( DEX )
+{
+    X--;
+    _cycles--;
+    _setZeroAndNegativeFlags( X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( DEY )
+{
+    Y--;
+    _cycles--;
+    _setZeroAndNegativeFlags( Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( DEC_ZP )
+{
+    Word Address = _addrZeroPage( pOperand );
+    Byte Value = _readByte( Address );
+    Value--;
+    _cycles--;
+    _writeByte( Value, Address );
+    _setZeroAndNegativeFlags( Value );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( DEC_ZPX )
+{
+    Word Address = _addrZeroPageX( pOperand );
+    Byte Value = _readByte( Address );
+    Value--;
+    _cycles--;
+    _writeByte( Value, Address );
+    _setZeroAndNegativeFlags( Value );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( DEC_ABS )
+{
+    Word Address = _addrAbsolute( pOperand );
+    Byte Value = _readByte( Address );
+    Value--;
+    _cycles--;
+    _writeByte( Value, Address );
+    _setZeroAndNegativeFlags( Value );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( DEC_ABSX )
+{
+    Word Address = _addrAbsoluteX_5( pOperand );
+    Byte Value = _readByte( Address );
+    Value--;
+    _cycles--;
+    _writeByte( Value, Address );
+    _setZeroAndNegativeFlags( Value );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( INC_ZP )
+{
+    Word Address = _addrZeroPage( pOperand );
+    Byte Value = _readByte( Address );
+    Value++;
+    _cycles--;
+    _writeByte( Value, Address );
+    _setZeroAndNegativeFlags( Value );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( INC_ZPX )
+{
+    Word Address = _addrZeroPageX( pOperand );
+    Byte Value = _readByte( Address );
+    Value++;
+    _cycles--;
+    _writeByte( Value, Address );
+    _setZeroAndNegativeFlags( Value );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( INC_ABS )
+{
+    Word Address = _addrAbsolute( pOperand );
+    Byte Value = _readByte( Address );
+    Value++;
+    _cycles--;
+    _writeByte( Value, Address );
+    _setZeroAndNegativeFlags( Value );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( INC_ABSX )
+{
+    Word Address = _addrAbsoluteX_5( pOperand );
+    Byte Value = _readByte( Address );
+    Value++;
+    _cycles--;
+    _writeByte( Value, Address );
+    _setZeroAndNegativeFlags( Value );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BEQ )
+{
+    _branchIf( _flagZ(), true, pOperand );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BNE )
+{
+    _branchIf( _flagZ(), false, pOperand );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BSC )
+{
+    _branchIf( _flagC(), true, pOperand );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BCC )
+{
+    _branchIf( _flagC(), false, pOperand );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BMI )
+{
+    _branchIf( _flagN(), true, pOperand );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BPL )
+{
+    _branchIf( _flagN(), false, pOperand );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BVC )
+{
+    _branchIf( _flagV(), false, pOperand );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BVS )
+{
+    _branchIf( _flagV(), true, pOperand );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CLC )
+{
+    _setFlagC( false );
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SEC )
+{
+    _setFlagC( true );
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CLD )
+{
+    Flags.D = false;
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SED )
+{
+    Flags.D = true;
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CLI )
+{
+    Flags.I = false;
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SEI )
+{
+    Flags.I = true;
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CLV )
+{
+    _setFlagV( false );
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( NOP )
+{
+    _cycles--;
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ADC_ABS )
+{
+    _ADC( _readByte( _addrAbsolute( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ADC_ABSX )
+{
+    _ADC( _readByte( _addrAbsoluteX( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ADC_ABSY )
+{
+    _ADC( _readByte( _addrAbsoluteY( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ADC_ZP )
+{
+    _ADC( _readByte( _addrZeroPage( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ADC_ZPX )
+{
+    _ADC( _readByte( _addrZeroPageX( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ADC_INDX )
+{
+    _ADC( _readByte( _addrIndirectX( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ADC_INDY )
+{
+    _ADC( _readByte( _addrIndirectY( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ADC )
+{
+    _ADC( _operandByte( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SBC )
+{
+    _SBC( _operandByte( pOperand ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SBC_ABS )
+{
+    _SBC( _readByte( _addrAbsolute( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SBC_ZP )
+{
+    _SBC( _readByte( _addrZeroPage( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SBC_ZPX )
+{
+    _SBC( _readByte( _addrZeroPageX( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SBC_ABSX )
+{
+    _SBC( _readByte ( _addrAbsoluteX( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SBC_ABSY )
+{
+    _SBC( _readByte( _addrAbsoluteY( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SBC_INDX )
+{
+    _SBC( _readByte( _addrIndirectX( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( SBC_INDY )
+{
+    _SBC( _readByte( _addrIndirectY( pOperand ) ) );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CPX )
+{
+    _registerCompare( _operandByte( pOperand ) , X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CPY )
+{
+    _registerCompare( _operandByte( pOperand ), Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CPX_ZP )
+{
+    _registerCompare( _readByte( _addrZeroPage( pOperand ) ), X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CPY_ZP )
+{
+    _registerCompare( _readByte( _addrZeroPage( pOperand ) ), Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CPX_ABS )
+{
+    _registerCompare( _readByte ( _addrAbsolute( pOperand ) ), X );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CPY_ABS )
+{
+    _registerCompare( _readByte ( _addrAbsolute( pOperand ) ), Y );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CMP )
+{
+    _registerCompare( _operandByte( pOperand ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CMP_ZP )
+{
+    _registerCompare( _readByte( _addrZeroPage( pOperand ) ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CMP_ZPX )
+{
+    _registerCompare( _readByte( _addrZeroPageX( pOperand ) ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CMP_ABS )
+{
+    _registerCompare( _readByte( _addrAbsolute( pOperand ) ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CMP_ABSX )
+{
+    _registerCompare( _readByte( _addrAbsoluteX( pOperand ) ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CMP_ABSY )
+{
+    _registerCompare( _readByte( _addrAbsoluteY( pOperand ) ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CMP_INDX )
+{
+    _registerCompare( _readByte( _addrIndirectX( pOperand ) ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( CMP_INDY )
+{
+    _registerCompare( _readByte( _addrIndirectY( pOperand ) ), A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ASL )
+{
+    A = _ASL( A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ASL_ZP )
+{
+    Word Address = _addrZeroPage( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ASL( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ASL_ZPX )
+{
+    Word Address = _addrZeroPageX( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ASL( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ASL_ABS )
+{
+    Word Address = _addrAbsolute( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ASL( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ASL_ABSX )
+{
+    Word Address = _addrAbsoluteX_5( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ASL( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LSR )
+{
+    A = _LSR( A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LSR_ZP )
+{
+    Word Address = _addrZeroPage( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _LSR( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LSR_ZPX )
+{
+    Word Address = _addrZeroPageX( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _LSR( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LSR_ABS )
+{
+    Word Address = _addrAbsolute( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _LSR( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( LSR_ABSX )
+{
+    Word Address = _addrAbsoluteX_5( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _LSR( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROL )
+{
+    A = _ROL( A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROL_ZP )
+{
+    Word Address = _addrZeroPage( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ROL( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROL_ZPX )
+{
+    Word Address = _addrZeroPageX( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ROL( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROL_ABS )
+{
+    Word Address = _addrAbsolute( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ROL( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROL_ABSX )
+{
+    Word Address = _addrAbsoluteX_5( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ROL( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROR )
+{
+    A = _ROR( A );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROR_ZP )
+{
+    Word Address = _addrZeroPage( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ROR( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROR_ZPX )
+{
+    Word Address = _addrZeroPageX( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ROR( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROR_ABS )
+{
+    Word Address = _addrAbsolute( pOperand );
+    Byte Operand = _readByte( Address );
+    Byte Result = _ROR( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( ROR_ABSX )
+{
+    Word Address = _addrAbsoluteX_5( pOperand );
+    Byte Operand = _readByte(Address);
+    Byte Result = _ROR( Operand );
+    _writeByte( Result, Address );
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( BRK )
+{
+    if ( _breakStop )
+    {
+        // Stopped on the opcode
+        _unfetch();
+        _raiseStop( EStop::Break );
+        return;
+    }
+    _pushPCPlusOneToStack();
+    _pushPSToStack();
+    constexpr Word InterruptVector = 0xFFFE;
+    PC = _readWord( InterruptVector );
+    Flags.B = true;
+    Flags.I = true;
+    _coverEdge();
+}
+
+/*****************************************************************************/
+
+M6502_INSTRUCTION( RTI )
+{
+    _popPSFromStack();
+    PC = _popWordFromStack();
+    _coverEdge();
+}
+
+#undef M6502_INSTRUCTION
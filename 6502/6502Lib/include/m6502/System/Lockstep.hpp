@@ -0,0 +1,339 @@
+/**
+ * @file Lockstep.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef LOCKSTEP_HPP
+#define LOCKSTEP_HPP
+
+#include <m6502/Config.hpp>
+#include <array>
+#include <vector>
+
+namespace m6502
+{
+
+/**
+ * @brief Registers of one lane of a CLockstepCPU
+ * 
+ */
+struct SLaneRegisters
+{
+    Word PC;
+    Byte SP;
+    Byte A;
+    Byte X;
+    Byte Y;
+    Byte PS;
+};
+
+/**
+ * @brief Counters of a CLockstepCPU
+ * 
+ */
+struct SLockstepStats
+{
+    /**
+     * @brief Opcodes dispatched, each one for a group of lanes
+     * 
+     */
+    u64 dispatches;
+
+    /**
+     * @brief Instructions run, summed over the lanes
+     * 
+     */
+    u64 instructions;
+};
+
+/**
+ * @brief Many 6502 running in lockstep, one per lane, each one with
+ *        its registers, cycles and 64KB of memory
+ *        Registers are kept lane by lane (structure of arrays) and memory
+ *        is interleaved, the byte of each lane for an address being
+ *        next to each other. Each dispatch runs the opcode at the lowest
+ *        PC for every lane at this PC with this opcode, lanes which
+ *        diverged on a branch wait for their turn. Instructions are
+ *        loops over the lanes, blending results with the lane mask,
+ *        which the compiler turns into SSE/AVX2 vector code.
+ *        Each lane runs as a CCPU on its own memory would, lanes
+ *        running an opcode the CPU does not handle, or ADC / SBC in
+ *        decimal mode, stop and are reported faulted.
+ *        Built for 8, 16 and 32 lanes.
+ * 
+ * @tparam Lanes 
+ */
+template<u32 Lanes>
+class CLockstepCPU
+{
+public:
+    /**
+     * @brief Value of each lane
+     * 
+     * @tparam T 
+     */
+    template<class T> using lanes_t = std::array<T, Lanes>;
+
+    /**
+     * @brief Construct lanes with cleared memory, reset at 0xFFFC
+     * 
+     */
+    CLockstepCPU();
+
+    /**
+     * @brief Reset every lane with the given start vector,
+     *        memory is kept
+     * 
+     * @param pResetVector 
+     */
+    void reset( const Word& pResetVector );
+
+    /**
+     * @brief Load program in the memory of every lane, PC of every
+     *        lane is set to the load address
+     * 
+     * @param pProgram load address first, as CCPU::loadPrg
+     * @param pNumBytes 
+     * @return Word the load address, 0 if no program
+     */
+    Word loadPrg( const Byte* pProgram, u32 pNumBytes );
+
+    /**
+     * @brief Run every lane for the given cycles, as CCPU::execute
+     * 
+     * @param pCycles 
+     */
+    void execute( s64 pCycles );
+
+    /**
+     * @brief Get the cycles run by a lane in the last execute
+     * 
+     * @param pLane 
+     * @return s64 
+     */
+    s64 getCycles( u32 pLane ) const;
+
+    /**
+     * @brief Tell if a lane stopped on an instruction it cannot run
+     *        Its registers are the ones before that instruction
+     * 
+     * @param pLane 
+     * @return true 
+     */
+    bool isFaulted( u32 pLane ) const;
+
+    /**
+     * @brief Get the registers of a lane
+     * 
+     * @param pLane 
+     * @return SLaneRegisters 
+     */
+    SLaneRegisters getRegisters( u32 pLane ) const;
+
+    /**
+     * @brief Set the registers of a lane
+     * 
+     * @param pLane 
+     * @param pRegisters 
+     */
+    void setRegisters( u32 pLane, const SLaneRegisters& pRegisters );
+
+    /**
+     * @brief Read the memory of a lane
+     * 
+     * @param pLane 
+     * @param pAddress 
+     * @return Byte 
+     */
+    Byte read( u32 pLane, const Word& pAddress ) const { return _memory[pAddress * Lanes + pLane]; }
+
+    /**
+     * @brief Write the memory of a lane
+     * 
+     * @param pLane 
+     * @param pAddress 
+     * @param pData 
+     */
+    void write( u32 pLane, const Word& pAddress, const Byte& pData ) { _memory[pAddress * Lanes + pLane] = pData; }
+
+    /**
+     * @brief Get the counters since construction
+     * 
+     * @return const SLockstepStats& 
+     */
+    const SLockstepStats& getStats() const;
+
+private:
+    alignas(32) lanes_t<Word> _pc;
+    alignas(32) lanes_t<Byte> _sp;
+    alignas(32) lanes_t<Byte> _a;
+    alignas(32) lanes_t<Byte> _x;
+    alignas(32) lanes_t<Byte> _y;
+
+    /**
+     * @brief Status flags, 0 or 1 for each lane
+     * 
+     */
+    alignas(32) lanes_t<Byte> _c;
+    alignas(32) lanes_t<Byte> _z;
+    alignas(32) lanes_t<Byte> _i;
+    alignas(32) lanes_t<Byte> _d;
+    alignas(32) lanes_t<Byte> _b;
+    alignas(32) lanes_t<Byte> _u;
+    alignas(32) lanes_t<Byte> _v;
+    alignas(32) lanes_t<Byte> _n;
+
+    /**
+     * @brief Cycles left in the slice of execute being run, 32 bits
+     *        so lanes compare and count with SSE2
+     * 
+     */
+    alignas(32) lanes_t<s32> _cycles;
+
+    /**
+     * @brief Cycles given to each lane by the last execute
+     * 
+     */
+    lanes_t<s64> _given;
+
+    /**
+     * @brief Lane stopped on an instruction it cannot run
+     * 
+     */
+    alignas(32) lanes_t<Byte> _faulted;
+
+    /**
+     * @brief 0xFF on the lanes running the instruction dispatched, 0
+     *        elsewhere, a member so the compiler knows it is not
+     *        another lane array
+     * 
+     */
+    alignas(32) lanes_t<Byte> _mask;
+
+    /**
+     * @brief First lane of _mask
+     * 
+     */
+    u32 _leader;
+
+    /**
+     * @brief Memory of the lanes, lane bytes of address 0, then
+     *        lane bytes of address 1...
+     * 
+     */
+    std::vector<Byte> _memory;
+
+    /**
+     * @brief Counters
+     * 
+     */
+    SLockstepStats _stats;
+
+    /**
+     * @brief Tell if every lane of _mask uses the address of the
+     *        leader, whose row of lane bytes is then read or written
+     *        at once
+     * 
+     * @param pAddress 
+     * @return true 
+     */
+    bool _uniform( const lanes_t<Word>& pAddress ) const;
+
+    /**
+     * @brief Read a byte of each lane at the given addresses
+     * 
+     * @param pAddress 
+     * @param pValue 
+     */
+    void _gather( const lanes_t<Word>& pAddress, lanes_t<Byte>& pValue ) const;
+
+    /**
+     * @brief Read a word of each lane at the given addresses,
+     *        high byte at address + 1
+     * 
+     * @param pAddress 
+     * @param pValue 
+     */
+    void _gatherWord( const lanes_t<Word>& pAddress, lanes_t<Word>& pValue ) const;
+
+    /**
+     * @brief Write a byte of the lanes of _mask
+     * 
+     * @param pAddress 
+     * @param pValue 
+     */
+    void _scatter( const lanes_t<Word>& pAddress, const lanes_t<Byte>& pValue );
+
+    /**
+     * @brief Push a byte on the stack of the lanes of _mask
+     * 
+     * @param pValue 
+     */
+    void _push( const lanes_t<Byte>& pValue );
+
+    /**
+     * @brief Pop a byte from the stack of the lanes of _mask
+     * 
+     * @param pValue 
+     */
+    void _pop( lanes_t<Byte>& pValue );
+
+    /**
+     * @brief Set Z and N of the lanes of _mask from a result
+     * 
+     * @param pValue 
+     */
+    void _setZeroAndNegativeFlags( const lanes_t<Byte>& pValue );
+
+    /**
+     * @brief Get the status register of each lane
+     * 
+     * @param pPS 
+     */
+    void _status( lanes_t<Byte>& pPS ) const;
+
+    /**
+     * @brief Set the status register of the lanes of the mask
+     * 
+     * @param pMask 
+     * @param pPS 
+     */
+    void _setStatus( const lanes_t<Byte>& pMask, const lanes_t<Byte>& pPS );
+
+    /**
+     * @brief Run the lanes until none has cycles left
+     * 
+     */
+    void _run();
+
+    /**
+     * @brief Run the opcode at pPC for the lanes of _mask
+     * 
+     * @param pPC 
+     * @param pOpCode 
+     */
+    void _dispatch( const Word& pPC, const Byte& pOpCode );
+};
+
+}
+
+#endif
@@ -28,6 +28,7 @@
 #include <m6502/Config.hpp>
 #include <m6502/System/Bus.hpp>
 #include <array>
+#include <vector>
 namespace m6502
 {
 
@@ -79,16 +80,152 @@ public:
      */
     Byte& operator[]( const Word& Address);
 
+    /**
+     * @brief First bytes of a delta, "M65D" read as little endian
+     * 
+     */
+    static constexpr u32 DeltaMagic = 0x4435364D;
+
+    /**
+     * @brief Format of the deltas written, changed with their layout
+     * 
+     */
+    static constexpr Word DeltaVersion = 1;
+
+    /**
+     * @brief Track the pages written since the last delta
+     *        Clean pages are not written directly by the bus, the first
+     *        write on each goes through the chip to mark it dirty
+     *        All pages start clean
+     * 
+     * @param pEnabled 
+     */
+    void setDirtyTracking( bool pEnabled );
+
+    /**
+     * @brief Tell if written pages are tracked
+     * 
+     * @return true 
+     */
+    bool getDirtyTracking() const;
+
+    /**
+     * @brief Tell if a page has been written since the last delta
+     *        operator[] gives write access, it marks the page too
+     * 
+     * @param pPage high byte of the page address
+     * @return true 
+     */
+    bool isDirty( const Byte& pPage ) const;
+
+    /**
+     * @brief Get the count of pages written since the last delta
+     * 
+     * @return u32 
+     */
+    u32 getDirtyPages() const;
+
+    /**
+     * @brief Save the pages written since the last delta and make
+     *        every page clean: magic, version, page count, then the
+     *        number and bytes of each page
+     *        The delta is reused, no allocation once big enough
+     * 
+     * @param pDelta 
+     */
+    void delta( std::vector<Byte>& pDelta );
+
+    /**
+     * @brief Make every page clean without saving a delta
+     * 
+     */
+    void clearDirty();
+
+    /**
+     * @brief Load the pages of a delta
+     *        Loaded pages are dirty, code changed needs
+     *        CCPU::flushBlockCache like operator[]
+     * 
+     * @param pDelta 
+     * @param pSize 
+     * @return true when the delta is valid and loaded
+     */
+    bool applyDelta( const Byte* pDelta, size_t pSize );
+
+    /**
+     * @brief Load a chain of deltas, oldest first, once all are valid
+     * 
+     * @param pChain 
+     * @return true when the chain is valid and loaded
+     */
+    bool applyDeltas( const std::vector<std::vector<Byte>>& pChain );
+
 protected:
     void onWriteBusData ( const Word& pAddress, const Byte& pData ) override;
     Byte onReadBusData ( const Word& pAddress) override;
 
+    /**
+     * @brief Memory is plain RAM, the bus reads and writes it directly
+     * 
+     * @param pOffset 
+     * @return const Byte* 
+     */
+    const Byte* onMapReadPage ( const Word& pOffset ) override;
+
+    /**
+     * @brief Memory is plain RAM, the bus reads and writes it directly
+     * 
+     * @param pOffset 
+     * @return Byte* 
+     */
+    Byte* onMapWritePage ( const Word& pOffset ) override;
+
+    /**
+     * @brief The whole memory is saved in snapshots
+     * 
+     * @return u32 
+     */
+    u32 onStateSize () const override;
+    void onSaveState ( Byte* pState ) const override;
+    void onLoadState ( const Byte* pState ) override;
+
 private:
     /**
      * @brief Memory container
      * 
      */
     std::array<Byte,MAX_MEM> _data;
+
+    /**
+     * @brief Pages written since the last delta, one bit per page
+     * 
+     */
+    std::array<u64,4> _dirty;
+
+    /**
+     * @brief Written pages are tracked
+     * 
+     */
+    bool _tracking;
+
+    /**
+     * @brief Mark a page written
+     * 
+     * @param pPage 
+     */
+    void _markDirty( const Byte& pPage )
+    {
+        _dirty[pPage >> 6] |= u64(1) << (pPage & 63);
+    }
+
+    /**
+     * @brief Tell if a delta is valid
+     * 
+     * @param pDelta 
+     * @param pSize 
+     * @return true 
+     */
+    static bool _isValidDelta( const Byte* pDelta, size_t pSize );
 };
 
 }
@@ -239,6 +239,66 @@ enum class Ins : Byte
 	RTI = 0x40
 };
 
+/**
+ * @brief Addressing modes of 6502 instructions
+ * 
+ */
+enum class EAddrMode : Byte
+{
+    Implied,
+    Accumulator,
+    Immediate,
+    ZeroPage,
+    ZeroPageX,
+    ZeroPageY,
+    Absolute,
+    AbsoluteX,
+    AbsoluteY,
+    Indirect,
+    IndirectX,
+    IndirectY,
+    Relative
+};
+
+/**
+ * @brief Extra cycles rule applied on top of
+ *        the base cycle count of an instruction
+ * 
+ */
+enum class EPagePenalty : Byte
+{
+    // Always takes the base cycle count
+    None,
+    // +1 cycle when the indexed address crosses a page
+    PageCross,
+    // +1 cycle when the branch is taken, +1 more if it crosses a page
+    Branch
+};
+
+/**
+ * @brief Number of bytes (opcode included) of an instruction
+ *        using the given addressing mode
+ * 
+ * @param pMode 
+ * @return constexpr Byte 
+ */
+constexpr Byte instructionSize(EAddrMode pMode)
+{
+    switch (pMode)
+    {
+        case EAddrMode::Implied:
+        case EAddrMode::Accumulator:
+            return 1;
+        case EAddrMode::Absolute:
+        case EAddrMode::AbsoluteX:
+        case EAddrMode::AbsoluteY:
+        case EAddrMode::Indirect:
+            return 3;
+        default:
+            return 2;
+    }
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,211 @@
+/**
+ * @file OpTable.inl
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+/*
+ * List of the implemented instructions, one line per Ins enum value :
+ *
+ *     M6502_OP( Name, Addressing mode, Base cycles, Page penalty )
+ *
+ * Define M6502_OP before including this file, it is undefined at the end.
+ * Used to generate the switch, the dispatch table and the threaded labels
+ * so every engine stays in sync with the Ins enum.
+ */
+
+#ifndef M6502_OP
+#error "M6502_OP must be defined before including OpTable.inl"
+#endif
+
+//LDA
+M6502_OP( LDA_IM,   Immediate,   2, None )
+M6502_OP( LDA_ZP,   ZeroPage,    3, None )
+M6502_OP( LDA_ZPX,  ZeroPageX,   4, None )
+M6502_OP( LDA_ABS,  Absolute,    4, None )
+M6502_OP( LDA_ABSX, AbsoluteX,   4, PageCross )
+M6502_OP( LDA_ABSY, AbsoluteY,   4, PageCross )
+M6502_OP( LDA_INDX, IndirectX,   6, None )
+M6502_OP( LDA_INDY, IndirectY,   5, PageCross )
+//LDX
+M6502_OP( LDX_IM,   Immediate,   2, None )
+M6502_OP( LDX_ZP,   ZeroPage,    3, None )
+M6502_OP( LDX_ZPY,  ZeroPageY,   4, None )
+M6502_OP( LDX_ABS,  Absolute,    4, None )
+M6502_OP( LDX_ABSY, AbsoluteY,   4, PageCross )
+//LDY
+M6502_OP( LDY_IM,   Immediate,   2, None )
+M6502_OP( LDY_ZP,   ZeroPage,    3, None )
+M6502_OP( LDY_ZPX,  ZeroPageX,   4, None )
+M6502_OP( LDY_ABS,  Absolute,    4, None )
+M6502_OP( LDY_ABSX, AbsoluteX,   4, PageCross )
+//STA
+M6502_OP( STA_ZP,   ZeroPage,    3, None )
+M6502_OP( STA_ZPX,  ZeroPageX,   4, None )
+M6502_OP( STA_ABS,  Absolute,    4, None )
+M6502_OP( STA_ABSX, AbsoluteX,   5, None )
+M6502_OP( STA_ABSY, AbsoluteY,   5, None )
+M6502_OP( STA_INDX, IndirectX,   6, None )
+M6502_OP( STA_INDY, IndirectY,   6, None )
+//STX
+M6502_OP( STX_ZP,   ZeroPage,    3, None )
+M6502_OP( STX_ZPY,  ZeroPageY,   4, None )
+M6502_OP( STX_ABS,  Absolute,    4, None )
+//STY
+M6502_OP( STY_ZP,   ZeroPage,    3, None )
+M6502_OP( STY_ZPX,  ZeroPageX,   4, None )
+M6502_OP( STY_ABS,  Absolute,    4, None )
+//Stack
+M6502_OP( TSX,      Implied,     2, None )
+M6502_OP( TXS,      Implied,     2, None )
+M6502_OP( PHA,      Implied,     3, None )
+M6502_OP( PLA,      Implied,     4, None )
+M6502_OP( PHP,      Implied,     3, None )
+M6502_OP( PLP,      Implied,     4, None )
+//Jumps and calls
+M6502_OP( JMP_ABS,  Absolute,    3, None )
+M6502_OP( JMP_IND,  Indirect,    5, None )
+M6502_OP( JSR,      Absolute,    6, None )
+M6502_OP( RTS,      Implied,     6, None )
+//AND
+M6502_OP( AND_IM,   Immediate,   2, None )
+M6502_OP( AND_ZP,   ZeroPage,    3, None )
+M6502_OP( AND_ZPX,  ZeroPageX,   4, None )
+M6502_OP( AND_ABS,  Absolute,    4, None )
+M6502_OP( AND_ABSX, AbsoluteX,   4, PageCross )
+M6502_OP( AND_ABSY, AbsoluteY,   4, PageCross )
+M6502_OP( AND_INDX, IndirectX,   6, None )
+M6502_OP( AND_INDY, IndirectY,   5, PageCross )
+//OR
+M6502_OP( ORA_IM,   Immediate,   2, None )
+M6502_OP( ORA_ZP,   ZeroPage,    3, None )
+M6502_OP( ORA_ZPX,  ZeroPageX,   4, None )
+M6502_OP( ORA_ABS,  Absolute,    4, None )
+M6502_OP( ORA_ABSX, AbsoluteX,   4, PageCross )
+M6502_OP( ORA_ABSY, AbsoluteY,   4, PageCross )
+M6502_OP( ORA_INDX, IndirectX,   6, None )
+M6502_OP( ORA_INDY, IndirectY,   5, PageCross )
+//EOR
+M6502_OP( EOR_IM,   Immediate,   2, None )
+M6502_OP( EOR_ZP,   ZeroPage,    3, None )
+M6502_OP( EOR_ZPX,  ZeroPageX,   4, None )
+M6502_OP( EOR_ABS,  Absolute,    4, None )
+M6502_OP( EOR_ABSX, AbsoluteX,   4, PageCross )
+M6502_OP( EOR_ABSY, AbsoluteY,   4, PageCross )
+M6502_OP( EOR_INDX, IndirectX,   6, None )
+M6502_OP( EOR_INDY, IndirectY,   5, PageCross )
+//BIT
+M6502_OP( BIT_ZP,   ZeroPage,    3, None )
+M6502_OP( BIT_ABS,  Absolute,    4, None )
+//Register Transfer
+M6502_OP( TAX,      Implied,     2, None )
+M6502_OP( TAY,      Implied,     2, None )
+M6502_OP( TXA,      Implied,     2, None )
+M6502_OP( TYA,      Implied,     2, None )
+//Increments, Decrements
+M6502_OP( INX,      Implied,     2, None )
+M6502_OP( INY,      Implied,     2, None )
+M6502_OP( DEY,      Implied,     2, None )
+M6502_OP( DEX,      Implied,     2, None )
+M6502_OP( DEC_ZP,   ZeroPage,    5, None )
+M6502_OP( DEC_ZPX,  ZeroPageX,   6, None )
+M6502_OP( DEC_ABS,  Absolute,    6, None )
+M6502_OP( DEC_ABSX, AbsoluteX,   7, None )
+M6502_OP( INC_ZP,   ZeroPage,    5, None )
+M6502_OP( INC_ZPX,  ZeroPageX,   6, None )
+M6502_OP( INC_ABS,  Absolute,    6, None )
+M6502_OP( INC_ABSX, AbsoluteX,   7, None )
+// Conditional Branch
+M6502_OP( BEQ,      Relative,    2, Branch )
+M6502_OP( BNE,      Relative,    2, Branch )
+M6502_OP( BSC,      Relative,    2, Branch )
+M6502_OP( BCC,      Relative,    2, Branch )
+M6502_OP( BMI,      Relative,    2, Branch )
+M6502_OP( BPL,      Relative,    2, Branch )
+M6502_OP( BVC,      Relative,    2, Branch )
+M6502_OP( BVS,      Relative,    2, Branch )
+// Status flag changes
+M6502_OP( CLC,      Implied,     2, None )
+M6502_OP( SEC,      Implied,     2, None )
+M6502_OP( CLD,      Implied,     2, None )
+M6502_OP( SED,      Implied,     2, None )
+M6502_OP( CLI,      Implied,     2, None )
+M6502_OP( SEI,      Implied,     2, None )
+M6502_OP( CLV,      Implied,     2, None )
+//Arithmetic
+M6502_OP( ADC,      Immediate,   2, None )
+M6502_OP( ADC_ZP,   ZeroPage,    3, None )
+M6502_OP( ADC_ZPX,  ZeroPageX,   4, None )
+M6502_OP( ADC_ABS,  Absolute,    4, None )
+M6502_OP( ADC_ABSX, AbsoluteX,   4, PageCross )
+M6502_OP( ADC_ABSY, AbsoluteY,   4, PageCross )
+M6502_OP( ADC_INDX, IndirectX,   6, None )
+M6502_OP( ADC_INDY, IndirectY,   5, PageCross )
+M6502_OP( SBC,      Immediate,   2, None )
+M6502_OP( SBC_ZP,   ZeroPage,    3, None )
+M6502_OP( SBC_ZPX,  ZeroPageX,   4, None )
+M6502_OP( SBC_ABS,  Absolute,    4, None )
+M6502_OP( SBC_ABSX, AbsoluteX,   4, PageCross )
+M6502_OP( SBC_ABSY, AbsoluteY,   4, PageCross )
+M6502_OP( SBC_INDX, IndirectX,   6, None )
+M6502_OP( SBC_INDY, IndirectY,   5, PageCross )
+// Register Comparison
+M6502_OP( CMP,      Immediate,   2, None )
+M6502_OP( CMP_ZP,   ZeroPage,    3, None )
+M6502_OP( CMP_ZPX,  ZeroPageX,   4, None )
+M6502_OP( CMP_ABS,  Absolute,    4, None )
+M6502_OP( CMP_ABSX, AbsoluteX,   4, PageCross )
+M6502_OP( CMP_ABSY, AbsoluteY,   4, PageCross )
+M6502_OP( CMP_INDX, IndirectX,   6, None )
+M6502_OP( CMP_INDY, IndirectY,   5, PageCross )
+M6502_OP( CPX,      Immediate,   2, None )
+M6502_OP( CPY,      Immediate,   2, None )
+M6502_OP( CPX_ZP,   ZeroPage,    3, None )
+M6502_OP( CPY_ZP,   ZeroPage,    3, None )
+M6502_OP( CPX_ABS,  Absolute,    4, None )
+M6502_OP( CPY_ABS,  Absolute,    4, None )
+// shifts
+M6502_OP( ASL,      Accumulator, 2, None )
+M6502_OP( ASL_ZP,   ZeroPage,    5, None )
+M6502_OP( ASL_ZPX,  ZeroPageX,   6, None )
+M6502_OP( ASL_ABS,  Absolute,    6, None )
+M6502_OP( ASL_ABSX, AbsoluteX,   7, None )
+M6502_OP( LSR,      Accumulator, 2, None )
+M6502_OP( LSR_ZP,   ZeroPage,    5, None )
+M6502_OP( LSR_ZPX,  ZeroPageX,   6, None )
+M6502_OP( LSR_ABS,  Absolute,    6, None )
+M6502_OP( LSR_ABSX, AbsoluteX,   7, None )
+M6502_OP( ROL,      Accumulator, 2, None )
+M6502_OP( ROL_ZP,   ZeroPage,    5, None )
+M6502_OP( ROL_ZPX,  ZeroPageX,   6, None )
+M6502_OP( ROL_ABS,  Absolute,    6, None )
+M6502_OP( ROL_ABSX, AbsoluteX,   7, None )
+M6502_OP( ROR,      Accumulator, 2, None )
+M6502_OP( ROR_ZP,   ZeroPage,    5, None )
+M6502_OP( ROR_ZPX,  ZeroPageX,   6, None )
+M6502_OP( ROR_ABS,  Absolute,    6, None )
+M6502_OP( ROR_ABSX, AbsoluteX,   7, None )
+// Misc
+M6502_OP( NOP,      Implied,     2, None )
+M6502_OP( BRK,      Implied,     7, None )
+M6502_OP( RTI,      Implied,     6, None )
+
+#undef M6502_OP
@@ -0,0 +1,217 @@
+/**
+ * @file Rom.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+
+#ifndef ROM_HPP
+#define ROM_HPP
+
+#include <m6502/Config.hpp>
+#include <m6502/System/Bus.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace m6502
+{
+
+/**
+ * @brief ROM file mapped read only in the process, shared by all
+ *        the ROM chips opening the same file
+ *        Files are memory mapped (read into memory on Windows),
+ *        the image is unmapped with the last chip holding it
+ *        The file must not be changed while mapped
+ * 
+ */
+class CRomImage
+{
+public:
+    /**
+     * @brief Get the image of a file, mapped on the first open
+     * 
+     * @param pPath 
+     * @return std::shared_ptr<const CRomImage> nullptr when the file
+     *         can't be mapped or is empty
+     */
+    static std::shared_ptr<const CRomImage> open( const std::string& pPath );
+
+    /**
+     * @brief Get the files the process keeps an image entry for,
+     *        entries no ROM holds are dropped by the next open
+     * 
+     * @return size_t 
+     */
+    static size_t getShared();
+
+    CRomImage( const CRomImage& ) = delete;
+    CRomImage& operator=( const CRomImage& ) = delete;
+
+    /**
+     * @brief Unmap the file
+     * 
+     */
+    ~CRomImage();
+
+    /**
+     * @brief Get the bytes of the file
+     * 
+     * @return const Byte* 
+     */
+    const Byte* getData() const { return _data; }
+
+    /**
+     * @brief Get the size of the file
+     * 
+     * @return size_t 
+     */
+    size_t getSize() const { return _size; }
+
+private:
+    /**
+     * @brief Construct an image, open maps its file
+     * 
+     */
+    CRomImage() = default;
+
+    /**
+     * @brief Bytes of the file
+     * 
+     */
+    const Byte* _data = nullptr;
+
+    /**
+     * @brief Size of the file
+     * 
+     */
+    size_t _size = 0;
+
+    /**
+     * @brief File read into memory where it is not mapped
+     * 
+     */
+    std::vector<Byte> _copy;
+};
+
+/**
+ * @brief Read only memory chip on a shared ROM image
+ *        Whole pages of the image are read directly by the bus,
+ *        writes are ignored. Addresses past the end of the image
+ *        read 0xFF
+ * 
+ */
+class CRom : CBusChip
+{
+public:
+    /**
+     * @brief Construct a ROM without image, reading 0xFF
+     * 
+     * @param pBus 
+     * @param pMask 
+     * @param pBank 
+     */
+    explicit CRom( CBus& pBus, const Word& pMask, const Word& pBank );
+
+    /**
+     * @brief Construct a ROM on an image
+     * 
+     * @param pBus 
+     * @param pMask 
+     * @param pBank 
+     * @param pImage 
+     */
+    CRom( CBus& pBus, const Word& pMask, const Word& pBank, std::shared_ptr<const CRomImage> pImage );
+
+    /**
+     * @brief Use the image of a file, the image of the same file is
+     *        shared with the other ROMs of the process
+     * 
+     * @param pPath 
+     * @return false when the file can't be mapped, the image is unchanged
+     */
+    bool load( const std::string& pPath );
+
+    /**
+     * @brief Use an image
+     * 
+     * @param pImage 
+     */
+    void load( std::shared_ptr<const CRomImage> pImage );
+
+    /**
+     * @brief Get the image, nullptr when none
+     * 
+     * @return const std::shared_ptr<const CRomImage>& 
+     */
+    const std::shared_ptr<const CRomImage>& getImage() const { return _image; }
+
+    /**
+     * @brief Read 1 Byte, offset from the bank of the chip
+     * 
+     * @param pOffset 
+     * @return Byte 
+     */
+    Byte operator[]( const Word& pOffset ) const;
+
+    /**
+     * @brief Get the writes ignored since the ROM was built
+     * 
+     * @return u64 
+     */
+    u64 getIgnoredWrites() const { return _ignoredWrites; }
+
+protected:
+    void onWriteBusData( const Word& pAddress, const Byte& pData ) override;
+    Byte onReadBusData( const Word& pAddress ) override;
+
+    /**
+     * @brief Whole pages of the image are read directly
+     * 
+     * @param pOffset 
+     * @return const Byte* 
+     */
+    const Byte* onMapReadPage( const Word& pOffset ) override;
+
+    /**
+     * @brief ROM reads never change
+     * 
+     * @return true 
+     */
+    bool onStableRead( const Word& ) override { return true; }
+
+private:
+    /**
+     * @brief Image read by the chip
+     * 
+     */
+    std::shared_ptr<const CRomImage> _image;
+
+    /**
+     * @brief Writes ignored
+     * 
+     */
+    u64 _ignoredWrites;
+};
+
+}
+
+#endif
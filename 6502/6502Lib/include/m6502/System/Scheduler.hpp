@@ -0,0 +1,188 @@
+/**
+ * @file Scheduler.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <m6502/Config.hpp>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace m6502
+{
+
+/**
+ * @brief Device events of a system, fired at an absolute cycle count
+ *        The CPU runs straight to the next deadline, then fires the
+ *        events due, so devices cost nothing between their events
+ *        Events fire at the first instruction boundary at or after
+ *        their deadline, in deadline order then scheduling order
+ * 
+ */
+class CScheduler
+{
+public:
+    /**
+     * @brief Called when an event fires, with the cycle count of its deadline
+     * 
+     */
+    typedef std::function<void(u64)> EventCallback;
+
+    /**
+     * @brief Deadline of an empty scheduler
+     * 
+     */
+    static constexpr u64 Never = std::numeric_limits<u64>::max();
+
+    /**
+     * @brief Construct a new scheduler, its clock at cycle 0
+     * 
+     */
+    CScheduler();
+
+    /**
+     * @brief Schedule an event at an absolute cycle count, an event
+     *        in the past fires at the next instruction boundary
+     *        Callbacks may schedule other events, periodic devices
+     *        schedule their next event from their callback
+     * 
+     * @param pCycle 
+     * @param pCallback 
+     * @return u64 id of the event, for cancel
+     */
+    u64 schedule( u64 pCycle, EventCallback pCallback );
+
+    /**
+     * @brief Schedule an event some cycles from now
+     * 
+     * @param pDelay 
+     * @param pCallback 
+     * @return u64 id of the event, for cancel
+     */
+    u64 scheduleIn( u64 pDelay, EventCallback pCallback ) { return schedule( _now + pDelay, std::move( pCallback ) ); }
+
+    /**
+     * @brief Cancel an event not fired yet
+     * 
+     * @param pId 
+     * @return false when already fired or cancelled
+     */
+    bool cancel( u64 pId );
+
+    /**
+     * @brief Get the cycles run since the scheduler was built
+     * 
+     * @return u64 
+     */
+    u64 getNow() const { return _now; }
+
+    /**
+     * @brief Get the deadline of the next event
+     * 
+     * @return u64 Never when no event
+     */
+    u64 getNextDeadline() const { return _heap.empty() ? Never : _heap.front().cycle; }
+
+    /**
+     * @brief Get the events not fired yet
+     * 
+     * @return size_t 
+     */
+    size_t getPending() const { return _callbacks.size(); }
+
+    /**
+     * @brief Move the clock forward and fire the events due, the
+     *        CPU calls it after running cycles
+     * 
+     * @param pCycles 
+     */
+    void advance( u64 pCycles );
+
+private:
+    /**
+     * @brief Entry of the min heap of deadlines
+     * 
+     */
+    struct SEvent
+    {
+        /**
+         * @brief Deadline
+         * 
+         */
+        u64 cycle;
+
+        /**
+         * @brief Id of the event, ids grow so they order ties
+         * 
+         */
+        u64 id;
+
+        /**
+         * @brief Heap order : the next event on top
+         * 
+         */
+        bool operator<( const SEvent& pOther ) const
+        {
+            return cycle != pOther.cycle ? cycle > pOther.cycle : id > pOther.id;
+        }
+    };
+
+    /**
+     * @brief Cycles run
+     * 
+     */
+    u64 _now;
+
+    /**
+     * @brief Id of the next event scheduled
+     * 
+     */
+    u64 _nextId;
+
+    /**
+     * @brief Min heap of the deadlines, cancelled events are dropped
+     *        when they reach the top
+     * 
+     */
+    std::vector<SEvent> _heap;
+
+    /**
+     * @brief Callback of each event not fired nor cancelled
+     * 
+     */
+    std::unordered_map<u64, EventCallback> _callbacks;
+
+    /**
+     * @brief Drop the cancelled events from the top of the heap
+     * 
+     */
+    void _dropCancelled();
+};
+
+}
+
+#endif
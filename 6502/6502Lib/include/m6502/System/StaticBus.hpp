@@ -0,0 +1,201 @@
+/**
+ * @file StaticBus.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef STATICBUS_HPP
+#define STATICBUS_HPP
+
+#include <m6502/Config.hpp>
+#include <cstddef>
+#include <tuple>
+
+namespace m6502
+{
+
+/**
+ * @brief Chip of a CStaticBus with its decoding, as mask and bank
+ *        of a CBusChip
+ *        TChip is default constructible and gives
+ *        Byte onReadBusData( const Word& ) and
+ *        void onWriteBusData( const Word&, const Byte& ),
+ *        addresses being relative to bank
+ * 
+ * @tparam TChip 
+ * @tparam Mask 
+ * @tparam Bank 
+ */
+template<class TChip, Word Mask, Word Bank>
+struct SStaticChip
+{
+    static_assert( (Bank & ~Mask) == 0, "Bits of bank outside of mask never decode" );
+
+    /**
+     * @brief Type of the chip
+     * 
+     */
+    typedef TChip chip;
+
+    /**
+     * @brief Address bits decoded
+     * 
+     */
+    static constexpr Word mask = Mask;
+
+    /**
+     * @brief Value of the decoded bits selecting the chip
+     * 
+     */
+    static constexpr Word bank = Bank;
+};
+
+/**
+ * @brief Data bus of a system known at compile time
+ *        Chips are given as SStaticChip, the bus owns them
+ *        Decoding is unrolled at compile time : a read goes to the first
+ *        chip in range, a write to every chip in range, as CBus does.
+ *        There is no master chip, the CPU is not on the bus
+ * 
+ * @tparam TChips SStaticChip of each chip, by decoding priority
+ */
+template<class... TChips>
+class CStaticBus
+{
+    public:
+        /**
+         * @brief Type of the chip at index
+         * 
+         * @tparam I 
+         */
+        template<std::size_t I>
+        using chip_t = typename std::tuple_element_t<I, std::tuple<TChips...>>::chip;
+
+        /**
+         * @brief Get a chip of the bus
+         * 
+         * @tparam I index of the chip in the template parameters
+         * @return chip_t<I>& 
+         */
+        template<std::size_t I>
+        chip_t<I>& getChip() { return std::get<I>( _chips ); }
+
+        /**
+         * @brief Send data on bus
+         * 
+         * @param pAddress 
+         * @param pData 
+         */
+        void writeBusData( const Word& pAddress, const Byte& pData ) { _write<0>( pAddress, pData ); }
+
+        /**
+         * @brief Read data from bus
+         * 
+         * @param pAddress 
+         * @return Byte 
+         */
+        Byte readBusData( const Word& pAddress ) { return _read<0>( pAddress ); }
+
+    private:
+        /**
+         * @brief Chips connected on bus
+         * 
+         */
+        std::tuple<typename TChips::chip...> _chips;
+
+        /**
+         * @brief Read the chip at index if in range, else the next ones
+         * 
+         * @tparam I 
+         * @param pAddress 
+         * @return Byte 
+         */
+        template<std::size_t I>
+        Byte _read( const Word& pAddress );
+
+        /**
+         * @brief Write the chips in range from index
+         * 
+         * @tparam I 
+         * @param pAddress 
+         * @param pData 
+         */
+        template<std::size_t I>
+        void _write( const Word& pAddress, const Byte& pData );
+};
+
+/*****************************************************************************/
+
+template<class... TChips>
+template<std::size_t I>
+inline Byte CStaticBus<TChips...>::_read( const Word& pAddress )
+{
+    if constexpr ( I == sizeof...(TChips) )
+    {
+        // No chip in range
+        return 0;
+    }
+    else
+    {
+        typedef std::tuple_element_t<I, std::tuple<TChips...>> Slot;
+        if constexpr ( Slot::mask == 0 )
+        {
+            // Whole address space, chips behind never answer
+            return std::get<I>( _chips ).onReadBusData( pAddress );
+        }
+        else
+        {
+            if ( (pAddress & Slot::mask) == Slot::bank )
+            {
+                return std::get<I>( _chips ).onReadBusData( pAddress - Slot::bank );
+            }
+            return _read<I + 1>( pAddress );
+        }
+    }
+}
+
+/*****************************************************************************/
+
+template<class... TChips>
+template<std::size_t I>
+inline void CStaticBus<TChips...>::_write( const Word& pAddress, const Byte& pData )
+{
+    if constexpr ( I < sizeof...(TChips) )
+    {
+        typedef std::tuple_element_t<I, std::tuple<TChips...>> Slot;
+        if constexpr ( Slot::mask == 0 )
+        {
+            std::get<I>( _chips ).onWriteBusData( pAddress, pData );
+        }
+        else
+        {
+            if ( (pAddress & Slot::mask) == Slot::bank )
+            {
+                std::get<I>( _chips ).onWriteBusData( pAddress - Slot::bank, pData );
+            }
+        }
+        _write<I + 1>( pAddress, pData );
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @file StaticCPU.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef STATICCPU_HPP
+#define STATICCPU_HPP
+
+#include <m6502/Config.hpp>
+#include <m6502/System/CPUCore.hpp>
+#include <m6502/System/StaticBus.hpp>
+
+namespace m6502
+{
+
+/**
+ * @brief 6502 CPU on a bus type known at compile time, e.g. a
+ *        CStaticBus, built with the code using it so every read
+ *        and write is inlined in the instructions
+ *        Runs the Threaded engine (Switch without computed goto),
+ *        without the block cache nor the idle loops skip of CCPU
+ * 
+ * @tparam TBus 
+ */
+template<class TBus>
+class CStaticCPU : public CCPUCore<CStaticCPU<TBus>, TBus>
+{
+    /**
+     * @brief Core calls the jump hooks
+     * 
+     */
+    friend class CCPUCore<CStaticCPU<TBus>, TBus>;
+
+    typedef CCPUCore<CStaticCPU<TBus>, TBus> core;
+
+public:
+    /**
+     * @brief Construct a new CPU object
+     * 
+     * @param pBus 
+     */
+    explicit CStaticCPU( TBus& pBus ) : core( pBus )
+    {
+        reset();
+        this->_loadFlags();
+    }
+
+    /**
+     * @brief Construct a new CPU object
+     * 
+     * @param pBus 
+     */
+    explicit CStaticCPU( TBus&& pBus ) = delete;
+
+    /**
+     * @brief Reset the CPU object
+     * 
+     */
+    void reset() { reset( 0xFFFC ); }
+
+    /**
+     * @brief Reset the CPU with the given start vector
+     * 
+     * @param pResetVector 
+     */
+    void reset( const Word& pResetVector ) { this->_resetRegisters( pResetVector ); }
+
+    /**
+     * @brief Execute specified number of cycles
+     * 
+     * @param pCycles 
+     * @return The real numbers cycles excecuted
+     */
+    s64 execute( s64 pCycles );
+
+    /**
+     * @brief Execute exactly one instruction
+     * 
+     * @return The cycles used by the instruction
+     */
+    s64 step();
+
+private:
+    /**
+     * @brief Static buses have no interrupt lines
+     * 
+     * @return false 
+     */
+    static constexpr bool _interruptPending() { return false; }
+
+    /**
+     * @brief Never called, nothing is pending
+     * 
+     * @return false 
+     */
+    bool _serviceInterrupts() { return false; }
+
+    /**
+     * @brief Nothing to do when a branch or JMP is taken
+     * 
+     */
+    void _onJump( const Word& ) {}
+
+    /**
+     * @brief Nothing to do when a branch is not taken
+     * 
+     */
+    void _onBranchNotTaken() {}
+};
+
+/*****************************************************************************/
+
+template<class TBus>
+s64 CStaticCPU<TBus>::execute( s64 pCycles )
+{
+    this->_startRun( pCycles );
+    if ( this->_watching() )
+    {
+        this->template _executeThreaded<true>();
+    }
+    else
+    {
+        this->template _executeThreaded<false>();
+    }
+    this->_endRun();
+    return pCycles - this->_cycles;
+}
+
+/*****************************************************************************/
+
+template<class TBus>
+s64 CStaticCPU<TBus>::step()
+{
+    // Every instruction takes at least one cycle, the engine
+    // stops after the first one
+    this->_startRun( 1 );
+    this->template _executeSwitch<false>();
+    this->_endRun();
+    return 1 - this->_cycles;
+}
+
+}
+
+#endif
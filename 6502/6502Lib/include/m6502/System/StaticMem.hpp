@@ -0,0 +1,98 @@
+/**
+ * @file StaticMem.hpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#ifndef STATICMEM_HPP
+#define STATICMEM_HPP
+
+#include <m6502/Config.hpp>
+#include <array>
+
+namespace m6502
+{
+
+/**
+ * @brief Memory chip of a CStaticBus
+ *        Size must cover the addresses left by the mask of the chip
+ * 
+ * @tparam Size bytes of memory
+ */
+template<u32 Size = MAX_MEM>
+class CStaticMem
+{
+public:
+    /**
+     * @brief Construct a new memory, filled with zeros
+     * 
+     */
+    CStaticMem() { initialise(); }
+
+    /**
+     * @brief Fill the memory with zeros
+     * 
+     */
+    void initialise() { _data.fill( 0x00 ); }
+
+    /**
+     * @brief Read 1 Byte
+     * 
+     * @param pAddress 
+     * @return Byte 
+     */
+    Byte operator[]( const Word& pAddress ) const { return _data[pAddress]; }
+
+    /**
+     * @brief Write 1 Byte
+     * 
+     * @param pAddress 
+     * @return Byte& 
+     */
+    Byte& operator[]( const Word& pAddress ) { return _data[pAddress]; }
+
+    /**
+     * @brief Read Event from Bus
+     * 
+     * @param pAddress 
+     * @return Byte 
+     */
+    Byte onReadBusData( const Word& pAddress ) const { return _data[pAddress]; }
+
+    /**
+     * @brief Write Event from Bus
+     * 
+     * @param pAddress 
+     * @param pData 
+     */
+    void onWriteBusData( const Word& pAddress, const Byte& pData ) { _data[pAddress] = pData; }
+
+private:
+    /**
+     * @brief Memory container
+     * 
+     */
+    std::array<Byte,Size> _data;
+};
+
+}
+
+#endif
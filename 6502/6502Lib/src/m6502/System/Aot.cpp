@@ -0,0 +1,101 @@
+/**
+ * @file Aot.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <m6502/System/Aot.hpp>
+
+namespace m6502
+{
+
+CAotProgram::CAotProgram( CCPU& pCPU, CBus& pBus, const SAotImage& pImage ) :
+    _cpu(pCPU), _bus(pBus), _image(pImage), _entries(0x10000, nullptr), _stats{}
+{
+    for (u32 Index = 0; Index < _image.blockCount; Index++)
+    {
+        const SAotBlock& Block = _image.blocks[Index];
+        _entries[Block.address] = &Block;
+    }
+}
+
+/*****************************************************************************/
+
+s64 CAotProgram::execute( s64 pCycles )
+{
+    CScheduler& Scheduler = _bus.getScheduler();
+    s64 Remaining = pCycles;
+    while (Remaining > 0)
+    {
+        // Translated blocks run only when they end before the next event
+        const u64 Deadline = Scheduler.getNextDeadline();
+        const u64 ToDeadline = Deadline > Scheduler.getNow() ? Deadline - Scheduler.getNow() : 0;
+        const s64 Limit = ToDeadline < static_cast<u64>(Remaining) ? static_cast<s64>(ToDeadline) : Remaining;
+        const SAotBlock* Block = _entries[_cpu.PC];
+        // Interrupts are taken by step, before the instruction at PC
+        const u32 Interrupts = _bus.getInterrupts();
+        const bool Pending = (Interrupts & (CBus::NMIEdge | CBus::ResetEdge | CBus::ResetLines)) ||
+            ((Interrupts & CBus::IRQLines) && !_cpu.Flags.I);
+        // Translated code knows binary mode only
+        if (Block && !Pending && Block->maxCycles < Limit && !_cpu.Flags.D)
+        {
+            const u32 Used = Block->run(_cpu, _bus);
+            Remaining -= Used;
+            _stats.translatedRuns++;
+            Scheduler.advance(Used);
+        }
+        else
+        {
+            Remaining -= _cpu.step();
+            _stats.interpretedInstructions++;
+            // Faults, BRK and halt stop the CPU
+            if (_cpu.getStop() != EStop::Budget)
+            {
+                break;
+            }
+        }
+    }
+    return pCycles - Remaining;
+}
+
+/*****************************************************************************/
+
+bool CAotProgram::matchesMemory() const
+{
+    for (u32 Index = 0; Index < _image.size; Index++)
+    {
+        const Word Address = static_cast<Word>(_image.loadAddress + Index);
+        if (_bus.readBusData(Address) != _image.data[Index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*****************************************************************************/
+
+void CAotProgram::resetStats()
+{
+    _stats = SAotStats{};
+}
+
+}
@@ -0,0 +1,227 @@
+/**
+ * @file Batch.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <m6502/System/Batch.hpp>
+#include <m6502/System/StaticBus.hpp>
+#include <m6502/System/StaticMem.hpp>
+#include <m6502/System/StaticCPU.hpp>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace m6502
+{
+
+namespace
+{
+
+/**
+ * @brief Bus of a batch system, RAM only
+ * 
+ */
+typedef CStaticBus<SStaticChip<CStaticMem<>, 0x0000, 0x0000>> CBatchBus;
+
+/**
+ * @brief Systems left to a thread, stolen from the back by the others
+ * 
+ */
+struct SBatchQueue
+{
+    std::mutex lock;
+    std::deque<u32> systems;
+};
+
+/**
+ * @brief Take the next system of a queue
+ * 
+ * @param pQueue 
+ * @param pFront own queue is run from the front, stolen from the back
+ * @param pSystem 
+ * @return true when a system was taken
+ */
+bool takeSystem( SBatchQueue& pQueue, bool pFront, u32& pSystem )
+{
+    std::lock_guard<std::mutex> Lock( pQueue.lock );
+    if ( pQueue.systems.empty() )
+    {
+        return false;
+    }
+    if ( pFront )
+    {
+        pSystem = pQueue.systems.front();
+        pQueue.systems.pop_front();
+    }
+    else
+    {
+        pSystem = pQueue.systems.back();
+        pQueue.systems.pop_back();
+    }
+    return true;
+}
+
+}
+
+/*****************************************************************************/
+
+CBatchRunner::CBatchRunner( u32 pThreads ) : _threads(pThreads), _stats{0, 0}
+{
+    if ( _threads == 0 )
+    {
+        _threads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+}
+
+/*****************************************************************************/
+
+std::vector<SBatchResult> CBatchRunner::run( const std::vector<SBatchSystem>& pSystems )
+{
+    std::vector<SBatchResult> Results( pSystems.size() );
+    const u32 Threads = static_cast<u32>( std::min<size_t>( _threads, std::max<size_t>( 1, pSystems.size() ) ) );
+    _stats = { Threads, 0 };
+    // Contiguous shares, neighbour systems often cost the same
+    std::vector<SBatchQueue> Queues( Threads );
+    for ( u32 System = 0; System < pSystems.size(); System++ )
+    {
+        Queues[static_cast<u64>(System) * Threads / pSystems.size()].systems.push_back( System );
+    }
+    std::atomic<u64> Steals( 0 );
+    auto Worker = [&]( u32 pThread )
+    {
+        u32 System;
+        u64 Stolen = 0;
+        while ( true )
+        {
+            bool Found = takeSystem( Queues[pThread], true, System );
+            for ( u32 Other = 1; !Found && Other < Threads; Other++ )
+            {
+                Found = takeSystem( Queues[(pThread + Other) % Threads], false, System );
+                Stolen += Found;
+            }
+            // Systems are only taken, once every queue is empty the batch is done
+            if ( !Found ) break;
+            Results[System] = runSystem( pSystems[System] );
+        }
+        Steals += Stolen;
+    };
+    std::vector<std::thread> Pool;
+    for ( u32 Thread = 1; Thread < Threads; Thread++ )
+    {
+        Pool.emplace_back( Worker, Thread );
+    }
+    Worker( 0 );
+    for ( std::thread& Thread : Pool )
+    {
+        Thread.join();
+    }
+    _stats.steals = Steals;
+    return Results;
+}
+
+/*****************************************************************************/
+
+SBatchResult CBatchRunner::runSystem( const SBatchSystem& pSystem )
+{
+    // 64KB each, kept off the stack of the threads
+    std::unique_ptr<CBatchBus> Bus = std::make_unique<CBatchBus>();
+    CStaticCPU<CBatchBus> CPU( *Bus );
+    CPU.loadPrg( pSystem.program.data(), static_cast<u32>( pSystem.program.size() ) );
+    CPU.PC = pSystem.resetVector;
+
+    SBatchResult Result;
+    Result.status = EBatchStatus::Budget;
+    Result.cycles = 0;
+    if ( pSystem.stop == EBatchStop::Trap )
+    {
+        try
+        {
+            // Checked between instructions
+            while ( Result.cycles < pSystem.cycles )
+            {
+                const Word PC = CPU.PC;
+                Result.cycles += CPU.step();
+                if ( CPU.PC == PC )
+                {
+                    Result.status = EBatchStatus::Trap;
+                    break;
+                }
+            }
+        }
+        catch ( ... )
+        {
+            Result.status = EBatchStatus::Illegal;
+        }
+    }
+    else if ( pSystem.stop == EBatchStop::Address && CPU.PC == pSystem.stopAddress )
+    {
+        // runUntilPC always runs the first instruction
+        Result.status = EBatchStatus::Address;
+    }
+    else
+    {
+        const SExecResult Run = pSystem.stop == EBatchStop::Address ?
+            CPU.runUntilPC( pSystem.stopAddress, pSystem.cycles ) : CPU.run( pSystem.cycles );
+        Result.cycles = Run.cycles;
+        if ( Run.stop == EStop::Condition )
+        {
+            Result.status = EBatchStatus::Address;
+        }
+        else if ( Run.stop == EStop::Fault )
+        {
+            Result.status = EBatchStatus::Illegal;
+        }
+    }
+    Result.PC = CPU.PC;
+    Result.SP = CPU.SP;
+    Result.A = CPU.A;
+    Result.X = CPU.X;
+    Result.Y = CPU.Y;
+    Result.PS = CPU.PS;
+    const CStaticMem<>& Mem = Bus->getChip<0>();
+    const u32 Size = std::min<u32>( pSystem.resultSize, MAX_MEM - pSystem.resultAddress );
+    Result.memory.resize( Size );
+    for ( u32 Offset = 0; Offset < Size; Offset++ )
+    {
+        Result.memory[Offset] = Mem[static_cast<Word>( pSystem.resultAddress + Offset )];
+    }
+    return Result;
+}
+
+/*****************************************************************************/
+
+u32 CBatchRunner::getThreads() const
+{
+    return _threads;
+}
+
+/*****************************************************************************/
+
+const SBatchStats& CBatchRunner::getStats() const
+{
+    return _stats;
+}
+
+}
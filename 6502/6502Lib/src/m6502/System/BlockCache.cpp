@@ -0,0 +1,194 @@
+/**
+ * @file BlockCache.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <m6502/System/BlockCache.hpp>
+#include <m6502/System/Cpu.hpp>
+
+namespace m6502
+{
+
+CBlockCache::CBlockCache(CBus& pBus, CBusChip* pWatcher) :
+    _bus(pBus),
+    _watcher(pWatcher),
+    _stats{0, 0, 0},
+    _generation(0)
+{
+}
+
+/*****************************************************************************/
+
+CBlockCache::~CBlockCache()
+{
+    clear();
+}
+
+/*****************************************************************************/
+
+const SBlock CBlockCache::Uncached = {0, 0, 0, 0, {}};
+
+/*****************************************************************************/
+
+const SBlock& CBlockCache::lookup(const Word& pPC)
+{
+    _retired.clear();
+    if (!_bus.getReadPage(pPC))
+    {
+        return Uncached;
+    }
+    if (_blocks.empty())
+    {
+        _blocks.resize(0x10000);
+    }
+    std::unique_ptr<SBlock>& Block = _blocks[pPC];
+    if (Block)
+    {
+        _stats.hits++;
+        return *Block;
+    }
+    _stats.misses++;
+    Block = std::make_unique<SBlock>(decode(_bus, pPC));
+    // Watch each page holding a byte of the block
+    const Byte LastPage = (Block->end - 1) >> 8;
+    Byte Page = Block->start >> 8;
+    while (true)
+    {
+        if (_pageBlocks[Page].empty())
+        {
+            _bus.watchPage(_watcher, Page);
+        }
+        _pageBlocks[Page].push_back(pPC);
+        if (Page == LastPage) break;
+        Page++;
+    }
+    return *Block;
+}
+
+/*****************************************************************************/
+
+void CBlockCache::invalidatePage(const Byte& pPage)
+{
+    std::vector<Word>& Entries = _pageBlocks[pPage];
+    if (Entries.empty()) return;
+    for (const Word Entry : Entries)
+    {
+        std::unique_ptr<SBlock>& Block = _blocks[Entry];
+        // Entry may be listed again for a newer block, already dropped
+        if (!Block) continue;
+        _retired.push_back(std::move(Block));
+        _stats.invalidations++;
+    }
+    Entries.clear();
+    _bus.unwatchPage(_watcher, pPage);
+    _generation++;
+}
+
+/*****************************************************************************/
+
+void CBlockCache::clear()
+{
+    for (u32 Page = 0; Page < _pageBlocks.size(); Page++)
+    {
+        if (_pageBlocks[Page].empty()) continue;
+        for (const Word Entry : _pageBlocks[Page])
+        {
+            if (_blocks[Entry])
+            {
+                _retired.push_back(std::move(_blocks[Entry]));
+            }
+        }
+        _pageBlocks[Page].clear();
+        _bus.unwatchPage(_watcher, static_cast<Byte>(Page));
+    }
+    _generation++;
+}
+
+/*****************************************************************************/
+
+void CBlockCache::resetStats()
+{
+    _stats = {0, 0, 0};
+}
+
+/*****************************************************************************/
+
+SBlock CBlockCache::decode(CBus& pBus, const Word& pPC)
+{
+    SBlock Block;
+    Block.start = pPC;
+    Block.cycles = 0;
+    Block.maxCycles = 0;
+    Word Address = pPC;
+    // Host memory only, reading a chip may change its state
+    auto Read = [&pBus](const Word& pAddress, Byte& pData)
+    {
+        const Byte* Page = pBus.getReadPage(pAddress);
+        if (Page)
+        {
+            pData = Page[pAddress & 0xFF];
+        }
+        return Page != nullptr;
+    };
+    while (Block.instructions.size() < MaxInstructions)
+    {
+        Byte OpCode;
+        if (!Read(Address, OpCode)) break;
+        const CCPU::SOpCode& Op = CCPU::OpTable[OpCode];
+        SBlockInstruction Instruction;
+        Instruction.handler = Op.decoded;
+        Instruction.address = Address;
+        Instruction.opcode = OpCode;
+        Instruction.mode = Op.mode;
+        Instruction.cycles = Op.cycles;
+        Instruction.size = Op.legal ? instructionSize(Op.mode) : 1;
+        Instruction.operand = 0;
+        Byte Low = 0;
+        Byte High = 0;
+        if ((Instruction.size > 1 && !Read(Address + 1, Low)) ||
+            (Instruction.size > 2 && !Read(Address + 2, High))) break;
+        Instruction.operand = static_cast<Word>(Low | (High << 8));
+        Block.instructions.push_back(Instruction);
+        Block.cycles += Op.cycles;
+        Block.maxCycles += Op.cycles;
+        if (Op.penalty == EPagePenalty::PageCross)
+        {
+            Block.maxCycles += 1;
+        }
+        Address += Instruction.size;
+        // Any instruction which may not continue at next address ends the block
+        if (!Op.legal || Op.penalty == EPagePenalty::Branch) break;
+        const Ins Instr = static_cast<Ins>(OpCode);
+        if (Instr == Ins::JMP_ABS || Instr == Ins::JMP_IND ||
+            Instr == Ins::JSR || Instr == Ins::RTS ||
+            Instr == Ins::RTI || Instr == Ins::BRK) break;
+    }
+    // A taken branch costs one cycle, one more when crossing a page
+    if (!Block.instructions.empty() && Block.instructions.back().mode == EAddrMode::Relative)
+    {
+        Block.maxCycles += 2;
+    }
+    Block.end = Address;
+    return Block;
+}
+
+}
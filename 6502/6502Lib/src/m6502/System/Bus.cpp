@@ -27,6 +27,25 @@
 namespace m6502
 {
 
+namespace
+{
+
+/**
+ * @brief Bytes of the snapshot header : magic, version and chip count
+ * 
+ */
+constexpr size_t SnapshotHeaderSize = 4 + 2 + 2;
+
+/**
+ * @brief Bytes of the state size before each chip state
+ * 
+ */
+constexpr size_t SnapshotChipHeaderSize = 4;
+
+}
+
+/*****************************************************************************/
+
 CBusChip::CBusChip (CBus& pBus, const Word& pMask, const Word& pBank) : bus(pBus), mask(pMask), bank(pBank)
 {
     bus._subscribe(this);
@@ -34,7 +53,7 @@ CBusChip::CBusChip (CBus& pBus, const Word& pMask, const Word& pBank) : bus(pBus
 
 /*****************************************************************************/
 
-CBusChip::CBusChip (const CBusChip& pCopy) : bus(pCopy.bus), mask(pCopy.mask), bank(pCopy.mask)
+CBusChip::CBusChip (const CBusChip& pCopy) : bus(pCopy.bus), mask(pCopy.mask), bank(pCopy.bank)
 {
     bus._subscribe(this);
 }
@@ -43,11 +62,56 @@ CBusChip::CBusChip (const CBusChip& pCopy) : bus(pCopy.bus), mask(pCopy.mask), b
 
 CBusChip::~CBusChip()
 {
+    // Lines held by the chip go with it
+    _setIRQ(false);
+    _setNMI(false);
+    _setReset(false);
     bus._unSubscribe(this);
 }
 
 /*****************************************************************************/
 
+void CBusChip::_setIRQ(bool pAsserted)
+{
+    if (_irq == pAsserted) return;
+    _irq = pAsserted;
+    pAsserted ? bus.assertIRQ() : bus.releaseIRQ();
+}
+
+/*****************************************************************************/
+
+void CBusChip::_setNMI(bool pAsserted)
+{
+    if (_nmi == pAsserted) return;
+    _nmi = pAsserted;
+    pAsserted ? bus.assertNMI() : bus.releaseNMI();
+}
+
+/*****************************************************************************/
+
+void CBusChip::_setReset(bool pAsserted)
+{
+    if (_reset == pAsserted) return;
+    _reset = pAsserted;
+    pAsserted ? bus.assertReset() : bus.releaseReset();
+}
+
+/*****************************************************************************/
+
+void CBusChip::_remap()
+{
+    bus._rebuildPages();
+}
+
+/*****************************************************************************/
+
+void CBusChip::_remapPage(const Word& pOffset)
+{
+    bus._remapPage(static_cast<Byte>((pOffset + bank) >> 8));
+}
+
+/*****************************************************************************/
+
 /*void CBusChip::SetReady(bool pFlag)
 {
     Bus.SetReady(pFlag);
@@ -69,6 +133,46 @@ CBusChip::~CBusChip()
 
 
 
+/*****************************************************************************/
+
+void CBus::assertNMI()
+{
+    const u32 Lines = _changeLine(NMILines, 0x000100, true);
+    if ((Lines & NMILines) == 0)
+    {
+        _interrupts.fetch_or(NMIEdge, std::memory_order_release);
+    }
+}
+
+/*****************************************************************************/
+
+void CBus::releaseReset()
+{
+    const u32 Lines = _changeLine(ResetLines, 0x010000, false);
+    if ((Lines & ResetLines) == 0x010000)
+    {
+        _interrupts.fetch_or(ResetEdge, std::memory_order_release);
+    }
+}
+
+/*****************************************************************************/
+
+u32 CBus::_changeLine(u32 pLines, u32 pOne, bool pHold)
+{
+    u32 Lines = _interrupts.load(std::memory_order_relaxed);
+    while (true)
+    {
+        const u32 Holders = Lines & pLines;
+        // Saturated, or released by a chip not holding it
+        if (pHold ? Holders == pLines : Holders == 0) return Lines;
+        const u32 Changed = pHold ? Lines + pOne : Lines - pOne;
+        if (_interrupts.compare_exchange_weak(Lines, Changed, std::memory_order_acq_rel))
+        {
+            return Lines;
+        }
+    }
+}
+
 /*****************************************************************************/
 
 void CBus::setReady(const bool)
@@ -78,7 +182,228 @@ void CBus::setReady(const bool)
 
 /*****************************************************************************/
 
+CBus::CBus() : _trapPages{}, _trapChip(nullptr), _trapFirst(0), _trapLast(0), _mapGeneration(0),
+    _interrupts(0)
+{
+    _rebuildPages();
+}
+
+/*****************************************************************************/
+
 void CBus::writeBusData(const Word& pAddress, const Byte& pData)
+{
+    const SBusPage& Page = _pages[pAddress >> 8];
+    if (Page.write)
+    {
+        Page.write[pAddress & 0xFF] = pData;
+    }
+    else if (Page.writeChip)
+    {
+        Page.writeChip->onWriteBusData(pAddress - Page.writeChip->bank, pData);
+    }
+    else if (Page.scan)
+    {
+        _scanWrite(pAddress, pData);
+    }
+    if (Page.watched)
+    {
+        // Backward, watchers may unwatch the page while notified
+        const v_buschips& Watchers = _watchers[pAddress >> 8];
+        for (size_t Index = Watchers.size(); Index > 0; Index--)
+        {
+            if (Index <= Watchers.size())
+            {
+                Watchers[Index - 1]->onWatchedWrite(pAddress);
+            }
+        }
+        if (_trapChip && pAddress >= _trapFirst && pAddress <= _trapLast)
+        {
+            _trapChip->onTrappedWrite(pAddress);
+        }
+    }
+}
+
+/*****************************************************************************/
+
+void CBus::watchPage(CBusChip* pWatcher, const Byte& pPage)
+{
+    v_buschips& Watchers = _watchers[pPage];
+    if (std::find(Watchers.begin(), Watchers.end(), pWatcher) == Watchers.end())
+    {
+        Watchers.push_back(pWatcher);
+        _updateWatch(pPage);
+    }
+}
+
+/*****************************************************************************/
+
+void CBus::unwatchPage(CBusChip* pWatcher, const Byte& pPage)
+{
+    v_buschips& Watchers = _watchers[pPage];
+    Watchers.erase(std::remove(Watchers.begin(), Watchers.end(), pWatcher), Watchers.end());
+    _updateWatch(pPage);
+}
+
+/*****************************************************************************/
+
+void CBus::trapWrites(CBusChip* pChip, const Word& pFirst, const Word& pLast)
+{
+    untrapWrites();
+    _trapChip = pChip;
+    _trapFirst = pFirst;
+    _trapLast = pLast;
+    for (u32 Page = pFirst >> 8; Page <= static_cast<u32>(pLast >> 8); Page++)
+    {
+        _trapPages[Page >> 6] |= u64(1) << (Page & 63);
+        _updateWatch(static_cast<Byte>(Page));
+    }
+}
+
+/*****************************************************************************/
+
+void CBus::untrapWrites()
+{
+    _trapChip = nullptr;
+    for (u32 Page = 0; Page < 256; Page++)
+    {
+        if ((_trapPages[Page >> 6] >> (Page & 63)) & 1)
+        {
+            _trapPages[Page >> 6] &= ~(u64(1) << (Page & 63));
+            _updateWatch(static_cast<Byte>(Page));
+        }
+    }
+}
+
+/*****************************************************************************/
+
+void CBus::_updateWatch(const Byte& pPage)
+{
+    SBusPage& Page = _pages[pPage];
+    const bool Watched = !_watchers[pPage].empty() || ((_trapPages[pPage >> 6] >> (pPage & 63)) & 1);
+    if (Page.watched != Watched)
+    {
+        _mapGeneration++;
+    }
+    Page.watched = Watched;
+    Page.write = nullptr;
+    if (Page.writeChip && !Page.watched)
+    {
+        Page.write = Page.writeChip->onMapWritePage((pPage << 8) - Page.writeChip->bank);
+    }
+}
+
+/*****************************************************************************/
+
+Byte CBus::readBusData(const Word& pAddress)
+{
+    const SBusPage& Page = _pages[pAddress >> 8];
+    if (Page.read)
+    {
+        return Page.read[pAddress & 0xFF];
+    }
+    if (Page.readChip)
+    {
+        return Page.readChip->onReadBusData(pAddress - Page.readChip->bank);
+    }
+    if (Page.scan)
+    {
+        return _scanRead(pAddress);
+    }
+    return 0;
+}
+
+/*****************************************************************************/
+
+bool CBus::isStableRead(const Word& pAddress)
+{
+    const SBusPage& Page = _pages[pAddress >> 8];
+    if (Page.read)
+    {
+        return true;
+    }
+    if (Page.readChip)
+    {
+        return Page.readChip->onStableRead(pAddress - Page.readChip->bank);
+    }
+    // Chips decoding less than a page are not asked
+    return !Page.scan;
+}
+
+/*****************************************************************************/
+
+void CBus::snapshot(std::vector<Byte>& pBlob) const
+{
+    size_t Size = SnapshotHeaderSize;
+    for (auto Chip : _chips)
+    {
+        Size += SnapshotChipHeaderSize + Chip->onStateSize();
+    }
+    pBlob.resize(Size);
+    Byte* State = pBlob.data();
+    State = CBusChip::_saveState(State, SnapshotMagic);
+    State = CBusChip::_saveState(State, SnapshotVersion);
+    State = CBusChip::_saveState(State, static_cast<Word>(_chips.size()));
+    for (auto Chip : _chips)
+    {
+        const u32 ChipSize = Chip->onStateSize();
+        State = CBusChip::_saveState(State, ChipSize);
+        Chip->onSaveState(State);
+        State += ChipSize;
+    }
+}
+
+/*****************************************************************************/
+
+std::vector<Byte> CBus::snapshot() const
+{
+    std::vector<Byte> Blob;
+    snapshot(Blob);
+    return Blob;
+}
+
+/*****************************************************************************/
+
+bool CBus::restore(const Byte* pBlob, size_t pSize)
+{
+    if (pSize < SnapshotHeaderSize) return false;
+    u32 Magic;
+    Word Version;
+    Word Chips;
+    const Byte* State = CBusChip::_loadState(pBlob, Magic);
+    State = CBusChip::_loadState(State, Version);
+    State = CBusChip::_loadState(State, Chips);
+    if (Magic != SnapshotMagic || Version != SnapshotVersion || Chips != _chips.size()) return false;
+    // Check every chip before loading any
+    size_t Offset = SnapshotHeaderSize;
+    for (auto Chip : _chips)
+    {
+        if (pSize - Offset < SnapshotChipHeaderSize) return false;
+        u32 ChipSize;
+        CBusChip::_loadState(pBlob + Offset, ChipSize);
+        Offset += SnapshotChipHeaderSize;
+        if (ChipSize != Chip->onStateSize() || pSize - Offset < ChipSize) return false;
+        Offset += ChipSize;
+    }
+    if (Offset != pSize) return false;
+    for (auto Chip : _chips)
+    {
+        State += SnapshotChipHeaderSize;
+        Chip->onLoadState(State);
+        State += Chip->onStateSize();
+    }
+    return true;
+}
+
+/*****************************************************************************/
+
+bool CBus::restore(const std::vector<Byte>& pBlob)
+{
+    return restore(pBlob.data(), pBlob.size());
+}
+
+/*****************************************************************************/
+
+void CBus::_scanWrite(const Word& pAddress, const Byte& pData)
 {
     for (auto Chip : _chips)
     {
@@ -94,7 +419,7 @@ void CBus::writeBusData(const Word& pAddress, const Byte& pData)
 
 /*****************************************************************************/
 
-Byte CBus::readBusData(const Word& pAddress)
+Byte CBus::_scanRead(const Word& pAddress)
 {
     for (auto Chip : _chips)
     {
@@ -112,11 +437,79 @@ Byte CBus::readBusData(const Word& pAddress)
 
 /*****************************************************************************/
 
+void CBus::_rebuildPages()
+{
+    _mapGeneration++;
+    for (u32 Index = 0; Index < _pages.size(); Index++)
+    {
+        const Word PageAddress = static_cast<Word>(Index << 8);
+        SBusPage& Page = _pages[Index];
+        Page = { nullptr, nullptr, nullptr, nullptr, false, false };
+        bool ReadDecoded = false;
+        int Writers = 0;
+        for (auto Chip : _chips)
+        {
+            // If chip on bus is a master (e.g. CPU, etc) we pass
+            if (Chip->mask == 0xFFFF) continue;
+            // High byte of address must be in range for any address of page
+            if ((Chip->mask & PageAddress & 0xFF00) != (Chip->bank & 0xFF00)) continue;
+            const Byte LowMask = Chip->mask & 0xFF;
+            const Byte LowBank = Chip->bank & 0xFF;
+            // Low byte of bank outside of mask never match
+            if (LowBank & ~LowMask) continue;
+            Writers++;
+            if (LowMask == 0)
+            {
+                // Chip decodes the whole page
+                if (!ReadDecoded)
+                {
+                    Page.readChip = Chip;
+                    ReadDecoded = true;
+                }
+                Page.writeChip = Chip;
+            }
+            else
+            {
+                // Chip decodes less than a page, only the scan knows
+                ReadDecoded = true;
+                Page.scan = true;
+            }
+        }
+        if (Writers > 1 || Page.scan)
+        {
+            // Several chips receive writes, or part of the page only
+            Page.writeChip = nullptr;
+            Page.scan = true;
+        }
+        if (Page.readChip)
+        {
+            Page.read = Page.readChip->onMapReadPage(PageAddress - Page.readChip->bank);
+        }
+        _updateWatch(static_cast<Byte>(Index));
+    }
+}
+
+/*****************************************************************************/
+
+void CBus::_remapPage(const Byte& pPage)
+{
+    _mapGeneration++;
+    SBusPage& Page = _pages[pPage];
+    if (Page.readChip)
+    {
+        Page.read = Page.readChip->onMapReadPage((pPage << 8) - Page.readChip->bank);
+    }
+    _updateWatch(pPage);
+}
+
+/*****************************************************************************/
+
 void CBus::_subscribe( CBusChip* pChip)
 {
     if (std::find(_chips.begin(), _chips.end(),pChip) == _chips.end())
     {
         _chips.push_back(pChip);
+        _rebuildPages();
     }
 }
 
@@ -125,6 +518,15 @@ void CBus::_subscribe( CBusChip* pChip)
 void CBus::_unSubscribe( CBusChip* pChip)
 {
     _chips.erase(std::remove(_chips.begin(), _chips.end(), pChip), _chips.end());
+    if (_trapChip == pChip)
+    {
+        untrapWrites();
+    }
+    for (auto& Watchers : _watchers)
+    {
+        Watchers.erase(std::remove(Watchers.begin(), Watchers.end(), pChip), Watchers.end());
+    }
+    _rebuildPages();
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+/**
+ * @file CowMem.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <m6502/System/CowMem.hpp>
+
+namespace m6502
+{
+
+/*****************************************************************************/
+
+CCowMem::CCowMem(CBus& pBus, const Word& pMask, const Word& pBank) : CBusChip(pBus,pMask,pBank)
+{
+    _pages.fill(nullptr);
+    initialise();
+}
+
+/*****************************************************************************/
+
+CCowMem::CCowMem(CBus& pBus, CCowMem& pParent) : CBusChip(pBus,pParent.mask,pParent.bank)
+{
+    _share(pParent);
+}
+
+/*****************************************************************************/
+
+CCowMem::CCowMem(CCowMem& pCopy) : CBusChip(pCopy)
+{
+    _share(pCopy);
+}
+
+/*****************************************************************************/
+
+CCowMem::~CCowMem()
+{
+    _release();
+}
+
+/*****************************************************************************/
+
+void CCowMem::initialise()
+{
+    _release();
+    SCowPage* Zero = new SCowPage;
+    Zero->refs.store(static_cast<u32>(_pages.size()), std::memory_order_relaxed);
+    Zero->data.fill(0x00);
+    _pages.fill(Zero);
+    _remap();
+}
+
+/*****************************************************************************/
+
+Byte CCowMem::operator[](const Word& pAddress) const
+{
+    return _pages[pAddress >> 8]->data[pAddress & 0xFF];
+}
+
+/*****************************************************************************/
+
+Byte& CCowMem::operator[](const Word& pAddress)
+{
+    return _own(static_cast<Byte>(pAddress >> 8)).data[pAddress & 0xFF];
+}
+
+/*****************************************************************************/
+
+u32 CCowMem::getPrivatePages() const
+{
+    u32 Pages = 0;
+    for (const SCowPage* Page : _pages)
+    {
+        Pages += Page->refs.load(std::memory_order_relaxed) == 1;
+    }
+    return Pages;
+}
+
+/*****************************************************************************/
+
+u64 CCowMem::getPrivateBytes() const
+{
+    return sizeof(*this) + static_cast<u64>(getPrivatePages()) * sizeof(SCowPage);
+}
+
+/*****************************************************************************/
+
+Byte CCowMem::onReadBusData(const Word& pAddress)
+{
+    return _pages[pAddress >> 8]->data[pAddress & 0xFF];
+}
+
+/*****************************************************************************/
+
+void CCowMem::onWriteBusData(const Word& pAddress, const Byte& pData)
+{
+    _own(static_cast<Byte>(pAddress >> 8)).data[pAddress & 0xFF] = pData;
+}
+
+/*****************************************************************************/
+
+const Byte* CCowMem::onMapReadPage(const Word& pOffset)
+{
+    return _pages[pOffset >> 8]->data.data();
+}
+
+/*****************************************************************************/
+
+Byte* CCowMem::onMapWritePage(const Word& pOffset)
+{
+    SCowPage* Page = _pages[pOffset >> 8];
+    // Pages shared when mapped are mapped again once written
+    if (Page->refs.load(std::memory_order_acquire) != 1) return nullptr;
+    return Page->data.data();
+}
+
+/*****************************************************************************/
+
+u32 CCowMem::onStateSize() const
+{
+    return MAX_MEM;
+}
+
+/*****************************************************************************/
+
+void CCowMem::onSaveState(Byte* pState) const
+{
+    for (const SCowPage* Page : _pages)
+    {
+        pState = std::copy(Page->data.begin(), Page->data.end(), pState);
+    }
+}
+
+/*****************************************************************************/
+
+void CCowMem::onLoadState(const Byte* pState)
+{
+    for (u32 Index = 0; Index < _pages.size(); Index++, pState += 256)
+    {
+        // Pages left as they are stay shared
+        if (std::equal(_pages[Index]->data.begin(), _pages[Index]->data.end(), pState)) continue;
+        SCowPage& Page = _own(static_cast<Byte>(Index));
+        std::copy(pState, pState + 256, Page.data.begin());
+    }
+}
+
+/*****************************************************************************/
+
+void CCowMem::_share(CCowMem& pParent)
+{
+    _pages = pParent._pages;
+    for (u32 Index = 0; Index < _pages.size(); Index++)
+    {
+        // Written directly by the parent bus until shared again
+        if (_pages[Index]->refs.fetch_add(1, std::memory_order_relaxed) == 1)
+        {
+            pParent._remapPage(static_cast<Word>(Index << 8));
+        }
+    }
+    _remap();
+}
+
+/*****************************************************************************/
+
+void CCowMem::_release()
+{
+    for (SCowPage*& Page : _pages)
+    {
+        if (Page && Page->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete Page;
+        }
+        Page = nullptr;
+    }
+}
+
+/*****************************************************************************/
+
+SCowPage& CCowMem::_own(const Byte& pPage)
+{
+    SCowPage* Page = _pages[pPage];
+    if (Page->refs.load(std::memory_order_acquire) == 1) return *Page;
+    SCowPage* Copy = new SCowPage;
+    Copy->refs.store(1, std::memory_order_relaxed);
+    Copy->data = Page->data;
+    _pages[pPage] = Copy;
+    if (Page->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // Others released it meanwhile
+        delete Page;
+    }
+    _remapPage(static_cast<Word>(pPage << 8));
+    return *Copy;
+}
+
+}
@@ -24,24 +24,46 @@
 
 #include <m6502/System/Cpu.hpp>
 
-#define ASSERT( Condition, Text ) { if ( !Condition ) { throw -1; } }
+#ifndef M6502_DEFAULT_ENGINE
+#define M6502_DEFAULT_ENGINE Switch
+#endif
 
 namespace m6502
 {
 
+namespace
+{
+
+/**
+ * @brief Analysis results of the loop closed at an address
+ * 
+ */
+constexpr Byte
+    IdleUnknown = 0,
+    IdleNone = 1,
+    IdleFound = 2;
+
+}
+
 /*****************************************************************************/
 
-CCPU::CCPU(CBus& pBus) : CBusChip(pBus, 0xFFFF, 0)
+CCPU::CCPU(CBus& pBus) : CCPUCore(pBus), CBusChip(pBus, 0xFFFF, 0), _blocks(pBus, this),
+    _idleSkip(false), _idleArmed(false), _idleBranch(0), _idleSkippedCycles(0)
 {
     reset();
     _cycles= 0;
+    _engine = EEngine::M6502_DEFAULT_ENGINE;
+    _loadFlags();
 }
 
 /*****************************************************************************/
 
-CCPU::CCPU(const CCPU& pCopy) : CRegisters(pCopy), CBusChip(pCopy)
+CCPU::CCPU(const CCPU& pCopy) : CCPUCore(pCopy), CBusChip(pCopy), _blocks(pCopy.bus, this),
+    _idleSkip(pCopy._idleSkip), _idleArmed(false), _idleBranch(0),
+    _idleSkippedCycles(pCopy._idleSkippedCycles)
 {
-    _cycles = pCopy._cycles;
+    _clearIdleLoops();
+    _engine = pCopy._engine;
 }
 
 /*****************************************************************************/
@@ -59,1210 +81,500 @@ void CCPU::reset()
 
 void CCPU::reset( const Word& pResetVector )
 {
-    PC = pResetVector;
-    SP = 0xFF;
-    Flags.C = Flags.Z = Flags.I = Flags.D = Flags.B = Flags.V = Flags.N = 0;
-    A = X = Y = 0;
+    _resetRegisters( pResetVector );
+    // Memory may have been changed without the bus
+    _blocks.clear();
+    _clearIdleLoops();
+    _idleSkippedCycles = 0;
 }
 
 /*****************************************************************************/
 
-Byte CCPU::_fetchByte()
+s64 CCPU::execute( s64 pCycles )
 {
-    _cycles--;
-    //return ReadBusData(PC++);
-    return CBusChip::bus.readBusData(PC++);
+    _startRun( pCycles );
+    // Registers and memory read by an idle loop may have been
+    // changed from outside since last run
+    _idleArmed = false;
+    // Breakpoints and runUntil conditions are checked by other
+    // instances of the engines
+    if ( _watching() )
+    {
+        _executeEvents<true>();
+    }
+    else
+    {
+        _executeEvents<false>();
+    }
+    _endRun();
+    return pCycles - _cycles;
 }
 
 /*****************************************************************************/
 
-SByte CCPU::_fetchSByte()
+s64 CCPU::step()
 {
-    return static_cast<SByte>(_fetchByte());
+    _startRun( 0 );
+    // A pending interrupt is taken in place of the instruction
+    if ( !_interruptPending() || !_serviceInterrupts() )
+    {
+        _instructions++;
+        OpTable[_fetchByte()].handler(*this);
+    }
+    _advanceScheduler( static_cast<u64>( -_cycles - (_stop != EStop::Budget ? _stopCycles : 0) ) );
+    _endRun();
+    return -_cycles;
 }
 
 /*****************************************************************************/
 
-Word CCPU::_fetchWord()
+void CCPU::_advanceScheduler( u64 pCycles )
 {
-    // 6502 is little endian
-    Word Data = bus.readBusData(PC++);
-    Data |= (bus.readBusData(PC++) << 8 );
-    _cycles-=2;
-    return Data;
+    _storeFlags();
+    bus.getScheduler().advance( pCycles );
+    _loadFlags();
 }
 
 /*****************************************************************************/
 
-Byte CCPU::_readByte( const Word& pAddress )
+template<bool Watch> void CCPU::_executeEvents()
 {
-    _cycles--;
-    return bus.readBusData(pAddress);
+    CScheduler& Scheduler = bus.getScheduler();
+    while ( _cycles > 0 )
+    {
+        // Run straight to the next deadline, the rest of the
+        // cycles is put back once there
+        const u64 Deadline = Scheduler.getNextDeadline();
+        const u64 ToDeadline = Deadline > Scheduler.getNow() ? Deadline - Scheduler.getNow() : 0;
+        const s64 Slice = ToDeadline < static_cast<u64>( _cycles ) ? static_cast<s64>( ToDeadline ) : _cycles;
+        const s64 Rest = _cycles - Slice;
+        _cycles = Slice;
+        _executeEngine<Watch>();
+        const bool Stopped = _stop != EStop::Budget;
+        const s64 Left = _cycles + (Stopped ? _stopCycles : 0);
+        _advanceScheduler( static_cast<u64>( Slice - Left ) );
+        _cycles += Rest;
+        // Stopped by the engine or by an event
+        if ( _stop != EStop::Budget ) return;
+    }
 }
 
 /*****************************************************************************/
 
-Word CCPU::_readWord( const Word& pAddress )
+template<bool Watch> void CCPU::_executeEngine()
 {
-    return _readByte( pAddress ) | (  _readByte( pAddress + 1 ) << 8 );
+    switch (_engine)
+    {
+        case EEngine::Table:
+        {
+            _executeTable<Watch>();
+        } break;
+        case EEngine::Threaded:
+        {
+            _executeThreaded<Watch>();
+        } break;
+        case EEngine::Block:
+        {
+            _executeBlock<Watch>();
+        } break;
+        default:
+        {
+            _executeSwitch<Watch>();
+        } break;
+    }
 }
 
 /*****************************************************************************/
 
-void CCPU::_writeByte( const Byte& pValue, const Word& pAddress )
+void CCPU::setEngine( EEngine pEngine )
 {
-    bus.writeBusData( pAddress , pValue );
-    _cycles--;
+    _engine = pEngine;
 }
 
 /*****************************************************************************/
 
-void CCPU::_writeWord( const Word& pValue, const Word& pAddress )
+EEngine CCPU::getEngine() const
 {
-    bus.writeBusData( pAddress , pValue & 0xFF);
-    bus.writeBusData( pAddress + 1 , pValue >> 8);
-    _cycles -= 2;
+    return _engine;
 }
 
 /*****************************************************************************/
 
-Word CCPU::SPToAddress() const
+const SBlockCacheStats& CCPU::getBlockCacheStats() const
 {
-    return 0x100 | SP;
+    return _blocks.getStats();
 }
 
 /*****************************************************************************/
 
-void CCPU::_pushWordToStack( const Word& pValue )
+void CCPU::resetBlockCacheStats()
 {
-    _writeByte( pValue >> 8, SPToAddress());
-    SP--;
-    _writeByte( pValue & 0xFF, SPToAddress());
-    SP--;
+    _blocks.resetStats();
 }
 
 /*****************************************************************************/
 
-void CCPU::_pushPCMinusOneToStack()
+void CCPU::flushBlockCache()
 {
-    _pushWordToStack( PC - 1 );
+    _blocks.clear();
 }
 
 /*****************************************************************************/
 
-void CCPU::_pushPCPlusOneToStack()
+void CCPU::onWatchedWrite( const Word& pAddress )
 {
-    _pushWordToStack( PC + 1 );
+    _blocks.invalidatePage( pAddress >> 8 );
 }
 
 /*****************************************************************************/
 
-void CCPU::_pushPCToStack()
+bool CCPU::_serviceInterrupts()
 {
-    _pushWordToStack( PC );
+    const u32 Lines = bus.getInterrupts();
+    if ( Lines & CBus::ResetLines )
+    {
+        // Held in reset, time goes by
+        _cycles -= std::max<s64>( _cycles, 1 );
+        return true;
+    }
+    if ( Lines & CBus::ResetEdge )
+    {
+        // Three dummy pushes, then the vector
+        bus.acknowledgeInterrupt( CBus::ResetEdge );
+        SP -= 3;
+        Flags.I = true;
+        _cycles -= 5;
+        PC = _readWord( 0xFFFC );
+        _idleArmed = false;
+        return true;
+    }
+    if ( Lines & CBus::NMIEdge )
+    {
+        bus.acknowledgeInterrupt( CBus::NMIEdge );
+        _interrupt( 0xFFFA );
+        _idleArmed = false;
+        return true;
+    }
+    if ( (Lines & CBus::IRQLines) && !Flags.I )
+    {
+        _interrupt( 0xFFFE );
+        _idleArmed = false;
+        return true;
+    }
+    return false;
 }
 
 /*****************************************************************************/
 
-void CCPU::_pushByteOntoStack( const Byte& pValue )
+void CCPU::onTrappedWrite( const Word& )
 {
-    bus.writeBusData( SPToAddress() , pValue );
-    _cycles-=2;
-    SP--;
+    _raiseStop( EStop::Condition );
 }
 
 /*****************************************************************************/
 
-Byte CCPU::_popByteFromStack()
+SExecResult CCPU::runUntilWrite( Word pFirst, Word pLast, s64 pCycles )
 {
-    SP++;
-    _cycles-=2;
-    return bus.readBusData( SPToAddress());
+    bus.trapWrites( this, pFirst, pLast );
+    const SExecResult Result = run( pCycles );
+    bus.untrapWrites();
+    return Result;
 }
 
 /*****************************************************************************/
 
-Word CCPU::_popWordFromStack()
+u32 CCPU::onStateSize() const
 {
-    Word ValueFromStack = _readWord( SPToAddress()+1 );
-    SP += 2;
-    _cycles--;
-    return ValueFromStack;
+    return sizeof(PC) + sizeof(SP) + sizeof(A) + sizeof(X) + sizeof(Y) + sizeof(PS) +
+        sizeof(_cycles) + sizeof(_idleSkippedCycles);
 }
 
 /*****************************************************************************/
 
-void CCPU::_setZeroAndNegativeFlags( const Byte& pRegister )
+void CCPU::onSaveState( Byte* pState ) const
 {
-    Flags.Z = (pRegister == 0);
-    Flags.N = (pRegister & NegativeFlagBit) > 0;
+    // Flags are in PS out of execute
+    pState = _saveState( pState, PC );
+    pState = _saveState( pState, SP );
+    pState = _saveState( pState, A );
+    pState = _saveState( pState, X );
+    pState = _saveState( pState, Y );
+    pState = _saveState( pState, PS );
+    pState = _saveState( pState, _cycles );
+    _saveState( pState, _idleSkippedCycles );
 }
 
 /*****************************************************************************/
 
-s64 CCPU::execute( s64 pCycles )
+void CCPU::onLoadState( const Byte* pState )
+{
+    pState = _loadState( pState, PC );
+    pState = _loadState( pState, SP );
+    pState = _loadState( pState, A );
+    pState = _loadState( pState, X );
+    pState = _loadState( pState, Y );
+    pState = _loadState( pState, PS );
+    pState = _loadState( pState, _cycles );
+    _loadState( pState, _idleSkippedCycles );
+    _loadFlags();
+    // Memory is loaded without the bus
+    _blocks.clear();
+    _clearIdleLoops();
+}
+
+/*****************************************************************************/
+
+template<bool Watch> void CCPU::_executeTable()
 {
-    s64 CyclesRequested = pCycles;
-    _cycles = pCycles;
     while ( _cycles > 0)
     {
-        Byte Instr = _fetchByte();
-        switch (ins(Instr))
+        if ( _interruptPending() && _serviceInterrupts() ) continue;
+        if constexpr ( Watch )
         {
-            case Ins::AND_IM:
-            {
-                A &= _fetchByte();
-                _setZeroAndNegativeFlags(A);
-            } break;
-            case Ins::ORA_IM:
-            {
-                A |= _fetchByte();
-                _setZeroAndNegativeFlags(A);
-            } break;
-            case Ins::EOR_IM:
-            {
-                A ^= _fetchByte();
-                _setZeroAndNegativeFlags(A);
-            } break;
-            case Ins::AND_ZP:
-            {
-                _and( _addrZeroPage() );
-            } break;
-            case Ins::ORA_ZP:
-            {
-                _ora( _addrZeroPage() );
-            } break;
-            case Ins::EOR_ZP:
-            {
-                _eor( _addrZeroPage() );
-            } break;
-            case Ins::AND_ZPX:
-            {
-                _and( _addrZeroPageX() );
-            } break;
-            case Ins::ORA_ZPX:
-            {
-                _ora( _addrZeroPageX() );
-            } break;
-            case Ins::EOR_ZPX:
-            {
-                _eor( _addrZeroPageX() );
-            } break;
-            case Ins::AND_ABS:
-            {
-                _and( _addrAbsolute() );
-            } break;
-            case Ins::ORA_ABS:
-            {
-                _ora( _addrAbsolute() );
-            } break;
-            case Ins::EOR_ABS:
-            {
-                _eor( _addrAbsolute() );
-            } break;
-            case Ins::AND_ABSX:
-            {
-                _and( _addrAbsoluteX() );
-            } break;
-            case Ins::ORA_ABSX:
-            {
-                _ora( _addrAbsoluteX() );
-            } break;
-            case Ins::EOR_ABSX:
-            {
-                _eor( _addrAbsoluteX() );
-            } break;
-            case Ins::AND_ABSY:
-            {
-                _and( _addrAbsoluteY() );
-            } break;
-            case Ins::ORA_ABSY:
-            {
-                _ora( _addrAbsoluteY() );
-            } break;
-            case Ins::EOR_ABSY:
-            {
-                _eor( _addrAbsoluteY() );
-            } break;
-            case Ins::AND_INDX:
-            {
-                _and( _addrIndirectX() );
-            } break;
-            case Ins::ORA_INDX:
-            {
-                _ora( _addrIndirectX() );
-            } break;
-            case Ins::EOR_INDX:
-            {
-                _eor( _addrIndirectX() );
-            } break;
-            case Ins::AND_INDY:
-            {
-                _and( _addrIndirectY() );
-            } break;
-            case Ins::ORA_INDY:
-            {
-                _ora( _addrIndirectY() );
-            } break;
-            case Ins::EOR_INDY:
-            {
-                _eor( _addrIndirectY() );
-            } break;
-            case Ins::BIT_ZP:
-            {
-                Byte Value = _readByte( _addrZeroPage() );
-                Flags.Z = ! (A & Value);
-                Flags.N = (Value & NegativeFlagBit) != 0;
-                Flags.V = (Value & OverflowFlagBit) != 0;
-            } break;
-            case Ins::BIT_ABS:
-            {
-                Byte Value = _readByte( _addrAbsolute() );
-                Flags.Z = ! (A & Value);
-                Flags.N = (Value & NegativeFlagBit) != 0;
-                Flags.V = (Value & OverflowFlagBit) != 0;
-            } break;
-            case Ins::LDA_IM:
-            {
-                A = _fetchByte ();
-                _setZeroAndNegativeFlags(A);
-            } break;
-            case Ins::LDX_IM:
-            {
-                X = _fetchByte ();
-                _setZeroAndNegativeFlags(X);
-            } break;
-            case Ins::LDY_IM:
-            {
-                Y = _fetchByte ();
-                _setZeroAndNegativeFlags(Y);
-            } break;
-            case Ins::LDA_ZP:
-            {
-                _loadRegister ( _addrZeroPage(), A );
-            } break;
-            case Ins::LDX_ZP:
-            {
-                _loadRegister ( _addrZeroPage(), X );
-            } break;
-            case Ins::LDY_ZP:
-            {
-                _loadRegister ( _addrZeroPage(), Y );
-            } break;
-            case Ins::LDA_ZPX:
-            {
-                _loadRegister ( _addrZeroPageX(), A );
-            } break;
-            case Ins::LDX_ZPY:
-            {
-                _loadRegister ( _addrZeroPageY(), X );
-            } break;
-            case Ins::LDY_ZPX:
-            {
-                _loadRegister ( _addrZeroPageX(), Y );
-            } break;
-            case Ins::LDA_ABS:
-            {
-                _loadRegister ( _addrAbsolute(), A );
-            } break;
-            case Ins::LDX_ABS:
-            {
-                _loadRegister ( _addrAbsolute(), X );
-            } break;
-            case Ins::LDY_ABS:
-            {
-                _loadRegister ( _addrAbsolute(), Y );
-            } break;
-            case Ins::LDA_ABSX:
-            {
-                _loadRegister ( _addrAbsoluteX(), A );
-            } break;
-            case Ins::LDA_ABSY:
-            {
-                _loadRegister ( _addrAbsoluteY(), A );
-            } break;
-            case Ins::LDX_ABSY:
-            {
-                _loadRegister ( _addrAbsoluteY(), X );
-            } break;
-            case Ins::LDY_ABSX:
-            {
-                _loadRegister ( _addrAbsoluteX(), Y );
-            } break;
-            case Ins::LDA_INDX:
-            {
-                _loadRegister ( _addrIndirectX(), A );
-            } break;
-            case Ins::LDA_INDY:
-            {
-                _loadRegister ( _addrIndirectY(), A );
-            } break;
-            case Ins::STA_ZP:
-            {
-                _writeByte ( A , _addrZeroPage() );
-            } break;
-            case Ins::STX_ZP:
-            {
-                _writeByte ( X , _addrZeroPage() );
-            } break;
-            case Ins::STY_ZP:
-            {
-                _writeByte ( Y , _addrZeroPage() );
-            } break;
-            case Ins::STA_ABS:
-            {
-                _writeByte ( A , _addrAbsolute() );
-            } break;
-            case Ins::STX_ABS:
-            {
-                _writeByte ( X , _addrAbsolute() );
-            } break;
-            case Ins::STY_ABS:
-            {
-                _writeByte ( Y , _addrAbsolute() );
-            } break;
-            case Ins::STA_ZPX:
-            {
-                _writeByte ( A , _addrZeroPageX() );
-            } break;
-            case Ins::STY_ZPX:
-            {
-                _writeByte ( Y , _addrZeroPageX() );
-            } break;
-            case Ins::STA_ABSX:
-            {
-                _writeByte ( A , _addrAbsoluteX_5() );
-            } break;
-            case Ins::STA_ABSY:
-            {
-                _writeByte ( A , _addrAbsoluteY_5() );
-            } break;
-            case Ins::STX_ZPY:
-            {
-                _writeByte ( X , _addrZeroPageY() );
-            } break;
-            case Ins::STA_INDX:
-            {
-                _writeByte ( A , _addrIndirectX_6() );
-            } break;
-            case Ins::STA_INDY:
-            {
-                _writeByte ( A , _addrIndirectY_6() );
-            } break;
-            case Ins::JSR:
-            {
-                Word SubAddr = _fetchWord();
-                _pushPCMinusOneToStack();
-                PC = SubAddr;
-                _cycles--;
-            } break;
-            case Ins::RTS:
-            {
-                PC = _popWordFromStack() + 1;	
-                _cycles -= 2;
-            } break;
-            //TODO:
-            //An original 6502 has does not correctly fetch the target 
-            //address if the indirect vector falls on a page boundary
-            //( e.g.$xxFF where xx is any value from $00 to $FF ).
-            //In this case fetches the LSB from $xxFF as expected but 
-            //takes the MSB from $xx00.This is fixed in some later chips 
-            //like the 65SC02 so for compatibility always ensure the 
-            //indirect vector is not at the end of the page.
-            case Ins::JMP_ABS:
-            {
-                PC = _addrAbsolute();
-            } break;
-            case Ins::JMP_IND:
-            {
-                PC = _readWord( _addrAbsolute() );
-            } break;
-            case Ins::TSX:
-            {
-                X = SP;
-                _cycles--;
-                _setZeroAndNegativeFlags( X );
-            } break;
-            case Ins::TXS:
-            {
-                SP = X;
-                _cycles--;
-            } break;
-            case Ins::PHA:
-            {
-                _pushByteOntoStack( A );
-            } break;
-            case Ins::PLA:
-            {
-                A = _popByteFromStack();
-                _setZeroAndNegativeFlags( A );
-                _cycles--;
-            } break;
-            case Ins::PHP:
-            {
-                _pushPSToStack();
-            } break;
-            case Ins::PLP:
-            {
-                _popPSFromStack();
-                _cycles--;
-            } break;
-            case Ins::TAX:
-            {
-                X = A;
-                _cycles--;
-                _setZeroAndNegativeFlags( X );
-            } break;
-            case Ins::TAY:
-            {
-                Y = A;
-                _cycles--;
-                _setZeroAndNegativeFlags( Y );
-            } break;
-            case Ins::TXA:
-            {
-                A = X;
-                _cycles--;
-                _setZeroAndNegativeFlags( A );
-            } break;
-            case Ins::TYA:
-            {
-                A = Y;
-                _cycles--;
-                _setZeroAndNegativeFlags( A );
-            } break;
-            case Ins::INX:
-            {
-                X++;
-                _cycles--;
-                _setZeroAndNegativeFlags( X );
-            } break;
-            case Ins::INY:
-            {
-                Y++;
-                _cycles--;
-                _setZeroAndNegativeFlags( Y );
-            } break;
-            case Ins::DEX:
-            {
-                X--;
-                _cycles--;
-                _setZeroAndNegativeFlags( X );
-            } break;
-            case Ins::DEY:
-            {
-                Y--;
-                _cycles--;
-                _setZeroAndNegativeFlags( Y );
-            } break;
-            case Ins::DEC_ZP:
-            {
-                Word Address = _addrZeroPage();
-                Byte Value = _readByte( Address );
-                Value--;
-                _cycles--;
-                _writeByte( Value, Address );
-                _setZeroAndNegativeFlags( Value );
-            } break;
-            case Ins::DEC_ZPX:
-            {
-                Word Address = _addrZeroPageX();
-                Byte Value = _readByte( Address );
-                Value--;
-                _cycles--;
-                _writeByte( Value, Address );
-                _setZeroAndNegativeFlags( Value );
-            } break;
-            case Ins::DEC_ABS:
-            {
-                Word Address = _addrAbsolute();
-                Byte Value = _readByte( Address );
-                Value--;
-                _cycles--;
-                _writeByte( Value, Address );
-                _setZeroAndNegativeFlags( Value );
-            } break;
-            case Ins::DEC_ABSX:
-            {
-                Word Address = _addrAbsoluteX_5();
-                Byte Value = _readByte( Address );
-                Value--;
-                _cycles--;
-                _writeByte( Value, Address );
-                _setZeroAndNegativeFlags( Value );
-            } break;
-            case Ins::INC_ZP:
-            {
-                Word Address = _addrZeroPage();
-                Byte Value = _readByte( Address );
-                Value++;
-                _cycles--;
-                _writeByte( Value, Address );
-                _setZeroAndNegativeFlags( Value );
-            } break;
-            case Ins::INC_ZPX:
-            {
-                Word Address = _addrZeroPageX();
-                Byte Value = _readByte( Address );
-                Value++;
-                _cycles--;
-                _writeByte( Value, Address );
-                _setZeroAndNegativeFlags( Value );
-            } break;
-            case Ins::INC_ABS:
-            {
-                Word Address = _addrAbsolute();
-                Byte Value = _readByte( Address );
-                Value++;
-                _cycles--;
-                _writeByte( Value, Address );
-                _setZeroAndNegativeFlags( Value );
-            } break;
-            case Ins::INC_ABSX:
-            {
-                Word Address = _addrAbsoluteX_5();
-                Byte Value = _readByte( Address );
-                Value++;
-                _cycles--;
-                _writeByte( Value, Address );
-                _setZeroAndNegativeFlags( Value );
-            } break;
-            case Ins::BEQ:
-            {
-                _branchIf( Flags.Z, true );
-            } break;
-            case Ins::BNE:
-            {
-                _branchIf( Flags.Z, false );
-            } break;
-            case Ins::BSC:
-            {
-                _branchIf( Flags.C, true );
-            } break;
-            case Ins::BCC:
-            {
-                _branchIf( Flags.C, false );
-            } break;
-            case Ins::BMI:
-            {
-                _branchIf( Flags.N, true );
-            } break;
-            case Ins::BPL:
-            {
-                _branchIf( Flags.N, false );
-            } break;
-            case Ins::BVC:
-            {
-                _branchIf( Flags.V, false );
-            } break;
-            case Ins::BVS:
-            {
-                _branchIf( Flags.V, true );
-            } break;
-            case Ins::CLC:
-            {
-                Flags.C = false;
-                _cycles--;
-            } break;
-            case Ins::SEC:
-            {
-                Flags.C = true;
-                _cycles--;
-            } break;
-            case Ins::CLD:
-            {
-                Flags.D = false;
-                _cycles--;
-            } break;
-            case Ins::SED:
-            {
-                Flags.D = true;
-                _cycles--;
-            } break;
-            case Ins::CLI:
-            {
-                Flags.I = false;
-                _cycles--;
-            } break;
-            case Ins::SEI:
-            {
-                Flags.I = true;
-                _cycles--;
-            } break;
-            case Ins::CLV:
-            {
-                Flags.V = false;
-                _cycles--;
-            } break;
-            case Ins::NOP:
-            {
-                _cycles--;
-            } break;
-            case Ins::ADC_ABS:
-            {
-                _ADC( _readByte( _addrAbsolute() ) );
-            } break;
-            case Ins::ADC_ABSX:
-            {
-                _ADC( _readByte( _addrAbsoluteX() ) );
-            } break;
-            case Ins::ADC_ABSY:
-            {
-                _ADC( _readByte( _addrAbsoluteY() ) );
-            } break;
-            case Ins::ADC_ZP:
-            {
-                _ADC( _readByte( _addrZeroPage() ) );
-            } break;
-            case Ins::ADC_ZPX:
-            {
-                _ADC( _readByte( _addrZeroPageX() ) );
-            } break;
-            case Ins::ADC_INDX:
-            {
-                _ADC( _readByte( _addrIndirectX() ) );
-            } break;
-            case Ins::ADC_INDY:
-            {
-                _ADC( _readByte( _addrIndirectY() ) );
-            } break;
-            case Ins::ADC:
-            {
-                _ADC( _fetchByte() );
-            } break;
-            case Ins::SBC:
-            {
-                _SBC( _fetchByte() );
-            } break;
-            case Ins::SBC_ABS:
-            {
-                _SBC( _readByte( _addrAbsolute() ) );
-            } break;
-            case Ins::SBC_ZP:
-            {
-                _SBC( _readByte( _addrZeroPage() ) );
-            } break;
-            case Ins::SBC_ZPX:
-            {
-                _SBC( _readByte( _addrZeroPageX() ) );
-            } break;
-            case Ins::SBC_ABSX:
-            {
-                _SBC( _readByte ( _addrAbsoluteX() ) );
-            } break;
-            case Ins::SBC_ABSY:
-            {
-                _SBC( _readByte( _addrAbsoluteY() ) );
-            } break;
-            case Ins::SBC_INDX:
-            {
-                _SBC( _readByte( _addrIndirectX() ) );
-            } break;
-            case Ins::SBC_INDY:
-            {
-                _SBC( _readByte( _addrIndirectY() ) );
-            } break;
-            case Ins::CPX:
-            {
-                _registerCompare( _fetchByte() , X );
-            } break;
-            case Ins::CPY:
-            {
-                _registerCompare( _fetchByte(), Y );
-            } break;
-            case Ins::CPX_ZP:
-            {
-                _registerCompare( _readByte( _addrZeroPage() ), X );
-            } break;
-            case Ins::CPY_ZP:
-            {
-                _registerCompare( _readByte( _addrZeroPage() ), Y );
-            } break;
-            case Ins::CPX_ABS:
-            {
-                _registerCompare( _readByte ( _addrAbsolute () ), X );
-            } break;
-            case Ins::CPY_ABS:
-            {
-                _registerCompare( _readByte ( _addrAbsolute () ), Y );
-            } break;
-            case Ins::CMP:
-            {
-                _registerCompare( _fetchByte(), A );
-            } break;
-            case Ins::CMP_ZP:
-            {
-                _registerCompare( _readByte( _addrZeroPage() ), A );
-            } break;
-            case Ins::CMP_ZPX:
-            {
-                _registerCompare( _readByte( _addrZeroPageX() ), A );
-            } break;
-            case Ins::CMP_ABS:
-            {
-                _registerCompare( _readByte( _addrAbsolute() ), A );
-            } break;
-            case Ins::CMP_ABSX:
-            {
-                _registerCompare( _readByte( _addrAbsoluteX() ), A );
-            } break;
-            case Ins::CMP_ABSY:
-            {
-                _registerCompare( _readByte( _addrAbsoluteY() ), A );
-            } break;
-            case Ins::CMP_INDX:
-            {
-                _registerCompare( _readByte( _addrIndirectX() ), A );
-            } break;
-            case Ins::CMP_INDY:
-            {
-                _registerCompare( _readByte( _addrIndirectY() ), A );
-            } break;
-            case Ins::ASL:
-            {
-                A = _ASL( A );
-            } break;
-            case Ins::ASL_ZP:
-            {
-                Word Address = _addrZeroPage();
-                Byte Operand = _readByte( Address );
-                Byte Result = _ASL( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ASL_ZPX:
-            {
-                Word Address = _addrZeroPageX();
-                Byte Operand = _readByte( Address );
-                Byte Result = _ASL( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ASL_ABS:
-            {
-                Word Address = _addrAbsolute();
-                Byte Operand = _readByte( Address );
-                Byte Result = _ASL( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ASL_ABSX:
-            {
-                Word Address = _addrAbsoluteX_5();
-                Byte Operand = _readByte( Address );
-                Byte Result = _ASL( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::LSR:
-            {
-                A = _LSR( A );
-            } break;
-            case Ins::LSR_ZP:
-            {
-                Word Address = _addrZeroPage();
-                Byte Operand = _readByte( Address );
-                Byte Result = _LSR( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::LSR_ZPX:
-            {
-                Word Address = _addrZeroPageX();
-                Byte Operand = _readByte( Address );
-                Byte Result = _LSR( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::LSR_ABS:
-            {
-                Word Address = _addrAbsolute();
-                Byte Operand = _readByte( Address );
-                Byte Result = _LSR( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::LSR_ABSX:
-            {
-                Word Address = _addrAbsoluteX_5();
-                Byte Operand = _readByte( Address );
-                Byte Result = _LSR( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ROL:
-            {
-                A = _ROL( A );
-            } break;
-            case Ins::ROL_ZP:
-            {
-                Word Address = _addrZeroPage( );
-                Byte Operand = _readByte( Address );
-                Byte Result = _ROL( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ROL_ZPX:
-            {
-                Word Address = _addrZeroPageX();
-                Byte Operand = _readByte( Address );
-                Byte Result = _ROL( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ROL_ABS:
-            {
-                Word Address = _addrAbsolute();
-                Byte Operand = _readByte( Address );
-                Byte Result = _ROL( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ROL_ABSX:
-            {
-                Word Address = _addrAbsoluteX_5();
-                Byte Operand = _readByte( Address );
-                Byte Result = _ROL( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ROR:
-            {
-                A = _ROR( A );
-            } break;
-            case Ins::ROR_ZP:
-            {
-                Word Address = _addrZeroPage();
-                Byte Operand = _readByte( Address );			
-                Byte Result = _ROR( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ROR_ZPX:
-            {
-                Word Address = _addrZeroPageX( );
-                Byte Operand = _readByte( Address );
-                Byte Result = _ROR( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ROR_ABS:
-            {
-                Word Address = _addrAbsolute();
-                Byte Operand = _readByte( Address );
-                Byte Result = _ROR( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::ROR_ABSX:
-            {
-                Word Address = _addrAbsoluteX_5();
-                Byte Operand = _readByte(Address);
-                Byte Result = _ROR( Operand );
-                _writeByte( Result, Address );
-            } break;
-            case Ins::BRK:
-            {
-                _pushPCPlusOneToStack();
-                _pushPSToStack();
-                constexpr Word InterruptVector = 0xFFFE;
-                PC = _readWord( InterruptVector );
-                Flags.B = true;
-                Flags.I = true;
-            } break;
-            case Ins::RTI:
-            {
-                _popPSFromStack();
-                PC = _popWordFromStack();
-            } break;
-            default:
-            {
-                printf("Instruction %02X not handled\n", Instr);
-                throw - 1;
-            } break;
+            if ( _watchStop() ) return;
         }
+        _instructions++;
+        OpTable[_fetchByte()].handler(*this);
     }
-    const s64 NumCyclesUsed = CyclesRequested - _cycles;
-    return NumCyclesUsed;
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrZeroPage()
+template<bool Watch> void CCPU::_executeBlock()
 {
-    return static_cast<Word>(_fetchByte());
+    while ( _cycles > 0 )
+    {
+        // Interrupts are taken between blocks
+        if ( _interruptPending() && _serviceInterrupts() ) continue;
+        const SBlock& Block = _blocks.lookup( PC );
+        if ( Block.instructions.empty() )
+        {
+            // Code out of host memory is run from the bus
+            if constexpr ( Watch )
+            {
+                if ( _watchStop() ) return;
+            }
+            _instructions++;
+            OpTable[_fetchByte()].handler( *this );
+            continue;
+        }
+        const u64 Generation = _blocks.getGeneration();
+        // Checking cycles once per block is enough when even the
+        // slowest run of the block leaves some
+        const bool CheckCycles = _cycles <= Block.maxCycles;
+        for ( const SBlockInstruction& Instruction : Block.instructions )
+        {
+            if constexpr ( Watch )
+            {
+                if ( _watchStop() ) return;
+            }
+            // Opcode fetch, already decoded
+            PC++;
+            _cycles--;
+            _instructions++;
+            Instruction.handler( *this, Instruction );
+            // Self modifying code, the block may be gone
+            if ( Generation != _blocks.getGeneration() ) break;
+            // Stops end the block whatever the cycles left
+            if ( _cycles <= 0 && (CheckCycles || _stop != EStop::Budget) ) return;
+        }
+    }
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrZeroPageX()
+template<Ins I> void CCPU::_dispatch( CCPU& pCPU )
 {
-    Byte ZeroPageAddr = _fetchByte();
-    ZeroPageAddr += X;
-    _cycles--;
-    return ZeroPageAddr;
+    pCPU._ins( SIns<I>(), SFetched() );
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrZeroPageY()
+template<Byte OpCode> void CCPU::_dispatchIllegal( CCPU& pCPU )
 {
-    Byte ZeroPageAddr = _fetchByte();
-    ZeroPageAddr += Y;
-    _cycles--;
-    return ZeroPageAddr;
+    pCPU._illegal( OpCode );
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrAbsolute()
+template<Ins I> void CCPU::_dispatchDecoded( CCPU& pCPU, const SBlockInstruction& pInstruction )
 {
-    return _fetchWord();
+    pCPU._ins( SIns<I>(), SDecoded{ pInstruction.operand } );
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrAbsoluteX()
+void CCPU::_dispatchDecodedIllegal( CCPU& pCPU, const SBlockInstruction& pInstruction )
 {
-    Word AbsAddress = _fetchWord();
-    Word AbsAddressX = AbsAddress + X;
-    const bool CrossedPageBoundary = (AbsAddress ^ AbsAddressX) >> 8;
-    if ( CrossedPageBoundary )
-    {
-        _cycles--;
-    }
-
-    return AbsAddressX;
+    pCPU._illegal( pInstruction.opcode );
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrAbsoluteX_5()
+template<std::size_t... OpCode>
+constexpr std::array<void(*)(CCPU&),256> CCPU::_illegalHandlers( std::index_sequence<OpCode...> )
 {
-    Word AbsAddress = _fetchWord();
-    _cycles--;
-    return AbsAddress + X;
+    return {{ &CCPU::_dispatchIllegal<static_cast<Byte>(OpCode)>... }};
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrAbsoluteY()
+constexpr std::array<CCPU::SOpCode,256> CCPU::_buildOpTable()
 {
-    Word AbsAddress = _fetchWord();
-    Word AbsAddressY = AbsAddress + Y;
-    const bool CrossedPageBoundary = (AbsAddress ^ AbsAddressY) >> 8;
-    if ( CrossedPageBoundary )
+    std::array<SOpCode,256> Table {};
+    const std::array<void(*)(CCPU&),256> Illegal = _illegalHandlers( std::make_index_sequence<256>() );
+    for ( size_t OpCode = 0; OpCode < Table.size(); OpCode++ )
     {
-        _cycles--;
+        Table[OpCode] = { Illegal[OpCode], EAddrMode::Implied, 1, EPagePenalty::None, false, &CCPU::_dispatchDecodedIllegal };
     }
-
-    return AbsAddressY;
+#define M6502_OP( Name, Mode, Cycles, Penalty ) \
+    Table[opcode(Ins::Name)] = { &CCPU::_dispatch<Ins::Name>, EAddrMode::Mode, Cycles, EPagePenalty::Penalty, true, \
+        &CCPU::_dispatchDecoded<Ins::Name> };
+#include <m6502/System/OpTable.inl>
+    return Table;
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrIndirectX()
-{
-    _cycles--;
-    return _readWord(_fetchByte() + X);
-}
+const std::array<CCPU::SOpCode,256> CCPU::OpTable = CCPU::_buildOpTable();
 
 /*****************************************************************************/
 
-Word CCPU::_addrIndirectY()
+void CCPU::setIdleSkip( bool pEnabled )
 {
-    Byte ZPAddress = _fetchByte();
-    Word EffectiveAddr = _readWord( ZPAddress );
-    Word EffectiveAddrY = EffectiveAddr + Y;
-    const bool CrossedPageBoundary = (EffectiveAddr ^ EffectiveAddrY) >> 8;
-    if ( CrossedPageBoundary )
-    {
-        _cycles--;
-    }
-    return EffectiveAddrY;
+    _idleSkip = pEnabled;
+    _clearIdleLoops();
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrAbsoluteY_5()
+bool CCPU::getIdleSkip() const
 {
-    _cycles--;
-    return _fetchWord() + Y;
+    return _idleSkip;
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrIndirectX_6()
+u64 CCPU::getIdleSkippedCycles() const
 {
-    _cycles--;
-    return _readWord( _fetchByte() ) + X;
+    return _idleSkippedCycles;
 }
 
 /*****************************************************************************/
 
-Word CCPU::_addrIndirectY_6()
+void CCPU::_clearIdleLoops()
 {
-    _cycles--;
-    return _readWord( _fetchByte() ) + Y;
+    _idleArmed = false;
+    _idleLoops.clear();
+    if ( _idleSkip )
+    {
+        _idleVerdicts.assign( 0x10000, IdleUnknown );
+    }
+    else
+    {
+        _idleVerdicts.clear();
+    }
 }
 
 /*****************************************************************************/
 
-Word CCPU::loadPrg( const Byte* pProgram, u32 NumBytes )
+void CCPU::_idleJump( const Word& pBranch )
 {
-    Word LoadAddress = 0;
-    if ( pProgram && NumBytes > 2 )
+    // Loops jump back
+    if ( PC > pBranch )
     {
-        Word At = 0;
-        const Word Lo = pProgram[At++];
-        const Word Hi = pProgram[At++] << 8;
-        LoadAddress = Lo | Hi;
-        for ( Word Addr = LoadAddress; Addr < LoadAddress+NumBytes-2; Addr++ )
+        _idleArmed = false;
+        return;
+    }
+    Byte& Verdict = _idleVerdicts[pBranch];
+    if ( Verdict == IdleUnknown )
+    {
+        SIdleLoop Loop = analyseIdleLoop( bus, PC, pBranch );
+        Verdict = Loop.kind == EIdleKind::None ? IdleNone : IdleFound;
+        if ( Verdict == IdleFound )
         {
-            //TODO: mem copy?
-            bus.writeBusData(Addr, pProgram[At++]);
+            _idleLoops[pBranch] = std::move( Loop );
         }
-        PC = LoadAddress;
     }
-    return LoadAddress;
-}
-
-/*****************************************************************************/
-
-void CCPU::_loadRegister(Word pAddress, Byte& pRegister)
-{
-    pRegister = _readByte ( pAddress );
-    _setZeroAndNegativeFlags( pRegister );
-}
-
-/*****************************************************************************/
-
-void CCPU::_and( Word pAddress )
-{
-    A &= _readByte( pAddress );
-    _setZeroAndNegativeFlags( A );
+    if ( Verdict != IdleFound )
+    {
+        _idleArmed = false;
+        return;
+    }
+    // Taken once, the loop may have been entered past its head
+    if ( !_idleArmed || _idleBranch != pBranch )
+    {
+        _idleArmed = true;
+        _idleBranch = pBranch;
+        return;
+    }
+    const SIdleLoop& Loop = _idleLoops[pBranch];
+    bool Changed = Loop.head != PC;
+    for ( size_t Index = 0; !Changed && Index < Loop.code.size(); Index++ )
+    {
+        Changed = _busRead( static_cast<Word>(Loop.head + Index) ) != Loop.code[Index];
+    }
+    if ( Changed )
+    {
+        // Analysed again next time
+        _idleLoops.erase( pBranch );
+        Verdict = IdleUnknown;
+        _idleArmed = false;
+        return;
+    }
+    _skipIdleLoop( Loop );
 }
 
 /*****************************************************************************/
 
-void CCPU::_ora( Word pAddress )
-{
-    A |= _readByte( pAddress );
-    _setZeroAndNegativeFlags( A );
-};
-
-/*****************************************************************************/
-
-void CCPU::_eor( Word pAddress )
-{
-    A ^= _readByte( pAddress );
-    _setZeroAndNegativeFlags( A );
-};
-
-/*****************************************************************************/
-
-void CCPU::_branchIf( bool pTest, bool pExpected )
+void CCPU::_skipIdleLoop( const SIdleLoop& pLoop )
 {
-    SByte Offset = _fetchSByte();
-    if ( pTest == pExpected )
+    s64 Period = pLoop.cycles;
+    for ( const SBlockInstruction& Read : pLoop.reads )
     {
-        const Word PCOld = PC;
-        PC += Offset;
-        _cycles--;
-
-        const bool PageChanged = (PC >> 8) != (PCOld >> 8);
-        if ( PageChanged )
+        Word Address = Read.operand;
+        switch ( Read.mode )
         {
-            _cycles--;
+            case EAddrMode::ZeroPageX: Address = static_cast<Byte>(Read.operand + X); break;
+            case EAddrMode::ZeroPageY: Address = static_cast<Byte>(Read.operand + Y); break;
+            case EAddrMode::AbsoluteX: Address = static_cast<Word>(Read.operand + X); break;
+            case EAddrMode::AbsoluteY: Address = static_cast<Word>(Read.operand + Y); break;
+            default: break;
+        }
+        // I/O polled may change at any time, unless its chip says otherwise
+        if ( !bus.isStableRead( Address ) )
+        {
+            return;
+        }
+        if ( OpTable[Read.opcode].penalty == EPagePenalty::PageCross && ((Read.operand ^ Address) >> 8) )
+        {
+            Period++;
         }
     }
-};
-
-/*****************************************************************************/
-
-void CCPU::_ADC( Byte pOperand )
-{
-    ASSERT( Flags.D == false, "haven't handled decimal mode!" );
-    const bool AreSignBitsTheSame =
-        !((A ^ pOperand) & NegativeFlagBit);
-    Word Sum = static_cast<Word>(A);
-    Sum += pOperand;
-    Sum += Flags.C;
-    A = (Sum & 0xFF);
-    _setZeroAndNegativeFlags( A );
-    Flags.C = Sum > 0xFF;
-    Flags.V = AreSignBitsTheSame &&
-        ((A ^ pOperand) & NegativeFlagBit);
-};
-    
-/*****************************************************************************/
-
-void CCPU::_SBC( Byte pOperand )
-{
-    _ADC( ~pOperand );
-};
-
-/*****************************************************************************/
-
-void CCPU::_registerCompare( Byte pOperand, Byte pRegisterValue )
-{
-    Byte Temp = pRegisterValue - pOperand;
-    Flags.N = (Temp & NegativeFlagBit) > 0;
-    Flags.Z = pRegisterValue == pOperand;
-    Flags.C = pRegisterValue >= pOperand;
-};
-
-/*****************************************************************************/
-
-Byte CCPU::_ASL( Byte pOperand )
-{
-    Flags.C = (pOperand & NegativeFlagBit) > 0;
-    Byte Result = pOperand << 1;
-    _setZeroAndNegativeFlags( Result );
-    _cycles--;
-    return Result;
-};
-
-/*****************************************************************************/
-
-Byte CCPU::_LSR( Byte pOperand )
-{
-    Flags.C = (pOperand & ZeroBit) > 0;
-    Byte Result = pOperand >> 1;
-    _setZeroAndNegativeFlags( Result );
-    _cycles--;
-    return Result;
-};
-
-/*****************************************************************************/
-
-Byte CCPU::_ROL( Byte pOperand )
-{
-    Byte NewBit0 = Flags.C ? ZeroBit : 0;
-    Flags.C = (pOperand & NegativeFlagBit) > 0;
-    pOperand = pOperand << 1;
-    pOperand |= NewBit0;
-    _setZeroAndNegativeFlags( pOperand );
-    _cycles--;
-    return pOperand;
-};
-
-/*****************************************************************************/
-
-Byte CCPU::_ROR( Byte pOperand )
-{
-    bool OldBit0 = (pOperand & ZeroBit) > 0;
-    pOperand = pOperand >> 1;
-    if ( Flags.C )
+    // Whole iterations starting with cycles left, the last ones
+    // are run as usual
+    if ( _cycles <= Period )
     {
-        pOperand |= NegativeFlagBit;
+        return;
     }
-    _cycles--;
-    Flags.C = OldBit0;
-    _setZeroAndNegativeFlags( pOperand );
-    return pOperand;
-};
-
-/*****************************************************************************/
-
-void CCPU::_pushPSToStack()
-{
-    Byte PSStack = PS | BreakFlagBit | UnusedFlagBit;		
-    _pushByteOntoStack( PSStack );
-};
-
-/*****************************************************************************/
-
-void CCPU::_popPSFromStack()
-{
-    PS = _popByteFromStack();
-    Flags.B = false;
-    Flags.Unused = false;
-};
+    s64 Iterations = (_cycles - 1) / Period;
+    if ( pLoop.kind == EIdleKind::Count )
+    {
+        Byte& Counter = pLoop.counter == EIdleCounter::X ? X : Y;
+        if ( pLoop.exits )
+        {
+            // Counter is not zero, the branch has been taken
+            const s64 Left = pLoop.step < 0 ? Counter - 1 : 0xFF - Counter;
+            Iterations = std::min( Iterations, Left );
+        }
+        Counter = static_cast<Byte>(Counter + pLoop.step * (Iterations & 0xFF));
+        if ( pLoop.countSetsFlags )
+        {
+            _setZeroAndNegativeFlags( Counter );
+        }
+    }
+    _cycles -= Iterations * Period;
+    _idleSkippedCycles += Iterations * Period;
+}
 
-}
\ No newline at end of file
+}
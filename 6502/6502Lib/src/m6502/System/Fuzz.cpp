@@ -0,0 +1,196 @@
+/**
+ * @file Fuzz.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <m6502/System/Fuzz.hpp>
+#include <algorithm>
+
+namespace m6502
+{
+
+namespace
+{
+
+/**
+ * @brief First byte value which is not an instruction, run as a trap
+ * 
+ * @return Byte 
+ */
+Byte trapOpCode()
+{
+    Byte OpCode = 0;
+    while ( CCPU::OpTable[OpCode].legal )
+    {
+        OpCode++;
+    }
+    return OpCode;
+}
+
+}
+
+/*****************************************************************************/
+
+CFuzzHarness::CFuzzHarness( const SFuzzConfig& pConfig ) :
+    _config( pConfig ),
+    _cpu( _bus ),
+    _mem( _bus, 0x0000, 0x0000 ),
+    _boot( MAX_MEM ),
+    _runs( 0 )
+{
+    _cpu.setFaultStop( true );
+    _cpu.loadPrg( _config.program.data(), static_cast<u32>( _config.program.size() ) );
+    _cpu.PC = _config.resetVector;
+    if ( _config.bootCycles > 0 )
+    {
+        _cpu.execute( _config.bootCycles );
+    }
+    // Traps once booted, boot code may use BRK
+    const Byte Trap = trapOpCode();
+    _mem[_config.trapAddress] = Trap;
+    _mem[0xFFFE] = _config.trapAddress & 0xFF;
+    _mem[0xFFFF] = _config.trapAddress >> 8;
+    if ( _config.stopOnTarget )
+    {
+        _mem[_config.targetPC] = Trap;
+    }
+    _cpu.flushBlockCache();
+    const CMem& Mem = _mem;
+    for ( u32 Address = 0; Address < MAX_MEM; Address++ )
+    {
+        _boot[Address] = Mem[static_cast<Word>( Address )];
+    }
+    _bootPC = _cpu.PC;
+    _bootSP = _cpu.SP;
+    _bootA = _cpu.A;
+    _bootX = _cpu.X;
+    _bootY = _cpu.Y;
+    _bootPS = _cpu.PS;
+    _mem.setDirtyTracking( true );
+}
+
+/*****************************************************************************/
+
+SFuzzResult CFuzzHarness::run( const Byte* pInput, size_t pSize )
+{
+    _runs++;
+    _restore();
+    const size_t Size = std::min<size_t>( pSize, _config.inputSize );
+    for ( size_t Index = 0; Index < Size; Index++ )
+    {
+        _mem[static_cast<Word>( _config.inputAddress + Index )] = pInput[Index];
+    }
+    if ( _config.writeSize )
+    {
+        _mem[_config.sizeAddress] = static_cast<Byte>( Size );
+        _mem[static_cast<Word>( _config.sizeAddress + 1 )] = static_cast<Byte>( Size >> 8 );
+    }
+#if M6502_COVERAGE
+    _cpu.resetCoveragePrevious();
+#endif
+    SFuzzResult Result;
+    Result.cycles = _cpu.execute( _config.cycles );
+    Result.PC = _cpu.PC;
+    switch ( _cpu.getFault() )
+    {
+        case EFault::None:
+        {
+            Result.exit = EFuzzExit::Cycles;
+        } break;
+        case EFault::Illegal:
+        {
+            if ( _cpu.PC == _config.trapAddress )
+            {
+                Result.exit = EFuzzExit::Break;
+            }
+            else if ( _config.stopOnTarget && _cpu.PC == _config.targetPC )
+            {
+                Result.exit = EFuzzExit::Target;
+            }
+            else
+            {
+                Result.exit = EFuzzExit::Illegal;
+            }
+        } break;
+        case EFault::Decimal:
+        {
+            Result.exit = EFuzzExit::Decimal;
+        } break;
+        case EFault::StackOverflow:
+        {
+            Result.exit = EFuzzExit::StackOverflow;
+        } break;
+        default:
+        {
+            Result.exit = EFuzzExit::StackUnderflow;
+        } break;
+    }
+    return Result;
+}
+
+/*****************************************************************************/
+
+CCPU& CFuzzHarness::getCPU()
+{
+    return _cpu;
+}
+
+/*****************************************************************************/
+
+const CMem& CFuzzHarness::getMem() const
+{
+    return _mem;
+}
+
+/*****************************************************************************/
+
+u64 CFuzzHarness::getRuns() const
+{
+    return _runs;
+}
+
+/*****************************************************************************/
+
+void CFuzzHarness::_restore()
+{
+    bool Restored = false;
+    for ( u32 Page = 0; Page < 256; Page++ )
+    {
+        if ( !_mem.isDirty( static_cast<Byte>( Page ) ) ) continue;
+        std::copy( &_boot[Page << 8], &_boot[Page << 8] + 256, &_mem[static_cast<Word>( Page << 8 )] );
+        Restored = true;
+    }
+    _mem.clearDirty();
+    if ( Restored && _cpu.getEngine() == EEngine::Block )
+    {
+        // Pages restored without the bus may hold code
+        _cpu.flushBlockCache();
+    }
+    _cpu.PC = _bootPC;
+    _cpu.SP = _bootSP;
+    _cpu.A = _bootA;
+    _cpu.X = _bootX;
+    _cpu.Y = _bootY;
+    _cpu.PS = _bootPS;
+}
+
+}
@@ -0,0 +1,217 @@
+/**
+ * @file IdleLoop.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <m6502/System/IdleLoop.hpp>
+#include <m6502/System/Cpu.hpp>
+
+namespace m6502
+{
+
+namespace
+{
+
+/**
+ * @brief Registers and flags an instruction reads or writes
+ * 
+ */
+constexpr Byte
+    RegA = 0x01,
+    RegX = 0x02,
+    RegY = 0x04,
+    RegSP = 0x08,
+    FlagC = 0x10,
+    FlagZN = 0x20,
+    FlagV = 0x40;
+
+/**
+ * @brief Longest loop analysed, in bytes
+ * 
+ */
+constexpr Word MaxLoopBytes = 64;
+
+/**
+ * @brief Registers and flags used by an instruction allowed in an idle loop
+ *        Allowed instructions never write memory nor read flags
+ * 
+ * @param pIns 
+ * @param pReads 
+ * @param pWrites 
+ * @return false when the instruction is not allowed
+ */
+bool effectOf(Ins pIns, Byte& pReads, Byte& pWrites)
+{
+    pReads = 0;
+    pWrites = 0;
+    switch (pIns)
+    {
+        case Ins::LDA_IM: case Ins::LDA_ZP: case Ins::LDA_ZPX:
+        case Ins::LDA_ABS: case Ins::LDA_ABSX: case Ins::LDA_ABSY:
+            pWrites = RegA | FlagZN; return true;
+        case Ins::LDX_IM: case Ins::LDX_ZP: case Ins::LDX_ZPY:
+        case Ins::LDX_ABS: case Ins::LDX_ABSY:
+            pWrites = RegX | FlagZN; return true;
+        case Ins::LDY_IM: case Ins::LDY_ZP: case Ins::LDY_ZPX:
+        case Ins::LDY_ABS: case Ins::LDY_ABSX:
+            pWrites = RegY | FlagZN; return true;
+        case Ins::CMP: case Ins::CMP_ZP: case Ins::CMP_ZPX:
+        case Ins::CMP_ABS: case Ins::CMP_ABSX: case Ins::CMP_ABSY:
+            pReads = RegA; pWrites = FlagC | FlagZN; return true;
+        case Ins::CPX: case Ins::CPX_ZP: case Ins::CPX_ABS:
+            pReads = RegX; pWrites = FlagC | FlagZN; return true;
+        case Ins::CPY: case Ins::CPY_ZP: case Ins::CPY_ABS:
+            pReads = RegY; pWrites = FlagC | FlagZN; return true;
+        case Ins::BIT_ZP: case Ins::BIT_ABS:
+            pReads = RegA; pWrites = FlagZN | FlagV; return true;
+        case Ins::TAX: pReads = RegA; pWrites = RegX | FlagZN; return true;
+        case Ins::TAY: pReads = RegA; pWrites = RegY | FlagZN; return true;
+        case Ins::TXA: pReads = RegX; pWrites = RegA | FlagZN; return true;
+        case Ins::TYA: pReads = RegY; pWrites = RegA | FlagZN; return true;
+        case Ins::TSX: pReads = RegSP; pWrites = RegX | FlagZN; return true;
+        case Ins::TXS: pReads = RegX; pWrites = RegSP; return true;
+        case Ins::CLC: case Ins::SEC: pWrites = FlagC; return true;
+        case Ins::CLV: pWrites = FlagV; return true;
+        case Ins::NOP: return true;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Flag tested by a branch
+ * 
+ * @param pIns 
+ * @return Byte 0 when not a branch
+ */
+Byte flagOf(Ins pIns)
+{
+    switch (pIns)
+    {
+        case Ins::BEQ: case Ins::BNE: return FlagZN;
+        case Ins::BMI: case Ins::BPL: return FlagZN;
+        case Ins::BSC: case Ins::BCC: return FlagC;
+        case Ins::BVS: case Ins::BVC: return FlagV;
+        default: return 0;
+    }
+}
+
+}
+
+/*****************************************************************************/
+
+SIdleLoop analyseIdleLoop( CBus& pBus, const Word& pHead, const Word& pBranch )
+{
+    SIdleLoop Loop;
+    Loop.kind = EIdleKind::None;
+    Loop.head = pHead;
+    Loop.branch = pBranch;
+    Loop.counter = EIdleCounter::None;
+    Loop.step = 0;
+    Loop.exits = false;
+    Loop.countSetsFlags = false;
+    Loop.cycles = 0;
+    if (pBranch < pHead || pBranch - pHead > MaxLoopBytes) return Loop;
+
+    // The loop must be a single straight run ending with the jump back
+    const SBlock Block = CBlockCache::decode(pBus, pHead);
+    if (Block.instructions.empty()) return Loop;
+    const SBlockInstruction& Last = Block.instructions.back();
+    if (Last.address != pBranch) return Loop;
+    const Ins Jump = static_cast<Ins>(Last.opcode);
+    const Byte Tested = flagOf(Jump);
+    if (!Tested && !(Jump == Ins::JMP_ABS && Last.operand == pHead)) return Loop;
+
+    Byte CounterMask = 0;
+    for (size_t Index = 0; Index + 1 < Block.instructions.size(); Index++)
+    {
+        const Ins Instr = static_cast<Ins>(Block.instructions[Index].opcode);
+        if (Instr == Ins::INX || Instr == Ins::INY || Instr == Ins::DEX || Instr == Ins::DEY)
+        {
+            // A single counter only
+            if (CounterMask) return Loop;
+            const bool OnX = Instr == Ins::INX || Instr == Ins::DEX;
+            CounterMask = OnX ? RegX : RegY;
+            Loop.counter = OnX ? EIdleCounter::X : EIdleCounter::Y;
+            Loop.step = (Instr == Ins::INX || Instr == Ins::INY) ? 1 : -1;
+        }
+    }
+
+    // Registers read so far, a register written after being read in
+    // the same iteration would not keep the value of the first one
+    Byte Read = 0;
+    for (size_t Index = 0; Index + 1 < Block.instructions.size(); Index++)
+    {
+        const SBlockInstruction& Instruction = Block.instructions[Index];
+        const Ins Instr = static_cast<Ins>(Instruction.opcode);
+        if (Instr == Ins::INX || Instr == Ins::INY || Instr == Ins::DEX || Instr == Ins::DEY)
+        {
+            Loop.countSetsFlags = true;
+            continue;
+        }
+        Byte Reads = 0;
+        Byte Writes = 0;
+        if (!effectOf(Instr, Reads, Writes)) return Loop;
+        switch (Instruction.mode)
+        {
+            case EAddrMode::ZeroPageX: case EAddrMode::AbsoluteX:
+                Reads |= RegX; break;
+            case EAddrMode::ZeroPageY: case EAddrMode::AbsoluteY:
+                Reads |= RegY; break;
+            default:
+                break;
+        }
+        if ((Reads | Writes) & CounterMask) return Loop;
+        Read |= Reads;
+        if (Writes & Read) return Loop;
+        if (Writes & FlagZN)
+        {
+            Loop.countSetsFlags = false;
+        }
+        if (Instruction.mode != EAddrMode::Implied && Instruction.mode != EAddrMode::Immediate)
+        {
+            Loop.reads.push_back(Instruction);
+        }
+    }
+
+    if (Tested == FlagZN && Loop.countSetsFlags)
+    {
+        // Only BNE on the counter ends, when it reaches zero
+        if (Jump != Ins::BNE) return Loop;
+        Loop.exits = true;
+    }
+    // Any other tested flag keeps the value which made the branch taken
+
+    Loop.kind = CounterMask ? EIdleKind::Count : EIdleKind::Spin;
+    Loop.cycles = Block.cycles;
+    if (Tested)
+    {
+        const Word Next = pBranch + Last.size;
+        Loop.cycles += ((pHead >> 8) != (Next >> 8)) ? 2 : 1;
+    }
+    for (Word Address = pHead; Address != Block.end; Address++)
+    {
+        Loop.code.push_back(pBus.readBusData(Address));
+    }
+    return Loop;
+}
+
+}
@@ -0,0 +1,870 @@
+/**
+ * @file Lockstep.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+#include <m6502/System/Lockstep.hpp>
+#include <m6502/System/Cpu.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace m6502
+{
+
+namespace
+{
+
+/**
+ * @brief Mnemonics, the operation run by the lanes for each opcode
+ *        Opcodes are named after them in OpTable.inl
+ * 
+ */
+#define M6502_LOCKSTEP_OPERATIONS( X ) \
+    X(LDA) X(LDX) X(LDY) X(STA) X(STX) X(STY) \
+    X(TAX) X(TAY) X(TXA) X(TYA) X(TSX) X(TXS) \
+    X(PHA) X(PHP) X(PLA) X(PLP) \
+    X(AND) X(EOR) X(ORA) X(BIT) \
+    X(ADC) X(SBC) X(CMP) X(CPX) X(CPY) \
+    X(INC) X(INX) X(INY) X(DEC) X(DEX) X(DEY) \
+    X(ASL) X(LSR) X(ROL) X(ROR) \
+    X(JMP) X(JSR) X(RTS) X(BRK) X(RTI) \
+    X(BCC) X(BSC) X(BEQ) X(BMI) X(BNE) X(BPL) X(BVC) X(BVS) \
+    X(CLC) X(CLD) X(CLI) X(CLV) X(SEC) X(SED) X(SEI) \
+    X(NOP)
+
+#define M6502_LOCKSTEP_ENUM( Name ) Name,
+#define M6502_LOCKSTEP_NAME( Name ) #Name,
+
+enum class EOperation : Byte
+{
+    M6502_LOCKSTEP_OPERATIONS( M6502_LOCKSTEP_ENUM )
+    Illegal
+};
+
+constexpr const char* OperationNames[] =
+{
+    M6502_LOCKSTEP_OPERATIONS( M6502_LOCKSTEP_NAME )
+};
+
+#undef M6502_LOCKSTEP_ENUM
+#undef M6502_LOCKSTEP_NAME
+#undef M6502_LOCKSTEP_OPERATIONS
+
+/**
+ * @brief Operation of an opcode name, its mnemonic before '_'
+ * 
+ * @param pName 
+ * @return constexpr EOperation 
+ */
+constexpr EOperation operationOf( const char* pName )
+{
+    for ( u32 Index = 0; Index < std::size( OperationNames ); Index++ )
+    {
+        const char* Mnemonic = OperationNames[Index];
+        if ( pName[0] == Mnemonic[0] && pName[1] == Mnemonic[1] && pName[2] == Mnemonic[2] &&
+            ( pName[3] == '\0' || pName[3] == '_' ) )
+        {
+            return static_cast<EOperation>(Index);
+        }
+    }
+    return EOperation::Illegal;
+}
+
+/**
+ * @brief Operation of each opcode byte value
+ * 
+ * @return constexpr std::array<EOperation,256> 
+ */
+constexpr std::array<EOperation,256> buildOperations()
+{
+    std::array<EOperation,256> Table {};
+    for ( EOperation& Entry : Table )
+    {
+        Entry = EOperation::Illegal;
+    }
+#define M6502_OP( Name, Mode, Cycles, Penalty ) \
+    Table[opcode(Ins::Name)] = operationOf( #Name );
+#include <m6502/System/OpTable.inl>
+    return Table;
+}
+
+constexpr std::array<EOperation,256> Operations = buildOperations();
+
+static_assert( operationOf( "BSC" ) == EOperation::BSC, "Opcode names must give their operation" );
+static_assert( Operations[opcode(Ins::LDA_INDY)] == EOperation::LDA, "Opcode names must give their operation" );
+static_assert( Operations[opcode(Ins::ROR)] == EOperation::ROR, "Opcode names must give their operation" );
+
+/**
+ * @brief Value on a lane of the mask, old value elsewhere
+ *        Bitwise, so loops of it are vectorised even with SSE2
+ * 
+ * @param pMask 0xFF on the lanes of the mask, 0 elsewhere
+ * @param pValue 
+ * @param pOld 
+ * @return Byte 
+ */
+inline Byte select( Byte pMask, Byte pValue, Byte pOld )
+{
+    return ( pValue & pMask ) | ( pOld & ~pMask );
+}
+
+/**
+ * @brief Keep the value of the lanes of the mask, the target elsewhere
+ * 
+ * @tparam T 
+ * @tparam Lanes 
+ * @param pMask 0xFF on the lanes of the mask, 0 elsewhere
+ * @param pTarget 
+ * @param pValue 
+ */
+template<class T, size_t Lanes>
+inline void blend( const std::array<Byte,Lanes>& pMask, std::array<T,Lanes>& pTarget, const std::array<T,Lanes>& pValue )
+{
+    for ( size_t Lane = 0; Lane < Lanes; Lane++ )
+    {
+        // Mask widened to the size of T
+        const T Keep = static_cast<T>(static_cast<SByte>(pMask[Lane]));
+        pTarget[Lane] = static_cast<T>(( pValue[Lane] & Keep ) | ( pTarget[Lane] & ~Keep ));
+    }
+}
+
+/**
+ * @brief Set a flag of the lanes of the mask
+ * 
+ * @tparam Lanes 
+ * @param pMask 0xFF on the lanes of the mask, 0 elsewhere
+ * @param pFlag 
+ * @param pValue 0 or 1
+ */
+template<size_t Lanes>
+inline void blendFlag( const std::array<Byte,Lanes>& pMask, std::array<Byte,Lanes>& pFlag, Byte pValue )
+{
+    for ( size_t Lane = 0; Lane < Lanes; Lane++ )
+    {
+        pFlag[Lane] = select( pMask[Lane], pValue, pFlag[Lane] );
+    }
+}
+
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+CLockstepCPU<Lanes>::CLockstepCPU() : _leader(0), _memory(0x10000 * Lanes, 0), _stats{0, 0}
+{
+    reset( 0xFFFC );
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::reset( const Word& pResetVector )
+{
+    _pc.fill( pResetVector );
+    _sp.fill( 0xFF );
+    _a.fill( 0 );
+    _x.fill( 0 );
+    _y.fill( 0 );
+    for ( lanes_t<Byte>* Flag : { &_c, &_z, &_i, &_d, &_b, &_u, &_v, &_n } )
+    {
+        Flag->fill( 0 );
+    }
+    _cycles.fill( 0 );
+    _given.fill( 0 );
+    _faulted.fill( 0 );
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+Word CLockstepCPU<Lanes>::loadPrg( const Byte* pProgram, u32 pNumBytes )
+{
+    Word LoadAddress = 0;
+    if ( pProgram && pNumBytes > 2 )
+    {
+        LoadAddress = pProgram[0] | ( pProgram[1] << 8 );
+        for ( u32 At = 2; At < pNumBytes; At++ )
+        {
+            const Word Address = static_cast<Word>(LoadAddress + At - 2);
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                write( Lane, Address, pProgram[At] );
+            }
+        }
+        _pc.fill( LoadAddress );
+    }
+    return LoadAddress;
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::execute( s64 pCycles )
+{
+    _cycles.fill( 0 );
+    _given.fill( 0 );
+    // Slices fitting lane counters, lanes going past the end of
+    // a slice start the next one in debt
+    constexpr s64 MaxSlice = 0x40000000;
+    s64 Left = pCycles;
+    do
+    {
+        const s32 Slice = static_cast<s32>(std::min( Left, MaxSlice ));
+        for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+        {
+            if ( _faulted[Lane] ) continue;
+            _cycles[Lane] += Slice;
+            _given[Lane] += Slice;
+        }
+        _run();
+        Left -= Slice;
+    } while ( Left > 0 );
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_run()
+{
+    alignas(32) lanes_t<u32> Key;
+    while ( true )
+    {
+        // Lanes at the lowest PC run first, the others wait for them
+        // to catch up, as after a loop some lanes left earlier
+        u32 First = 0x1FFFF;
+        for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+        {
+            // Lanes out of cycles or faulted sort last
+            const u32 Stopped = ( _cycles[Lane] <= 0 ) | _faulted[Lane];
+            Key[Lane] = _pc[Lane] | ( Stopped << 16 );
+            First = std::min( First, Key[Lane] );
+        }
+        if ( First > 0xFFFF ) break;
+        const Word PC = static_cast<Word>(First);
+        _leader = 0;
+        while ( Key[_leader] != First )
+        {
+            _leader++;
+        }
+        const Byte OpCode = read( _leader, PC );
+        // Memory is per lane, so may be the code
+        const Byte* Row = &_memory[PC * Lanes];
+        for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+        {
+            _mask[Lane] = static_cast<Byte>(0 - ( ( Key[Lane] == First ) & ( Row[Lane] == OpCode ) ));
+        }
+        _dispatch( PC, OpCode );
+    }
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+s64 CLockstepCPU<Lanes>::getCycles( u32 pLane ) const
+{
+    return _given[pLane] - _cycles[pLane];
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+bool CLockstepCPU<Lanes>::isFaulted( u32 pLane ) const
+{
+    return _faulted[pLane] != 0;
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+SLaneRegisters CLockstepCPU<Lanes>::getRegisters( u32 pLane ) const
+{
+    alignas(32) lanes_t<Byte> PS;
+    _status( PS );
+    return { _pc[pLane], _sp[pLane], _a[pLane], _x[pLane], _y[pLane], PS[pLane] };
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::setRegisters( u32 pLane, const SLaneRegisters& pRegisters )
+{
+    _pc[pLane] = pRegisters.PC;
+    _sp[pLane] = pRegisters.SP;
+    _a[pLane] = pRegisters.A;
+    _x[pLane] = pRegisters.X;
+    _y[pLane] = pRegisters.Y;
+    alignas(32) lanes_t<Byte> Mask {};
+    alignas(32) lanes_t<Byte> PS {};
+    Mask[pLane] = 0xFF;
+    PS[pLane] = pRegisters.PS;
+    _setStatus( Mask, PS );
+    // Registers may have been fixed
+    _faulted[pLane] = 0;
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+const SLockstepStats& CLockstepCPU<Lanes>::getStats() const
+{
+    return _stats;
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+bool CLockstepCPU<Lanes>::_uniform( const lanes_t<Word>& pAddress ) const
+{
+    const Word Base = pAddress[_leader];
+    Byte Differ = 0;
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        Differ |= _mask[Lane] & ( pAddress[Lane] != Base );
+    }
+    return !Differ;
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_gather( const lanes_t<Word>& pAddress, lanes_t<Byte>& pValue ) const
+{
+    if ( _uniform( pAddress ) )
+    {
+        // Bytes of the lanes are next to each other
+        const Byte* Row = &_memory[pAddress[_leader] * Lanes];
+        for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+        {
+            pValue[Lane] = Row[Lane];
+        }
+        return;
+    }
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        pValue[Lane] = _memory[pAddress[Lane] * Lanes + Lane];
+    }
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_gatherWord( const lanes_t<Word>& pAddress, lanes_t<Word>& pValue ) const
+{
+    if ( _uniform( pAddress ) )
+    {
+        const Byte* Low = &_memory[pAddress[_leader] * Lanes];
+        const Byte* High = &_memory[static_cast<Word>(pAddress[_leader] + 1) * Lanes];
+        for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+        {
+            pValue[Lane] = Low[Lane] | ( High[Lane] << 8 );
+        }
+        return;
+    }
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        const Word High = static_cast<Word>(pAddress[Lane] + 1);
+        pValue[Lane] = _memory[pAddress[Lane] * Lanes + Lane] | ( _memory[High * Lanes + Lane] << 8 );
+    }
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_scatter( const lanes_t<Word>& pAddress, const lanes_t<Byte>& pValue )
+{
+    if ( _uniform( pAddress ) )
+    {
+        Byte* Row = &_memory[pAddress[_leader] * Lanes];
+        for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+        {
+            Row[Lane] = select( _mask[Lane], pValue[Lane], Row[Lane] );
+        }
+        return;
+    }
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        if ( _mask[Lane] )
+        {
+            _memory[pAddress[Lane] * Lanes + Lane] = pValue[Lane];
+        }
+    }
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_push( const lanes_t<Byte>& pValue )
+{
+    alignas(32) lanes_t<Word> Address;
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        Address[Lane] = 0x100 | _sp[Lane];
+        _sp[Lane] = static_cast<Byte>(_sp[Lane] - ( _mask[Lane] & 1 ));
+    }
+    _scatter( Address, pValue );
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_pop( lanes_t<Byte>& pValue )
+{
+    alignas(32) lanes_t<Word> Address;
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        _sp[Lane] = static_cast<Byte>(_sp[Lane] + ( _mask[Lane] & 1 ));
+        Address[Lane] = 0x100 | _sp[Lane];
+    }
+    _gather( Address, pValue );
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_setZeroAndNegativeFlags( const lanes_t<Byte>& pValue )
+{
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        _z[Lane] = select( _mask[Lane], pValue[Lane] == 0, _z[Lane] );
+        _n[Lane] = select( _mask[Lane], pValue[Lane] >> 7, _n[Lane] );
+    }
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_status( lanes_t<Byte>& pPS ) const
+{
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        pPS[Lane] = _c[Lane] | ( _z[Lane] << 1 ) | ( _i[Lane] << 2 ) | ( _d[Lane] << 3 ) |
+            ( _b[Lane] << 4 ) | ( _u[Lane] << 5 ) | ( _v[Lane] << 6 ) | ( _n[Lane] << 7 );
+    }
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_setStatus( const lanes_t<Byte>& pMask, const lanes_t<Byte>& pPS )
+{
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        const Byte PS = pPS[Lane];
+        const Byte Set = pMask[Lane];
+        _c[Lane] = select( Set, PS & 1, _c[Lane] );
+        _z[Lane] = select( Set, ( PS >> 1 ) & 1, _z[Lane] );
+        _i[Lane] = select( Set, ( PS >> 2 ) & 1, _i[Lane] );
+        _d[Lane] = select( Set, ( PS >> 3 ) & 1, _d[Lane] );
+        _b[Lane] = select( Set, ( PS >> 4 ) & 1, _b[Lane] );
+        _u[Lane] = select( Set, ( PS >> 5 ) & 1, _u[Lane] );
+        _v[Lane] = select( Set, ( PS >> 6 ) & 1, _v[Lane] );
+        _n[Lane] = select( Set, PS >> 7, _n[Lane] );
+    }
+}
+
+/*****************************************************************************/
+
+template<u32 Lanes>
+void CLockstepCPU<Lanes>::_dispatch( const Word& pPC, const Byte& pOpCode )
+{
+    const CCPU::SOpCode& Info = CCPU::OpTable[pOpCode];
+    const EOperation Operation = Operations[pOpCode];
+    _stats.dispatches++;
+    if ( Operation == EOperation::Illegal )
+    {
+        for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+        {
+            _faulted[Lane] |= _mask[Lane];
+        }
+        return;
+    }
+    if ( Operation == EOperation::ADC || Operation == EOperation::SBC )
+    {
+        // Decimal mode not handled
+        for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+        {
+            _faulted[Lane] |= _mask[Lane] & _d[Lane];
+            _mask[Lane] &= static_cast<Byte>(_d[Lane] - 1);
+        }
+    }
+    u32 Running = 0;
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        Running += _mask[Lane] & 1;
+    }
+    _stats.instructions += Running;
+
+    // Operand bytes, at the same address for every lane of the mask
+    alignas(32) lanes_t<Byte> Low;
+    alignas(32) lanes_t<Byte> High;
+    const Byte* LowRow = &_memory[static_cast<Word>(pPC + 1) * Lanes];
+    const Byte* HighRow = &_memory[static_cast<Word>(pPC + 2) * Lanes];
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        Low[Lane] = LowRow[Lane];
+        High[Lane] = HighRow[Lane];
+    }
+
+    // Effective address, with the quirks of CCPU addressing modes
+    alignas(32) lanes_t<Word> Address {};
+    alignas(32) lanes_t<Word> Pointer;
+    alignas(32) lanes_t<Byte> Crossed {};
+    switch ( Info.mode )
+    {
+        case EAddrMode::ZeroPage:
+        {
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Address[Lane] = Low[Lane];
+        } break;
+        case EAddrMode::ZeroPageX:
+        {
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Address[Lane] = static_cast<Byte>(Low[Lane] + _x[Lane]);
+        } break;
+        case EAddrMode::ZeroPageY:
+        {
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Address[Lane] = static_cast<Byte>(Low[Lane] + _y[Lane]);
+        } break;
+        case EAddrMode::Absolute:
+        {
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Address[Lane] = Low[Lane] | ( High[Lane] << 8 );
+        } break;
+        case EAddrMode::AbsoluteX:
+        case EAddrMode::AbsoluteY:
+        {
+            const lanes_t<Byte>& Index = Info.mode == EAddrMode::AbsoluteX ? _x : _y;
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                const Word Base = Low[Lane] | ( High[Lane] << 8 );
+                Address[Lane] = static_cast<Word>(Base + Index[Lane]);
+                Crossed[Lane] = ( ( Base ^ Address[Lane] ) >> 8 ) != 0;
+            }
+        } break;
+        case EAddrMode::Indirect:
+        {
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Pointer[Lane] = Low[Lane] | ( High[Lane] << 8 );
+            _gatherWord( Pointer, Address );
+        } break;
+        case EAddrMode::IndirectX:
+        {
+            // Stores index the address read, loads index the pointer
+            // without zero page wrap
+            const bool Store = Operation == EOperation::STA;
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Pointer[Lane] = Store ? Low[Lane] : Low[Lane] + _x[Lane];
+            _gatherWord( Pointer, Address );
+            if ( Store )
+            {
+                for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Address[Lane] = static_cast<Word>(Address[Lane] + _x[Lane]);
+            }
+        } break;
+        case EAddrMode::IndirectY:
+        {
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Pointer[Lane] = Low[Lane];
+            _gatherWord( Pointer, Address );
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                const Word Base = Address[Lane];
+                Address[Lane] = static_cast<Word>(Base + _y[Lane]);
+                Crossed[Lane] = ( ( Base ^ Address[Lane] ) >> 8 ) != 0;
+            }
+        } break;
+        default: break;
+    }
+    const Byte PageCross = Info.penalty == EPagePenalty::PageCross ? 1 : 0;
+    for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+    {
+        const s32 Keep = static_cast<SByte>(_mask[Lane]);
+        _cycles[Lane] -= ( Info.cycles + ( Crossed[Lane] & PageCross ) ) & Keep;
+    }
+
+    // Operand value, for the operations reading one
+    alignas(32) lanes_t<Byte> Value {};
+    switch ( Info.mode )
+    {
+        case EAddrMode::Immediate:
+        {
+            Value = Low;
+        } break;
+        case EAddrMode::Accumulator:
+        {
+            Value = _a;
+        } break;
+        case EAddrMode::Implied:
+        case EAddrMode::Relative:
+        case EAddrMode::Indirect:
+        {
+        } break;
+        default:
+        {
+            if ( Operation != EOperation::STA && Operation != EOperation::STX &&
+                 Operation != EOperation::STY && Operation != EOperation::JMP &&
+                 Operation != EOperation::JSR )
+            {
+                _gather( Address, Value );
+            }
+        } break;
+    }
+
+    alignas(32) lanes_t<Word> PC;
+    PC.fill( static_cast<Word>(pPC + instructionSize( Info.mode )) );
+    alignas(32) lanes_t<Byte> Result;
+    switch ( Operation )
+    {
+        case EOperation::LDA:
+        case EOperation::LDX:
+        case EOperation::LDY:
+        {
+            lanes_t<Byte>& Register = Operation == EOperation::LDA ? _a : Operation == EOperation::LDX ? _x : _y;
+            blend( _mask, Register, Value );
+            _setZeroAndNegativeFlags( Value );
+        } break;
+        case EOperation::STA: _scatter( Address, _a ); break;
+        case EOperation::STX: _scatter( Address, _x ); break;
+        case EOperation::STY: _scatter( Address, _y ); break;
+        case EOperation::TAX:
+        case EOperation::TAY:
+        case EOperation::TXA:
+        case EOperation::TYA:
+        case EOperation::TSX:
+        {
+            const lanes_t<Byte>& Source = Operation == EOperation::TAX || Operation == EOperation::TAY ? _a :
+                Operation == EOperation::TXA ? _x : Operation == EOperation::TYA ? _y : _sp;
+            lanes_t<Byte>& Target = Operation == EOperation::TAX || Operation == EOperation::TSX ? _x :
+                Operation == EOperation::TAY ? _y : _a;
+            Result = Source;
+            blend( _mask, Target, Result );
+            _setZeroAndNegativeFlags( Result );
+        } break;
+        case EOperation::TXS: blend( _mask, _sp, _x ); break;
+        case EOperation::PHA:
+        {
+            _push( _a );
+        } break;
+        case EOperation::PHP:
+        {
+            _status( Result );
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Result[Lane] |= 0x30;
+            _push( Result );
+        } break;
+        case EOperation::PLA:
+        {
+            _pop( Result );
+            blend( _mask, _a, Result );
+            _setZeroAndNegativeFlags( Result );
+        } break;
+        case EOperation::PLP:
+        {
+            // Break and unused bits are not restored
+            _pop( Result );
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Result[Lane] &= 0xCF;
+            _setStatus( _mask, Result );
+        } break;
+        case EOperation::AND:
+        case EOperation::EOR:
+        case EOperation::ORA:
+        {
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                Result[Lane] = Operation == EOperation::AND ? _a[Lane] & Value[Lane] :
+                    Operation == EOperation::EOR ? _a[Lane] ^ Value[Lane] : _a[Lane] | Value[Lane];
+            }
+            blend( _mask, _a, Result );
+            _setZeroAndNegativeFlags( Result );
+        } break;
+        case EOperation::BIT:
+        {
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                _z[Lane] = select( _mask[Lane], ( _a[Lane] & Value[Lane] ) == 0, _z[Lane] );
+                _n[Lane] = select( _mask[Lane], Value[Lane] >> 7, _n[Lane] );
+                _v[Lane] = select( _mask[Lane], ( Value[Lane] >> 6 ) & 1, _v[Lane] );
+            }
+        } break;
+        case EOperation::ADC:
+        case EOperation::SBC:
+        {
+            const Byte Invert = Operation == EOperation::SBC ? 0xFF : 0x00;
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                const Byte Operand = Value[Lane] ^ Invert;
+                const Word Sum = _a[Lane] + Operand + _c[Lane];
+                Result[Lane] = static_cast<Byte>(Sum);
+                const Byte Overflow = ( ~( _a[Lane] ^ Operand ) & ( Result[Lane] ^ Operand ) ) >> 7;
+                _c[Lane] = select( _mask[Lane], Sum > 0xFF, _c[Lane] );
+                _v[Lane] = select( _mask[Lane], Overflow, _v[Lane] );
+            }
+            blend( _mask, _a, Result );
+            _setZeroAndNegativeFlags( Result );
+        } break;
+        case EOperation::CMP:
+        case EOperation::CPX:
+        case EOperation::CPY:
+        {
+            const lanes_t<Byte>& Register = Operation == EOperation::CMP ? _a : Operation == EOperation::CPX ? _x : _y;
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                Result[Lane] = static_cast<Byte>(Register[Lane] - Value[Lane]);
+                _c[Lane] = select( _mask[Lane], Register[Lane] >= Value[Lane], _c[Lane] );
+            }
+            _setZeroAndNegativeFlags( Result );
+        } break;
+        case EOperation::INC:
+        case EOperation::DEC:
+        {
+            const Byte Step = Operation == EOperation::INC ? 1 : 0xFF;
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Result[Lane] = static_cast<Byte>(Value[Lane] + Step);
+            _scatter( Address, Result );
+            _setZeroAndNegativeFlags( Result );
+        } break;
+        case EOperation::INX:
+        case EOperation::INY:
+        case EOperation::DEX:
+        case EOperation::DEY:
+        {
+            lanes_t<Byte>& Register = Operation == EOperation::INX || Operation == EOperation::DEX ? _x : _y;
+            const Byte Step = Operation == EOperation::INX || Operation == EOperation::INY ? 1 : 0xFF;
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Result[Lane] = static_cast<Byte>(Register[Lane] + Step);
+            blend( _mask, Register, Result );
+            _setZeroAndNegativeFlags( Result );
+        } break;
+        case EOperation::ASL:
+        case EOperation::LSR:
+        case EOperation::ROL:
+        case EOperation::ROR:
+        {
+            // Bit shifted in, carry out
+            const Byte In = Operation == EOperation::ROL || Operation == EOperation::ROR ? 1 : 0;
+            if ( Operation == EOperation::ASL || Operation == EOperation::ROL )
+            {
+                for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+                {
+                    Result[Lane] = static_cast<Byte>(( Value[Lane] << 1 ) | ( _c[Lane] & In ));
+                    _c[Lane] = select( _mask[Lane], Value[Lane] >> 7, _c[Lane] );
+                }
+            }
+            else
+            {
+                for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+                {
+                    Result[Lane] = static_cast<Byte>(( Value[Lane] >> 1 ) | ( ( _c[Lane] & In ) << 7 ));
+                    _c[Lane] = select( _mask[Lane], Value[Lane] & 1, _c[Lane] );
+                }
+            }
+            if ( Info.mode == EAddrMode::Accumulator )
+            {
+                blend( _mask, _a, Result );
+            }
+            else
+            {
+                _scatter( Address, Result );
+            }
+            _setZeroAndNegativeFlags( Result );
+        } break;
+        case EOperation::JMP:
+        {
+            PC = Address;
+        } break;
+        case EOperation::JSR:
+        case EOperation::BRK:
+        {
+            // Return address pushed high byte first, JSR pushes the
+            // address of its last byte, BRK skips the byte after it
+            const Word Return = static_cast<Word>(pPC + 2);
+            Result.fill( Return >> 8 );
+            _push( Result );
+            Result.fill( Return & 0xFF );
+            _push( Result );
+            if ( Operation == EOperation::JSR )
+            {
+                PC = Address;
+                break;
+            }
+            _status( Result );
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Result[Lane] |= 0x30;
+            _push( Result );
+            Pointer.fill( 0xFFFE );
+            _gatherWord( Pointer, PC );
+            blendFlag( _mask, _b, 1 );
+            blendFlag( _mask, _i, 1 );
+        } break;
+        case EOperation::RTS:
+        case EOperation::RTI:
+        {
+            if ( Operation == EOperation::RTI )
+            {
+                _pop( Result );
+                for ( u32 Lane = 0; Lane < Lanes; Lane++ ) Result[Lane] &= 0xCF;
+                _setStatus( _mask, Result );
+            }
+            // Word above the stack pointer, without wrap in page 1
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                Pointer[Lane] = ( 0x100 | _sp[Lane] ) + 1;
+                _sp[Lane] = static_cast<Byte>(_sp[Lane] + ( _mask[Lane] & 2 ));
+            }
+            _gatherWord( Pointer, PC );
+            if ( Operation == EOperation::RTS )
+            {
+                for ( u32 Lane = 0; Lane < Lanes; Lane++ ) PC[Lane] = static_cast<Word>(PC[Lane] + 1);
+            }
+        } break;
+        case EOperation::BCC:
+        case EOperation::BSC:
+        case EOperation::BEQ:
+        case EOperation::BMI:
+        case EOperation::BNE:
+        case EOperation::BPL:
+        case EOperation::BVC:
+        case EOperation::BVS:
+        {
+            const lanes_t<Byte>& Flag = Operation == EOperation::BCC || Operation == EOperation::BSC ? _c :
+                Operation == EOperation::BEQ || Operation == EOperation::BNE ? _z :
+                Operation == EOperation::BMI || Operation == EOperation::BPL ? _n : _v;
+            const Byte Expected = Operation == EOperation::BSC || Operation == EOperation::BEQ ||
+                Operation == EOperation::BMI || Operation == EOperation::BVS ? 1 : 0;
+            const Word Next = PC[0];
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                const Word Target = static_cast<Word>(Next + static_cast<SByte>(Low[Lane]));
+                const Byte Taken = _mask[Lane] & ( Flag[Lane] == Expected );
+                const Byte Crossing = ( Target >> 8 ) != ( Next >> 8 );
+                PC[Lane] = Taken ? Target : Next;
+                _cycles[Lane] -= Taken + ( Taken & Crossing );
+            }
+        } break;
+        case EOperation::CLC: blendFlag( _mask, _c, 0 ); break;
+        case EOperation::CLD: blendFlag( _mask, _d, 0 ); break;
+        case EOperation::CLI: blendFlag( _mask, _i, 0 ); break;
+        case EOperation::CLV: blendFlag( _mask, _v, 0 ); break;
+        case EOperation::SEC: blendFlag( _mask, _c, 1 ); break;
+        case EOperation::SED: blendFlag( _mask, _d, 1 ); break;
+        case EOperation::SEI: blendFlag( _mask, _i, 1 ); break;
+        default: break;
+    }
+    blend( _mask, _pc, PC );
+}
+
+/*****************************************************************************/
+
+template class CLockstepCPU<8>;
+template class CLockstepCPU<16>;
+template class CLockstepCPU<32>;
+
+}
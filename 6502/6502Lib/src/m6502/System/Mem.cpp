@@ -27,17 +27,56 @@
 namespace m6502
 {
 
+namespace
+{
+
+/**
+ * @brief Bytes of the delta header : magic, version and page count
+ * 
+ */
+constexpr size_t DeltaHeaderSize = 4 + 2 + 2;
+
+/**
+ * @brief Bytes of a page in a delta : its number then its bytes
+ * 
+ */
+constexpr size_t DeltaPageSize = 1 + 256;
+
+/**
+ * @brief Read a little endian value of a delta
+ * 
+ * @param pDelta 
+ * @param pBytes 
+ * @return u32 
+ */
+u32 deltaValue( const Byte* pDelta, u32 pBytes )
+{
+    u32 Value = 0;
+    for (u32 Index = 0; Index < pBytes; Index++)
+    {
+        Value |= static_cast<u32>(pDelta[Index]) << (Index * 8);
+    }
+    return Value;
+}
+
+}
+
 /*****************************************************************************/
 
-CMem::CMem (CBus& pBus, const Word& pMask, const Word& pBank) : CBusChip(pBus,pMask,pBank)
+CMem::CMem (CBus& pBus, const Word& pMask, const Word& pBank) : CBusChip(pBus,pMask,pBank),
+    _tracking(false)
 {
     initialise();
+    // Bus connected the chip before _data existed, map it now
+    _remap();
 }
 
 /*****************************************************************************/
 
-CMem::CMem (const CMem& pCopy) : CBusChip(pCopy), _data(pCopy._data)
+CMem::CMem (const CMem& pCopy) : CBusChip(pCopy), _data(pCopy._data), _dirty(pCopy._dirty),
+    _tracking(pCopy._tracking)
 {
+    _remap();
 }
 
 /*****************************************************************************/
@@ -49,6 +88,11 @@ CMem::~CMem() {}
 void CMem::initialise ()
 {
     _data.fill(0x00);
+    _dirty.fill(~u64(0));
+    if (_tracking)
+    {
+        _remap();
+    }
 }
 
 /*****************************************************************************/
@@ -63,18 +107,192 @@ Byte CMem::operator[]( const Word& pAddress) const
 
 Byte& CMem::operator[]( const Word& pAddress)
 {
+    _markDirty(static_cast<Byte>(pAddress >> 8));
     // assert here Address is < MAX_MEM
     return _data[pAddress];
 }
 
+/*****************************************************************************/
+
 Byte CMem::onReadBusData (const Word& pAddress)
 {
     return _data[pAddress];
 }
 
+/*****************************************************************************/
+
 void CMem::onWriteBusData (const Word& pAddress, const Byte& pData)
 {
    _data[pAddress]=pData;
+   if (_tracking && !isDirty(static_cast<Byte>(pAddress >> 8)))
+   {
+       // Dirty pages are written directly
+       _markDirty(static_cast<Byte>(pAddress >> 8));
+       _remapPage(pAddress & 0xFF00);
+   }
+}
+
+/*****************************************************************************/
+
+const Byte* CMem::onMapReadPage (const Word& pOffset)
+{
+    return &_data[pOffset];
+}
+
+/*****************************************************************************/
+
+Byte* CMem::onMapWritePage (const Word& pOffset)
+{
+    // First write on a clean page marks it
+    if (_tracking && !isDirty(static_cast<Byte>(pOffset >> 8))) return nullptr;
+    return &_data[pOffset];
+}
+
+/*****************************************************************************/
+
+u32 CMem::onStateSize () const
+{
+    return MAX_MEM;
+}
+
+/*****************************************************************************/
+
+void CMem::onSaveState (Byte* pState) const
+{
+    std::copy(_data.begin(), _data.end(), pState);
+}
+
+/*****************************************************************************/
+
+void CMem::onLoadState (const Byte* pState)
+{
+    for (u32 Page = 0; Page < 256; Page++, pState += 256)
+    {
+        Byte* Data = &_data[Page << 8];
+        if (std::equal(Data, Data + 256, pState)) continue;
+        std::copy(pState, pState + 256, Data);
+        const bool Clean = !isDirty(static_cast<Byte>(Page));
+        _markDirty(static_cast<Byte>(Page));
+        if (_tracking && Clean)
+        {
+            _remapPage(static_cast<Word>(Page << 8));
+        }
+    }
 }
 
-}
\ No newline at end of file
+/*****************************************************************************/
+
+void CMem::setDirtyTracking (bool pEnabled)
+{
+    _tracking = pEnabled;
+    _dirty.fill(0);
+    _remap();
+}
+
+/*****************************************************************************/
+
+bool CMem::getDirtyTracking () const
+{
+    return _tracking;
+}
+
+/*****************************************************************************/
+
+bool CMem::isDirty (const Byte& pPage) const
+{
+    return (_dirty[pPage >> 6] >> (pPage & 63)) & 1;
+}
+
+/*****************************************************************************/
+
+u32 CMem::getDirtyPages () const
+{
+    u32 Pages = 0;
+    for (u32 Page = 0; Page < 256; Page++)
+    {
+        Pages += isDirty(static_cast<Byte>(Page));
+    }
+    return Pages;
+}
+
+/*****************************************************************************/
+
+void CMem::delta (std::vector<Byte>& pDelta)
+{
+    const u32 Pages = getDirtyPages();
+    pDelta.resize(DeltaHeaderSize + Pages * DeltaPageSize);
+    Byte* Delta = _saveState(pDelta.data(), DeltaMagic);
+    Delta = _saveState(Delta, DeltaVersion);
+    Delta = _saveState(Delta, static_cast<Word>(Pages));
+    for (u32 Page = 0; Page < 256; Page++)
+    {
+        if (!isDirty(static_cast<Byte>(Page))) continue;
+        *Delta++ = static_cast<Byte>(Page);
+        Delta = std::copy(&_data[Page << 8], &_data[Page << 8] + 256, Delta);
+    }
+    clearDirty();
+}
+
+/*****************************************************************************/
+
+void CMem::clearDirty ()
+{
+    for (u32 Page = 0; Page < 256; Page++)
+    {
+        if (!isDirty(static_cast<Byte>(Page))) continue;
+        _dirty[Page >> 6] &= ~(u64(1) << (Page & 63));
+        if (_tracking)
+        {
+            // Clean again, the next write goes through the chip
+            _remapPage(static_cast<Word>(Page << 8));
+        }
+    }
+}
+
+/*****************************************************************************/
+
+bool CMem::applyDelta (const Byte* pDelta, size_t pSize)
+{
+    if (!_isValidDelta(pDelta, pSize)) return false;
+    const u32 Pages = deltaValue(pDelta + 6, 2);
+    const Byte* Delta = pDelta + DeltaHeaderSize;
+    for (u32 Index = 0; Index < Pages; Index++, Delta += DeltaPageSize)
+    {
+        const Byte Page = Delta[0];
+        std::copy(Delta + 1, Delta + DeltaPageSize, &_data[Page << 8]);
+        const bool Clean = !isDirty(Page);
+        _markDirty(Page);
+        if (_tracking && Clean)
+        {
+            _remapPage(static_cast<Word>(Page << 8));
+        }
+    }
+    return true;
+}
+
+/*****************************************************************************/
+
+bool CMem::applyDeltas (const std::vector<std::vector<Byte>>& pChain)
+{
+    for (const std::vector<Byte>& Delta : pChain)
+    {
+        if (!_isValidDelta(Delta.data(), Delta.size())) return false;
+    }
+    for (const std::vector<Byte>& Delta : pChain)
+    {
+        applyDelta(Delta.data(), Delta.size());
+    }
+    return true;
+}
+
+/*****************************************************************************/
+
+bool CMem::_isValidDelta (const Byte* pDelta, size_t pSize)
+{
+    if (pSize < DeltaHeaderSize) return false;
+    if (deltaValue(pDelta, 4) != DeltaMagic || deltaValue(pDelta + 4, 2) != DeltaVersion) return false;
+    const u32 Pages = deltaValue(pDelta + 6, 2);
+    return Pages <= 256 && pSize == DeltaHeaderSize + Pages * DeltaPageSize;
+}
+
+}
@@ -33,7 +33,7 @@ CRegisters::CRegisters ()
 {
     PC = 0xFFFC;
     SP = 0xFF;
-    Flags.C = Flags.Z = Flags.I = Flags.D = Flags.B = Flags.V = Flags.N = 0;
+    Flags.C = Flags.Z = Flags.I = Flags.D = Flags.B = Flags.Unused = Flags.V = Flags.N = 0;
     A = X = Y = 0;
 }
 
@@ -0,0 +1,182 @@
+/**
+ * @file Rom.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+
+#include <m6502/System/Rom.hpp>
+#include <map>
+#include <mutex>
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace m6502
+{
+
+namespace
+{
+
+/**
+ * @brief Images of the process by file path, kept while a ROM holds them
+ * 
+ */
+std::mutex ImagesMutex;
+std::map<std::string, std::weak_ptr<const CRomImage>> Images;
+
+}
+
+/*****************************************************************************/
+
+std::shared_ptr<const CRomImage> CRomImage::open( const std::string& pPath )
+{
+    std::lock_guard<std::mutex> Lock( ImagesMutex );
+    // Images no ROM holds anymore are dropped, failed opens never enter
+    for ( auto It = Images.begin(); It != Images.end(); )
+    {
+        It = It->second.expired() ? Images.erase( It ) : std::next( It );
+    }
+    const auto Found = Images.find( pPath );
+    if ( Found != Images.end() )
+    {
+        std::shared_ptr<const CRomImage> Shared = Found->second.lock();
+        if ( Shared ) return Shared;
+    }
+
+    std::shared_ptr<CRomImage> Image( new CRomImage() );
+#if defined(_WIN32)
+    std::ifstream File( pPath, std::ios::binary );
+    if ( !File ) return nullptr;
+    Image->_copy.assign( std::istreambuf_iterator<char>( File ), std::istreambuf_iterator<char>() );
+    Image->_data = Image->_copy.data();
+    Image->_size = Image->_copy.size();
+#else
+    const int File = ::open( pPath.c_str(), O_RDONLY );
+    if ( File < 0 ) return nullptr;
+    struct stat Stat;
+    if ( fstat( File, &Stat ) == 0 && Stat.st_size > 0 )
+    {
+        void* Mapped = mmap( nullptr, static_cast<size_t>( Stat.st_size ), PROT_READ, MAP_PRIVATE, File, 0 );
+        if ( Mapped != MAP_FAILED )
+        {
+            Image->_data = static_cast<const Byte*>( Mapped );
+            Image->_size = static_cast<size_t>( Stat.st_size );
+        }
+    }
+    // The mapping stays once the file is closed
+    close( File );
+#endif
+    if ( Image->_size == 0 ) return nullptr;
+    Images[pPath] = Image;
+    return Image;
+}
+
+/*****************************************************************************/
+
+size_t CRomImage::getShared()
+{
+    std::lock_guard<std::mutex> Lock( ImagesMutex );
+    return Images.size();
+}
+
+/*****************************************************************************/
+
+CRomImage::~CRomImage()
+{
+#if !defined(_WIN32)
+    if ( _data && _copy.empty() )
+    {
+        munmap( const_cast<Byte*>( _data ), _size );
+    }
+#endif
+}
+
+/*****************************************************************************/
+
+CRom::CRom( CBus& pBus, const Word& pMask, const Word& pBank ) : CBusChip(pBus,pMask,pBank),
+    _ignoredWrites(0)
+{
+}
+
+/*****************************************************************************/
+
+CRom::CRom( CBus& pBus, const Word& pMask, const Word& pBank, std::shared_ptr<const CRomImage> pImage ) :
+    CBusChip(pBus,pMask,pBank), _ignoredWrites(0)
+{
+    load( std::move( pImage ) );
+}
+
+/*****************************************************************************/
+
+bool CRom::load( const std::string& pPath )
+{
+    std::shared_ptr<const CRomImage> Image = CRomImage::open( pPath );
+    if ( !Image ) return false;
+    load( std::move( Image ) );
+    return true;
+}
+
+/*****************************************************************************/
+
+void CRom::load( std::shared_ptr<const CRomImage> pImage )
+{
+    _image = std::move( pImage );
+    _remap();
+}
+
+/*****************************************************************************/
+
+Byte CRom::operator[]( const Word& pOffset ) const
+{
+    if ( !_image || pOffset >= _image->getSize() ) return 0xFF;
+    return _image->getData()[pOffset];
+}
+
+/*****************************************************************************/
+
+void CRom::onWriteBusData( const Word&, const Byte& )
+{
+    _ignoredWrites++;
+}
+
+/*****************************************************************************/
+
+Byte CRom::onReadBusData( const Word& pAddress )
+{
+    return (*this)[pAddress];
+}
+
+/*****************************************************************************/
+
+const Byte* CRom::onMapReadPage( const Word& pOffset )
+{
+    if ( !_image || static_cast<size_t>( pOffset ) + 256 > _image->getSize() ) return nullptr;
+    return _image->getData() + pOffset;
+}
+
+}
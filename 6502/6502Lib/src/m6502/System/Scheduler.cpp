@@ -0,0 +1,89 @@
+/**
+ * @file Scheduler.cpp
+ * @author Gianni Peschiutta
+ * @brief M6502Lib - Motorola 6502 CPU Emulator
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2023
+ * Based on davepoo work: https://github.com/davepoo/6502Emulator
+ *
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *    This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ *    You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>
+ */
+
+
+#include <m6502/System/Scheduler.hpp>
+#include <algorithm>
+
+namespace m6502
+{
+
+/*****************************************************************************/
+
+CScheduler::CScheduler() : _now(0), _nextId(0)
+{
+}
+
+/*****************************************************************************/
+
+u64 CScheduler::schedule( u64 pCycle, EventCallback pCallback )
+{
+    const u64 Id = _nextId++;
+    _callbacks.emplace( Id, std::move( pCallback ) );
+    _heap.push_back( { pCycle, Id } );
+    std::push_heap( _heap.begin(), _heap.end() );
+    return Id;
+}
+
+/*****************************************************************************/
+
+bool CScheduler::cancel( u64 pId )
+{
+    if ( _callbacks.erase( pId ) == 0 ) return false;
+    _dropCancelled();
+    return true;
+}
+
+/*****************************************************************************/
+
+void CScheduler::advance( u64 pCycles )
+{
+    _now += pCycles;
+    while ( !_heap.empty() && _heap.front().cycle <= _now )
+    {
+        const SEvent Event = _heap.front();
+        std::pop_heap( _heap.begin(), _heap.end() );
+        _heap.pop_back();
+        auto Callback = _callbacks.find( Event.id );
+        if ( Callback == _callbacks.end() ) continue;
+        // Out of the table first, the callback may schedule again
+        const EventCallback Fire = std::move( Callback->second );
+        _callbacks.erase( Callback );
+        Fire( Event.cycle );
+    }
+    _dropCancelled();
+}
+
+/*****************************************************************************/
+
+void CScheduler::_dropCancelled()
+{
+    while ( !_heap.empty() && _callbacks.find( _heap.front().id ) == _callbacks.end() )
+    {
+        std::pop_heap( _heap.begin(), _heap.end() );
+        _heap.pop_back();
+    }
+}
+
+}
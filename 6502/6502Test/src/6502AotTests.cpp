@@ -0,0 +1,214 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+#include <m6502/System/Aot.hpp>
+#include <vector>
+
+/* data/AotTest.prg, translated by M6502Aot at build time
+
+    * = $0300
+
+start   ldx #$FF
+        txs
+        lda #$F0
+        sta $20
+        lda #$04
+        sta $21
+        lda #$00
+        sta $24
+        lda #$06
+        sta $25
+loop    ldy #$00
+fill    tya
+        clc
+        adc $22
+        sta ($20),y
+        eor #$5A
+        sta $0480,y
+        lda $04F0,y
+        sbc #$11
+        sta $05C0,x
+        iny
+        cpy #$20
+        bne fill
+        ldx #$08
+shifts  asl $30
+        rol a
+        ror $31,x
+        lsr a
+        bit $30
+        bvc nov
+        inc $32
+nov     bmi neg
+        dec $33
+neg     dex
+        bpl shifts
+        php
+        pla
+        sta $34
+        lda #$C3
+        pha
+        plp
+        cmp ($20,x)
+        lda ($20),y
+        sta ($24,x)
+        jsr sub
+        inc $22
+        lda $22
+        and #$01
+        beq even
+        lda #<hidden
+        sta $40
+        lda #>hidden
+        sta $41
+        jmp ($0040)
+even    lda #<loop
+        sta $40
+        lda #>loop
+        sta $41
+        jmp ($0040)
+sub     pha
+        tsx
+        stx $36
+        ldx #$03
+subl    lda $0400,x
+        adc $0401,x
+        sta $0500,x
+        dex
+        bne subl
+        pla
+        rts
+hidden  inc $35
+        ldx $35
+        cpx #$80
+        bcc back
+        ldx #$00
+        stx $35
+back    jmp loop
+*/
+extern const m6502::SAotImage AotTestProgram;
+
+class M6502AotTests : public testing::Test
+{
+public:
+    M6502AotTests() :
+        cpu(bus), mem(bus,0x0000,0x0000),
+        refCpu(refBus), refMem(refBus,0x0000,0x0000),
+        program(cpu, bus, AotTestProgram) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+    m6502::CBus refBus;
+    m6502::CCPU refCpu;
+    m6502::CMem refMem;
+    m6502::CAotProgram program;
+
+    virtual void SetUp()
+    {
+        using namespace m6502;
+        mem.initialise();
+        refMem.initialise();
+        cpu.reset( 0xFFFC );
+        refCpu.reset( 0xFFFC );
+        std::vector<Byte> Prg = { static_cast<Byte>(AotTestProgram.loadAddress & 0xFF),
+                                  static_cast<Byte>(AotTestProgram.loadAddress >> 8) };
+        Prg.insert( Prg.end(), AotTestProgram.data, AotTestProgram.data + AotTestProgram.size );
+        cpu.loadPrg( Prg.data(), static_cast<u32>(Prg.size()) );
+        refCpu.loadPrg( Prg.data(), static_cast<u32>(Prg.size()) );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    bool HasBlock( m6502::Word pAddress ) const
+    {
+        for ( m6502::u32 Index = 0; Index < AotTestProgram.blockCount; Index++ )
+        {
+            if ( AotTestProgram.blocks[Index].address == pAddress ) return true;
+        }
+        return false;
+    }
+};
+
+TEST_F( M6502AotTests, BlocksAreRecoveredFromTheLoadAddress )
+{
+    // given:
+    using namespace m6502;
+
+    // when:
+    const Word LoadAddress = AotTestProgram.loadAddress;
+
+    // then:
+    EXPECT_EQ( LoadAddress, 0x0300 );
+    EXPECT_TRUE( HasBlock( 0x0300 ) );
+    // Branch targets and fall through, JSR target and return
+    EXPECT_TRUE( HasBlock( 0x0315 ) );
+    EXPECT_TRUE( HasBlock( 0x032F ) );
+    EXPECT_TRUE( HasBlock( 0x0371 ) );
+    EXPECT_TRUE( HasBlock( 0x0353 ) );
+    // Code after PLP, left to the interpreter
+    EXPECT_TRUE( HasBlock( 0x034A ) );
+    // Reached by JMP (ind) only
+    EXPECT_FALSE( HasBlock( 0x0385 ) );
+}
+
+TEST_F( M6502AotTests, RunsLikeTheInterpreter )
+{
+    // given:
+    using namespace m6502;
+
+    // when:
+    for ( int Slice = 0; Slice < 5000; Slice++ )
+    {
+        const s64 Cycles = 1 + (Slice * 13) % 97;
+        ASSERT_EQ( program.execute( Cycles ), refCpu.execute( Cycles ) ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.PC, refCpu.PC ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.A, refCpu.A ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.X, refCpu.X ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.Y, refCpu.Y ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.SP, refCpu.SP ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.PS, refCpu.PS ) << "Slice " << Slice;
+    }
+
+    // then:
+    for ( u32 Address = 0; Address < 0x10000; Address++ )
+    {
+        ASSERT_EQ( mem[Address], refMem[Address] ) << "Address " << Address;
+    }
+    EXPECT_GT( program.getStats().translatedRuns, 0u );
+    // PLP and the JMP (ind) target
+    EXPECT_GT( program.getStats().interpretedInstructions, 0u );
+}
+
+TEST_F( M6502AotTests, ModifiedProgramDoesNotMatch )
+{
+    // given:
+    using namespace m6502;
+    EXPECT_TRUE( program.matchesMemory() );
+
+    // when:
+    mem[0x0310] = 0xEA;
+
+    // then:
+    EXPECT_FALSE( program.matchesMemory() );
+}
+
+TEST_F( M6502AotTests, FaultOutOfTheProgramStopsTheRun )
+{
+    // given:
+    using namespace m6502;
+    // NOP / illegal
+    mem[0x2000] = 0xEA;
+    mem[0x2001] = 0x02;
+    cpu.PC = 0x2000;
+    cpu.setFaultStop( true );
+
+    // when:
+    const s64 CyclesUsed = program.execute( 1000 );
+
+    // then:
+    EXPECT_EQ( cpu.getStop(), EStop::Fault );
+    EXPECT_EQ( cpu.getFault(), EFault::Illegal );
+    EXPECT_EQ( cpu.PC, 0x2001 );
+    EXPECT_LT( CyclesUsed, 10 );
+}
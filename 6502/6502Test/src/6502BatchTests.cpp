@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502BatchTests : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    // Program loaded at $0200, started there
+    m6502::SBatchSystem System( const std::vector<m6502::Byte>& pCode, m6502::s64 pCycles )
+    {
+        m6502::SBatchSystem Result;
+        Result.program.reserve( pCode.size() + 2 );
+        Result.program.push_back( 0x00 );
+        Result.program.push_back( 0x02 );
+        Result.program.insert( Result.program.end(), pCode.begin(), pCode.end() );
+        Result.resetVector = 0x0200;
+        Result.cycles = pCycles;
+        Result.stop = m6502::EBatchStop::Budget;
+        Result.stopAddress = 0;
+        Result.resultAddress = 0x0000;
+        Result.resultSize = m6502::MAX_MEM;
+        return Result;
+    }
+
+    void ExpectSame( const m6502::SBatchResult& pResult, const m6502::SBatchResult& pExpected )
+    {
+        EXPECT_EQ( pResult.status, pExpected.status );
+        EXPECT_EQ( pResult.cycles, pExpected.cycles );
+        EXPECT_EQ( pResult.PC, pExpected.PC );
+        EXPECT_EQ( pResult.SP, pExpected.SP );
+        EXPECT_EQ( pResult.A, pExpected.A );
+        EXPECT_EQ( pResult.X, pExpected.X );
+        EXPECT_EQ( pResult.Y, pExpected.Y );
+        EXPECT_EQ( pResult.PS, pExpected.PS );
+        EXPECT_TRUE( pResult.memory == pExpected.memory );
+    }
+};
+
+/* Table fill, indirect copy, shifts, calls and short loops,
+   the program of M6502Bench without its load address */
+static const std::vector<m6502::Byte> MixedCode = {
+    0xA9, 0x00, 0x85, 0x20, 0x85, 0x22, 0xA9, 0x04, 0x85, 0x21, 0xA9, 0x06,
+    0x85, 0x23, 0xA2, 0x00, 0x8A, 0x18, 0x69, 0x03, 0x9D, 0x00, 0x04, 0x45,
+    0x10, 0x29, 0x7F, 0x05, 0x11, 0x9D, 0x00, 0x05, 0xE8, 0xD0, 0xED, 0xA0,
+    0x3F, 0xB1, 0x20, 0x0A, 0x26, 0x30, 0xC9, 0x40, 0x90, 0x02, 0xE9, 0x40,
+    0x91, 0x22, 0x88, 0x10, 0xF0, 0xA2, 0x10, 0x20, 0x42, 0x02, 0xCA, 0xD0,
+    0xFA, 0xE6, 0x12, 0x4C, 0x0E, 0x02, 0x48, 0x8A, 0x48, 0x46, 0x31, 0xBD,
+    0x00, 0x05, 0xA0, 0x04, 0x88, 0xD0, 0xFD, 0x68, 0xAA, 0x68, 0x60 };
+
+TEST_F( M6502BatchTests, ResultsAreTheOnesOfCCPU )
+{
+    // given:
+    using namespace m6502;
+    std::vector<SBatchSystem> Systems;
+    for ( s64 Index = 0; Index < 8; Index++ )
+    {
+        Systems.push_back( System( MixedCode, 1000 + Index * 3571 ) );
+    }
+    CBatchRunner Runner( 3 );
+
+    // when:
+    const std::vector<SBatchResult> Results = Runner.run( Systems );
+
+    // then:
+    ASSERT_EQ( Results.size(), Systems.size() );
+    for ( size_t Index = 0; Index < Systems.size(); Index++ )
+    {
+        CBus Bus;
+        CMem Mem( Bus, 0x0000, 0x0000 );
+        CCPU CPU( Bus );
+        CPU.loadPrg( Systems[Index].program.data(), static_cast<u32>( Systems[Index].program.size() ) );
+        const s64 Cycles = CPU.execute( Systems[Index].cycles );
+        EXPECT_EQ( Results[Index].status, EBatchStatus::Budget );
+        EXPECT_EQ( Results[Index].cycles, Cycles );
+        EXPECT_EQ( Results[Index].PC, CPU.PC );
+        EXPECT_EQ( Results[Index].A, CPU.A );
+        EXPECT_EQ( Results[Index].X, CPU.X );
+        EXPECT_EQ( Results[Index].Y, CPU.Y );
+        EXPECT_EQ( Results[Index].SP, CPU.SP );
+        EXPECT_EQ( Results[Index].PS, CPU.PS );
+        for ( u32 Address = 0; Address < MAX_MEM; Address++ )
+        {
+            ASSERT_EQ( Results[Index].memory[Address], Mem[static_cast<Word>( Address )] ) << "Address " << Address;
+        }
+    }
+}
+
+TEST_F( M6502BatchTests, ResultsDoNotDependOnThreads )
+{
+    // given:
+    using namespace m6502;
+    std::vector<SBatchSystem> Systems;
+    for ( s64 Index = 0; Index < 100; Index++ )
+    {
+        // Uneven budgets, threads steal from each other
+        Systems.push_back( System( MixedCode, 100 + (Index * 7919) % 20011 ) );
+        Systems.back().resultAddress = 0x0400;
+        Systems.back().resultSize = 0x0200;
+    }
+    CBatchRunner Serial( 1 );
+    CBatchRunner Parallel( 4 );
+
+    // when:
+    const std::vector<SBatchResult> Expected = Serial.run( Systems );
+    const std::vector<SBatchResult> Results = Parallel.run( Systems );
+
+    // then:
+    ASSERT_EQ( Results.size(), Expected.size() );
+    for ( size_t Index = 0; Index < Results.size(); Index++ )
+    {
+        ExpectSame( Results[Index], Expected[Index] );
+    }
+    EXPECT_EQ( Parallel.getStats().threads, 4u );
+    EXPECT_EQ( Results[0].memory.size(), 0x200u );
+}
+
+TEST_F( M6502BatchTests, StopsWhenPCReachesTheStopAddress )
+{
+    // given:
+    using namespace m6502;
+    // LDX #0 / loop: INX / CPX #$10 / BNE loop / done: LDA #$FF
+    SBatchSystem Counter = System( { 0xA2, 0x00, 0xE8, 0xE0, 0x10, 0xD0, 0xFB, 0xA9, 0xFF }, 100000 );
+    Counter.stop = EBatchStop::Address;
+    Counter.stopAddress = 0x0207;
+
+    // when:
+    const SBatchResult Result = CBatchRunner::runSystem( Counter );
+
+    // then:
+    EXPECT_EQ( Result.status, EBatchStatus::Address );
+    EXPECT_EQ( Result.PC, 0x0207 );
+    EXPECT_EQ( Result.X, 0x10 );
+    EXPECT_EQ( Result.A, 0x00 );
+    // 2 + 15 * (2 + 2 + 3) + (2 + 2 + 2)
+    EXPECT_EQ( Result.cycles, 113 );
+}
+
+TEST_F( M6502BatchTests, TrapStopsOnAJumpToItself )
+{
+    // given:
+    using namespace m6502;
+    // LDA #$05 / STA $10 / trap: JMP trap
+    SBatchSystem Trap = System( { 0xA9, 0x05, 0x85, 0x10, 0x4C, 0x04, 0x02 }, 100000 );
+    Trap.stop = EBatchStop::Trap;
+
+    // when:
+    const SBatchResult Result = CBatchRunner::runSystem( Trap );
+
+    // then:
+    EXPECT_EQ( Result.status, EBatchStatus::Trap );
+    EXPECT_EQ( Result.PC, 0x0204 );
+    EXPECT_EQ( Result.memory[0x10], 0x05 );
+    EXPECT_EQ( Result.cycles, 8 );
+}
+
+TEST_F( M6502BatchTests, IllegalOpcodeEndsTheSystemOnly )
+{
+    // given:
+    using namespace m6502;
+    std::vector<SBatchSystem> Systems;
+    // LDA #$01 / illegal
+    Systems.push_back( System( { 0xA9, 0x01, 0x02 }, 1000 ) );
+    Systems.push_back( System( MixedCode, 1000 ) );
+    CBatchRunner Runner( 2 );
+
+    // when:
+    const std::vector<SBatchResult> Results = Runner.run( Systems );
+
+    // then:
+    EXPECT_EQ( Results[0].status, EBatchStatus::Illegal );
+    EXPECT_EQ( Results[0].A, 0x01 );
+    EXPECT_EQ( Results[1].status, EBatchStatus::Budget );
+    ExpectSame( Results[1], CBatchRunner::runSystem( Systems[1] ) );
+}
+
+TEST_F( M6502BatchTests, EmptyBatchGivesNoResult )
+{
+    // given:
+    using namespace m6502;
+    CBatchRunner Runner;
+
+    // when:
+    const std::vector<SBatchResult> Results = Runner.run( {} );
+
+    // then:
+    EXPECT_TRUE( Results.empty() );
+    EXPECT_GE( Runner.getThreads(), 1u );
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502BlockCacheTests : public testing::Test
+{
+public:
+    M6502BlockCacheTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        cpu.reset( 0x1000 );
+        cpu.setEngine( m6502::EEngine::Block );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void LoadCountingLoop()
+    {
+        using namespace m6502;
+        // LDX #0 / loop: INX / CPX #$10 / BNE loop / JMP *
+        const Byte Code[] = { 0xA2, 0x00, 0xE8, 0xE0, 0x10, 0xD0, 0xFB,
+            0x4C, 0x07, 0x10 };
+        for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+        {
+            mem[0x1000 + Index] = Code[Index];
+        }
+    }
+};
+
+TEST_F( M6502BlockCacheTests, DecodeStopsAtTheFirstBranch )
+{
+    // given:
+    using namespace m6502;
+    LoadCountingLoop();
+
+    // when:
+    const SBlock Block = CBlockCache::decode( bus, 0x1000 );
+
+    // then:
+    ASSERT_EQ( Block.instructions.size(), 4u );
+    EXPECT_EQ( Block.start, 0x1000 );
+    EXPECT_EQ( Block.end, 0x1007 );
+    EXPECT_EQ( Block.cycles, 8 );
+    EXPECT_EQ( Block.maxCycles, 10 );
+    EXPECT_EQ( Block.instructions[2].opcode, opcode(Ins::CPX) );
+    EXPECT_EQ( Block.instructions[2].mode, EAddrMode::Immediate );
+    EXPECT_EQ( Block.instructions[2].operand, 0x10 );
+    EXPECT_EQ( Block.instructions[3].address, 0x1005 );
+}
+
+TEST_F( M6502BlockCacheTests, LoopRunsFromDecodedBlocks )
+{
+    // given:
+    using namespace m6502;
+    LoadCountingLoop();
+    constexpr s64 EXPECTED_CYCLES = 2 + 16 * 6 + 15;
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( EXPECTED_CYCLES );
+
+    // then:
+    EXPECT_EQ( CyclesUsed, EXPECTED_CYCLES );
+    EXPECT_EQ( cpu.X, 0x10 );
+    EXPECT_EQ( cpu.PC, 0x1007 );
+    const SBlockCacheStats& Stats = cpu.getBlockCacheStats();
+    EXPECT_EQ( Stats.misses, 2u );
+    EXPECT_EQ( Stats.hits, 14u );
+    EXPECT_EQ( Stats.invalidations, 0u );
+    EXPECT_GT( Stats.hitRate(), 0.8 );
+}
+
+TEST_F( M6502BlockCacheTests, SelfModifyingCodeRunsTheNewInstruction )
+{
+    // given:
+    using namespace m6502;
+    // LDA #LDY_IM / STA $1005 / LDX #$07 becoming LDY #$07 / JMP *
+    const Byte Code[] = { 0xA9, opcode(Ins::LDY_IM), 0x8D, 0x05, 0x10,
+        0xA2, 0x07, 0x4C, 0x07, 0x10 };
+    for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+    {
+        mem[0x1000 + Index] = Code[Index];
+    }
+    constexpr s64 EXPECTED_CYCLES = 2 + 4 + 2;
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( EXPECTED_CYCLES );
+
+    // then:
+    EXPECT_EQ( CyclesUsed, EXPECTED_CYCLES );
+    EXPECT_EQ( cpu.X, 0x00 );
+    EXPECT_EQ( cpu.Y, 0x07 );
+    EXPECT_EQ( cpu.getBlockCacheStats().invalidations, 1u );
+}
+
+TEST_F( M6502BlockCacheTests, OnlyCodePagesAreWatched )
+{
+    // given:
+    using namespace m6502;
+    // loop: STA $2000 / JMP loop
+    const Byte Code[] = { 0x8D, 0x00, 0x20, 0x4C, 0x00, 0x10 };
+    for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+    {
+        mem[0x1000 + Index] = Code[Index];
+    }
+    cpu.A = 0x55;
+
+    // when:
+    cpu.execute( 70 );
+
+    // then:
+    EXPECT_EQ( mem[0x2000], 0x55 );
+    EXPECT_EQ( cpu.getBlockCacheStats().invalidations, 0u );
+    EXPECT_EQ( bus.getWritePage( 0x1000 ), nullptr );
+    EXPECT_NE( bus.getWritePage( 0x2000 ), nullptr );
+}
+
+TEST_F( M6502BlockCacheTests, ResetDropsTheBlocks )
+{
+    // given:
+    using namespace m6502;
+    LoadCountingLoop();
+    cpu.execute( 10 );
+
+    // when:
+    cpu.reset( 0x1000 );
+    const Byte* CodePage = bus.getWritePage( 0x1000 );
+    mem[0x1001] = 0x05;
+    cpu.execute( 2 );
+
+    // then:
+    EXPECT_NE( CodePage, nullptr );
+    EXPECT_EQ( cpu.X, 0x05 );
+}
+
+/**
+ * @brief Chip serving code from its registers, counting the reads
+ *
+ */
+class CCodeChip : public m6502::CBusChip
+{
+public:
+    CCodeChip( m6502::CBus& pBus, const std::vector<m6502::Byte>& pCode ) :
+        CBusChip( pBus, 0xFF00, 0xC000 ), code(pCode), reads(0) {}
+
+    std::vector<m6502::Byte> code;
+    int reads;
+
+protected:
+    void onWriteBusData( const m6502::Word&, const m6502::Byte& ) override {}
+
+    m6502::Byte onReadBusData( const m6502::Word& pAddress ) override
+    {
+        reads++;
+        return pAddress < code.size() ? code[pAddress] : 0;
+    }
+};
+
+TEST_F( M6502BlockCacheTests, ChipCodeIsNotDecoded )
+{
+    // given:
+    using namespace m6502;
+    CBus Bus;
+    // LDX #0 / loop: INX / JMP loop
+    CCodeChip Chip( Bus, { 0xA2, 0x00, 0xE8, 0x4C, 0x02, 0xC0 } );
+
+    // when:
+    const SBlock Block = CBlockCache::decode( Bus, 0xC000 );
+
+    // then:
+    EXPECT_TRUE( Block.instructions.empty() );
+    EXPECT_EQ( Chip.reads, 0 );
+}
+
+TEST_F( M6502BlockCacheTests, ChipCodeIsReadOncePerFetch )
+{
+    // given:
+    using namespace m6502;
+    // LDX #0 / loop: INX / JMP loop
+    const std::vector<Byte> Code = { 0xA2, 0x00, 0xE8, 0x4C, 0x02, 0xC0 };
+    int Reads[2] = { 0, 0 };
+    Byte X[2] = { 0, 0 };
+
+    // when:
+    for ( int Index = 0; Index < 2; Index++ )
+    {
+        CBus Bus;
+        CCodeChip Chip( Bus, Code );
+        CMem Mem( Bus, 0x0000, 0x0000 );
+        CCPU CPU( Bus );
+        Mem.initialise();
+        CPU.reset( 0xC000 );
+        CPU.setEngine( Index ? EEngine::Block : EEngine::Switch );
+        CPU.execute( 2 + 10 * (2 + 3) );
+        Reads[Index] = Chip.reads;
+        X[Index] = CPU.X;
+    }
+
+    // then:
+    EXPECT_EQ( X[1], 10 );
+    EXPECT_EQ( X[1], X[0] );
+    EXPECT_EQ( Reads[1], Reads[0] );
+}
+
+TEST_F( M6502BlockCacheTests, IllegalOpcodeInChipIsNotReadBack )
+{
+    // given:
+    using namespace m6502;
+    CBus Bus;
+    // NOP / illegal
+    CCodeChip Chip( Bus, { 0xEA, 0x02 } );
+    CMem Mem( Bus, 0x0000, 0x0000 );
+    CCPU CPU( Bus );
+    Mem.initialise();
+    CPU.reset( 0xC000 );
+    CPU.setEngine( EEngine::Block );
+    CPU.setFaultStop( true );
+
+    // when:
+    CPU.execute( 10 );
+
+    // then:
+    EXPECT_EQ( CPU.getFault(), EFault::Illegal );
+    EXPECT_EQ( CPU.PC, 0xC001 );
+    EXPECT_EQ( Chip.reads, 2 );
+}
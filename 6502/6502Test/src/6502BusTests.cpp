@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+#include <memory>
+
+/**
+ * Chip answering its own register value and recording the last write
+ */
+class CTestChip : public m6502::CBusChip
+{
+public:
+    CTestChip(m6502::CBus& pBus, m6502::Word pMask, m6502::Word pBank, m6502::Byte pValue) :
+        CBusChip(pBus, pMask, pBank), Value(pValue) {}
+
+    m6502::Byte Value;
+    m6502::Word LastWriteAddress = 0;
+    m6502::Byte LastWriteData = 0;
+    int Writes = 0;
+
+protected:
+    void onWriteBusData(const m6502::Word& pAddress, const m6502::Byte& pData) override
+    {
+        LastWriteAddress = pAddress;
+        LastWriteData = pData;
+        Writes++;
+    }
+
+    m6502::Byte onReadBusData(const m6502::Word&) override
+    {
+        return Value;
+    }
+};
+
+class M6502BusTests : public testing::Test
+{
+public:
+    m6502::CBus bus;
+
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F( M6502BusTests, ReadWithoutChipReturnsZero )
+{
+    // given:
+    using namespace m6502;
+
+    // when:
+    const Byte Data = bus.readBusData( 0x1234 );
+
+    // then:
+    EXPECT_EQ( Data, 0x00 );
+}
+
+TEST_F( M6502BusTests, ChipsAreDecodedOnTheirBankOnly )
+{
+    // given:
+    using namespace m6502;
+    CTestChip Low( bus, 0xC000, 0x0000, 0x11 );
+    CTestChip High( bus, 0xC000, 0xC000, 0x22 );
+
+    // when:
+    bus.writeBusData( 0xC123, 0x42 );
+
+    // then:
+    EXPECT_EQ( bus.readBusData( 0x3FFF ), 0x11 );
+    EXPECT_EQ( bus.readBusData( 0x4000 ), 0x00 );
+    EXPECT_EQ( bus.readBusData( 0xC000 ), 0x22 );
+    EXPECT_EQ( High.LastWriteAddress, 0x0123 );
+    EXPECT_EQ( High.LastWriteData, 0x42 );
+    EXPECT_EQ( Low.Writes, 0 );
+}
+
+TEST_F( M6502BusTests, FirstConnectedChipAnswersReadsAndAllChipsReceiveWrites )
+{
+    // given:
+    using namespace m6502;
+    CTestChip First( bus, 0x0000, 0x0000, 0x11 );
+    CTestChip Second( bus, 0x8000, 0x8000, 0x22 );
+
+    // when:
+    bus.writeBusData( 0x8001, 0x42 );
+
+    // then:
+    EXPECT_EQ( bus.readBusData( 0x8001 ), 0x11 );
+    EXPECT_EQ( First.LastWriteAddress, 0x8001 );
+    EXPECT_EQ( Second.LastWriteAddress, 0x0001 );
+    EXPECT_EQ( First.Writes, 1 );
+    EXPECT_EQ( Second.Writes, 1 );
+}
+
+TEST_F( M6502BusTests, ChipSmallerThanAPageIsDecodedOnItsAddressesOnly )
+{
+    // given:
+    using namespace m6502;
+    CTestChip Io( bus, 0xFFF0, 0xD010, 0x33 );
+    CTestChip Ram( bus, 0x0000, 0x0000, 0x11 );
+
+    // when:
+    bus.writeBusData( 0xD012, 0x42 );
+    bus.writeBusData( 0xD020, 0x43 );
+
+    // then:
+    EXPECT_EQ( bus.readBusData( 0xD00F ), 0x11 );
+    EXPECT_EQ( bus.readBusData( 0xD010 ), 0x33 );
+    EXPECT_EQ( bus.readBusData( 0xD01F ), 0x33 );
+    EXPECT_EQ( bus.readBusData( 0xD020 ), 0x11 );
+    EXPECT_EQ( Io.LastWriteAddress, 0x0002 );
+    EXPECT_EQ( Io.Writes, 1 );
+    EXPECT_EQ( Ram.Writes, 2 );
+}
+
+TEST_F( M6502BusTests, PagesAreDecodedAgainWhenChipsConnectAndDisconnect )
+{
+    // given:
+    using namespace m6502;
+    CTestChip Ram( bus, 0x0000, 0x0000, 0x11 );
+    EXPECT_EQ( bus.readBusData( 0x2000 ), 0x11 );
+    std::unique_ptr<CTestChip> Shadow( new CTestChip( bus, 0xF000, 0x2000, 0x22 ) );
+
+    // when:
+    bus.writeBusData( 0x2000, 0x42 );
+    const Byte WithShadow = bus.readBusData( 0x2000 );
+    Shadow.reset();
+    bus.writeBusData( 0x2000, 0x43 );
+
+    // then:
+    EXPECT_EQ( WithShadow, 0x11 );
+    EXPECT_EQ( Ram.Writes, 2 );
+    EXPECT_EQ( Ram.LastWriteData, 0x43 );
+    EXPECT_EQ( bus.readBusData( 0x2000 ), 0x11 );
+}
+
+TEST_F( M6502BusTests, CopiedChipKeepsItsBank )
+{
+    // given:
+    using namespace m6502;
+    CMem Mem( bus, 0xC000, 0x4000 );
+    Mem[0x0010] = 0x42;
+
+    // when:
+    CMem Copy( Mem );
+
+    // then:
+    EXPECT_EQ( bus.readBusData( 0x4010 ), 0x42 );
+    EXPECT_EQ( bus.readBusData( 0xC010 ), 0x00 );
+}
+
+TEST_F( M6502BusTests, MemoryPagesAreMappedForDirectAccess )
+{
+    // given:
+    using namespace m6502;
+    CMem Mem( bus, 0x8000, 0x0000 );
+    CTestChip Io( bus, 0xFF00, 0xD000, 0x33 );
+
+    // when:
+    Mem[0x1234] = 0x42;
+
+    // then:
+    ASSERT_NE( bus.getReadPage( 0x1234 ), nullptr );
+    ASSERT_NE( bus.getWritePage( 0x1234 ), nullptr );
+    EXPECT_EQ( bus.getReadPage( 0x1234 )[0x34], 0x42 );
+    EXPECT_EQ( bus.getReadPage( 0xD000 ), nullptr );
+    EXPECT_EQ( bus.getWritePage( 0xD000 ), nullptr );
+    EXPECT_EQ( bus.getReadPage( 0x8000 ), nullptr );
+}
+
+TEST_F( M6502BusTests, CPUReachesMemoryDirectlyAndChipsThroughTheBus )
+{
+    // given:
+    using namespace m6502;
+    // I/O connected first answers reads on its page before memory
+    CTestChip Io( bus, 0xFF00, 0xD000, 0x33 );
+    CMem Mem( bus, 0x0000, 0x0000 );
+    CCPU cpu( bus );
+    cpu.reset( 0x0200 );
+    Mem[0x0200] = opcode(Ins::LDA_ABS);
+    Mem[0x0201] = 0x05;
+    Mem[0x0202] = 0xD0;
+    Mem[0x0203] = opcode(Ins::STA_ABS);
+    Mem[0x0204] = 0x10;
+    Mem[0x0205] = 0xD0;
+    Mem[0x0206] = opcode(Ins::STA_ZP);
+    Mem[0x0207] = 0x80;
+
+    // when:
+    const s64 ActualCycles = cpu.execute( 11 );
+
+    // then:
+    EXPECT_EQ( ActualCycles, 11 );
+    EXPECT_EQ( cpu.A, 0x33 );
+    EXPECT_EQ( Io.LastWriteAddress, 0x0010 );
+    EXPECT_EQ( Io.LastWriteData, 0x33 );
+    EXPECT_EQ( Mem[0x0080], 0x33 );
+    EXPECT_EQ( bus.getReadPage( 0xD010 ), nullptr );
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+#include <numeric>
+#include <vector>
+
+class M6502CoverageTests : public testing::Test
+{
+public:
+    M6502CoverageTests() : cpu(bus), mem(bus,0x0000,0x0000),
+        map(m6502::CCPU::CoverageMapSize, 0) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+    std::vector<m6502::Byte> map;
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        cpu.reset( 0x1000 );
+        cpu.setCoverageMap( map.data() );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void Load( m6502::Word pAddress, const std::vector<m6502::Byte>& pCode )
+    {
+        for ( m6502::Word Index = 0; Index < pCode.size(); Index++ )
+        {
+            mem[pAddress + Index] = pCode[Index];
+        }
+    }
+
+    static m6502::Word Location( m6502::Word pPC )
+    {
+        return static_cast<m6502::Word>( (pPC >> 4) ^ (pPC << 8) );
+    }
+
+    m6502::u32 Hits() const
+    {
+        return std::accumulate( map.begin(), map.end(), 0u );
+    }
+};
+
+TEST_F( M6502CoverageTests, TakenBranchesCountTheirEdges )
+{
+    // given:
+    using namespace m6502;
+    // LDX #4 / loop: DEX / BNE loop / JMP *
+    Load( 0x1000, { 0xA2, 0x04, 0xCA, 0xD0, 0xFD, 0x4C, 0x05, 0x10 } );
+    constexpr s64 CYCLES = 2 + 3 * (2 + 3) + 2 + 2;
+
+    // when:
+    cpu.execute( CYCLES );
+
+    // then:
+    const Word Loop = Location( 0x1002 );
+    EXPECT_EQ( map[Loop], 1 );
+    EXPECT_EQ( map[Loop ^ (Loop >> 1)], 2 );
+    EXPECT_EQ( Hits(), 3u );
+}
+
+TEST_F( M6502CoverageTests, CallsReturnsAndInterruptsAreCounted )
+{
+    // given:
+    using namespace m6502;
+    // JSR $2345 / BRK / pad / JMP *   $2345: RTS   $3456: RTI
+    Load( 0x1000, { 0x20, 0x45, 0x23, 0x00, 0x00, 0x4C, 0x05, 0x10 } );
+    Load( 0x2345, { 0x60 } );
+    Load( 0x3456, { 0x40 } );
+    Load( 0xFFFE, { 0x56, 0x34 } );
+    constexpr s64 CYCLES = 6 + 6 + 7 + 6;
+
+    // when:
+    cpu.execute( CYCLES );
+
+    // then:
+    EXPECT_EQ( cpu.PC, 0x1005 );
+    const Word Sub = Location( 0x2345 );
+    const Word Back = Location( 0x1003 );
+    const Word Handler = Location( 0x3456 );
+    EXPECT_EQ( map[Sub], 1 );
+    EXPECT_EQ( map[Back ^ (Sub >> 1)], 1 );
+    EXPECT_EQ( map[Handler ^ (Back >> 1)], 1 );
+    EXPECT_EQ( map[Location( 0x1005 ) ^ (Handler >> 1)], 1 );
+    EXPECT_EQ( Hits(), 4u );
+}
+
+TEST_F( M6502CoverageTests, EnginesCountTheSameEdges )
+{
+    // given:
+    using namespace m6502;
+    // LDY #3 / outer: LDX #5 / inner: DEX / BNE inner / JSR $2000 / DEY / BNE outer / JMP *
+    Load( 0x1000, { 0xA0, 0x03, 0xA2, 0x05, 0xCA, 0xD0, 0xFD, 0x20, 0x00, 0x20,
+        0x88, 0xD0, 0xF5, 0x4C, 0x0D, 0x10 } );
+    Load( 0x2000, { 0x60 } );
+    cpu.execute( 500 );
+    const std::vector<Byte> Expected = map;
+
+    for ( EEngine Engine : { EEngine::Switch, EEngine::Table, EEngine::Threaded, EEngine::Block } )
+    {
+        // when:
+        std::fill( map.begin(), map.end(), 0 );
+        cpu.reset( 0x1000 );
+        cpu.setEngine( Engine );
+        cpu.resetCoveragePrevious();
+        cpu.execute( 500 );
+
+        // then:
+        EXPECT_EQ( map, Expected );
+    }
+}
+
+TEST_F( M6502CoverageTests, NoMapCountsNothing )
+{
+    // given:
+    using namespace m6502;
+    // loop: JMP loop
+    Load( 0x1000, { 0x4C, 0x00, 0x10 } );
+    cpu.execute( 30 );
+    EXPECT_EQ( Hits(), 10u );
+
+    // when:
+    cpu.setCoverageMap( nullptr );
+    cpu.execute( 30 );
+
+    // then:
+    EXPECT_EQ( Hits(), 10u );
+}
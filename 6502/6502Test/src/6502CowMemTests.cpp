@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+#include <memory>
+#include <thread>
+
+class M6502CowMemTests : public testing::Test
+{
+public:
+    M6502CowMemTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CCowMem mem;
+
+    /**
+     * @brief System forked from the one of the fixture
+     *
+     */
+    struct SFork
+    {
+        SFork( m6502::CCowMem& pParent, const m6502::CCPU& pCPU ) : cpu(bus), mem(bus, pParent)
+        {
+            cpu.PC = pCPU.PC;
+            cpu.SP = pCPU.SP;
+            cpu.A = pCPU.A;
+            cpu.X = pCPU.X;
+            cpu.Y = pCPU.Y;
+            cpu.PS = pCPU.PS;
+        }
+        m6502::CBus bus;
+        m6502::CCPU cpu;
+        m6502::CCowMem mem;
+    };
+
+    virtual void SetUp()
+    {
+        cpu.reset( 0x1000 );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void LoadFillLoop()
+    {
+        using namespace m6502;
+        // LDX #0 / loop: TXA / STA $2000,X / INX / BNE loop / JMP *
+        const Byte Code[] = { 0xA2, 0x00, 0x8A, 0x9D, 0x00, 0x20, 0xE8,
+            0xD0, 0xF9, 0x4C, 0x09, 0x10 };
+        for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+        {
+            mem[0x1000 + Index] = Code[Index];
+        }
+    }
+};
+
+TEST_F( M6502CowMemTests, NewMemorySharesOneZeroPage )
+{
+    // given:
+    using namespace m6502;
+
+    // when:
+    const CCowMem& Mem = mem;
+
+    // then:
+    EXPECT_EQ( Mem[0x0000], 0 );
+    EXPECT_EQ( Mem[0xFFFF], 0 );
+    EXPECT_EQ( mem.getPrivatePages(), 0u );
+    EXPECT_LT( mem.getPrivateBytes(), 4096u );
+}
+
+TEST_F( M6502CowMemTests, CPURunsOnItLikeOnCMem )
+{
+    // given:
+    using namespace m6502;
+    LoadFillLoop();
+    CBus Bus;
+    CCPU CPU( Bus );
+    CMem Mem( Bus, 0x0000, 0x0000 );
+    CPU.reset( 0x1000 );
+    for ( Word Index = 0; Index < 12; Index++ )
+    {
+        Mem[0x1000 + Index] = mem[0x1000 + Index];
+    }
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( 5000 );
+    const s64 ExpectedCycles = CPU.execute( 5000 );
+
+    // then:
+    EXPECT_EQ( CyclesUsed, ExpectedCycles );
+    EXPECT_EQ( cpu.PC, CPU.PC );
+    EXPECT_EQ( cpu.X, CPU.X );
+    const CCowMem& CowMem = mem;
+    for ( u32 Address = 0; Address < MAX_MEM; Address++ )
+    {
+        ASSERT_EQ( CowMem[static_cast<Word>(Address)], Mem[static_cast<Word>(Address)] );
+    }
+    EXPECT_EQ( mem.getPrivatePages(), 2u );
+}
+
+TEST_F( M6502CowMemTests, ForkCopiesOnlyThePagesItWrites )
+{
+    // given:
+    using namespace m6502;
+    LoadFillLoop();
+    mem[0x20F0] = 0x55;
+    mem[0x3000] = 0x66;
+    cpu.execute( 5 );
+
+    // when:
+    SFork Fork( mem, cpu );
+    Fork.cpu.execute( 5000 );
+
+    // then:
+    const CCowMem& Parent = mem;
+    const CCowMem& Child = Fork.mem;
+    EXPECT_EQ( Child[0x20F0], 0xF0 );
+    EXPECT_EQ( Child[0x3000], 0x66 );
+    EXPECT_EQ( Parent[0x20F0], 0x55 );
+    EXPECT_EQ( Parent[0x20FF], 0x00 );
+    EXPECT_EQ( Fork.mem.getPrivatePages(), 1u );
+    // Page copied by the fork is the parent's alone again
+    EXPECT_EQ( mem.getPrivatePages(), 1u );
+    EXPECT_LT( Fork.mem.getPrivateBytes(), 4096u );
+}
+
+TEST_F( M6502CowMemTests, ParentWritesAfterForkAreNotSeenByForks )
+{
+    // given:
+    using namespace m6502;
+    LoadFillLoop();
+    cpu.execute( 50 );
+    const Byte Written = mem[0x2001];
+    SFork Fork( mem, cpu );
+
+    // when:
+    cpu.execute( 5000 );
+
+    // then:
+    const CCowMem& Child = Fork.mem;
+    EXPECT_EQ( mem[0x20FF], 0xFF );
+    EXPECT_EQ( Child[0x2001], Written );
+    EXPECT_EQ( Child[0x20FF], 0x00 );
+}
+
+TEST_F( M6502CowMemTests, ForksRunOnOtherThreads )
+{
+    // given:
+    using namespace m6502;
+    LoadFillLoop();
+    cpu.execute( 50 );
+    std::vector<std::unique_ptr<SFork>> Forks;
+    for ( u32 Index = 0; Index < 8; Index++ )
+    {
+        Forks.push_back( std::make_unique<SFork>( mem, cpu ) );
+        // LDX #Index
+        Forks.back()->mem[0x1001] = static_cast<Byte>( Index );
+        Forks.back()->cpu.PC = 0x1000;
+    }
+
+    // when:
+    std::vector<std::thread> Threads;
+    for ( auto& Fork : Forks )
+    {
+        Threads.emplace_back( [&Fork]() { Fork->cpu.execute( 5000 ); } );
+    }
+    for ( std::thread& Thread : Threads )
+    {
+        Thread.join();
+    }
+
+    // then:
+    for ( u32 Index = 0; Index < Forks.size(); Index++ )
+    {
+        const CCowMem& Child = Forks[Index]->mem;
+        EXPECT_EQ( Child[0x20FF], 0xFF );
+        EXPECT_EQ( Child[static_cast<Word>( 0x2000 + Index )], Index );
+        EXPECT_EQ( Child.getPrivatePages(), 2u );
+    }
+    const CCowMem& Parent = mem;
+    EXPECT_EQ( Parent[0x20FF], 0x00 );
+}
+
+TEST_F( M6502CowMemTests, RestoreKeepsUnchangedPagesShared )
+{
+    // given:
+    using namespace m6502;
+    LoadFillLoop();
+    SFork Fork( mem, cpu );
+    const std::vector<Byte> Blob = Fork.bus.snapshot();
+    Fork.cpu.execute( 5000 );
+    EXPECT_EQ( Fork.mem.getPrivatePages(), 1u );
+
+    // when:
+    const bool Restored = Fork.bus.restore( Blob );
+
+    // then:
+    const CCowMem& Child = Fork.mem;
+    ASSERT_TRUE( Restored );
+    EXPECT_EQ( Child[0x20FF], 0x00 );
+    EXPECT_EQ( Fork.cpu.PC, 0x1000 );
+    EXPECT_EQ( Child.getPrivatePages(), 1u );
+    EXPECT_EQ( Fork.cpu.execute( 5000 ), cpu.execute( 5000 ) );
+    EXPECT_EQ( Child[0x20FF], 0xFF );
+}
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502DispatchEngineTests : public testing::TestWithParam<m6502::EEngine>
+{
+public:
+    M6502DispatchEngineTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+
+    virtual void SetUp()
+    {
+        cpu.reset();
+        cpu.setEngine( GetParam() );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    // Place the opcode at $0200 with an absolute operand on Target
+    // or a zero page operand on $10 holding Target, then run it alone
+    m6502::s64 RunSingleInstruction( m6502::Byte OpCode, m6502::Byte Index,
+        m6502::Word Target )
+    {
+        using namespace m6502;
+        mem.initialise();
+        cpu.reset( 0x0200 );
+        cpu.X = cpu.Y = Index;
+        mem[0x0200] = OpCode;
+        if ( instructionSize( CCPU::OpTable[OpCode].mode ) == 3 )
+        {
+            mem[0x0201] = Target & 0xFF;
+            mem[0x0202] = Target >> 8;
+        }
+        else
+        {
+            // Zero page operand, also the indirect vector
+            mem[0x0201] = 0x10;
+            mem[0x0010] = Target & 0xFF;
+            mem[0x0011] = Target >> 8;
+        }
+        return cpu.execute( 1 );
+    }
+
+    m6502::s64 ExpectedCycles( m6502::Byte OpCode, bool PageCrossed )
+    {
+        using namespace m6502;
+        const CCPU::SOpCode& Op = CCPU::OpTable[OpCode];
+        s64 Cycles = Op.cycles;
+        if ( Op.penalty == EPagePenalty::PageCross && PageCrossed )
+        {
+            Cycles++;
+        }
+        const Word NextPC = 0x0200 + instructionSize( Op.mode );
+        if ( Op.penalty == EPagePenalty::Branch && cpu.PC != NextPC )
+        {
+            Cycles++;
+        }
+        return Cycles;
+    }
+};
+
+TEST_P( M6502DispatchEngineTests, TableHasAnEntryForEachHandledOpCode )
+{
+    // given:
+    using namespace m6502;
+    int LegalCount = 0;
+
+    // when:
+    for ( const CCPU::SOpCode& Op : CCPU::OpTable )
+    {
+        if ( Op.legal ) LegalCount++;
+    }
+
+    // then:
+    EXPECT_EQ( LegalCount, 151 );
+    EXPECT_TRUE( CCPU::OpTable[opcode(Ins::LDA_ABSX)].legal );
+    EXPECT_EQ( CCPU::OpTable[opcode(Ins::LDA_ABSX)].mode, EAddrMode::AbsoluteX );
+    EXPECT_FALSE( CCPU::OpTable[0xFF].legal );
+}
+
+TEST_P( M6502DispatchEngineTests, BaseCyclesOfTheTableMatchTheExecutedCycles )
+{
+    using namespace m6502;
+    for ( int OpCode = 0; OpCode < 256; OpCode++ )
+    {
+        if ( !CCPU::OpTable[OpCode].legal ) continue;
+
+        // when:
+        const s64 ActualCycles = RunSingleInstruction( static_cast<Byte>(OpCode), 0x00, 0x0210 );
+
+        // then:
+        EXPECT_EQ( ActualCycles, ExpectedCycles( static_cast<Byte>(OpCode), false ) )
+            << "OpCode " << std::hex << OpCode;
+    }
+}
+
+TEST_P( M6502DispatchEngineTests, PagePenaltyOfTheTableMatchTheExecutedCycles )
+{
+    using namespace m6502;
+    for ( int OpCode = 0; OpCode < 256; OpCode++ )
+    {
+        if ( !CCPU::OpTable[OpCode].legal ) continue;
+
+        // when:
+        const s64 ActualCycles = RunSingleInstruction( static_cast<Byte>(OpCode), 0x20, 0x02F0 );
+
+        // then:
+        EXPECT_EQ( ActualCycles, ExpectedCycles( static_cast<Byte>(OpCode), true ) )
+            << "OpCode " << std::hex << OpCode;
+    }
+}
+
+TEST_P( M6502DispatchEngineTests, EnginesRunAProgramToTheSameState )
+{
+    // given:
+    using namespace m6502;
+    /*
+    * = $1000
+        ldx #$00
+    loop
+        txa
+        clc
+        adc $20
+        sta $0300,x
+        inc $21
+        inx
+        cpx #$10
+        bne loop
+        jsr sub
+        jmp *
+    sub
+        pha
+        lda $0305
+        eor #$FF
+        sta $22
+        pla
+        rts
+    */
+    Byte Prg[] = {
+        0x00, 0x10,
+        0xA2, 0x00, 0x8A, 0x18, 0x65, 0x20, 0x9D, 0x00, 0x03, 0xE6, 0x21, 0xE8,
+        0xE0, 0x10, 0xD0, 0xF2, 0x20, 0x16, 0x10, 0x4C, 0x13, 0x10, 0x48, 0xAD,
+        0x05, 0x03, 0x49, 0xFF, 0x85, 0x22, 0x68, 0x60 };
+    mem[0x0020] = 0x07;
+    cpu.loadPrg( Prg, sizeof(Prg) );
+
+    // when:
+    const s64 ActualCycles = cpu.execute( 600 );
+
+    // then:
+    EXPECT_EQ( ActualCycles, 602 );
+    EXPECT_EQ( cpu.PC, 0x1013 );
+    EXPECT_EQ( cpu.X, 0x10 );
+    EXPECT_EQ( mem[0x0305], 0x0C );
+    EXPECT_EQ( mem[0x0021], 0x10 );
+    EXPECT_EQ( mem[0x0022], 0xF3 );
+    EXPECT_EQ( cpu.SP, 0xFF );
+}
+
+INSTANTIATE_TEST_SUITE_P( Engines, M6502DispatchEngineTests,
+    testing::Values( m6502::EEngine::Switch, m6502::EEngine::Table,
+        m6502::EEngine::Threaded, m6502::EEngine::Block ) );
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502FaultTests : public testing::Test
+{
+public:
+    M6502FaultTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        cpu.reset( 0x1000 );
+        cpu.setFaultStop( true );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void Load( const std::vector<m6502::Byte>& pCode )
+    {
+        for ( m6502::Word Index = 0; Index < pCode.size(); Index++ )
+        {
+            mem[0x1000 + Index] = pCode[Index];
+        }
+    }
+};
+
+TEST_F( M6502FaultTests, IllegalOpcodeStopsEveryEngine )
+{
+    using namespace m6502;
+    for ( EEngine Engine : { EEngine::Switch, EEngine::Table, EEngine::Threaded, EEngine::Block } )
+    {
+        // given:
+        // NOP / LDA #1 / illegal
+        Load( { 0xEA, 0xA9, 0x01, 0x02, 0xEA } );
+        cpu.reset( 0x1000 );
+        cpu.setEngine( Engine );
+
+        // when:
+        const s64 CyclesUsed = cpu.execute( 100 );
+
+        // then:
+        EXPECT_EQ( cpu.getFault(), EFault::Illegal );
+        EXPECT_EQ( CyclesUsed, 2 + 2 + 1 );
+        EXPECT_EQ( cpu.PC, 0x1003 );
+        EXPECT_EQ( cpu.A, 0x01 );
+    }
+}
+
+TEST_F( M6502FaultTests, FaultsThrowByDefault )
+{
+    // given:
+    using namespace m6502;
+    Load( { 0x02 } );
+    cpu.setFaultStop( false );
+
+    // when:
+    // then:
+    EXPECT_ANY_THROW( cpu.execute( 10 ) );
+}
+
+TEST_F( M6502FaultTests, PushOnAFullStackIsAnOverflow )
+{
+    // given:
+    using namespace m6502;
+    // PHA / NOP
+    Load( { 0x48, 0xEA } );
+    cpu.SP = 0x00;
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( 100 );
+
+    // then:
+    EXPECT_EQ( cpu.getFault(), EFault::StackOverflow );
+    EXPECT_EQ( CyclesUsed, 3 );
+    EXPECT_EQ( cpu.SP, 0xFF );
+    EXPECT_EQ( cpu.PC, 0x1001 );
+}
+
+TEST_F( M6502FaultTests, ReturnOnAnEmptyStackIsAnUnderflow )
+{
+    // given:
+    using namespace m6502;
+    // RTS
+    Load( { 0x60 } );
+    cpu.SP = 0xFE;
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( 100 );
+
+    // then:
+    EXPECT_EQ( cpu.getFault(), EFault::StackUnderflow );
+    EXPECT_EQ( CyclesUsed, 6 );
+}
+
+TEST_F( M6502FaultTests, DecimalAddIsAFault )
+{
+    // given:
+    using namespace m6502;
+    // SED / ADC #1
+    Load( { 0xF8, 0x69, 0x01 } );
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( 100 );
+
+    // then:
+    EXPECT_EQ( cpu.getFault(), EFault::Decimal );
+    EXPECT_EQ( CyclesUsed, 2 + 2 );
+    EXPECT_EQ( cpu.A, 0x00 );
+}
+
+TEST_F( M6502FaultTests, ThrownDecimalAddLeavesTheFlags )
+{
+    // given:
+    using namespace m6502;
+    // LDA #0 / SED / ADC #1
+    Load( { 0xA9, 0x00, 0xF8, 0x69, 0x01 } );
+    cpu.setFaultStop( false );
+
+    // when:
+    EXPECT_ANY_THROW( cpu.execute( 100 ) );
+
+    // then:
+    EXPECT_TRUE( cpu.Flags.Z );
+    EXPECT_TRUE( cpu.Flags.D );
+    // D and Z
+    EXPECT_EQ( cpu.PS, 0x0A );
+}
+
+TEST_F( M6502FaultTests, NextExecuteClearsTheFault )
+{
+    // given:
+    using namespace m6502;
+    // illegal / NOP
+    Load( { 0x02, 0xEA } );
+    cpu.execute( 10 );
+    EXPECT_EQ( cpu.getFault(), EFault::Illegal );
+    mem[0x1000] = 0xEA;
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( 4 );
+
+    // then:
+    EXPECT_EQ( cpu.getFault(), EFault::None );
+    EXPECT_EQ( CyclesUsed, 4 );
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502FuzzTests : public testing::Test
+{
+public:
+    m6502::SFuzzConfig config;
+
+    virtual void SetUp()
+    {
+        using namespace m6502;
+        // Parser of the zero terminated input at $0200:
+        //         LDX #0
+        // next:   LDA $0200,X / BEQ done
+        //         CMP #$FF / BEQ crash
+        //         CMP #$FE / BEQ deep
+        //         INX / BNE next
+        // done:   BRK
+        // crash:  illegal
+        // deep:   JSR deep
+        config.program = { 0x00, 0x10,
+            0xA2, 0x00, 0xBD, 0x00, 0x02, 0xF0, 0x0B, 0xC9, 0xFF, 0xF0, 0x08,
+            0xC9, 0xFE, 0xF0, 0x05, 0xE8, 0xD0, 0xF0, 0x00, 0x02, 0x20, 0x14, 0x10 };
+        config.resetVector = 0x1000;
+        config.bootCycles = 0;
+        config.inputAddress = 0x0200;
+        config.inputSize = 16;
+        config.writeSize = false;
+        config.sizeAddress = 0;
+        config.stopOnTarget = false;
+        config.targetPC = 0;
+        config.trapAddress = 0xFFF0;
+        config.cycles = 100000;
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    static m6502::SFuzzResult Run( m6502::CFuzzHarness& pHarness, const std::vector<m6502::Byte>& pInput )
+    {
+        return pHarness.run( pInput.data(), pInput.size() );
+    }
+};
+
+TEST_F( M6502FuzzTests, VerdictsOfInputs )
+{
+    // given:
+    using namespace m6502;
+    CFuzzHarness Harness( config );
+
+    // when:
+    const SFuzzResult Exit = Run( Harness, { 0x01, 0x02, 0x00 } );
+    const SFuzzResult Illegal = Run( Harness, { 0x01, 0xFF } );
+    const SFuzzResult Overflow = Run( Harness, { 0xFE } );
+
+    // then:
+    EXPECT_EQ( Exit.exit, EFuzzExit::Break );
+    EXPECT_FALSE( Exit.crashed() );
+    EXPECT_EQ( Exit.PC, 0xFFF0 );
+    EXPECT_EQ( Exit.cycles, 2 + 2 * (4 + 2 + 2 + 2 + 2 + 2 + 2 + 3) + 4 + 3 + 7 + 1 );
+    EXPECT_EQ( Illegal.exit, EFuzzExit::Illegal );
+    EXPECT_TRUE( Illegal.crashed() );
+    EXPECT_EQ( Illegal.PC, 0x1013 );
+    EXPECT_EQ( Overflow.exit, EFuzzExit::StackOverflow );
+    EXPECT_TRUE( Overflow.crashed() );
+    EXPECT_EQ( Harness.getRuns(), 3u );
+}
+
+TEST_F( M6502FuzzTests, EachInputStartsFromTheBootedState )
+{
+    // given:
+    using namespace m6502;
+    CFuzzHarness Harness( config );
+    Run( Harness, { 0x01, 0x02, 0x03, 0x04, 0x00 } );
+
+    // when:
+    const SFuzzResult Result = Run( Harness, {} );
+
+    // then:
+    EXPECT_EQ( Result.exit, EFuzzExit::Break );
+    EXPECT_EQ( Result.cycles, 2 + 4 + 3 + 7 + 1 );
+    EXPECT_EQ( Harness.getMem()[0x0201], 0x00 );
+    EXPECT_EQ( Harness.getCPU().SP, 0xFF - 3 );
+}
+
+TEST_F( M6502FuzzTests, InputsAreCutToTheirRAM )
+{
+    // given:
+    using namespace m6502;
+    config.writeSize = true;
+    config.sizeAddress = 0x0300;
+    CFuzzHarness Harness( config );
+    const std::vector<Byte> Input( 40, 0x01 );
+
+    // when:
+    Run( Harness, Input );
+
+    // then:
+    EXPECT_EQ( Harness.getMem()[0x020F], 0x01 );
+    EXPECT_EQ( Harness.getMem()[0x0210], 0x00 );
+    EXPECT_EQ( Harness.getMem()[0x0300], 16 );
+    EXPECT_EQ( Harness.getMem()[0x0301], 0 );
+}
+
+TEST_F( M6502FuzzTests, TargetAndCycleCapStopTheRun )
+{
+    // given:
+    using namespace m6502;
+    config.stopOnTarget = true;
+    config.targetPC = 0x100F;
+    CFuzzHarness Target( config );
+    config.stopOnTarget = false;
+    config.cycles = 20;
+    CFuzzHarness Capped( config );
+
+    // when:
+    const SFuzzResult Reached = Run( Target, { 0x01, 0x00 } );
+    const SFuzzResult Used = Run( Capped, { 0x01, 0x01, 0x01, 0x00 } );
+
+    // then:
+    EXPECT_EQ( Reached.exit, EFuzzExit::Target );
+    EXPECT_EQ( Reached.PC, 0x100F );
+    EXPECT_EQ( Used.exit, EFuzzExit::Cycles );
+    EXPECT_GE( Used.cycles, 20 );
+    EXPECT_FALSE( Used.crashed() );
+}
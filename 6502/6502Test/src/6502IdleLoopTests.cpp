@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502IdleLoopTests : public testing::Test
+{
+public:
+    M6502IdleLoopTests() :
+        cpu(bus), mem(bus,0x0000,0x0000),
+        refCpu(refBus), refMem(refBus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+    m6502::CBus refBus;
+    m6502::CCPU refCpu;
+    m6502::CMem refMem;
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        refMem.initialise();
+        cpu.reset( 0x1000 );
+        refCpu.reset( 0x1000 );
+        cpu.setIdleSkip( true );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void Load( const m6502::Byte* pCode, m6502::Word pSize )
+    {
+        for ( m6502::Word Index = 0; Index < pSize; Index++ )
+        {
+            mem[0x1000 + Index] = pCode[Index];
+            refMem[0x1000 + Index] = pCode[Index];
+        }
+    }
+
+    // Run both CPU with the same slices, the one skipping idle loops
+    // must end each slice as the strict one
+    void RunLockstep( int pSlices )
+    {
+        using namespace m6502;
+        for ( int Slice = 0; Slice < pSlices; Slice++ )
+        {
+            const s64 Cycles = 1 + (Slice * 7919) % 5003;
+            ASSERT_EQ( cpu.execute( Cycles ), refCpu.execute( Cycles ) ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.PC, refCpu.PC ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.A, refCpu.A ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.X, refCpu.X ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.Y, refCpu.Y ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.SP, refCpu.SP ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.PS, refCpu.PS ) << "Slice " << Slice;
+        }
+        for ( u32 Address = 0; Address < 0x2000; Address++ )
+        {
+            ASSERT_EQ( mem[Address], refMem[Address] ) << "Address " << Address;
+        }
+    }
+};
+
+class CIdleTestIo : public m6502::CBusChip
+{
+public:
+    CIdleTestIo(m6502::CBus& pBus, bool pStable) : CBusChip(pBus, 0xFF00, 0x4000), Stable(pStable) {}
+    bool Stable;
+protected:
+    m6502::Byte onReadBusData(const m6502::Word&) override { return 0x00; }
+    bool onStableRead(const m6502::Word&) override { return Stable; }
+};
+
+TEST_F( M6502IdleLoopTests, IdleSkipIsOffByDefault )
+{
+    // given:
+    using namespace m6502;
+
+    // when:
+    const bool Enabled = refCpu.getIdleSkip();
+
+    // then:
+    EXPECT_FALSE( Enabled );
+}
+
+TEST_F( M6502IdleLoopTests, JumpToSelfIsSkipped )
+{
+    // given:
+    using namespace m6502;
+    // spin: JMP spin
+    const Byte Code[] = { 0x4C, 0x00, 0x10 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    RunLockstep( 200 );
+
+    // then:
+    EXPECT_GT( cpu.getIdleSkippedCycles(), 0u );
+    EXPECT_EQ( refCpu.getIdleSkippedCycles(), 0u );
+}
+
+TEST_F( M6502IdleLoopTests, CountingLoopWithoutEndUpdatesTheCounter )
+{
+    // given:
+    using namespace m6502;
+    // LDX #0 / loop: INX / JMP loop
+    const Byte Code[] = { 0xA2, 0x00, 0xE8, 0x4C, 0x02, 0x10 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    RunLockstep( 200 );
+
+    // then:
+    EXPECT_GT( cpu.getIdleSkippedCycles(), 0u );
+}
+
+TEST_F( M6502IdleLoopTests, DelayLoopsStopWhenTheCounterReachesZero )
+{
+    // given:
+    using namespace m6502;
+    // start: LDX #$FF / d: DEX / BNE d / INC $10 / LDY #$80
+    // l2: LDA $20 / NOP / INY / BNE l2 / JMP start
+    const Byte Code[] = { 0xA2, 0xFF, 0xCA, 0xD0, 0xFD, 0xE6, 0x10, 0xA0,
+        0x80, 0xA5, 0x20, 0xEA, 0xC8, 0xD0, 0xFA, 0x4C, 0x00, 0x10 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    RunLockstep( 300 );
+
+    // then:
+    EXPECT_GT( cpu.getIdleSkippedCycles(), 0u );
+    EXPECT_GT( mem[0x10], 0 );
+}
+
+TEST_F( M6502IdleLoopTests, PollingRamCountsPageCrossing )
+{
+    // given:
+    using namespace m6502;
+    // start: LDY #3 / w: LDA $10 / CMP $0FFE,Y / BNE w / INC $12 / JMP start
+    const Byte Code[] = { 0xA0, 0x03, 0xA5, 0x10, 0xD9, 0xFE, 0x0F, 0xD0,
+        0xF9, 0xE6, 0x12, 0x4C, 0x00, 0x10 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    RunLockstep( 200 );
+
+    // then:
+    EXPECT_GT( cpu.getIdleSkippedCycles(), 0u );
+}
+
+TEST_F( M6502IdleLoopTests, LoopWritingMemoryIsNotSkipped )
+{
+    // given:
+    using namespace m6502;
+    // loop: INC $10 / JMP loop
+    const Byte Code[] = { 0xE6, 0x10, 0x4C, 0x00, 0x10 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    RunLockstep( 100 );
+
+    // then:
+    EXPECT_EQ( cpu.getIdleSkippedCycles(), 0u );
+}
+
+TEST_F( M6502IdleLoopTests, PollingIOIsSkippedOnlyWhenReadsAreStable )
+{
+    // given:
+    using namespace m6502;
+    // The first chip connected answers the reads of a page
+    CBus IoBus;
+    CIdleTestIo Io( IoBus, false );
+    CMem IoMem( IoBus, 0x0000, 0x0000 );
+    CCPU IoCpu( IoBus );
+    CBus RefIoBus;
+    CIdleTestIo RefIo( RefIoBus, false );
+    CMem RefIoMem( RefIoBus, 0x0000, 0x0000 );
+    CCPU RefIoCpu( RefIoBus );
+    IoMem.initialise();
+    RefIoMem.initialise();
+    IoCpu.reset( 0x1000 );
+    RefIoCpu.reset( 0x1000 );
+    IoCpu.setIdleSkip( true );
+    // p: LDA $4000 / BPL p / INC $11 / JMP p
+    const Byte Code[] = { 0xAD, 0x00, 0x40, 0x10, 0xFB, 0xE6, 0x11, 0x4C,
+        0x00, 0x10 };
+    for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+    {
+        IoMem[0x1000 + Index] = Code[Index];
+        RefIoMem[0x1000 + Index] = Code[Index];
+    }
+
+    // when:
+    const s64 UnstableCycles = IoCpu.execute( 10000 );
+    const u64 UnstableSkipped = IoCpu.getIdleSkippedCycles();
+    Io.Stable = true;
+    const s64 StableCycles = IoCpu.execute( 10000 );
+
+    // then:
+    EXPECT_EQ( UnstableSkipped, 0u );
+    EXPECT_GT( IoCpu.getIdleSkippedCycles(), 0u );
+    EXPECT_EQ( UnstableCycles, RefIoCpu.execute( 10000 ) );
+    EXPECT_EQ( StableCycles, RefIoCpu.execute( 10000 ) );
+    EXPECT_EQ( IoCpu.PC, RefIoCpu.PC );
+    EXPECT_EQ( IoCpu.PS, RefIoCpu.PS );
+}
+
+TEST_F( M6502IdleLoopTests, StepNeverSkips )
+{
+    // given:
+    using namespace m6502;
+    // spin: JMP spin
+    const Byte Code[] = { 0x4C, 0x00, 0x10 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    s64 Cycles = 0;
+    for ( int Index = 0; Index < 10; Index++ )
+    {
+        Cycles += cpu.step();
+    }
+
+    // then:
+    EXPECT_EQ( Cycles, 30 );
+    EXPECT_EQ( cpu.getIdleSkippedCycles(), 0u );
+}
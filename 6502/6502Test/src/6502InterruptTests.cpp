@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+#include <m6502/System/Aot.hpp>
+
+extern const m6502::SAotImage AotTestProgram;
+
+/**
+ * @brief Chip driving the interrupt lines
+ *
+ */
+class CLinesChip : public m6502::CBusChip
+{
+public:
+    CLinesChip( m6502::CBus& pBus ) : CBusChip( pBus, 0xFFFF, 0xD000 ) {}
+
+    void setIRQ( bool pAsserted ) { _setIRQ( pAsserted ); }
+    void setNMI( bool pAsserted ) { _setNMI( pAsserted ); }
+    void setReset( bool pAsserted ) { _setReset( pAsserted ); }
+
+protected:
+    void onWriteBusData( const m6502::Word&, const m6502::Byte& ) override {}
+
+    m6502::Byte onReadBusData( const m6502::Word& ) override
+    {
+        return 0;
+    }
+};
+
+class M6502InterruptTests : public testing::Test
+{
+public:
+    M6502InterruptTests() : cpu(bus), mem(bus,0x0000,0x0000), lines(bus) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+    CLinesChip lines;
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        cpu.reset( 0x1000 );
+        // loop: INX / JMP loop   IRQ: INY / RTI   NMI: DEY / RTI
+        Load( 0x1000, { 0xE8, 0x4C, 0x00, 0x10 } );
+        Load( 0x2000, { 0xC8, 0x40 } );
+        Load( 0x3000, { 0x88, 0x40 } );
+        Load( 0xFFFA, { 0x00, 0x30, 0x00, 0x10, 0x00, 0x20 } );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void Load( m6502::Word pAddress, const std::vector<m6502::Byte>& pCode )
+    {
+        for ( m6502::Word Index = 0; Index < pCode.size(); Index++ )
+        {
+            mem[pAddress + Index] = pCode[Index];
+        }
+    }
+};
+
+TEST_F( M6502InterruptTests, IRQEntersTheHandlerInSevenCycles )
+{
+    // given:
+    using namespace m6502;
+    cpu.Flags.I = false;
+    cpu.Flags.C = true;
+    lines.setIRQ( true );
+
+    // when:
+    const s64 Cycles = cpu.step();
+
+    // then:
+    EXPECT_EQ( Cycles, 7 );
+    EXPECT_EQ( cpu.PC, 0x2000 );
+    EXPECT_TRUE( cpu.Flags.I );
+    EXPECT_EQ( cpu.SP, 0xFC );
+    EXPECT_EQ( mem[0x01FF], 0x10 );
+    EXPECT_EQ( mem[0x01FE], 0x00 );
+    // B clear, unused and carry set
+    EXPECT_EQ( mem[0x01FD], CCPU::UnusedFlagBit | 0x01 );
+}
+
+TEST_F( M6502InterruptTests, IRQIsMaskedByTheInterruptFlag )
+{
+    // given:
+    using namespace m6502;
+    cpu.Flags.I = true;
+    lines.setIRQ( true );
+
+    // when:
+    cpu.execute( 50 );
+
+    // then:
+    EXPECT_EQ( cpu.Y, 0 );
+    EXPECT_EQ( cpu.X, 10 );
+}
+
+TEST_F( M6502InterruptTests, HeldIRQIsTakenAgainAfterRTIWithEveryEngine )
+{
+    // given:
+    using namespace m6502;
+
+    for ( EEngine Engine : { EEngine::Switch, EEngine::Table, EEngine::Threaded, EEngine::Block } )
+    {
+        cpu.reset( 0x1000 );
+        cpu.setEngine( Engine );
+        cpu.Flags.I = false;
+        lines.setIRQ( true );
+
+        // when:
+        cpu.execute( 3 * (7 + 2 + 6) );
+        lines.setIRQ( false );
+        cpu.execute( 50 );
+
+        // then:
+        EXPECT_EQ( cpu.Y, 3 );
+        EXPECT_GT( cpu.X, 0 );
+        EXPECT_EQ( cpu.SP, 0xFF );
+    }
+}
+
+TEST_F( M6502InterruptTests, NMIIsTakenOncePerEdge )
+{
+    // given:
+    using namespace m6502;
+    cpu.Flags.I = true;
+
+    // when:
+    lines.setNMI( true );
+    cpu.execute( 100 );
+    const Byte HeldY = cpu.Y;
+    lines.setNMI( false );
+    cpu.execute( 100 );
+    lines.setNMI( true );
+    cpu.execute( 100 );
+
+    // then:
+    EXPECT_EQ( HeldY, 0xFF );
+    EXPECT_EQ( cpu.Y, 0xFE );
+    EXPECT_EQ( cpu.SP, 0xFF );
+}
+
+TEST_F( M6502InterruptTests, LinesAreSharedBetweenChips )
+{
+    // given:
+    using namespace m6502;
+    CLinesChip Other( bus );
+    lines.setIRQ( true );
+    Other.setIRQ( true );
+    lines.setIRQ( true );
+
+    // when:
+    lines.setIRQ( false );
+
+    // then:
+    EXPECT_EQ( bus.getInterrupts() & CBus::IRQLines, 1u );
+    Other.setIRQ( false );
+    EXPECT_EQ( bus.getInterrupts(), 0u );
+}
+
+TEST_F( M6502InterruptTests, ResetHoldsTheCPUThenRunsTheResetVector )
+{
+    // given:
+    using namespace m6502;
+    cpu.execute( 20 );
+    const Byte X = cpu.X;
+    const Byte SP = cpu.SP;
+
+    // when:
+    lines.setReset( true );
+    EXPECT_EQ( cpu.execute( 100 ), 100 );
+    const Byte HeldX = cpu.X;
+    lines.setReset( false );
+    cpu.step();
+
+    // then:
+    EXPECT_EQ( HeldX, X );
+    EXPECT_EQ( cpu.PC, 0x1000 );
+    EXPECT_TRUE( cpu.Flags.I );
+    EXPECT_EQ( cpu.SP, static_cast<Byte>( SP - 3 ) );
+    EXPECT_EQ( bus.getInterrupts(), 0u );
+}
+
+TEST_F( M6502InterruptTests, ScheduledEventCanRaiseAnIRQ )
+{
+    // given:
+    using namespace m6502;
+    cpu.Flags.I = false;
+    u64 Fired = 0;
+    bus.getScheduler().schedule( 50, [&]( u64 pNow ) { Fired = pNow; lines.setIRQ( true ); } );
+
+    // when:
+    cpu.execute( 53 );
+
+    // then:
+    EXPECT_EQ( Fired, 50u );
+    EXPECT_EQ( cpu.PC, 0x2000 );
+    EXPECT_EQ( cpu.X, 10 );
+}
+
+TEST_F( M6502InterruptTests, UnbalancedLinesStayInTheirCounter )
+{
+    // given:
+    using namespace m6502;
+
+    // when:
+    bus.releaseIRQ();
+    bus.releaseNMI();
+    bus.releaseReset();
+    const u32 Released = bus.getInterrupts();
+    for ( int Holder = 0; Holder < 300; Holder++ )
+    {
+        bus.assertIRQ();
+    }
+
+    // then:
+    EXPECT_EQ( Released, 0u );
+    EXPECT_EQ( bus.getInterrupts(), CBus::IRQLines );
+}
+
+TEST_F( M6502InterruptTests, AotProgramTakesTheIRQBeforeATranslatedBlock )
+{
+    // given:
+    using namespace m6502;
+    // IRQ: INY / JMP *
+    Load( 0x2000, { 0xC8, 0x4C, 0x01, 0x20 } );
+    std::vector<Byte> Prg = { static_cast<Byte>(AotTestProgram.loadAddress & 0xFF),
+                              static_cast<Byte>(AotTestProgram.loadAddress >> 8) };
+    Prg.insert( Prg.end(), AotTestProgram.data, AotTestProgram.data + AotTestProgram.size );
+    cpu.loadPrg( Prg.data(), static_cast<u32>(Prg.size()) );
+    ASSERT_EQ( cpu.PC, AotTestProgram.loadAddress );
+    CAotProgram Program( cpu, bus, AotTestProgram );
+    cpu.Flags.I = false;
+    lines.setIRQ( true );
+
+    // when:
+    Program.execute( 1000 );
+
+    // then:
+    EXPECT_EQ( Program.getStats().translatedRuns, 0u );
+    EXPECT_EQ( cpu.Y, 1 );
+    EXPECT_TRUE( cpu.Flags.I );
+    // Return address is the start of the program, its first block never ran
+    EXPECT_EQ( mem[0x01FF], 0x03 );
+    EXPECT_EQ( mem[0x01FE], 0x00 );
+}
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+#include <m6502/Jit/Jit.hpp>
+#include <fstream>
+#include <string>
+
+class M6502JitTests : public testing::Test
+{
+public:
+    M6502JitTests() :
+        cpu(bus), mem(bus,0x0000,0x0000),
+        refCpu(refBus), refMem(refBus,0x0000,0x0000),
+        jit(cpu, bus) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+    m6502::CBus refBus;
+    m6502::CCPU refCpu;
+    m6502::CMem refMem;
+    m6502::CJit jit;
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        refMem.initialise();
+        cpu.reset( 0x1000 );
+        refCpu.reset( 0x1000 );
+        jit.setHotThreshold( 1 );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void Load( const m6502::Byte* pCode, m6502::Word pSize )
+    {
+        for ( m6502::Word Index = 0; Index < pSize; Index++ )
+        {
+            mem[0x1000 + Index] = pCode[Index];
+            refMem[0x1000 + Index] = pCode[Index];
+        }
+    }
+
+    // Run both CPU with the same slices, the JIT one must follow
+    // the interpreter one cycle for cycle
+    void RunLockstep( int pSlices )
+    {
+        using namespace m6502;
+        for ( int Slice = 0; Slice < pSlices; Slice++ )
+        {
+            const s64 Cycles = 1 + (Slice * 7) % 61;
+            ASSERT_EQ( jit.execute( Cycles ), refCpu.execute( Cycles ) ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.PC, refCpu.PC ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.A, refCpu.A ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.X, refCpu.X ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.Y, refCpu.Y ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.SP, refCpu.SP ) << "Slice " << Slice;
+            ASSERT_EQ( cpu.PS, refCpu.PS ) << "Slice " << Slice;
+        }
+        for ( u32 Address = 0; Address < 0x4000; Address++ )
+        {
+            ASSERT_EQ( mem[Address], refMem[Address] ) << "Address " << Address;
+        }
+    }
+};
+
+TEST_F( M6502JitTests, RunsLikeTheInterpreter )
+{
+    // given:
+    using namespace m6502;
+    // Loads, stores crossing pages, ADC/SBC, shifts, BIT and PHP/PLP
+    // left to the interpreter, JSR/RTS, PHA/PLA and branches
+    const Byte Code[] = { 0xA2, 0x00, 0xA0, 0x10, 0x18, 0x8A, 0x69, 0x37,
+        0x9D, 0xF0, 0x20, 0xBD, 0xF0, 0x20, 0x45, 0x30, 0x85, 0x30, 0x2A,
+        0x66, 0x31, 0x16, 0x32, 0x4A, 0xE9, 0x05, 0x24, 0x30, 0x08, 0xC9,
+        0x80, 0x90, 0x02, 0xE6, 0x33, 0xC6, 0x34, 0x28, 0x48, 0x20, 0x37,
+        0x10, 0x68, 0x70, 0x03, 0x99, 0x00, 0x30, 0xE8, 0x88, 0xD0, 0xD1,
+        0x4C, 0x02, 0x10, 0x85, 0x35, 0xA5, 0x36, 0x69, 0x01, 0x85, 0x36,
+        0xB4, 0x35, 0xA4, 0x3F, 0xA0, 0x01, 0xC0, 0x01, 0xA4, 0x35, 0x60 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    RunLockstep( 3000 );
+
+    // then:
+    if ( jit.isAvailable() )
+    {
+        EXPECT_GT( jit.getStats().compiledBlocks, 0u );
+        EXPECT_GT( jit.getStats().nativeRuns, 0u );
+    }
+}
+
+TEST_F( M6502JitTests, SelfModifyingCodeIsInvalidated )
+{
+    // given:
+    using namespace m6502;
+    // loop: LDA #INX / STA patch / patch: NOP / LDA #NOP / STA patch / JMP loop
+    const Byte Code[] = { 0xA9, 0xE8, 0x8D, 0x05, 0x10, 0xEA, 0xA9, 0xEA,
+        0x8D, 0x05, 0x10, 0x4C, 0x00, 0x10 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    RunLockstep( 500 );
+
+    // then:
+    EXPECT_EQ( cpu.X, refCpu.X );
+    EXPECT_NE( cpu.X, 0x00 );
+    if ( jit.isAvailable() )
+    {
+        EXPECT_GT( jit.getStats().invalidations, 0u );
+    }
+}
+
+class CJitTestIo : public m6502::CBusChip
+{
+public:
+    CJitTestIo(m6502::CBus& pBus) : CBusChip(pBus, 0xFF00, 0x4000), Reads(0), Writes(0) {}
+    int Reads;
+    int Writes;
+protected:
+    m6502::Byte onReadBusData(const m6502::Word&) override { return static_cast<m6502::Byte>(++Reads); }
+    void onWriteBusData(const m6502::Word&, const m6502::Byte&) override { Writes++; }
+};
+
+TEST_F( M6502JitTests, IOPagesAreLeftToTheInterpreter )
+{
+    // given:
+    using namespace m6502;
+    CJitTestIo Io( bus );
+    CJitTestIo RefIo( refBus );
+    // loop: LDA $4000 / STA $4001 / INX / JMP loop
+    const Byte Code[] = { 0xAD, 0x00, 0x40, 0x8D, 0x01, 0x40, 0xE8, 0x4C,
+        0x00, 0x10 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    RunLockstep( 200 );
+
+    // then:
+    EXPECT_GT( Io.Writes, 0 );
+    EXPECT_EQ( Io.Writes, RefIo.Writes );
+    EXPECT_EQ( bus.getWritePage( 0x4000 ), nullptr );
+}
+
+TEST_F( M6502JitTests, CodeArenaIsNeverWritableAndExecutable )
+{
+    // given:
+    using namespace m6502;
+    // loop: INX / BNE skip / INY / skip: JMP loop
+    const Byte Code[] = { 0xE8, 0xD0, 0x01, 0xC8, 0x4C, 0x00, 0x10 };
+    Load( Code, sizeof( Code ) );
+
+    // when:
+    RunLockstep( 300 );
+
+    // then:
+    if ( jit.isAvailable() )
+    {
+        EXPECT_GT( jit.getStats().compiledBlocks, 1u );
+    }
+    std::ifstream Maps( "/proc/self/maps" );
+    std::string Line;
+    while ( std::getline( Maps, Line ) )
+    {
+        EXPECT_EQ( Line.find( " rwx" ), std::string::npos ) << Line;
+    }
+}
+
+TEST_F( M6502JitTests, NativeBlocksMoveTheSchedulerClock )
+{
+    // given:
+    using namespace m6502;
+    // loop: INX / INY / JMP loop
+    const Byte Code[] = { 0xE8, 0xC8, 0x4C, 0x00, 0x10 };
+    Load( Code, sizeof( Code ) );
+    CScheduler& Scheduler = bus.getScheduler();
+    u64 FiredAt = 0;
+    Scheduler.schedule( 5000, [&]( u64 ) { FiredAt = Scheduler.getNow(); } );
+
+    // when:
+    const s64 CyclesUsed = jit.execute( 100000 );
+
+    // then:
+    if ( jit.isAvailable() )
+    {
+        EXPECT_GT( jit.getStats().nativeRuns, 0u );
+    }
+    EXPECT_EQ( Scheduler.getNow(), static_cast<u64>( CyclesUsed ) );
+    EXPECT_GE( FiredAt, 5000u );
+    EXPECT_LT( FiredAt, 5007u );
+}
+
+TEST_F( M6502JitTests, IRQIsTakenBetweenNativeBlocks )
+{
+    // given:
+    using namespace m6502;
+    // loop: INX / JMP loop   IRQ: INY / JMP *
+    const Byte Code[] = { 0xE8, 0x4C, 0x00, 0x10, 0xC8, 0x4C, 0x05, 0x10 };
+    Load( Code, sizeof( Code ) );
+    mem[0xFFFE] = 0x04;
+    mem[0xFFFF] = 0x10;
+    cpu.Flags.I = false;
+    bus.getScheduler().schedule( 5000, [&]( u64 ) { bus.assertIRQ(); } );
+
+    // when:
+    jit.execute( 100000 );
+
+    // then:
+    if ( jit.isAvailable() )
+    {
+        EXPECT_GT( jit.getStats().nativeRuns, 0u );
+    }
+    EXPECT_EQ( cpu.Y, 1 );
+    EXPECT_TRUE( cpu.Flags.I );
+    EXPECT_EQ( cpu.PC, 0x1005 );
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502LazyFlagsTests : public testing::Test
+{
+public:
+    M6502LazyFlagsTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+
+    virtual void SetUp()
+    {
+        cpu.reset( 0xFF00 );
+        mem.initialise();
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F( M6502LazyFlagsTests, PHPPushesTheFlagsOfThePreviousInstruction )
+{
+    // given:
+    using namespace m6502;
+    mem[0xFF00] = opcode(Ins::LDA_IM);
+    mem[0xFF01] = 0x80;
+    mem[0xFF02] = opcode(Ins::PHP);
+    constexpr s64 EXPECTED_CYCLES = 2 + 3;
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( EXPECTED_CYCLES );
+
+    // then:
+    EXPECT_EQ( CyclesUsed, EXPECTED_CYCLES );
+    EXPECT_EQ( mem[0x01FF], CRegisters::NegativeFlagBit |
+        CRegisters::BreakFlagBit | CRegisters::UnusedFlagBit );
+}
+
+TEST_F( M6502LazyFlagsTests, BITSetsZeroAndNegativeFromDifferentValues )
+{
+    // given:
+    using namespace m6502;
+    cpu.A = 0x0F;
+    mem[0xFF00] = opcode(Ins::BIT_ZP);
+    mem[0xFF01] = 0x42;
+    mem[0x0042] = 0xC0;
+    constexpr s64 EXPECTED_CYCLES = 3;
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( EXPECTED_CYCLES );
+
+    // then:
+    EXPECT_EQ( CyclesUsed, EXPECTED_CYCLES );
+    EXPECT_TRUE( cpu.Flags.Z );
+    EXPECT_TRUE( cpu.Flags.N );
+    EXPECT_TRUE( cpu.Flags.V );
+}
+
+TEST_F( M6502LazyFlagsTests, PLPReplacesTheFlagsUsedByTheNextBranch )
+{
+    // given:
+    using namespace m6502;
+    mem[0xFF00] = opcode(Ins::LDA_IM);
+    mem[0xFF01] = 0x01;
+    mem[0xFF02] = opcode(Ins::PHA);
+    mem[0xFF03] = opcode(Ins::LDA_IM);
+    mem[0xFF04] = 0x00;
+    mem[0xFF05] = opcode(Ins::PLP);
+    mem[0xFF06] = opcode(Ins::BSC);
+    mem[0xFF07] = 0x02;
+    mem[0xFF08] = opcode(Ins::LDX_IM);
+    mem[0xFF09] = 0x01;
+    mem[0xFF0A] = opcode(Ins::LDY_IM);
+    mem[0xFF0B] = 0x02;
+    constexpr s64 EXPECTED_CYCLES = 2 + 3 + 2 + 4 + 3 + 2;
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( EXPECTED_CYCLES );
+
+    // then:
+    EXPECT_EQ( CyclesUsed, EXPECTED_CYCLES );
+    EXPECT_EQ( cpu.X, 0x00 );
+    EXPECT_EQ( cpu.Y, 0x02 );
+    EXPECT_TRUE( cpu.Flags.C );
+    EXPECT_FALSE( cpu.Flags.Z );
+}
+
+TEST_F( M6502LazyFlagsTests, FlagsChangedBetweenTwoRunsAreSeenByTheCPU )
+{
+    // given:
+    using namespace m6502;
+    mem[0xFF00] = opcode(Ins::LDA_IM);
+    mem[0xFF01] = 0x00;
+    mem[0xFF02] = opcode(Ins::BEQ);
+    mem[0xFF03] = 0x02;
+    cpu.execute( 2 );
+    cpu.Flags.Z = false;
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( 1 );
+
+    // then:
+    EXPECT_EQ( CyclesUsed, 2 );
+    EXPECT_EQ( cpu.PC, 0xFF04 );
+}
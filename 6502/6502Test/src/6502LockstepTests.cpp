@@ -0,0 +1,317 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+#include <memory>
+
+class M6502LockstepTests : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    // Scalar system a lane is checked against
+    struct SScalar
+    {
+        m6502::CBus bus;
+        m6502::CMem mem { bus, 0x0000, 0x0000 };
+        m6502::CCPU cpu { bus };
+    };
+
+    // Program loaded at $0200 in every lane
+    template<m6502::u32 Lanes>
+    void Load( m6502::CLockstepCPU<Lanes>& pLanes, const std::vector<m6502::Byte>& pCode )
+    {
+        std::vector<m6502::Byte> Program = { 0x00, 0x02 };
+        Program.insert( Program.end(), pCode.begin(), pCode.end() );
+        pLanes.loadPrg( Program.data(), static_cast<m6502::u32>( Program.size() ) );
+    }
+
+    // Run each lane and a CCPU started with the same registers and
+    // memory for the same budgets, both must end the same every time
+    template<m6502::u32 Lanes>
+    void ExpectLanesMatchCCPU( m6502::CLockstepCPU<Lanes>& pLanes, const std::vector<m6502::s64>& pBudgets )
+    {
+        using namespace m6502;
+        std::vector<std::unique_ptr<SScalar>> Scalars;
+        for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+        {
+            Scalars.push_back( std::make_unique<SScalar>() );
+            SScalar& Scalar = *Scalars.back();
+            for ( u32 Address = 0; Address < MAX_MEM; Address++ )
+            {
+                Scalar.mem[static_cast<Word>( Address )] = pLanes.read( Lane, static_cast<Word>( Address ) );
+            }
+            const SLaneRegisters Registers = pLanes.getRegisters( Lane );
+            Scalar.cpu.PC = Registers.PC;
+            Scalar.cpu.SP = Registers.SP;
+            Scalar.cpu.A = Registers.A;
+            Scalar.cpu.X = Registers.X;
+            Scalar.cpu.Y = Registers.Y;
+            Scalar.cpu.PS = Registers.PS;
+        }
+        for ( const s64 Budget : pBudgets )
+        {
+            pLanes.execute( Budget );
+            for ( u32 Lane = 0; Lane < Lanes; Lane++ )
+            {
+                CCPU& CPU = Scalars[Lane]->cpu;
+                bool Thrown = false;
+                s64 Cycles = 0;
+                try
+                {
+                    Cycles = CPU.execute( Budget );
+                }
+                catch ( ... )
+                {
+                    Thrown = true;
+                }
+                ASSERT_EQ( pLanes.isFaulted( Lane ), Thrown ) << "Lane " << Lane;
+                if ( Thrown ) continue;
+                const SLaneRegisters Registers = pLanes.getRegisters( Lane );
+                EXPECT_EQ( pLanes.getCycles( Lane ), Cycles ) << "Lane " << Lane;
+                EXPECT_EQ( Registers.PC, CPU.PC ) << "Lane " << Lane;
+                EXPECT_EQ( Registers.SP, CPU.SP ) << "Lane " << Lane;
+                EXPECT_EQ( Registers.A, CPU.A ) << "Lane " << Lane;
+                EXPECT_EQ( Registers.X, CPU.X ) << "Lane " << Lane;
+                EXPECT_EQ( Registers.Y, CPU.Y ) << "Lane " << Lane;
+                EXPECT_EQ( Registers.PS, CPU.PS ) << "Lane " << Lane;
+                for ( u32 Address = 0; Address < MAX_MEM; Address++ )
+                {
+                    ASSERT_EQ( pLanes.read( Lane, static_cast<Word>( Address ) ), Scalars[Lane]->mem[static_cast<Word>( Address )] )
+                        << "Lane " << Lane << " Address " << Address;
+                }
+            }
+        }
+    }
+};
+
+/* Table fill, indirect copy, shifts, calls and short loops,
+   the program of M6502Bench without its load address */
+static const std::vector<m6502::Byte> MixedCode = {
+    0xA9, 0x00, 0x85, 0x20, 0x85, 0x22, 0xA9, 0x04, 0x85, 0x21, 0xA9, 0x06,
+    0x85, 0x23, 0xA2, 0x00, 0x8A, 0x18, 0x69, 0x03, 0x9D, 0x00, 0x04, 0x45,
+    0x10, 0x29, 0x7F, 0x05, 0x11, 0x9D, 0x00, 0x05, 0xE8, 0xD0, 0xED, 0xA0,
+    0x3F, 0xB1, 0x20, 0x0A, 0x26, 0x30, 0xC9, 0x40, 0x90, 0x02, 0xE9, 0x40,
+    0x91, 0x22, 0x88, 0x10, 0xF0, 0xA2, 0x10, 0x20, 0x42, 0x02, 0xCA, 0xD0,
+    0xFA, 0xE6, 0x12, 0x4C, 0x0E, 0x02, 0x48, 0x8A, 0x48, 0x46, 0x31, 0xBD,
+    0x00, 0x05, 0xA0, 0x04, 0x88, 0xD0, 0xFD, 0x68, 0xAA, 0x68, 0x60 };
+
+/* Loop over the addressing modes quirks of CCPU, the stack, BRK / RTI
+   and the flags of ADC / SBC / BIT, on operands read from the zero page */
+static const std::vector<m6502::Byte> QuirksCode = {
+    // $0200: LDX $E0 / LDY $E1 / LDA $E2 / PHP
+    0xA6, 0xE0, 0xA4, 0xE1, 0xA5, 0xE2, 0x08,
+    // $0207: ADC #$37 / STA $40 / SBC #$90 / BIT $40
+    0x69, 0x37, 0x85, 0x40, 0xE9, 0x90, 0x24, 0x40,
+    // $020F: STA ($F0,X) / LDA ($F8,X) / STA ($F2),Y / LDA ($F4),Y
+    0x81, 0xF0, 0xA1, 0xF8, 0x91, 0xF2, 0xB1, 0xF4,
+    // $0217: ADC $03FC,X / ROL A / ROR A / ASL $0300,X / ROL $80,X
+    0x7D, 0xFC, 0x03, 0x2A, 0x6A, 0x1E, 0x00, 0x03, 0x36, 0x80,
+    // $0221: BRK, padding / PLP / CMP #$80 / BCS $022E
+    0x00, 0xEA, 0x28, 0xC9, 0x80, 0xB0, 0x06,
+    // $0228: INC $E2 / DEC $E1 / BCC $0230 / $022E: INC $E1
+    0xE6, 0xE2, 0xC6, 0xE1, 0x90, 0x02, 0xE6, 0xE1,
+    // $0230: INX / TXA / AND #$07 / STA $E0 / JSR $0240 / JMP ($0600)
+    0xE8, 0x8A, 0x29, 0x07, 0x85, 0xE0, 0x20, 0x40, 0x02, 0x6C, 0x00, 0x06,
+    0xEA, 0xEA, 0xEA, 0xEA,
+    // $0240: TSX / TXS / TYA / EOR $E2 / ORA $E3 / STA $E3 / RTS
+    0xBA, 0x9A, 0x98, 0x45, 0xE2, 0x05, 0xE3, 0x85, 0xE3, 0x60,
+    0xEA, 0xEA, 0xEA, 0xEA, 0xEA, 0xEA,
+    // $0250: interrupt handler, PHA / TXA / PLA / RTI
+    0x48, 0x8A, 0x68, 0x40 };
+
+TEST_F( M6502LockstepTests, LanesRunningTheSameDataStayTogether )
+{
+    // given:
+    using namespace m6502;
+    CLockstepCPU<8> Lanes;
+    Load( Lanes, MixedCode );
+
+    // when:
+    Lanes.execute( 20000 );
+
+    // then:
+    const SLockstepStats& Stats = Lanes.getStats();
+    EXPECT_GT( Stats.dispatches, 0u );
+    EXPECT_EQ( Stats.instructions, Stats.dispatches * 8 );
+    for ( u32 Lane = 1; Lane < 8; Lane++ )
+    {
+        EXPECT_EQ( Lanes.getCycles( Lane ), Lanes.getCycles( 0 ) );
+        EXPECT_EQ( Lanes.getRegisters( Lane ).PC, Lanes.getRegisters( 0 ).PC );
+        EXPECT_EQ( Lanes.read( Lane, 0x0512 ), Lanes.read( 0, 0x0512 ) );
+    }
+}
+
+TEST_F( M6502LockstepTests, EachLaneIsTheCCPUOnItsMemory )
+{
+    // given:
+    using namespace m6502;
+    CLockstepCPU<16> Lanes;
+    Load( Lanes, MixedCode );
+    for ( u32 Lane = 0; Lane < 16; Lane++ )
+    {
+        // Copy loop count of LDY #$3F, lanes leave the loop apart
+        Lanes.write( Lane, 0x0224, static_cast<Byte>( 0x3F - Lane ) );
+        Lanes.write( Lane, 0x0010, static_cast<Byte>( Lane * 37 ) );
+        Lanes.write( Lane, 0x0011, static_cast<Byte>( Lane * 101 ) );
+        Lanes.write( Lane, 0x0030, static_cast<Byte>( Lane * 13 ) );
+    }
+
+    // when / then:
+    ExpectLanesMatchCCPU( Lanes, { 137, 1000, 20011, 3 } );
+    EXPECT_LT( Lanes.getStats().instructions, Lanes.getStats().dispatches * 16 );
+}
+
+TEST_F( M6502LockstepTests, QuirksAreTheOnesOfCCPU )
+{
+    // given:
+    using namespace m6502;
+    CLockstepCPU<32> Lanes;
+    Load( Lanes, QuirksCode );
+    u32 Seed = 12345;
+    for ( u32 Lane = 0; Lane < 32; Lane++ )
+    {
+        auto Random = [&Seed]() { Seed = Seed * 1103515245 + 12345; return static_cast<Byte>( Seed >> 16 ); };
+        Lanes.write( Lane, 0x00E0, Lane & 7 );
+        Lanes.write( Lane, 0x00E1, Random() );
+        Lanes.write( Lane, 0x00E2, Random() );
+        Lanes.write( Lane, 0x00E3, Random() );
+        for ( Word Pointer = 0x00F0; Pointer < 0x00F8; Pointer += 2 )
+        {
+            Lanes.write( Lane, Pointer, Random() );
+            Lanes.write( Lane, Pointer + 1, 0x03 );
+        }
+        // Pointers read at $F8 + X, up to $0100
+        for ( Word Pointer = 0x00F8; Pointer <= 0x00FF; Pointer++ )
+        {
+            Lanes.write( Lane, Pointer, 0x03 );
+        }
+        Lanes.write( Lane, 0x0100, 0x04 );
+        for ( Word Address = 0x0300; Address < 0x0500; Address++ )
+        {
+            Lanes.write( Lane, Address, Random() );
+        }
+        Lanes.write( Lane, 0x0600, 0x00 );
+        Lanes.write( Lane, 0x0601, 0x02 );
+        Lanes.write( Lane, 0xFFFE, 0x50 );
+        Lanes.write( Lane, 0xFFFF, 0x02 );
+    }
+
+    // when / then:
+    ExpectLanesMatchCCPU( Lanes, { 50, 777, 9000 } );
+    EXPECT_LT( Lanes.getStats().instructions, Lanes.getStats().dispatches * 32 );
+    for ( u32 Lane = 0; Lane < 32; Lane++ )
+    {
+        EXPECT_FALSE( Lanes.isFaulted( Lane ) );
+    }
+}
+
+TEST_F( M6502LockstepTests, IllegalOpcodeStopsItsLaneOnly )
+{
+    // given:
+    using namespace m6502;
+    CLockstepCPU<8> Lanes;
+    // LDX #0 / loop: INX / JMP loop
+    Load( Lanes, { 0xA2, 0x00, 0xE8, 0x4C, 0x02, 0x02 } );
+    Lanes.write( 3, 0x0202, 0x02 );
+
+    // when:
+    Lanes.execute( 100 );
+
+    // then:
+    EXPECT_TRUE( Lanes.isFaulted( 3 ) );
+    EXPECT_EQ( Lanes.getRegisters( 3 ).PC, 0x0202 );
+    EXPECT_EQ( Lanes.getCycles( 3 ), 2 );
+    for ( u32 Lane = 0; Lane < 8; Lane++ )
+    {
+        if ( Lane == 3 ) continue;
+        EXPECT_FALSE( Lanes.isFaulted( Lane ) );
+        EXPECT_GE( Lanes.getCycles( Lane ), 100 );
+    }
+}
+
+TEST_F( M6502LockstepTests, DecimalModeFaultsAddWithCarry )
+{
+    // given:
+    using namespace m6502;
+    CLockstepCPU<8> Lanes;
+    // ADC #1 / ADC #1
+    Load( Lanes, { 0x69, 0x01, 0x69, 0x01 } );
+    SLaneRegisters Registers = Lanes.getRegisters( 5 );
+    Registers.PS |= 0x08;
+    Lanes.setRegisters( 5, Registers );
+
+    // when:
+    Lanes.execute( 4 );
+
+    // then:
+    EXPECT_TRUE( Lanes.isFaulted( 5 ) );
+    EXPECT_EQ( Lanes.getRegisters( 5 ).A, 0 );
+    EXPECT_FALSE( Lanes.isFaulted( 4 ) );
+    EXPECT_EQ( Lanes.getRegisters( 4 ).A, 2 );
+}
+
+TEST_F( M6502LockstepTests, ResetClearsFaults )
+{
+    // given:
+    using namespace m6502;
+    CLockstepCPU<8> Lanes;
+    Load( Lanes, { 0x02 } );
+    Lanes.execute( 10 );
+    ASSERT_TRUE( Lanes.isFaulted( 0 ) );
+
+    // when:
+    Lanes.reset( 0x0200 );
+
+    // then:
+    EXPECT_FALSE( Lanes.isFaulted( 0 ) );
+    EXPECT_EQ( Lanes.getRegisters( 0 ).PC, 0x0200 );
+    EXPECT_EQ( Lanes.getRegisters( 0 ).SP, 0xFF );
+}
+
+TEST_F( M6502LockstepTests, RandomProgramsOverEveryLegalOpcodeMatchCCPU )
+{
+    // given:
+    using namespace m6502;
+    std::vector<Byte> Legal;
+    for ( u32 OpCode = 0; OpCode < 256; OpCode++ )
+    {
+        if ( CCPU::OpTable[OpCode].legal ) Legal.push_back( static_cast<Byte>( OpCode ) );
+    }
+    constexpr u32 LANES = 16;
+    u32 Seed = 2026;
+    auto Random = [&Seed]() { Seed = Seed * 1103515245 + 12345; return static_cast<Byte>( Seed >> 16 ); };
+
+    for ( u32 First = 0; First < Legal.size(); First += LANES )
+    {
+        CLockstepCPU<LANES> Lanes;
+        for ( u32 Lane = 0; Lane < LANES; Lane++ )
+        {
+            // Random legal opcodes everywhere, jumps land on code more often
+            for ( u32 Address = 0; Address < MAX_MEM; Address++ )
+            {
+                const Byte Value = ( Random() & 1 ) ? Legal[Random() % Legal.size()] : Random();
+                Lanes.write( Lane, static_cast<Word>( Address ), Value );
+            }
+            // Every legal opcode is the first instruction of one lane
+            Lanes.write( Lane, 0x0200, Legal[( First + Lane ) % Legal.size()] );
+            SLaneRegisters Registers;
+            Registers.PC = 0x0200;
+            Registers.SP = Random();
+            Registers.A = Random();
+            Registers.X = Random();
+            Registers.Y = Random();
+            // Binary mode, decimal is a fault on both sides
+            Registers.PS = Random() & ~0x08;
+            Lanes.setRegisters( Lane, Registers );
+        }
+
+        // when / then:
+        ExpectLanesMatchCCPU( Lanes, { 1, 29, 400, 3000 } );
+        if ( HasFatalFailure() ) return;
+    }
+}
@@ -0,0 +1,346 @@
+#include <gtest/gtest.h>
+#include <loop.hpp>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Subscriber counting its calls, leaving after a number of them
+ *        when asked to
+ *
+ */
+class CCountingEvent : public CProcessEvent
+{
+public:
+    CCountingEvent( CLoop& pLoop, int pLeaveAfter = 0 ) :
+        CProcessEvent( pLoop ), calls(0), leaveAfter(pLeaveAfter)
+    {
+        startProcess();
+    }
+
+    ~CCountingEvent()
+    {
+        stopProcess();
+    }
+
+    void leave()
+    {
+        stopProcess();
+    }
+
+    std::atomic<int> calls;
+    const int leaveAfter;
+
+protected:
+    void onProcess( const period& ) override
+    {
+        if ( ++calls == leaveAfter )
+        {
+            stopProcess();
+        }
+    }
+};
+
+/**
+ * @brief Subscriber busy for a while on each call, noting calls
+ *        overlapping on two workers
+ *
+ */
+class CBusyEvent : public CProcessEvent
+{
+public:
+    CBusyEvent( CLoop& pLoop, std::chrono::microseconds pBusy ) :
+        CProcessEvent( pLoop ), busy(pBusy)
+    {
+        startProcess();
+    }
+
+    ~CBusyEvent()
+    {
+        stopProcess();
+    }
+
+    const std::chrono::microseconds busy;
+    std::atomic<bool> inside{false};
+    std::atomic<int> overlaps{0};
+    std::atomic<int> calls{0};
+
+protected:
+    void onProcess( const period& ) override
+    {
+        if ( inside.exchange( true ) ) overlaps++;
+        const steady::time_point End = steady::now() + busy;
+        while ( steady::now() < End )
+        {
+        }
+        calls++;
+        inside = false;
+    }
+};
+
+/**
+ * @brief Subscriber removing another one from its onProcess
+ *
+ */
+class CRemovingEvent : public CProcessEvent
+{
+public:
+    CRemovingEvent( CLoop& pLoop ) : CProcessEvent( pLoop )
+    {
+        startProcess();
+    }
+
+    ~CRemovingEvent()
+    {
+        stopProcess();
+    }
+
+    void leave()
+    {
+        stopProcess();
+    }
+
+    // Removed on first call, deleted when owned
+    CRemovingEvent* other = nullptr;
+    std::unique_ptr<CCountingEvent> owned;
+    // Callers meeting before the removal, zero when not waited for
+    std::atomic<int>* meeting = nullptr;
+    std::atomic<int> calls{0};
+
+protected:
+    void onProcess( const period& ) override
+    {
+        if ( calls++ ) return;
+        if ( meeting )
+        {
+            // Both calls in progress, each one removes the other
+            (*meeting)++;
+            const steady::time_point End = steady::now() + std::chrono::seconds( 1 );
+            while ( *meeting < 2 && steady::now() < End )
+            {
+                std::this_thread::yield();
+            }
+        }
+        if ( other ) other->leave();
+        owned.reset();
+    }
+};
+
+/**
+ * @brief Subscriber starting new subscribers from its onProcess
+ *
+ */
+class CSpawningEvent : public CProcessEvent
+{
+public:
+    CSpawningEvent( CLoop& pLoop, std::size_t pChildren ) :
+        CProcessEvent( pLoop ), loop(pLoop), children(pChildren)
+    {
+        // Read from the test while filled, never moved
+        spawned.reserve( children );
+        startProcess();
+    }
+
+    ~CSpawningEvent()
+    {
+        stopProcess();
+    }
+
+    CLoop& loop;
+    const std::size_t children;
+    std::vector<std::unique_ptr<CCountingEvent>> spawned;
+    std::atomic<std::size_t> count{0};
+
+protected:
+    void onProcess( const period& ) override
+    {
+        if ( spawned.size() < children )
+        {
+            spawned.push_back( std::make_unique<CCountingEvent>( loop, 1 ) );
+            count = spawned.size();
+        }
+    }
+};
+
+class M6502LoopTests : public testing::Test
+{
+public:
+    virtual void SetUp()
+    {
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    // Poll until a condition is true, false after a few seconds
+    template<class TCondition>
+    bool WaitFor( TCondition pCondition )
+    {
+        const steady::time_point End = steady::now() + std::chrono::seconds( 10 );
+        while ( !pCondition() )
+        {
+            if ( steady::now() > End ) return false;
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+        return true;
+    }
+};
+
+TEST_F( M6502LoopTests, SubscribersComeAndGoWhileTheLoopRuns )
+{
+    // given:
+    CLoop Loop;
+    Loop.start( 1, 2 );
+    CCountingEvent Resident( Loop );
+    std::vector<std::unique_ptr<CCountingEvent>> Leaving;
+    CSpawningEvent Spawner( Loop, 20 );
+
+    // when:
+    std::thread Churn( [&Loop, &Leaving]()
+    {
+        for ( int Round = 0; Round < 200; Round++ )
+        {
+            CCountingEvent Short( Loop );
+            if ( Round % 10 == 0 )
+            {
+                Leaving.push_back( std::make_unique<CCountingEvent>( Loop, 1 ) );
+            }
+            std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+        }
+    } );
+    Churn.join();
+    const bool Spawned = WaitFor( [&Spawner]() { return Spawner.count == Spawner.children; } );
+    const bool Left = WaitFor( [&Leaving, &Spawner]()
+    {
+        for ( const auto& Event : Leaving ) if ( Event->calls == 0 ) return false;
+        for ( std::size_t Index = 0; Index < Spawner.count; Index++ ) if ( Spawner.spawned[Index]->calls == 0 ) return false;
+        return true;
+    } );
+    Loop.stop();
+
+    // then:
+    EXPECT_TRUE( Spawned );
+    EXPECT_TRUE( Left );
+    EXPECT_GT( Resident.calls, 0 );
+    // Subscribers leaving from their onProcess are never called again
+    for ( const auto& Event : Leaving ) EXPECT_EQ( Event->calls, 1 );
+    for ( const auto& Event : Spawner.spawned ) EXPECT_EQ( Event->calls, 1 );
+    EXPECT_EQ( Loop.getSubscribers( 0 ) + Loop.getSubscribers( 1 ), 2u );
+}
+
+TEST_F( M6502LoopTests, SubscriberIsNotCalledOnceUnsubscribed )
+{
+    // given:
+    CLoop Loop;
+    CCountingEvent Event( Loop );
+    Loop.start( 1, 1 );
+    ASSERT_TRUE( WaitFor( [&Event]() { return Event.calls >= 3; } ) );
+
+    // when:
+    Event.leave();
+    const int Calls = Event.calls;
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    Loop.stop();
+
+    // then:
+    EXPECT_EQ( Event.calls, Calls );
+    EXPECT_EQ( Loop.getSubscribers( 0 ), 0u );
+}
+
+TEST_F( M6502LoopTests, SubscribersAreSpreadOverTheWorkers )
+{
+    // given:
+    CLoop Loop;
+    std::vector<std::unique_ptr<CCountingEvent>> Events;
+    for ( int Index = 0; Index < 4; Index++ )
+    {
+        Events.push_back( std::make_unique<CCountingEvent>( Loop ) );
+    }
+
+    // when:
+    Loop.start( 1, 2 );
+    const bool Called = WaitFor( [&Events]()
+    {
+        for ( const auto& Event : Events ) if ( Event->calls == 0 ) return false;
+        return true;
+    } );
+    Loop.stop();
+
+    // then:
+    EXPECT_TRUE( Called );
+    EXPECT_EQ( Loop.getWorkers(), 2u );
+    EXPECT_EQ( Loop.getSubscribers( 0 ), 2u );
+    EXPECT_EQ( Loop.getSubscribers( 1 ), 2u );
+}
+
+TEST_F( M6502LoopTests, SubscriberDeletedByAnotherOfItsWorkerIsSkipped )
+{
+    // given:
+    CLoop Loop;
+    CRemovingEvent Remover( Loop );
+    // Called after the remover in the same walk
+    Remover.owned = std::make_unique<CCountingEvent>( Loop );
+
+    // when:
+    Loop.start( 1, 1 );
+    const bool Called = WaitFor( [&Remover]() { return Remover.calls >= 3; } );
+    Loop.stop();
+
+    // then:
+    EXPECT_TRUE( Called );
+    EXPECT_EQ( Remover.owned, nullptr );
+    EXPECT_EQ( Loop.getSubscribers( 0 ), 1u );
+}
+
+TEST_F( M6502LoopTests, SubscribersOfTwoWorkersRemovingEachOtherDoNotWaitForever )
+{
+    // given:
+    CLoop Loop;
+    std::atomic<int> Meeting{0};
+    CRemovingEvent First( Loop );
+    CRemovingEvent Second( Loop );
+    First.other = &Second;
+    Second.other = &First;
+    First.meeting = &Meeting;
+    Second.meeting = &Meeting;
+
+    // when:
+    // One on each worker
+    Loop.start( 1, 2 );
+    const bool Left = WaitFor( [&Loop]() { return Loop.getSubscribers( 0 ) + Loop.getSubscribers( 1 ) == 0; } );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    Loop.stop();
+
+    // then:
+    EXPECT_TRUE( Left );
+    EXPECT_EQ( First.calls, 1 );
+    EXPECT_EQ( Second.calls, 1 );
+}
+
+TEST_F( M6502LoopTests, RebalanceMovesABusySubscriberToTheIdleWorker )
+{
+    // given:
+    CLoop Loop;
+    // Busy ones on the first worker, idle ones on the second
+    CBusyEvent Busy1( Loop, std::chrono::microseconds( 100 ) );
+    CCountingEvent Idle1( Loop );
+    CBusyEvent Busy2( Loop, std::chrono::microseconds( 100 ) );
+    CCountingEvent Idle2( Loop );
+
+    // when:
+    Loop.start( 1, 2 );
+    ASSERT_EQ( Loop.getSubscribers( 0 ), 2u );
+    const bool Moved = WaitFor( [&Loop]() { return Loop.getSubscribers( 0 ) == 1 && Loop.getSubscribers( 1 ) == 3; } );
+    const int Calls1 = Busy1.calls;
+    const int Calls2 = Busy2.calls;
+    const bool Called = WaitFor( [&]() { return Busy1.calls > Calls1 + 10 && Busy2.calls > Calls2 + 10; } );
+    Loop.stop();
+
+    // then:
+    EXPECT_TRUE( Moved );
+    EXPECT_TRUE( Called );
+    EXPECT_EQ( Busy1.overlaps, 0 );
+    EXPECT_EQ( Busy2.overlaps, 0 );
+    EXPECT_GT( Idle1.calls, 0 );
+    EXPECT_GT( Idle2.calls, 0 );
+}
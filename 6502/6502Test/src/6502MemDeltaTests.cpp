@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502MemDeltaTests : public testing::Test
+{
+public:
+    M6502MemDeltaTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+
+    virtual void SetUp()
+    {
+        using namespace m6502;
+        mem.initialise();
+        cpu.reset( 0x1000 );
+        // loop: INC $3000 / INX / STX $4000 / JMP loop
+        const Byte Code[] = { 0xEE, 0x00, 0x30, 0xE8, 0x8E, 0x00, 0x40,
+            0x4C, 0x00, 0x10 };
+        for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+        {
+            mem[0x1000 + Index] = Code[Index];
+        }
+        mem.setDirtyTracking( true );
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+TEST_F( M6502MemDeltaTests, BusWritesMarkTheirPagesDirty )
+{
+    // given:
+    using namespace m6502;
+    EXPECT_EQ( mem.getDirtyPages(), 0u );
+
+    // when:
+    cpu.execute( 100 );
+
+    // then:
+    EXPECT_EQ( mem.getDirtyPages(), 2u );
+    EXPECT_TRUE( mem.isDirty( 0x30 ) );
+    EXPECT_TRUE( mem.isDirty( 0x40 ) );
+    EXPECT_FALSE( mem.isDirty( 0x10 ) );
+    EXPECT_EQ( mem[0x3000], cpu.X );
+}
+
+TEST_F( M6502MemDeltaTests, DeltaHoldsTheDirtyPagesOnly )
+{
+    // given:
+    using namespace m6502;
+    cpu.execute( 100 );
+    std::vector<Byte> Delta;
+
+    // when:
+    mem.delta( Delta );
+
+    // then:
+    ASSERT_EQ( Delta.size(), 8u + 2u * 257u );
+    EXPECT_EQ( Delta[0], 'M' );
+    EXPECT_EQ( Delta[3], 'D' );
+    EXPECT_EQ( Delta[6], 2 );
+    EXPECT_EQ( Delta[8], 0x30 );
+    EXPECT_EQ( Delta[9], cpu.X );
+    EXPECT_EQ( Delta[8 + 257], 0x40 );
+    EXPECT_EQ( mem.getDirtyPages(), 0u );
+}
+
+TEST_F( M6502MemDeltaTests, PagesCleanedByADeltaAreTrackedAgain )
+{
+    // given:
+    using namespace m6502;
+    cpu.execute( 100 );
+    std::vector<Byte> Delta;
+    mem.delta( Delta );
+    const Byte* Data = Delta.data();
+
+    // when:
+    cpu.execute( 100 );
+    mem.delta( Delta );
+
+    // then:
+    EXPECT_EQ( Delta.data(), Data );
+    EXPECT_EQ( Delta[6], 2 );
+    EXPECT_EQ( Delta[9], cpu.X );
+    mem.delta( Delta );
+    EXPECT_EQ( Delta.size(), 8u );
+}
+
+TEST_F( M6502MemDeltaTests, ChainOfDeltasRebuildsTheMemory )
+{
+    // given:
+    using namespace m6502;
+    const std::vector<Byte> Base = bus.snapshot();
+    std::vector<std::vector<Byte>> Chain( 3 );
+    for ( std::vector<Byte>& Delta : Chain )
+    {
+        cpu.execute( 1000 );
+        mem.delta( Delta );
+    }
+    CBus Bus;
+    CCPU CPU( Bus );
+    CMem Mem( Bus, 0x0000, 0x0000 );
+    Mem.setDirtyTracking( true );
+    ASSERT_TRUE( Bus.restore( Base ) );
+
+    // when:
+    const bool Applied = Mem.applyDeltas( Chain );
+
+    // then:
+    ASSERT_TRUE( Applied );
+    const CMem& Expected = mem;
+    const CMem& Actual = Mem;
+    for ( u32 Address = 0; Address < MAX_MEM; Address++ )
+    {
+        ASSERT_EQ( Actual[static_cast<Word>(Address)], Expected[static_cast<Word>(Address)] );
+    }
+    // Code loaded by the restore, then the pages of the deltas
+    EXPECT_EQ( Mem.getDirtyPages(), 3u );
+}
+
+TEST_F( M6502MemDeltaTests, InvalidChainIsRejectedAsAWhole )
+{
+    // given:
+    using namespace m6502;
+    std::vector<std::vector<Byte>> Chain( 2 );
+    cpu.execute( 1000 );
+    mem.delta( Chain[0] );
+    cpu.execute( 1000 );
+    mem.delta( Chain[1] );
+    Chain[1].pop_back();
+    CBus Bus;
+    CMem Mem( Bus, 0x0000, 0x0000 );
+
+    // when:
+    const bool Applied = Mem.applyDeltas( Chain );
+
+    // then:
+    EXPECT_FALSE( Applied );
+    const CMem& Actual = Mem;
+    EXPECT_EQ( Actual[0x3000], 0 );
+    EXPECT_FALSE( Mem.applyDelta( Chain[1].data(), Chain[1].size() ) );
+    EXPECT_TRUE( Mem.applyDelta( Chain[0].data(), Chain[0].size() ) );
+    EXPECT_NE( Actual[0x3000], 0 );
+}
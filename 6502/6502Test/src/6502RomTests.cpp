@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+#include <fstream>
+
+class M6502RomTests : public testing::Test
+{
+public:
+    M6502RomTests() : cpu(bus), rom(bus,0xC000,0xC000), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CRom rom;
+    m6502::CMem mem;
+    std::string path;
+
+    virtual void SetUp()
+    {
+        using namespace m6502;
+        mem.initialise();
+        // 16KB : $C000 LDA $C100 / STA $0200 / STA $C100 / JMP *
+        // $C100 $42, reset vector to $C000
+        std::vector<Byte> Image( 0x4000, 0xEA );
+        const Byte Code[] = { 0xAD, 0x00, 0xC1, 0x8D, 0x00, 0x02, 0x8D, 0x00, 0xC1,
+            0x4C, 0x09, 0xC0 };
+        std::copy( Code, Code + sizeof( Code ), Image.begin() );
+        Image[0x0100] = 0x42;
+        Image[0x3FFC] = 0x00;
+        Image[0x3FFD] = 0xC0;
+        path = WriteFile( "rom.bin", Image );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    static std::string WriteFile( const std::string& pName, const std::vector<m6502::Byte>& pBytes )
+    {
+        const std::string Path = testing::TempDir() + pName;
+        std::ofstream File( Path, std::ios::binary );
+        File.write( reinterpret_cast<const char*>( pBytes.data() ), static_cast<std::streamsize>( pBytes.size() ) );
+        return Path;
+    }
+};
+
+TEST_F( M6502RomTests, CPURunsFromTheMappedFile )
+{
+    // given:
+    using namespace m6502;
+    ASSERT_TRUE( rom.load( path ) );
+    cpu.reset();
+    cpu.PC = static_cast<Word>( bus.readBusData( 0xFFFC ) | (bus.readBusData( 0xFFFD ) << 8) );
+
+    // when:
+    cpu.execute( 4 + 4 + 4 + 3 );
+
+    // then:
+    EXPECT_EQ( cpu.PC, 0xC009 );
+    EXPECT_EQ( cpu.A, 0x42 );
+    EXPECT_EQ( mem[0x0200], 0x42 );
+    EXPECT_EQ( rom.getIgnoredWrites(), 1u );
+    EXPECT_EQ( bus.readBusData( 0xC100 ), 0x42 );
+    EXPECT_EQ( bus.getReadPage( 0xC000 ), rom.getImage()->getData() );
+}
+
+TEST_F( M6502RomTests, SystemsShareTheImageOfAFile )
+{
+    // given:
+    using namespace m6502;
+    ASSERT_TRUE( rom.load( path ) );
+
+    // when:
+    CBus Bus;
+    CRom Rom( Bus, 0xC000, 0xC000 );
+    ASSERT_TRUE( Rom.load( path ) );
+
+    // then:
+    EXPECT_EQ( Rom.getImage(), rom.getImage() );
+    EXPECT_EQ( Bus.getReadPage( 0xFF00 ), bus.getReadPage( 0xFF00 ) );
+    EXPECT_EQ( Rom.getImage().use_count(), 2 );
+}
+
+TEST_F( M6502RomTests, PartialLastPageIsReadByTheChip )
+{
+    // given:
+    using namespace m6502;
+    const std::string Path = WriteFile( "short.bin", std::vector<Byte>( 0x180, 0x11 ) );
+
+    // when:
+    ASSERT_TRUE( rom.load( Path ) );
+
+    // then:
+    EXPECT_NE( bus.getReadPage( 0xC000 ), nullptr );
+    EXPECT_EQ( bus.getReadPage( 0xC100 ), nullptr );
+    EXPECT_EQ( bus.readBusData( 0xC17F ), 0x11 );
+    EXPECT_EQ( bus.readBusData( 0xC180 ), 0xFF );
+    EXPECT_EQ( bus.readBusData( 0xFFFF ), 0xFF );
+}
+
+TEST_F( M6502RomTests, MissingFileKeepsTheImage )
+{
+    // given:
+    using namespace m6502;
+    ASSERT_TRUE( rom.load( path ) );
+
+    // when:
+    const bool Loaded = rom.load( testing::TempDir() + "missing.bin" );
+
+    // then:
+    EXPECT_FALSE( Loaded );
+    EXPECT_EQ( rom[0x0100], 0x42 );
+    EXPECT_EQ( CRomImage::open( testing::TempDir() + "missing.bin" ), nullptr );
+}
+
+TEST_F( M6502RomTests, ClosedAndMissingFilesLeaveNoImageEntry )
+{
+    // given:
+    using namespace m6502;
+    const std::string Other = WriteFile( "other.bin", std::vector<Byte>( 0x100, 0xEA ) );
+    // Entries left by ROMs gone before are dropped by an open
+    CRomImage::open( testing::TempDir() + "missing.bin" );
+    const size_t Before = CRomImage::getShared();
+    std::shared_ptr<const CRomImage> Image = CRomImage::open( Other );
+    ASSERT_NE( Image, nullptr );
+    EXPECT_EQ( CRomImage::getShared(), Before + 1 );
+
+    // when:
+    Image.reset();
+    const std::shared_ptr<const CRomImage> Missing = CRomImage::open( testing::TempDir() + "missing.bin" );
+
+    // then:
+    EXPECT_EQ( Missing, nullptr );
+    EXPECT_EQ( CRomImage::getShared(), Before );
+}
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+/**
+ * @brief Chip halting the CPU when written
+ *
+ */
+class CHaltChip : public m6502::CBusChip
+{
+public:
+    CHaltChip( m6502::CBus& pBus, m6502::Word pMask, m6502::Word pBank, m6502::CCPU& pCPU ) :
+        CBusChip( pBus, pMask, pBank ), CPU( pCPU ) {}
+
+    m6502::CCPU& CPU;
+
+protected:
+    void onWriteBusData( const m6502::Word&, const m6502::Byte& ) override
+    {
+        CPU.halt();
+    }
+
+    m6502::Byte onReadBusData( const m6502::Word& ) override
+    {
+        return 0;
+    }
+};
+
+class M6502RunTests : public testing::Test
+{
+public:
+    M6502RunTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        cpu.reset( 0x1000 );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void Load( m6502::Word pAddress, const std::vector<m6502::Byte>& pCode )
+    {
+        for ( m6502::Word Index = 0; Index < pCode.size(); Index++ )
+        {
+            mem[pAddress + Index] = pCode[Index];
+        }
+    }
+};
+
+TEST_F( M6502RunTests, BudgetRunGivesCyclesAndInstructions )
+{
+    // given:
+    using namespace m6502;
+    // loop: INX / JMP loop
+    Load( 0x1000, { 0xE8, 0x4C, 0x00, 0x10 } );
+
+    // when:
+    const SExecResult Result = cpu.run( 50 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Budget );
+    EXPECT_EQ( Result.fault, EFault::None );
+    EXPECT_EQ( Result.cycles, 50 );
+    EXPECT_EQ( Result.instructions, 20u );
+    EXPECT_EQ( Result.PC, cpu.PC );
+    EXPECT_EQ( cpu.X, 10 );
+    EXPECT_EQ( cpu.getInstructions(), 20u );
+}
+
+TEST_F( M6502RunTests, IllegalOpcodeStopsTheRunWithoutThrowing )
+{
+    // given:
+    using namespace m6502;
+    // LDA #$42 / illegal
+    Load( 0x1000, { 0xA9, 0x42, 0x02 } );
+    ASSERT_FALSE( cpu.getFaultStop() );
+
+    // when:
+    const SExecResult Result = cpu.run( 1000 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Fault );
+    EXPECT_EQ( Result.fault, EFault::Illegal );
+    EXPECT_EQ( Result.PC, 0x1002 );
+    EXPECT_EQ( Result.instructions, 1u );
+    EXPECT_EQ( Result.cycles, 2 + 1 );
+    EXPECT_EQ( cpu.A, 0x42 );
+    // execute still throws
+    EXPECT_ANY_THROW( cpu.execute( 1000 ) );
+}
+
+TEST_F( M6502RunTests, DecimalModeStopsTheRunWithoutThrowing )
+{
+    // given:
+    using namespace m6502;
+    // SED / ADC #$01
+    Load( 0x1000, { 0xF8, 0x69, 0x01 } );
+
+    // when:
+    const SExecResult Result = cpu.run( 1000 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Fault );
+    EXPECT_EQ( Result.fault, EFault::Decimal );
+    EXPECT_EQ( Result.PC, 0x1003 );
+}
+
+TEST_F( M6502RunTests, BreakStopLeavesPCOnTheBRK )
+{
+    // given:
+    using namespace m6502;
+    // INX / BRK
+    Load( 0x1000, { 0xE8, 0x00 } );
+    Load( 0xFFFE, { 0x00, 0x20 } );
+    cpu.setBreakStop( true );
+
+    // when:
+    const SExecResult Result = cpu.run( 1000 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Break );
+    EXPECT_EQ( Result.PC, 0x1001 );
+    EXPECT_EQ( cpu.PC, 0x1001 );
+    EXPECT_EQ( cpu.SP, 0xFF );
+    EXPECT_EQ( Result.instructions, 1u );
+}
+
+TEST_F( M6502RunTests, BreakpointStopsBeforeItsInstructionWithEveryEngine )
+{
+    // given:
+    using namespace m6502;
+    // LDX #3 / loop: DEX / BNE loop / JMP *
+    Load( 0x1000, { 0xA2, 0x03, 0xCA, 0xD0, 0xFD, 0x4C, 0x05, 0x10 } );
+
+    for ( EEngine Engine : { EEngine::Switch, EEngine::Table, EEngine::Threaded, EEngine::Block } )
+    {
+        // when:
+        cpu.reset( 0x1000 );
+        cpu.setEngine( Engine );
+        cpu.setBreakpoint( 0x1002 );
+        std::vector<Byte> Xs;
+        for ( SExecResult Result = cpu.run( 1000 ); Result.stop == EStop::Breakpoint; Result = cpu.run( 1000 ) )
+        {
+            EXPECT_EQ( Result.PC, 0x1002 );
+            Xs.push_back( cpu.X );
+        }
+        cpu.clearBreakpoints();
+
+        // then:
+        EXPECT_EQ( Xs, std::vector<Byte>( { 3, 2, 1 } ) );
+        EXPECT_EQ( cpu.X, 0 );
+        EXPECT_EQ( cpu.PC, 0x1005 );
+        EXPECT_FALSE( cpu.isBreakpoint( 0x1002 ) );
+    }
+}
+
+TEST_F( M6502RunTests, ChipCanHaltTheCPU )
+{
+    // given:
+    using namespace m6502;
+    CBus Bus;
+    CCPU CPU( Bus );
+    CHaltChip Halt( Bus, 0xFF00, 0xD000, CPU );
+    CMem Mem( Bus, 0x0000, 0x0000 );
+    CPU.reset( 0x1000 );
+    // INX / STX $D000 / INX / JMP *
+    const Byte Code[] = { 0xE8, 0x8E, 0x00, 0xD0, 0xE8, 0x4C, 0x05, 0x10 };
+    for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+    {
+        Mem[0x1000 + Index] = Code[Index];
+    }
+
+    // when:
+    const SExecResult Result = CPU.run( 1000 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Halt );
+    EXPECT_EQ( Result.cycles, 2 + 4 );
+    EXPECT_EQ( Result.instructions, 2u );
+    EXPECT_EQ( CPU.PC, 0x1004 );
+    EXPECT_EQ( CPU.X, 1 );
+}
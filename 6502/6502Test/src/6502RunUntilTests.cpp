@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502RunUntilTests : public testing::Test
+{
+public:
+    M6502RunUntilTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        cpu.reset( 0x1000 );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void Load( m6502::Word pAddress, const std::vector<m6502::Byte>& pCode )
+    {
+        for ( m6502::Word Index = 0; Index < pCode.size(); Index++ )
+        {
+            mem[pAddress + Index] = pCode[Index];
+        }
+    }
+
+    void LoadCountLoop()
+    {
+        // LDX #0 / loop: INX / TXA / STA $3000,X / CPX #$20 / BNE loop / JMP *
+        Load( 0x1000, { 0xA2, 0x00, 0xE8, 0x8A, 0x9D, 0x00, 0x30, 0xE0, 0x20,
+            0xD0, 0xF7, 0x4C, 0x0B, 0x10 } );
+    }
+};
+
+TEST_F( M6502RunUntilTests, RunUntilPCStopsBeforeTheAddressWithEveryEngine )
+{
+    // given:
+    using namespace m6502;
+    LoadCountLoop();
+
+    for ( EEngine Engine : { EEngine::Switch, EEngine::Table, EEngine::Threaded, EEngine::Block } )
+    {
+        // when:
+        cpu.reset( 0x1000 );
+        cpu.setEngine( Engine );
+        const SExecResult Result = cpu.runUntilPC( 0x100B, 100000 );
+
+        // then:
+        EXPECT_EQ( Result.stop, EStop::Condition );
+        EXPECT_EQ( Result.PC, 0x100B );
+        EXPECT_EQ( cpu.PC, 0x100B );
+        EXPECT_EQ( cpu.X, 0x20 );
+        EXPECT_EQ( Result.instructions, 1u + 0x20 * 5 );
+        EXPECT_FALSE( cpu.isBreakpoint( 0x100B ) );
+    }
+}
+
+TEST_F( M6502RunUntilTests, RunUntilWriteStopsAfterTheWritingInstruction )
+{
+    // given:
+    using namespace m6502;
+    LoadCountLoop();
+    ASSERT_NE( bus.getWritePage( 0x3000 ), nullptr );
+
+    // when:
+    const SExecResult Result = cpu.runUntilWrite( 0x3010, 0x3013, 100000 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Condition );
+    EXPECT_EQ( cpu.X, 0x10 );
+    EXPECT_EQ( cpu.PC, 0x1007 );
+    EXPECT_EQ( mem[0x3010], 0x10 );
+    EXPECT_EQ( mem[0x3011], 0x00 );
+    // Trap is gone, the page is written directly again
+    EXPECT_NE( bus.getWritePage( 0x3000 ), nullptr );
+    EXPECT_EQ( cpu.runUntilWrite( 0x3015, 100000 ).stop, EStop::Condition );
+    EXPECT_EQ( cpu.X, 0x15 );
+}
+
+TEST_F( M6502RunUntilTests, RunUntilReturnRunsTheWholeCall )
+{
+    // given:
+    using namespace m6502;
+    // JSR $2000 / JMP *   $2000: JSR $2100 / INY / RTS   $2100: INY / RTS
+    Load( 0x1000, { 0x20, 0x00, 0x20, 0x4C, 0x03, 0x10 } );
+    Load( 0x2000, { 0x20, 0x00, 0x21, 0xC8, 0x60 } );
+    Load( 0x2100, { 0xC8, 0x60 } );
+
+    // when:
+    const SExecResult Result = cpu.runUntilReturn( cpu.SP, 100000 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Condition );
+    EXPECT_EQ( cpu.PC, 0x1003 );
+    EXPECT_EQ( cpu.SP, 0xFF );
+    EXPECT_EQ( cpu.Y, 2 );
+    EXPECT_EQ( Result.cycles, 6 + 6 + 2 + 6 + 2 + 6 );
+}
+
+TEST_F( M6502RunUntilTests, RunUntilPredicateIsTrueWithEveryEngine )
+{
+    // given:
+    using namespace m6502;
+    LoadCountLoop();
+
+    for ( EEngine Engine : { EEngine::Switch, EEngine::Table, EEngine::Threaded, EEngine::Block } )
+    {
+        // when:
+        cpu.reset( 0x1000 );
+        cpu.setEngine( Engine );
+        const SExecResult Result = cpu.runUntil(
+            [this]( const CCPU& pCPU ) { return pCPU.X >= 5 && mem[0x3005] == 5; }, 100000 );
+
+        // then:
+        EXPECT_EQ( Result.stop, EStop::Condition );
+        EXPECT_EQ( cpu.X, 5 );
+    }
+}
+
+TEST_F( M6502RunUntilTests, RunUntilPredicateSeesTheFlagsWithEveryEngine )
+{
+    // given:
+    using namespace m6502;
+    // NOP / SEC / NOP / JMP *
+    Load( 0x1000, { 0xEA, 0x38, 0xEA, 0x4C, 0x03, 0x10 } );
+
+    for ( EEngine Engine : { EEngine::Switch, EEngine::Table, EEngine::Threaded, EEngine::Block } )
+    {
+        // when:
+        cpu.reset( 0x1000 );
+        cpu.Flags.C = false;
+        cpu.setEngine( Engine );
+        const SExecResult Result = cpu.runUntil( []( const CCPU& pCPU ) { return pCPU.Flags.C; }, 100000 );
+
+        // then:
+        EXPECT_EQ( Result.stop, EStop::Condition );
+        EXPECT_EQ( cpu.PC, 0x1002 );
+        EXPECT_EQ( Result.instructions, 2u );
+    }
+}
+
+TEST_F( M6502RunUntilTests, RunUntilPredicateStopsInsideABlockWithEveryEngine )
+{
+    // given:
+    using namespace m6502;
+    LoadCountLoop();
+
+    for ( EEngine Engine : { EEngine::Switch, EEngine::Table, EEngine::Threaded, EEngine::Block } )
+    {
+        // when:
+        cpu.reset( 0x1000 );
+        cpu.setEngine( Engine );
+        const SExecResult Result = cpu.runUntil(
+            []( const CCPU& pCPU ) { return pCPU.PC == 0x1007 && pCPU.X == 3; }, 100000 );
+
+        // then:
+        EXPECT_EQ( Result.stop, EStop::Condition );
+        EXPECT_EQ( cpu.PC, 0x1007 );
+        EXPECT_EQ( Result.instructions, 1u + 2 * 5 + 3 );
+    }
+}
+
+TEST_F( M6502RunUntilTests, RunUntilPredicateSeesEveryTurnOfAnIdleLoop )
+{
+    // given:
+    using namespace m6502;
+    // LDY #0 / loop: DEY / BNE loop
+    Load( 0x1000, { 0xA0, 0x00, 0x88, 0xD0, 0xFD } );
+    cpu.setIdleSkip( true );
+
+    // when:
+    const SExecResult Result = cpu.runUntil( []( const CCPU& pCPU ) { return pCPU.Y == 0x80; }, 100000 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Condition );
+    EXPECT_EQ( cpu.Y, 0x80 );
+    EXPECT_EQ( Result.cycles, 639 );
+}
+
+TEST_F( M6502RunUntilTests, ConditionNeverMetUsesTheBudget )
+{
+    // given:
+    using namespace m6502;
+    LoadCountLoop();
+
+    // when:
+    const SExecResult Result = cpu.runUntilPC( 0x2000, 1000 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Budget );
+    EXPECT_GE( Result.cycles, 1000 );
+    EXPECT_EQ( Result.instructions, cpu.getInstructions() );
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+#include <m6502/System/Aot.hpp>
+
+extern const m6502::SAotImage AotTestProgram;
+
+class M6502SchedulerTests : public testing::Test
+{
+public:
+    M6502SchedulerTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        cpu.reset( 0x1000 );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void Load( m6502::Word pAddress, const std::vector<m6502::Byte>& pCode )
+    {
+        for ( m6502::Word Index = 0; Index < pCode.size(); Index++ )
+        {
+            mem[pAddress + Index] = pCode[Index];
+        }
+    }
+};
+
+TEST_F( M6502SchedulerTests, EventsFireInDeadlineThenSchedulingOrder )
+{
+    // given:
+    using namespace m6502;
+    CScheduler Scheduler;
+    std::vector<int> Fired;
+    Scheduler.schedule( 30, [&]( u64 ) { Fired.push_back( 3 ); } );
+    Scheduler.schedule( 10, [&]( u64 ) { Fired.push_back( 1 ); } );
+    Scheduler.schedule( 30, [&]( u64 ) { Fired.push_back( 4 ); } );
+    const u64 Cancelled = Scheduler.schedule( 20, [&]( u64 ) { Fired.push_back( 2 ); } );
+
+    // when:
+    EXPECT_TRUE( Scheduler.cancel( Cancelled ) );
+    Scheduler.advance( 25 );
+    const std::vector<int> Early = Fired;
+    Scheduler.advance( 5 );
+
+    // then:
+    EXPECT_EQ( Early, std::vector<int>( { 1 } ) );
+    EXPECT_EQ( Fired, std::vector<int>( { 1, 3, 4 } ) );
+    EXPECT_EQ( Scheduler.getNow(), 30u );
+    EXPECT_EQ( Scheduler.getPending(), 0u );
+    EXPECT_EQ( Scheduler.getNextDeadline(), CScheduler::Never );
+    EXPECT_FALSE( Scheduler.cancel( Cancelled ) );
+}
+
+TEST_F( M6502SchedulerTests, ExecuteFiresEventsAtInstructionBoundaries )
+{
+    // given:
+    using namespace m6502;
+    // loop: INX / JMP loop
+    Load( 0x1000, { 0xE8, 0x4C, 0x00, 0x10 } );
+    CScheduler& Scheduler = bus.getScheduler();
+    u64 FiredAt = 0;
+    Byte X = 0;
+    Scheduler.schedule( 9, [&]( u64 ) { FiredAt = Scheduler.getNow(); X = cpu.X; } );
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( 50 );
+
+    // then:
+    EXPECT_EQ( CyclesUsed, 50 );
+    EXPECT_EQ( FiredAt, 10u );
+    EXPECT_EQ( X, 2 );
+    EXPECT_EQ( Scheduler.getNow(), 50u );
+}
+
+TEST_F( M6502SchedulerTests, PeriodicEventDoesNotChangeTheRun )
+{
+    // given:
+    using namespace m6502;
+    // loop: NOP / INX / JMP loop
+    Load( 0x1000, { 0xEA, 0xE8, 0x4C, 0x00, 0x10 } );
+    CBus Bus;
+    CCPU CPU( Bus );
+    CMem Mem( Bus, 0x0000, 0x0000 );
+    CPU.reset( 0x1000 );
+    for ( Word Index = 0; Index < 5; Index++ )
+    {
+        Mem[0x1000 + Index] = mem[0x1000 + Index];
+    }
+    CScheduler& Scheduler = bus.getScheduler();
+    u32 Ticks = 0;
+    std::function<void(u64)> Tick = [&]( u64 pCycle )
+    {
+        Ticks++;
+        Scheduler.schedule( pCycle + 100, Tick );
+    };
+    Scheduler.schedule( 100, Tick );
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( 10000 );
+    const s64 ExpectedCycles = CPU.execute( 10000 );
+
+    // then:
+    EXPECT_EQ( CyclesUsed, ExpectedCycles );
+    EXPECT_EQ( cpu.X, CPU.X );
+    EXPECT_EQ( cpu.PC, CPU.PC );
+    EXPECT_EQ( Ticks, 100u );
+    EXPECT_EQ( Scheduler.getNextDeadline(), 10100u );
+}
+
+TEST_F( M6502SchedulerTests, EventCanHaltTheCPU )
+{
+    // given:
+    using namespace m6502;
+    // loop: INX / JMP loop
+    Load( 0x1000, { 0xE8, 0x4C, 0x00, 0x10 } );
+    bus.getScheduler().schedule( 12, [&]( u64 ) { cpu.halt(); } );
+
+    // when:
+    const SExecResult Result = cpu.run( 1000 );
+
+    // then:
+    EXPECT_EQ( Result.stop, EStop::Halt );
+    EXPECT_EQ( Result.cycles, 12 );
+    EXPECT_EQ( cpu.X, 3 );
+    EXPECT_EQ( bus.getScheduler().getNow(), 12u );
+}
+
+TEST_F( M6502SchedulerTests, StepMovesTheClock )
+{
+    // given:
+    using namespace m6502;
+    // INX / INX
+    Load( 0x1000, { 0xE8, 0xE8 } );
+    bool Fired = false;
+    bus.getScheduler().schedule( 3, [&]( u64 ) { Fired = true; } );
+
+    // when:
+    cpu.step();
+    const bool FiredFirst = Fired;
+    cpu.step();
+
+    // then:
+    EXPECT_FALSE( FiredFirst );
+    EXPECT_TRUE( Fired );
+    EXPECT_EQ( bus.getScheduler().getNow(), 4u );
+}
+
+TEST_F( M6502SchedulerTests, EventsSeeAndChangeTheFlags )
+{
+    // given:
+    using namespace m6502;
+    // SEC / loop: INX / JMP loop
+    Load( 0x1000, { 0x38, 0xE8, 0x4C, 0x01, 0x10 } );
+    bool Carry = false;
+    bus.getScheduler().schedule( 10, [&]( u64 ) { Carry = cpu.Flags.C; cpu.Flags.C = false; } );
+
+    // when:
+    cpu.execute( 50 );
+
+    // then:
+    EXPECT_TRUE( Carry );
+    EXPECT_FALSE( cpu.Flags.C );
+}
+
+TEST_F( M6502SchedulerTests, TranslatedBlocksMoveTheClockUpToTheDeadlines )
+{
+    // given:
+    using namespace m6502;
+    std::vector<Byte> Prg = { static_cast<Byte>(AotTestProgram.loadAddress & 0xFF),
+                              static_cast<Byte>(AotTestProgram.loadAddress >> 8) };
+    Prg.insert( Prg.end(), AotTestProgram.data, AotTestProgram.data + AotTestProgram.size );
+    cpu.reset( 0xFFFC );
+    cpu.loadPrg( Prg.data(), static_cast<u32>(Prg.size()) );
+    CAotProgram Program( cpu, bus, AotTestProgram );
+    CScheduler& Scheduler = bus.getScheduler();
+    u64 FiredAt = 0;
+    Scheduler.schedule( 5000, [&]( u64 ) { FiredAt = Scheduler.getNow(); } );
+
+    // when:
+    const s64 CyclesUsed = Program.execute( 100000 );
+
+    // then:
+    EXPECT_GT( Program.getStats().translatedRuns, 0u );
+    EXPECT_EQ( Scheduler.getNow(), static_cast<u64>( CyclesUsed ) );
+    EXPECT_GE( FiredAt, 5000u );
+    EXPECT_LT( FiredAt, 5007u );
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+class M6502SnapshotTests : public testing::Test
+{
+public:
+    M6502SnapshotTests() : cpu(bus), mem(bus,0x0000,0x0000) {}
+    m6502::CBus bus;
+    m6502::CCPU cpu;
+    m6502::CMem mem;
+
+    /**
+     * @brief Another system with the same chips, to fan out snapshots
+     *
+     */
+    struct SSystem
+    {
+        m6502::CBus bus;
+        m6502::CCPU cpu{bus};
+        m6502::CMem mem{bus,0x0000,0x0000};
+    };
+
+    virtual void SetUp()
+    {
+        mem.initialise();
+        cpu.reset( 0x1000 );
+    }
+
+    virtual void TearDown()
+    {
+    }
+
+    void LoadFillLoop()
+    {
+        using namespace m6502;
+        // LDX #0 / loop: TXA / STA $2000,X / INX / BNE loop / JMP *
+        const Byte Code[] = { 0xA2, 0x00, 0x8A, 0x9D, 0x00, 0x20, 0xE8,
+            0xD0, 0xF9, 0x4C, 0x09, 0x10 };
+        for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+        {
+            mem[0x1000 + Index] = Code[Index];
+        }
+    }
+
+    /**
+     * @brief Registers of a CPU, copying the CPU would connect it to the bus
+     *
+     */
+    struct SState
+    {
+        m6502::Word PC;
+        m6502::Byte SP, A, X, Y, PS;
+    };
+
+    static SState State( const m6502::CCPU& pCPU )
+    {
+        return { pCPU.PC, pCPU.SP, pCPU.A, pCPU.X, pCPU.Y, pCPU.PS };
+    }
+
+    static void ExpectSameState( const SState& pExpected, const m6502::CCPU& pActual )
+    {
+        EXPECT_EQ( pActual.PC, pExpected.PC );
+        EXPECT_EQ( pActual.SP, pExpected.SP );
+        EXPECT_EQ( pActual.A, pExpected.A );
+        EXPECT_EQ( pActual.X, pExpected.X );
+        EXPECT_EQ( pActual.Y, pExpected.Y );
+        EXPECT_EQ( pActual.PS, pExpected.PS );
+    }
+};
+
+TEST_F( M6502SnapshotTests, RestoreGoesBackToTheSnapshot )
+{
+    // given:
+    using namespace m6502;
+    LoadFillLoop();
+    cpu.execute( 300 );
+    const std::vector<Byte> Blob = bus.snapshot();
+    const SState Before = State( cpu );
+    const Byte Filled = mem[0x2010];
+
+    // when:
+    const s64 CyclesUsed = cpu.execute( 4000 );
+    const SState After = State( cpu );
+    const bool Restored = bus.restore( Blob );
+
+    // then:
+    ASSERT_TRUE( Restored );
+    ExpectSameState( Before, cpu );
+    EXPECT_EQ( mem[0x2010], Filled );
+    EXPECT_EQ( mem[0x20FF], 0 );
+    EXPECT_EQ( cpu.execute( 4000 ), CyclesUsed );
+    ExpectSameState( After, cpu );
+    EXPECT_EQ( mem[0x20FF], 0xFF );
+}
+
+TEST_F( M6502SnapshotTests, SnapshotFansOutToOtherSystems )
+{
+    // given:
+    using namespace m6502;
+    LoadFillLoop();
+    cpu.execute( 500 );
+    cpu.Flags.C = 1;
+    const std::vector<Byte> Blob = bus.snapshot();
+    cpu.execute( 700 );
+
+    // when:
+    SSystem Systems[4];
+    for ( SSystem& System : Systems )
+    {
+        ASSERT_TRUE( System.bus.restore( Blob ) );
+        System.cpu.execute( 700 );
+    }
+
+    // then:
+    for ( SSystem& System : Systems )
+    {
+        ExpectSameState( State( cpu ), System.cpu );
+        for ( u32 Address = 0; Address < MAX_MEM; Address++ )
+        {
+            ASSERT_EQ( System.mem[static_cast<Word>(Address)], mem[static_cast<Word>(Address)] );
+        }
+    }
+}
+
+TEST_F( M6502SnapshotTests, RestoreDropsTheDecodedBlocks )
+{
+    // given:
+    using namespace m6502;
+    cpu.setEngine( EEngine::Block );
+    // LDY #$02 / JMP *
+    const Byte Code[] = { 0xA0, 0x02, 0x4C, 0x02, 0x10 };
+    for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+    {
+        mem[0x1000 + Index] = Code[Index];
+    }
+    const std::vector<Byte> Blob = bus.snapshot();
+    mem[0x1001] = 0x01;
+    cpu.execute( 20 );
+    EXPECT_EQ( cpu.Y, 0x01 );
+
+    // when:
+    ASSERT_TRUE( bus.restore( Blob ) );
+    cpu.execute( 20 );
+
+    // then:
+    EXPECT_EQ( cpu.Y, 0x02 );
+}
+
+TEST_F( M6502SnapshotTests, BlobIsReusedWithoutAllocation )
+{
+    // given:
+    using namespace m6502;
+    LoadFillLoop();
+    std::vector<Byte> Blob;
+    bus.snapshot( Blob );
+    const Byte* Data = Blob.data();
+    const size_t Size = Blob.size();
+
+    // when:
+    cpu.execute( 1000 );
+    bus.snapshot( Blob );
+
+    // then:
+    EXPECT_EQ( Blob.data(), Data );
+    EXPECT_EQ( Blob.size(), Size );
+    EXPECT_EQ( Size, 8u + 4u + 23u + 4u + MAX_MEM );
+    EXPECT_EQ( Blob[0], 'M' );
+    EXPECT_EQ( Blob[1], '6' );
+    EXPECT_EQ( Blob[2], '5' );
+    EXPECT_EQ( Blob[3], 'S' );
+    EXPECT_EQ( Blob[4], CBus::SnapshotVersion );
+    EXPECT_EQ( Blob[6], 2 );
+}
+
+TEST_F( M6502SnapshotTests, MismatchedBlobsAreRejected )
+{
+    // given:
+    using namespace m6502;
+    LoadFillLoop();
+    const std::vector<Byte> Blob = bus.snapshot();
+    std::vector<Byte> Truncated( Blob.begin(), Blob.end() - 1 );
+    std::vector<Byte> NewerVersion( Blob );
+    NewerVersion[4]++;
+    SSystem Other;
+    CMem Extra( Other.bus, 0x0000, 0x0000 );
+    cpu.execute( 1000 );
+    const SState After = State( cpu );
+
+    // when:
+    const bool TruncatedRestored = bus.restore( Truncated );
+    const bool NewerRestored = bus.restore( NewerVersion );
+    const bool OtherRestored = Other.bus.restore( Blob );
+
+    // then:
+    EXPECT_FALSE( TruncatedRestored );
+    EXPECT_FALSE( NewerRestored );
+    EXPECT_FALSE( OtherRestored );
+    ExpectSameState( After, cpu );
+    EXPECT_EQ( mem[0x2010], 0x10 );
+    EXPECT_EQ( Other.cpu.PC, 0xFFFC );
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <m6502/System.hpp>
+
+// Chip counting its accesses, registers at $D000-$D00F
+class CStaticTestIo
+{
+public:
+    CStaticTestIo() : Reads(0), Writes(0), LastOffset(0), LastData(0) {}
+    m6502::Byte onReadBusData( const m6502::Word& pAddress )
+    {
+        Reads++;
+        LastOffset = pAddress;
+        return static_cast<m6502::Byte>(0xA0 | pAddress);
+    }
+    void onWriteBusData( const m6502::Word& pAddress, const m6502::Byte& pData )
+    {
+        Writes++;
+        LastOffset = pAddress;
+        LastData = pData;
+    }
+    int Reads;
+    int Writes;
+    m6502::Word LastOffset;
+    m6502::Byte LastData;
+};
+
+typedef m6502::CStaticBus<
+    m6502::SStaticChip<CStaticTestIo, 0xFFF0, 0xD000>,
+    m6502::SStaticChip<m6502::CStaticMem<>, 0x0000, 0x0000>> CStaticTestBus;
+
+class M6502StaticBusTests : public testing::Test
+{
+public:
+    M6502StaticBusTests() : cpu(bus), refCpu(refBus), refMem(refBus,0x0000,0x0000) {}
+    CStaticTestBus bus;
+    m6502::CStaticCPU<CStaticTestBus> cpu;
+    m6502::CBus refBus;
+    m6502::CCPU refCpu;
+    m6502::CMem refMem;
+
+    m6502::CStaticMem<>& Mem() { return bus.getChip<1>(); }
+    CStaticTestIo& Io() { return bus.getChip<0>(); }
+
+    virtual void SetUp()
+    {
+        refMem.initialise();
+        cpu.reset( 0xFFFC );
+        refCpu.reset( 0xFFFC );
+    }
+
+    virtual void TearDown()
+    {
+    }
+};
+
+/* Table fill, indirect copy, shifts, calls and short loops,
+   the program of M6502Bench loaded at $0200 */
+static const m6502::Byte MixedPrg[] = {
+    0x00, 0x02,
+    0xA9, 0x00, 0x85, 0x20, 0x85, 0x22, 0xA9, 0x04, 0x85, 0x21, 0xA9, 0x06,
+    0x85, 0x23, 0xA2, 0x00, 0x8A, 0x18, 0x69, 0x03, 0x9D, 0x00, 0x04, 0x45,
+    0x10, 0x29, 0x7F, 0x05, 0x11, 0x9D, 0x00, 0x05, 0xE8, 0xD0, 0xED, 0xA0,
+    0x3F, 0xB1, 0x20, 0x0A, 0x26, 0x30, 0xC9, 0x40, 0x90, 0x02, 0xE9, 0x40,
+    0x91, 0x22, 0x88, 0x10, 0xF0, 0xA2, 0x10, 0x20, 0x42, 0x02, 0xCA, 0xD0,
+    0xFA, 0xE6, 0x12, 0x4C, 0x0E, 0x02, 0x48, 0x8A, 0x48, 0x46, 0x31, 0xBD,
+    0x00, 0x05, 0xA0, 0x04, 0x88, 0xD0, 0xFD, 0x68, 0xAA, 0x68, 0x60 };
+
+TEST_F( M6502StaticBusTests, ReadsGoToTheFirstChipInRange )
+{
+    // given:
+    using namespace m6502;
+    Mem()[0xD003] = 0x11;
+    Mem()[0xD010] = 0x22;
+
+    // when:
+    const Byte Chip = bus.readBusData( 0xD003 );
+    const Byte Ram = bus.readBusData( 0xD010 );
+
+    // then:
+    EXPECT_EQ( Chip, 0xA3 );
+    EXPECT_EQ( Ram, 0x22 );
+    EXPECT_EQ( Io().Reads, 1 );
+}
+
+TEST_F( M6502StaticBusTests, WritesGoToEveryChipInRange )
+{
+    // given:
+    using namespace m6502;
+
+    // when:
+    bus.writeBusData( 0xD005, 0x5A );
+    bus.writeBusData( 0x1234, 0x77 );
+
+    // then:
+    EXPECT_EQ( Io().Writes, 1 );
+    EXPECT_EQ( Io().LastData, 0x5A );
+    EXPECT_EQ( Mem()[0xD005], 0x5A );
+    EXPECT_EQ( Mem()[0x1234], 0x77 );
+}
+
+TEST_F( M6502StaticBusTests, ChipsGetAddressesRelativeToTheirBank )
+{
+    // given:
+    using namespace m6502;
+
+    // when:
+    bus.writeBusData( 0xD00C, 0x01 );
+
+    // then:
+    EXPECT_EQ( Io().LastOffset, 0x000C );
+}
+
+TEST_F( M6502StaticBusTests, AddressesOfNoChipReadZero )
+{
+    // given:
+    using namespace m6502;
+    typedef CStaticBus<SStaticChip<CStaticMem<0x800>, 0xF800, 0x0000>> CSmallBus;
+    CSmallBus SmallBus;
+    SmallBus.writeBusData( 0x0800, 0x42 );
+    SmallBus.writeBusData( 0x07FF, 0x43 );
+
+    // when:
+    const Byte Outside = SmallBus.readBusData( 0x0800 );
+    const Byte Inside = SmallBus.readBusData( 0x07FF );
+
+    // then:
+    EXPECT_EQ( Outside, 0x00 );
+    EXPECT_EQ( Inside, 0x43 );
+}
+
+TEST_F( M6502StaticBusTests, StaticCPURunsLikeCCPU )
+{
+    // given:
+    using namespace m6502;
+    cpu.loadPrg( MixedPrg, sizeof( MixedPrg ) );
+    refCpu.loadPrg( MixedPrg, sizeof( MixedPrg ) );
+
+    // when:
+    for ( int Slice = 0; Slice < 300; Slice++ )
+    {
+        const s64 Cycles = 1 + (Slice * 7919) % 5003;
+        ASSERT_EQ( cpu.execute( Cycles ), refCpu.execute( Cycles ) ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.PC, refCpu.PC ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.A, refCpu.A ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.X, refCpu.X ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.Y, refCpu.Y ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.SP, refCpu.SP ) << "Slice " << Slice;
+        ASSERT_EQ( cpu.PS, refCpu.PS ) << "Slice " << Slice;
+    }
+
+    // then:
+    for ( u32 Address = 0; Address < 0x1000; Address++ )
+    {
+        ASSERT_EQ( Mem()[Address], refMem[Address] ) << "Address " << Address;
+    }
+}
+
+TEST_F( M6502StaticBusTests, StepRunsOneInstruction )
+{
+    // given:
+    using namespace m6502;
+    cpu.reset( 0x1000 );
+    refCpu.reset( 0x1000 );
+    // LDA $D002 / STA $10
+    const Byte Code[] = { 0xAD, 0x02, 0xD0, 0x85, 0x10 };
+    for ( Word Index = 0; Index < sizeof( Code ); Index++ )
+    {
+        Mem()[0x1000 + Index] = Code[Index];
+    }
+
+    // when:
+    const s64 Load = cpu.step();
+    const s64 Store = cpu.step();
+
+    // then:
+    EXPECT_EQ( Load, 4 );
+    EXPECT_EQ( Store, 3 );
+    EXPECT_EQ( cpu.PC, 0x1005 );
+    EXPECT_EQ( Mem()[0x10], 0xA2 );
+    EXPECT_TRUE( cpu.Flags.N );
+    EXPECT_EQ( Io().Reads, 1 );
+}
+
+TEST_F( M6502StaticBusTests, IllegalOpcodeThrowsAsCCPU )
+{
+    // given:
+    using namespace m6502;
+    cpu.reset( 0x1000 );
+    Mem()[0x1000] = 0x02;
+
+    // when:
+    // then:
+    EXPECT_ANY_THROW( cpu.execute( 10 ) );
+}